@@ -20,6 +20,26 @@ typedef void(*TIMED_CB)(void);
 /** Type representing a function pointer to a window callback */
 typedef void(*WINDOW_CB)(PROF_WIN_TAG win, char *line);
 
+/**
+Type representing one event delivered to an events callback.
+type is one of "chat", "room", "private", "presence", "offline", "message_stanza", "presence_stanza" or "iq_stanza".
+resource holds the nickname for room and private messages.
+message holds the message, the presence status, or the stanza for stanza events.
+presence and priority are only set for presence events.
+Fields that do not apply to an event are NULL.
+*/
+typedef struct prof_event_t {
+    const char *type;
+    const char *barejid;
+    const char *resource;
+    const char *message;
+    const char *presence;
+    int priority;
+} PROF_EVENT;
+
+/** Type representing a function pointer to an events callback, the events are only valid during the call */
+typedef void(*EVENTS_CB)(PROF_EVENT *events, int count);
+
 /**	Highlights the console window in the status bar. */
 void prof_cons_alert(void);
 
@@ -71,6 +91,14 @@ Register a function that Profanity will call periodically.
 */
 void prof_register_timed(TIMED_CB callback, int interval_seconds);
 
+/**
+Register a function that receives received messages, presence updates and stanzas in batches,
+instead of one hook call per event. Registering again replaces the previous function.
+@param callback The {@link EVENTS_CB} function to execute
+@param interval_ms the time to collect events for between calls, in milliseconds, 0 for every main loop iteration
+*/
+void prof_register_events(EVENTS_CB callback, int interval_ms);
+
 /**
 Add values to be autocompleted by Profanity for a command, or command argument. If the key already exists, Profanity will add the items to the existing autocomplete items for that key.
 @param key the prefix to trigger autocompletion
@@ -204,6 +232,14 @@ Show a message in the plugin window.
 */
 int prof_win_show(PROF_WIN_TAG win, char *message);
 
+/**
+Show several messages in the plugin window at once.
+@param win the {@link PROF_WIN_TAG} of the window to display the messages
+@param lines NULL terminated array of messages to print
+@return 1 on success, 0 on failure
+*/
+int prof_win_show_lines(PROF_WIN_TAG win, char **lines);
+
 /**	
 Show a message in the plugin window, using the specified theme.
 Themes are specified in ~/.local/share/profanity/plugin_themes
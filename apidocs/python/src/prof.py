@@ -122,6 +122,28 @@ def register_timed(callback, interval):
     pass
 
 
+def register_events(callback, interval=0):
+    """Register a function that receives received messages, presence updates and stanzas in batches,
+    instead of one hook call per event. Registering again replaces the previous function.
+
+    The callback is passed a list of dicts with the keys ``type``, ``barejid``, ``resource``,
+    ``message``, ``presence`` and ``priority``. ``type`` is one of ``"chat"``, ``"room"``, ``"private"``,
+    ``"presence"``, ``"offline"``, ``"message_stanza"``, ``"presence_stanza"`` or ``"iq_stanza"``.
+    ``resource`` holds the nickname for room and private messages, ``message`` holds the message,
+    the presence status, or the stanza for stanza events. Values that do not apply are ``None``.
+
+    :param callback: the function to call
+    :param interval: the time to collect events for between calls, in milliseconds, 0 for every main loop iteration
+    :type callback: function
+    :type interval: int
+
+    Example:
+    ::
+        prof.register_events(count_messages, 1000)
+    """
+    pass
+
+
 def completer_add(key, items):
     """Add values to be autocompleted by Profanity for a command, or command argument. If the key already exists, Profanity will add the items to the existing autocomplete items for that key.
 
@@ -374,6 +396,21 @@ def win_show(tag, message):
     pass
 
 
+def win_show_lines(tag, lines):
+    """Show several messages in the plugin window at once.
+
+    :param tag: The tag of the window to display the messages
+    :type tag: str or unicode
+    :param lines: the messages to print
+    :type lines: list of str or unicode
+
+    Example:
+    ::
+        prof.win_show_lines("My Plugin", [ "first line", "second line" ])
+    """
+    pass
+
+
 def win_show_themed(tag, group, key, default, message): 
     """Show a message in the plugin window, using the specified theme.\n
     Themes are specified in ``~/.local/share/profanity/plugin_themes``
@@ -12,6 +12,7 @@ BuildRequires:	libstrophe-devel
 # or:
 #BuildRequires:	libmesode-devel
 BuildRequires:	libcurl-devel
+BuildRequires:	sqlite-devel
 BuildRequires:	ncurses-devel
 BuildRequires:	openssl-devel
 BuildRequires:	glib2-devel
@@ -20,6 +21,7 @@ BuildRequires:	libotr-devel
 BuildRequires:	gnutls-devel
 Requires:	libstrophe
 Requires:	libcurl
+Requires:	sqlite
 Requires:	ncurses-libs
 Requires:	openssl
 Requires:	glib2
@@ -54,6 +54,7 @@
 #include "xmpp/muc.h"
 #include "xmpp/xmpp.h"
 #include "xmpp/roster_list.h"
+#include "xmpp/room_directory.h"
 
 #ifdef HAVE_LIBGPGME
 #include "pgp/gpg.h"
@@ -113,11 +114,29 @@ static char* _status_autocomplete(ProfWin *window, const char *const input, gboo
 static char* _logging_autocomplete(ProfWin *window, const char *const input, gboolean previous);
 static char* _color_autocomplete(ProfWin *window, const char *const input, gboolean previous);
 static char* _avatar_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _xmlconsole_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _memory_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _history_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _boolean_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _nick_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _contact_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _fulljid_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _ping_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _prefs_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _disco_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _room_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _autoping_autocomplete(ProfWin *window, const char *const input, gboolean previous);
+static char* _winpos_autocomplete(ProfWin *window, const char *const input, gboolean previous);
 
 static char* _script_autocomplete_func(const char *const prefix, gboolean previous);
 
 static char* _cmd_ac_complete_params(ProfWin *window, const char *const input, gboolean previous);
 
+typedef char* (*ac_func_t)(ProfWin *window, const char *const input, gboolean previous);
+
+// command name to the function completing its arguments, built once at init
+static GHashTable *ac_funcs;
+
 static Autocomplete commands_ac;
 static Autocomplete who_room_ac;
 static Autocomplete who_roster_ac;
@@ -168,6 +187,7 @@ static Autocomplete roster_private_ac;
 static Autocomplete group_ac;
 static Autocomplete bookmark_ac;
 static Autocomplete bookmark_property_ac;
+static Autocomplete bookmark_order_ac;
 static Autocomplete otr_ac;
 static Autocomplete otr_log_ac;
 static Autocomplete otr_policy_ac;
@@ -234,6 +254,12 @@ static Autocomplete status_ac;
 static Autocomplete status_state_ac;
 static Autocomplete logging_ac;
 static Autocomplete color_ac;
+static Autocomplete xmlconsole_ac;
+static Autocomplete xmlconsole_filter_ac;
+static Autocomplete xmlconsole_filter_clear_ac;
+static Autocomplete xmlconsole_type_ac;
+static Autocomplete memory_ac;
+static Autocomplete history_ac;
 
 void
 cmd_ac_init(void)
@@ -579,6 +605,11 @@ cmd_ac_init(void)
     autocomplete_add(bookmark_ac, "remove");
     autocomplete_add(bookmark_ac, "join");
     autocomplete_add(bookmark_ac, "invites");
+    autocomplete_add(bookmark_ac, "order");
+
+    bookmark_order_ac = autocomplete_new();
+    autocomplete_add(bookmark_order_ac, "activity");
+    autocomplete_add(bookmark_order_ac, "server");
 
     bookmark_property_ac = autocomplete_new();
     autocomplete_add(bookmark_property_ac, "nick");
@@ -855,7 +886,6 @@ cmd_ac_init(void)
     autocomplete_add(tray_ac, "on");
     autocomplete_add(tray_ac, "off");
     autocomplete_add(tray_ac, "read");
-    autocomplete_add(tray_ac, "timer");
 
     presence_ac = autocomplete_new();
     autocomplete_add(presence_ac, "titlebar");
@@ -920,12 +950,120 @@ cmd_ac_init(void)
     logging_ac = autocomplete_new();
     autocomplete_add(logging_ac, "chat");
     autocomplete_add(logging_ac, "group");
+    autocomplete_add(logging_ac, "compress");
 
     color_ac = autocomplete_new();
     autocomplete_add(color_ac, "on");
     autocomplete_add(color_ac, "off");
     autocomplete_add(color_ac, "redgreen");
     autocomplete_add(color_ac, "blue");
+
+    xmlconsole_ac = autocomplete_new();
+    autocomplete_add(xmlconsole_ac, "filter");
+    autocomplete_add(xmlconsole_ac, "save");
+
+    xmlconsole_filter_ac = autocomplete_new();
+    autocomplete_add(xmlconsole_filter_ac, "type");
+    autocomplete_add(xmlconsole_filter_ac, "ns");
+    autocomplete_add(xmlconsole_filter_ac, "jid");
+    autocomplete_add(xmlconsole_filter_ac, "clear");
+
+    xmlconsole_filter_clear_ac = autocomplete_new();
+    autocomplete_add(xmlconsole_filter_clear_ac, "type");
+    autocomplete_add(xmlconsole_filter_clear_ac, "ns");
+    autocomplete_add(xmlconsole_filter_clear_ac, "jid");
+
+    xmlconsole_type_ac = autocomplete_new();
+    autocomplete_add(xmlconsole_type_ac, "message");
+    autocomplete_add(xmlconsole_type_ac, "presence");
+    autocomplete_add(xmlconsole_type_ac, "iq");
+
+    memory_ac = autocomplete_new();
+    autocomplete_add(memory_ac, "budget");
+    autocomplete_add(memory_ac, "log");
+    autocomplete_add(memory_ac, "trim");
+
+    history_ac = autocomplete_new();
+    autocomplete_add(history_ac, "on");
+    autocomplete_add(history_ac, "off");
+    autocomplete_add(history_ac, "search");
+
+    ac_funcs = g_hash_table_new(g_str_hash, g_str_equal);
+    g_hash_table_insert(ac_funcs, "/beep",          _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/intype",        _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/states",        _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/outtype",       _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/flash",         _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/splash",        _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/history",       _history_autocomplete);
+    g_hash_table_insert(ac_funcs, "/vercheck",      _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/privileges",    _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/wrap",          _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/carbons",       _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/lastactivity",  _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/os",            _boolean_autocomplete);
+    g_hash_table_insert(ac_funcs, "/msg",           _contact_autocomplete);
+    g_hash_table_insert(ac_funcs, "/info",          _contact_autocomplete);
+    g_hash_table_insert(ac_funcs, "/caps",          _fulljid_autocomplete);
+    g_hash_table_insert(ac_funcs, "/software",      _fulljid_autocomplete);
+    g_hash_table_insert(ac_funcs, "/ping",          _ping_autocomplete);
+    g_hash_table_insert(ac_funcs, "/prefs",         _prefs_autocomplete);
+    g_hash_table_insert(ac_funcs, "/disco",         _disco_autocomplete);
+    g_hash_table_insert(ac_funcs, "/room",          _room_autocomplete);
+    g_hash_table_insert(ac_funcs, "/autoping",      _autoping_autocomplete);
+    g_hash_table_insert(ac_funcs, "/mainwin",       _winpos_autocomplete);
+    g_hash_table_insert(ac_funcs, "/inputwin",      _winpos_autocomplete);
+    g_hash_table_insert(ac_funcs, "/help",          _help_autocomplete);
+    g_hash_table_insert(ac_funcs, "/who",           _who_autocomplete);
+    g_hash_table_insert(ac_funcs, "/sub",           _sub_autocomplete);
+    g_hash_table_insert(ac_funcs, "/notify",        _notify_autocomplete);
+    g_hash_table_insert(ac_funcs, "/autoaway",      _autoaway_autocomplete);
+    g_hash_table_insert(ac_funcs, "/theme",         _theme_autocomplete);
+    g_hash_table_insert(ac_funcs, "/log",           _log_autocomplete);
+    g_hash_table_insert(ac_funcs, "/account",       _account_autocomplete);
+    g_hash_table_insert(ac_funcs, "/roster",        _roster_autocomplete);
+    g_hash_table_insert(ac_funcs, "/bookmark",      _bookmark_autocomplete);
+    g_hash_table_insert(ac_funcs, "/autoconnect",   _autoconnect_autocomplete);
+    g_hash_table_insert(ac_funcs, "/otr",           _otr_autocomplete);
+    g_hash_table_insert(ac_funcs, "/pgp",           _pgp_autocomplete);
+    g_hash_table_insert(ac_funcs, "/omemo",         _omemo_autocomplete);
+    g_hash_table_insert(ac_funcs, "/connect",       _connect_autocomplete);
+    g_hash_table_insert(ac_funcs, "/alias",         _alias_autocomplete);
+    g_hash_table_insert(ac_funcs, "/join",          _join_autocomplete);
+    g_hash_table_insert(ac_funcs, "/form",          _form_autocomplete);
+    g_hash_table_insert(ac_funcs, "/occupants",     _occupants_autocomplete);
+    g_hash_table_insert(ac_funcs, "/kick",          _kick_autocomplete);
+    g_hash_table_insert(ac_funcs, "/ban",           _ban_autocomplete);
+    g_hash_table_insert(ac_funcs, "/affiliation",   _affiliation_autocomplete);
+    g_hash_table_insert(ac_funcs, "/role",          _role_autocomplete);
+    g_hash_table_insert(ac_funcs, "/resource",      _resource_autocomplete);
+    g_hash_table_insert(ac_funcs, "/wintitle",      _wintitle_autocomplete);
+    g_hash_table_insert(ac_funcs, "/inpblock",      _inpblock_autocomplete);
+    g_hash_table_insert(ac_funcs, "/time",          _time_autocomplete);
+    g_hash_table_insert(ac_funcs, "/receipts",      _receipts_autocomplete);
+    g_hash_table_insert(ac_funcs, "/wins",          _wins_autocomplete);
+    g_hash_table_insert(ac_funcs, "/tls",           _tls_autocomplete);
+    g_hash_table_insert(ac_funcs, "/titlebar",      _titlebar_autocomplete);
+    g_hash_table_insert(ac_funcs, "/script",        _script_autocomplete);
+    g_hash_table_insert(ac_funcs, "/subject",       _subject_autocomplete);
+    g_hash_table_insert(ac_funcs, "/console",       _console_autocomplete);
+    g_hash_table_insert(ac_funcs, "/win",           _win_autocomplete);
+    g_hash_table_insert(ac_funcs, "/close",         _close_autocomplete);
+    g_hash_table_insert(ac_funcs, "/plugins",       _plugins_autocomplete);
+    g_hash_table_insert(ac_funcs, "/sendfile",      _sendfile_autocomplete);
+    g_hash_table_insert(ac_funcs, "/blocked",       _blocked_autocomplete);
+    g_hash_table_insert(ac_funcs, "/tray",          _tray_autocomplete);
+    g_hash_table_insert(ac_funcs, "/presence",      _presence_autocomplete);
+    g_hash_table_insert(ac_funcs, "/rooms",         _rooms_autocomplete);
+    g_hash_table_insert(ac_funcs, "/statusbar",     _statusbar_autocomplete);
+    g_hash_table_insert(ac_funcs, "/clear",         _clear_autocomplete);
+    g_hash_table_insert(ac_funcs, "/invite",        _invite_autocomplete);
+    g_hash_table_insert(ac_funcs, "/status",        _status_autocomplete);
+    g_hash_table_insert(ac_funcs, "/logging",       _logging_autocomplete);
+    g_hash_table_insert(ac_funcs, "/color",         _color_autocomplete);
+    g_hash_table_insert(ac_funcs, "/avatar",        _avatar_autocomplete);
+    g_hash_table_insert(ac_funcs, "/xmlconsole",    _xmlconsole_autocomplete);
+    g_hash_table_insert(ac_funcs, "/memory",        _memory_autocomplete);
 }
 
 void
@@ -1171,6 +1309,7 @@ cmd_ac_reset(ProfWin *window)
     autocomplete_reset(wintitle_ac);
     autocomplete_reset(bookmark_ac);
     autocomplete_reset(bookmark_property_ac);
+    autocomplete_reset(bookmark_order_ac);
     autocomplete_reset(otr_ac);
     autocomplete_reset(otr_log_ac);
     autocomplete_reset(otr_policy_ac);
@@ -1231,6 +1370,12 @@ cmd_ac_reset(ProfWin *window)
     autocomplete_reset(status_state_ac);
     autocomplete_reset(logging_ac);
     autocomplete_reset(color_ac);
+    autocomplete_reset(xmlconsole_ac);
+    autocomplete_reset(xmlconsole_filter_ac);
+    autocomplete_reset(xmlconsole_filter_clear_ac);
+    autocomplete_reset(xmlconsole_type_ac);
+    autocomplete_reset(memory_ac);
+    autocomplete_reset(history_ac);
 
     autocomplete_reset(script_ac);
     if (script_show_ac) {
@@ -1254,6 +1399,7 @@ cmd_ac_reset(ProfWin *window)
     }
 
     bookmark_autocomplete_reset();
+    room_directory_reset_find();
     blocked_ac_reset();
     prefs_reset_room_trigger_ac();
     win_reset_search_attempts();
@@ -1264,6 +1410,8 @@ cmd_ac_reset(ProfWin *window)
 void
 cmd_ac_uninit(void)
 {
+    g_hash_table_destroy(ac_funcs);
+    ac_funcs = NULL;
     autocomplete_free(commands_ac);
     autocomplete_free(who_room_ac);
     autocomplete_free(who_roster_ac);
@@ -1314,6 +1462,7 @@ cmd_ac_uninit(void)
     autocomplete_free(group_ac);
     autocomplete_free(bookmark_ac);
     autocomplete_free(bookmark_property_ac);
+    autocomplete_free(bookmark_order_ac);
     autocomplete_free(otr_ac);
     autocomplete_free(otr_log_ac);
     autocomplete_free(otr_policy_ac);
@@ -1378,6 +1527,12 @@ cmd_ac_uninit(void)
     autocomplete_free(status_state_ac);
     autocomplete_free(logging_ac);
     autocomplete_free(color_ac);
+    autocomplete_free(xmlconsole_ac);
+    autocomplete_free(xmlconsole_filter_ac);
+    autocomplete_free(xmlconsole_filter_clear_ac);
+    autocomplete_free(xmlconsole_type_ac);
+    autocomplete_free(memory_ac);
+    autocomplete_free(history_ac);
 }
 
 static void
@@ -1501,170 +1656,152 @@ cmd_ac_complete_filepath(const char *const input, char *const startstr, gboolean
 static char*
 _cmd_ac_complete_params(ProfWin *window, const char *const input, gboolean previous)
 {
-    int i;
     char *result = NULL;
 
-    jabber_conn_status_t conn_status = connection_get_status();
+    int len = strcspn(input, " ");
+    char parsed[len+1];
+    memcpy(parsed, input, len);
+    parsed[len] = '\0';
 
-    // autocomplete boolean settings
-    gchar *boolean_choices[] = { "/beep", "/intype", "/states", "/outtype", "/flash", "/splash",
-        "/history", "/vercheck", "/privileges", "/wrap", "/carbons", "/lastactivity", "/os"};
+    ac_func_t ac_func = g_hash_table_lookup(ac_funcs, parsed);
+    if (ac_func) {
+        result = ac_func(window, input, previous);
+        if (result) {
+            return result;
+        }
+    }
+
+    result = plugins_autocomplete(input, previous);
+    if (result) {
+        return result;
+    }
 
-    for (i = 0; i < ARRAY_SIZE(boolean_choices); i++) {
-        result = autocomplete_param_with_func(input, boolean_choices[i], prefs_autocomplete_boolean_choice, previous);
+    if (g_str_has_prefix(input, "/field")) {
+        result = _form_field_autocomplete(window, input, previous);
         if (result) {
             return result;
         }
     }
 
+    return NULL;
+}
+
+static char*
+_boolean_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    char *command = g_strndup(input, strcspn(input, " "));
+    char *result = autocomplete_param_with_func(input, command, prefs_autocomplete_boolean_choice, previous);
+    g_free(command);
+
+    return result;
+}
+
+static char*
+_nick_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    ProfMucWin *mucwin = (ProfMucWin*)window;
+    assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
+    Autocomplete nick_ac = muc_roster_ac(mucwin->roomjid);
+    if (nick_ac == NULL) {
+        return NULL;
+    }
+
+    char *command = g_strndup(input, strcspn(input, " "));
+
+    // Remove quote character before and after names when doing autocomplete
+    char *unquoted = strip_arg_quotes(input);
+    char *result = autocomplete_param_with_ac(unquoted, command, nick_ac, TRUE, previous);
+    free(unquoted);
+    g_free(command);
+
+    return result;
+}
+
+static char*
+_contact_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
     // autocomplete nickname in chat rooms
     if (window->type == WIN_MUC) {
-        ProfMucWin *mucwin = (ProfMucWin*)window;
-        assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
-        Autocomplete nick_ac = muc_roster_ac(mucwin->roomjid);
-        if (nick_ac) {
-            gchar *nick_choices[] = { "/msg", "/info", "/caps", "/software" } ;
-
-            // Remove quote character before and after names when doing autocomplete
-            char *unquoted = strip_arg_quotes(input);
-            for (i = 0; i < ARRAY_SIZE(nick_choices); i++) {
-                result = autocomplete_param_with_ac(unquoted, nick_choices[i], nick_ac, TRUE, previous);
-                if (result) {
-                    free(unquoted);
-                    return result;
-                }
-            }
-            free(unquoted);
-        }
+        return _nick_autocomplete(window, input, previous);
+    }
 
     // otherwise autocomplete using roster
-    } else if (conn_status == JABBER_CONNECTED) {
-        gchar *contact_choices[] = { "/msg", "/info" };
-        // Remove quote character before and after names when doing autocomplete
-        char *unquoted = strip_arg_quotes(input);
-        for (i = 0; i < ARRAY_SIZE(contact_choices); i++) {
-            result = autocomplete_param_with_func(unquoted, contact_choices[i], roster_contact_autocomplete, previous);
-            if (result) {
-                free(unquoted);
-                return result;
-            }
-        }
-        free(unquoted);
+    if (connection_get_status() != JABBER_CONNECTED) {
+        return NULL;
+    }
 
-        gchar *resource_choices[] = { "/caps", "/software", "/ping" };
-        for (i = 0; i < ARRAY_SIZE(resource_choices); i++) {
-            result = autocomplete_param_with_func(input, resource_choices[i], roster_fulljid_autocomplete, previous);
-            if (result) {
-                return result;
-            }
-        }
+    char *command = g_strndup(input, strcspn(input, " "));
+
+    // Remove quote character before and after names when doing autocomplete
+    char *unquoted = strip_arg_quotes(input);
+    char *result = autocomplete_param_with_func(unquoted, command, roster_contact_autocomplete, previous);
+    free(unquoted);
+    g_free(command);
+
+    return result;
+}
+
+static char*
+_fulljid_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    if (window->type == WIN_MUC) {
+        return _nick_autocomplete(window, input, previous);
     }
 
-    gchar *invite_choices[] = { "/join" };
-    for (i = 0; i < ARRAY_SIZE(invite_choices); i++) {
-        result = autocomplete_param_with_func(input, invite_choices[i], muc_invites_find, previous);
-        if (result) {
-            return result;
-        }
+    if (connection_get_status() != JABBER_CONNECTED) {
+        return NULL;
     }
 
-    gchar *cmds[] = { "/prefs", "/disco", "/room", "/autoping", "/mainwin", "/inputwin" };
-    Autocomplete completers[] = { prefs_ac, disco_ac, room_ac, autoping_ac, winpos_ac, winpos_ac };
+    char *command = g_strndup(input, strcspn(input, " "));
+    char *result = autocomplete_param_with_func(input, command, roster_fulljid_autocomplete, previous);
+    g_free(command);
 
-    for (i = 0; i < ARRAY_SIZE(cmds); i++) {
-        result = autocomplete_param_with_ac(input, cmds[i], completers[i], TRUE, previous);
-        if (result) {
-            return result;
-        }
+    return result;
+}
+
+static char*
+_ping_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    if (window->type == WIN_MUC || connection_get_status() != JABBER_CONNECTED) {
+        return NULL;
     }
 
-    GHashTable *ac_funcs = g_hash_table_new(g_str_hash, g_str_equal);
-    g_hash_table_insert(ac_funcs, "/help",          _help_autocomplete);
-    g_hash_table_insert(ac_funcs, "/who",           _who_autocomplete);
-    g_hash_table_insert(ac_funcs, "/sub",           _sub_autocomplete);
-    g_hash_table_insert(ac_funcs, "/notify",        _notify_autocomplete);
-    g_hash_table_insert(ac_funcs, "/autoaway",      _autoaway_autocomplete);
-    g_hash_table_insert(ac_funcs, "/theme",         _theme_autocomplete);
-    g_hash_table_insert(ac_funcs, "/log",           _log_autocomplete);
-    g_hash_table_insert(ac_funcs, "/account",       _account_autocomplete);
-    g_hash_table_insert(ac_funcs, "/roster",        _roster_autocomplete);
-    g_hash_table_insert(ac_funcs, "/bookmark",      _bookmark_autocomplete);
-    g_hash_table_insert(ac_funcs, "/autoconnect",   _autoconnect_autocomplete);
-    g_hash_table_insert(ac_funcs, "/otr",           _otr_autocomplete);
-    g_hash_table_insert(ac_funcs, "/pgp",           _pgp_autocomplete);
-    g_hash_table_insert(ac_funcs, "/omemo",         _omemo_autocomplete);
-    g_hash_table_insert(ac_funcs, "/connect",       _connect_autocomplete);
-    g_hash_table_insert(ac_funcs, "/alias",         _alias_autocomplete);
-    g_hash_table_insert(ac_funcs, "/join",          _join_autocomplete);
-    g_hash_table_insert(ac_funcs, "/form",          _form_autocomplete);
-    g_hash_table_insert(ac_funcs, "/occupants",     _occupants_autocomplete);
-    g_hash_table_insert(ac_funcs, "/kick",          _kick_autocomplete);
-    g_hash_table_insert(ac_funcs, "/ban",           _ban_autocomplete);
-    g_hash_table_insert(ac_funcs, "/affiliation",   _affiliation_autocomplete);
-    g_hash_table_insert(ac_funcs, "/role",          _role_autocomplete);
-    g_hash_table_insert(ac_funcs, "/resource",      _resource_autocomplete);
-    g_hash_table_insert(ac_funcs, "/wintitle",      _wintitle_autocomplete);
-    g_hash_table_insert(ac_funcs, "/inpblock",      _inpblock_autocomplete);
-    g_hash_table_insert(ac_funcs, "/time",          _time_autocomplete);
-    g_hash_table_insert(ac_funcs, "/receipts",      _receipts_autocomplete);
-    g_hash_table_insert(ac_funcs, "/wins",          _wins_autocomplete);
-    g_hash_table_insert(ac_funcs, "/tls",           _tls_autocomplete);
-    g_hash_table_insert(ac_funcs, "/titlebar",      _titlebar_autocomplete);
-    g_hash_table_insert(ac_funcs, "/script",        _script_autocomplete);
-    g_hash_table_insert(ac_funcs, "/subject",       _subject_autocomplete);
-    g_hash_table_insert(ac_funcs, "/console",       _console_autocomplete);
-    g_hash_table_insert(ac_funcs, "/win",           _win_autocomplete);
-    g_hash_table_insert(ac_funcs, "/close",         _close_autocomplete);
-    g_hash_table_insert(ac_funcs, "/plugins",       _plugins_autocomplete);
-    g_hash_table_insert(ac_funcs, "/sendfile",      _sendfile_autocomplete);
-    g_hash_table_insert(ac_funcs, "/blocked",       _blocked_autocomplete);
-    g_hash_table_insert(ac_funcs, "/tray",          _tray_autocomplete);
-    g_hash_table_insert(ac_funcs, "/presence",      _presence_autocomplete);
-    g_hash_table_insert(ac_funcs, "/rooms",         _rooms_autocomplete);
-    g_hash_table_insert(ac_funcs, "/statusbar",     _statusbar_autocomplete);
-    g_hash_table_insert(ac_funcs, "/clear",         _clear_autocomplete);
-    g_hash_table_insert(ac_funcs, "/invite",        _invite_autocomplete);
-    g_hash_table_insert(ac_funcs, "/status",        _status_autocomplete);
-    g_hash_table_insert(ac_funcs, "/logging",       _logging_autocomplete);
-    g_hash_table_insert(ac_funcs, "/color",         _color_autocomplete);
-    g_hash_table_insert(ac_funcs, "/avatar",        _avatar_autocomplete);
+    return autocomplete_param_with_func(input, "/ping", roster_fulljid_autocomplete, previous);
+}
 
-    int len = strlen(input);
-    char parsed[len+1];
-    i = 0;
-    while (i < len) {
-        if (input[i] == ' ') {
-            break;
-        } else {
-            parsed[i] = input[i];
-        }
-        i++;
-    }
-    parsed[i] = '\0';
+static char*
+_prefs_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    return autocomplete_param_with_ac(input, "/prefs", prefs_ac, TRUE, previous);
+}
 
-    char * (*ac_func)(ProfWin*, const char * const, gboolean) = g_hash_table_lookup(ac_funcs, parsed);
-    if (ac_func) {
-        result = ac_func(window, input, previous);
-        if (result) {
-            g_hash_table_destroy(ac_funcs);
-            return result;
-        }
-    }
-    g_hash_table_destroy(ac_funcs);
+static char*
+_disco_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    return autocomplete_param_with_ac(input, "/disco", disco_ac, TRUE, previous);
+}
 
-    result = plugins_autocomplete(input, previous);
+static char*
+_room_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    return autocomplete_param_with_ac(input, "/room", room_ac, TRUE, previous);
+}
+
+static char*
+_autoping_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    return autocomplete_param_with_ac(input, "/autoping", autoping_ac, TRUE, previous);
+}
+
+static char*
+_winpos_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    char *result = autocomplete_param_with_ac(input, "/mainwin", winpos_ac, TRUE, previous);
     if (result) {
         return result;
     }
 
-    if (g_str_has_prefix(input, "/field")) {
-        result = _form_field_autocomplete(window, input, previous);
-        if (result) {
-            return result;
-        }
-    }
-
-    return NULL;
+    return autocomplete_param_with_ac(input, "/inputwin", winpos_ac, TRUE, previous);
 }
 
 static char*
@@ -2029,6 +2166,10 @@ _bookmark_autocomplete(ProfWin *window, const char *const input, gboolean previo
     if (found) {
         return found;
     }
+    found = autocomplete_param_with_ac(input, "/bookmark order", bookmark_order_ac, TRUE, previous);
+    if (found) {
+        return found;
+    }
 
     found = autocomplete_param_with_ac(input, "/bookmark", bookmark_ac, TRUE, previous);
     return found;
@@ -3136,6 +3277,11 @@ _join_autocomplete(ProfWin *window, const char *const input, gboolean previous)
     char *found = NULL;
     gboolean result = FALSE;
 
+    found = autocomplete_param_with_func(input, "/join", muc_invites_find, previous);
+    if (found) {
+        return found;
+    }
+
     gchar **args = parse_args(input, 1, 5, &result);
 
     if (result) {
@@ -3170,6 +3316,11 @@ _join_autocomplete(ProfWin *window, const char *const input, gboolean previous)
         return found;
     }
 
+    found = autocomplete_param_with_func(input, "/join", room_directory_find, previous);
+    if (found) {
+        return found;
+    }
+
     return NULL;
 }
 
@@ -3673,3 +3824,47 @@ _avatar_autocomplete(ProfWin *window, const char *const input, gboolean previous
 
     return NULL;
 }
+
+static char*
+_xmlconsole_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    char *result = NULL;
+
+    result = autocomplete_param_with_ac(input, "/xmlconsole filter type", xmlconsole_type_ac, TRUE, previous);
+    if (result) {
+        return result;
+    }
+
+    result = autocomplete_param_with_ac(input, "/xmlconsole filter clear", xmlconsole_filter_clear_ac, TRUE, previous);
+    if (result) {
+        return result;
+    }
+
+    result = autocomplete_param_with_ac(input, "/xmlconsole filter", xmlconsole_filter_ac, TRUE, previous);
+    if (result) {
+        return result;
+    }
+
+    if (strncmp(input, "/xmlconsole save ", 17) == 0) {
+        return cmd_ac_complete_filepath(input, "/xmlconsole save", previous);
+    }
+
+    result = autocomplete_param_with_ac(input, "/xmlconsole", xmlconsole_ac, TRUE, previous);
+    if (result) {
+        return result;
+    }
+
+    return NULL;
+}
+
+static char*
+_memory_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    return autocomplete_param_with_ac(input, "/memory", memory_ac, TRUE, previous);
+}
+
+static char*
+_history_autocomplete(ProfWin *window, const char *const input, gboolean previous)
+{
+    return autocomplete_param_with_ac(input, "/history", history_ac, TRUE, previous);
+}
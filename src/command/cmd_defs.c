@@ -234,7 +234,8 @@ static struct cmd_t command_defs[] =
         CMD_SYN(
             "/disconnect")
         CMD_DESC(
-            "Disconnect from the current chat service.")
+            "Disconnect from the current chat service. "
+            "While a connection attempt or reconnect is still in progress, cancel it instead.")
         CMD_NOARGS
         CMD_NOEXAMPLES
     },
@@ -561,7 +562,8 @@ static struct cmd_t command_defs[] =
             "If no room is supplied, a generated name will be used with the format private-chat-[UUID]. "
             "If the domain part is not included in the room name, the account preference 'muc.service' will be used. "
             "If no nickname is specified the account preference 'muc.nick' will be used which by default is the localpart of your JID. "
-            "If the room doesn't exist, and the server allows it, a new one will be created.")
+            "If the room doesn't exist, and the server allows it, a new one will be created. "
+            "Rooms from cached /rooms lists are offered when completing the room.")
         CMD_ARGS(
             { "<room>",              "The chat room to join." },
             { "nick <nick>",         "Nickname to use in the room." },
@@ -780,12 +782,13 @@ static struct cmd_t command_defs[] =
         CMD_DESC(
             "List the chat rooms available at the specified conference service. "
             "If no argument is supplied, the account preference 'muc.service' is used, 'conference.<domain-part>' by default. "
-            "The filter argument only shows rooms that contain the provided text, case insensitive.")
+            "The filter argument only shows rooms that contain the provided text, case insensitive. "
+            "When caching is enabled, room lists are kept on disk, shown immediately and refreshed once they are older than a day.")
         CMD_ARGS(
             { "service <service>",  "The conference service to query." },
             { "filter <text>",      "The text to filter results by."},
             { "cache on|off",       "Enable or disable caching of rooms list response, enabled by default."},
-            { "cache clear",        "Clear the rooms response cache if enabled."})
+            { "cache clear",        "Clear the rooms response cache, including the copy kept on disk."})
         CMD_EXAMPLES(
             "/rooms",
             "/rooms filter development",
@@ -806,7 +809,8 @@ static struct cmd_t command_defs[] =
             "/bookmark update <room> [nick <nick>] [password <password>] [autojoin on|off]",
             "/bookmark remove [<room>]",
             "/bookmark join <room>",
-            "/bookmark invites on|off")
+            "/bookmark invites on|off",
+            "/bookmark order activity|server")
         CMD_DESC(
             "Manage bookmarks and join bookmarked rooms. "
             "In a chat room, no arguments will bookmark the current room, setting autojoin to \"on\".")
@@ -819,7 +823,10 @@ static struct cmd_t command_defs[] =
             { "password <password>", "Password if required, may be stored in plaintext on your server." },
             { "autojoin on|off", "Whether to join the room automatically on login." },
             { "join <room>", "Join room using the properties associated with the bookmark." },
-            { "invites on|off", "Whether or not to bookmark accepted room invites, defaults to 'on'."})
+            { "invites on|off", "Whether or not to bookmark accepted room invites, defaults to 'on'."},
+            { "order activity|server", "Order in which autojoin rooms are joined on login, a few at a time. "
+                                       "Rooms with an open window always come first, then either those with the most recent activity "
+                                       "or the order stored on the server, defaults to 'activity'."})
         CMD_NOEXAMPLES
     },
 
@@ -1489,14 +1496,13 @@ static struct cmd_t command_defs[] =
             CMD_TAG_UI)
         CMD_SYN(
             "/tray on|off",
-            "/tray read on|off",
-            "/tray timer <seconds>")
+            "/tray read on|off")
         CMD_DESC(
-            "Display an icon in the tray that will indicate new messages.")
+            "Display an icon in the tray that will indicate new messages. "
+            "The icon changes as soon as messages arrive or are read.")
         CMD_ARGS(
             { "on|off",             "Show tray icon." },
-            { "read on|off",        "Show tray icon when no unread messages." },
-            { "timer <seconds>",    "Set tray icon timer, seconds must be between 1-10" })
+            { "read on|off",        "Show tray icon when no unread messages." })
         CMD_NOEXAMPLES
     },
 
@@ -1613,18 +1619,52 @@ static struct cmd_t command_defs[] =
         CMD_TAGS(
             CMD_TAG_CHAT)
         CMD_SYN(
-            "/logging chat|group on|off")
+            "/logging chat|group on|off",
+            "/logging compress <days>|off")
         CMD_DESC(
             "Switch logging on or off. "
             "Chat logging will be enabled if /history is set to on. "
-            "When disabling this option, /history will also be disabled. ")
+            "When disabling this option, /history will also be disabled. "
+            "Logs older than the given number of days can be compressed in the background, "
+            "they remain readable for /history.")
         CMD_ARGS(
             { "chat", "Regular chat logging" },
             { "group", "Groupchat (room) logging" },
-            { "on|off", "Enable or disable logging." })
+            { "on|off", "Enable or disable logging." },
+            { "compress <days>", "Compress chat and groupchat logs older than <days> days." },
+            { "compress off", "Do not compress logs." })
         CMD_EXAMPLES(
             "/logging chat on",
-            "/logging group off" )
+            "/logging group off",
+            "/logging compress 30" )
+    },
+
+    { "/memory",
+        parse_args, 0, 2, &cons_memory_setting,
+        CMD_NOSUBFUNCS
+        CMD_MAINFUNC(cmd_memory)
+        CMD_TAGS(
+            CMD_TAG_UI)
+        CMD_SYN(
+            "/memory",
+            "/memory budget <kb>|off",
+            "/memory log <minutes>|off",
+            "/memory trim")
+        CMD_DESC(
+            "Show the approximate memory used by window buffers, window pads, the roster, rooms, "
+            "the capabilities cache and the OMEMO stores. "
+            "When window buffers and pads use more than the budget, the least recently shown windows "
+            "release their pads and move older history to disk, it is read back when scrolling up.")
+        CMD_ARGS(
+            { "budget <kb>",   "Limit the memory used by window buffers and pads to <kb> kilobytes." },
+            { "budget off",    "Do not limit the memory used by windows." },
+            { "log <minutes>", "Log the memory used by each subsystem every <minutes> minutes." },
+            { "log off",       "Do not log memory use." },
+            { "trim",          "Trim all windows except the console and the current window, or only until within the budget when set." })
+        CMD_EXAMPLES(
+            "/memory budget 8192",
+            "/memory log 60",
+            "/memory trim")
     },
 
     { "/states",
@@ -1780,20 +1820,24 @@ static struct cmd_t command_defs[] =
     },
 
     { "/history",
-        parse_args, 1, 1, &cons_history_setting,
+        parse_args_with_freetext, 1, 2, &cons_history_setting,
         CMD_NOSUBFUNCS
         CMD_MAINFUNC(cmd_history)
         CMD_TAGS(
             CMD_TAG_UI,
             CMD_TAG_CHAT)
         CMD_SYN(
-            "/history on|off")
+            "/history on|off",
+            "/history search <text>")
         CMD_DESC(
             "Switch chat history on or off, /chlog will automatically be enabled when this setting is on. "
-            "When history is enabled, previous messages are shown in chat windows.")
+            "When history is enabled, previous messages are shown in chat windows. "
+            "Logged messages with the contact or room in the current window can be searched.")
         CMD_ARGS(
-            { "on|off", "Enable or disable showing chat history." })
-        CMD_NOEXAMPLES
+            { "on|off",        "Enable or disable showing chat history." },
+            { "search <text>", "Show the most recent logged messages containing text." })
+        CMD_EXAMPLES(
+            "/history search meeting")
     },
 
     { "/log",
@@ -2021,7 +2065,7 @@ static struct cmd_t command_defs[] =
             { "set <account> <presence> <priority>",    "Set the priority (-128..127) to use for the specified presence." },
             { "set <account> resource <resource>",      "The resource to be used for this account, defaults to 'profanity'." },
             { "set <account> password <password>",      "Password for the account, note this is currently stored in plaintext if set." },
-            { "set <account> eval_password <command>",  "Shell command evaluated to retrieve password for the account. Can be used to retrieve password from keyring." },
+            { "set <account> eval_password <command>",  "Shell command evaluated to retrieve password for the account. Can be used to retrieve password from keyring. It runs in the background and is stopped after 60 seconds." },
             { "set <account> muc <service>",            "The default MUC chat service to use, defaults to the servers disco info response." },
             { "set <account> nick <nick>",              "The default nickname to use when joining chat rooms." },
             { "set <account> otr <policy>",             "Override global OTR policy for this account, see /otr." },
@@ -2151,17 +2195,33 @@ static struct cmd_t command_defs[] =
     },
 
     { "/xmlconsole",
-        parse_args, 0, 0, NULL,
+        parse_args, 0, 3, NULL,
         CMD_NOSUBFUNCS
         CMD_MAINFUNC(cmd_xmlconsole)
         CMD_TAGS(
             CMD_TAG_UI)
         CMD_SYN(
-            "/xmlconsole")
-        CMD_DESC(
-            "Open the XML console to view incoming and outgoing XMPP traffic.")
-        CMD_NOARGS
-        CMD_NOEXAMPLES
+            "/xmlconsole",
+            "/xmlconsole filter",
+            "/xmlconsole filter type|ns|jid <value>",
+            "/xmlconsole filter clear [type|ns|jid]",
+            "/xmlconsole save <file>")
+        CMD_DESC(
+            "Open the XML console to view incoming and outgoing XMPP traffic. "
+            "While the console is open the most recent 10000 stanzas are captured, "
+            "stanzas matching the current filters are rendered at most four times per second.")
+        CMD_ARGS(
+            { "filter",                     "Show the current filters." },
+            { "filter type <type>",         "Only show stanzas of the given type, e.g. message, presence or iq." },
+            { "filter ns <namespace>",      "Only show stanzas declaring the given namespace." },
+            { "filter jid <jid>",           "Only show stanzas sent to or from the given JID, a bare JID also matches its full JIDs." },
+            { "filter clear [type|ns|jid]", "Clear all filters, or only the given filter." },
+            { "save <file>",                "Save all captured stanzas, ignoring the filters, to a file." })
+        CMD_EXAMPLES(
+            "/xmlconsole filter type message",
+            "/xmlconsole filter ns http://jabber.org/protocol/disco#info",
+            "/xmlconsole filter jid room@conference.example.org",
+            "/xmlconsole save ~/xmlconsole.log")
     },
 
     { "/script",
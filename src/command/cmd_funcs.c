@@ -53,6 +53,7 @@
 
 #include "profanity.h"
 #include "log.h"
+#include "database.h"
 #include "common.h"
 #include "command/cmd_funcs.h"
 #include "command/cmd_defs.h"
@@ -102,6 +103,9 @@
 #include "plugins/python_plugins.h"
 #endif
 
+// most messages shown by /history search
+#define HISTORY_SEARCH_MAX 50
+
 static void _update_presence(const resource_presence_t presence,
     const char *const show, gchar **args);
 static void _cmd_set_boolean_preference(gchar *arg, const char *const command,
@@ -129,8 +133,7 @@ cmd_process_input(ProfWin *window, char *inp)
 
     // handle command if input starts with a '/'
     } else if (inp[0] == '/') {
-        char *inp_cpy = strdup(inp);
-        char *command = strtok(inp_cpy, " ");
+        char *command = g_strndup(inp, strcspn(inp, " "));
         char *question_mark = strchr(command, '?');
         if (question_mark) {
             *question_mark = '\0';
@@ -142,7 +145,7 @@ cmd_process_input(ProfWin *window, char *inp)
         } else {
             result = _cmd_execute(window, command, inp);
         }
-        free(inp_cpy);
+        g_free(command);
 
     // call a default handler if input didn't start with '/'
     } else {
@@ -406,25 +409,10 @@ cmd_connect(ProfWin *window, const char *const command, gchar **args)
         if (tls_policy != NULL)
             account_set_tls_policy(account, tls_policy);
 
-        // use password if set
-        if (account->password) {
+        // use password if set, eval_password is run in the background by the session
+        if (account->password || account->eval_password) {
             conn_status = cl_ev_connect_account(account);
 
-        // use eval_password if set
-        } else if (account->eval_password) {
-            gboolean res = account_eval_password(account);
-            if (res) {
-                conn_status = cl_ev_connect_account(account);
-                free(account->password);
-                account->password = NULL;
-            } else {
-                cons_show("Error evaluating password, see logs for details.");
-                account_free(account);
-                free(user);
-                options_destroy(options);
-                return TRUE;
-            }
-
         // no account password setting, prompt
         } else {
             account->password = ui_ask_password();
@@ -1226,7 +1214,11 @@ gboolean
 cmd_disconnect(ProfWin *window, const char *const command, gchar **args)
 {
     if (connection_get_status() != JABBER_CONNECTED) {
-        cons_show("You are not currently connected.");
+        if (session_cancel_connect()) {
+            cons_show("Connection attempt cancelled.");
+        } else {
+            cons_show("You are not currently connected.");
+        }
         return TRUE;
     }
 
@@ -3138,14 +3130,14 @@ cmd_resource(ProfWin *window, const char *const command, gchar **args)
 
         chatwin->resource_override = strdup(resource);
         chat_state_free(chatwin->state);
-        chatwin->state = chat_state_new();
+        chatwin->state = chat_state_new(chatwin->barejid);
         chat_session_resource_override(chatwin->barejid, resource);
         return TRUE;
 
     } else if (g_strcmp0(cmd, "off") == 0) {
         FREE_SET_NULL(chatwin->resource_override);
         chat_state_free(chatwin->state);
-        chatwin->state = chat_state_new();
+        chatwin->state = chat_state_new(chatwin->barejid);
         chat_session_remove(chatwin->barejid);
         return TRUE;
     } else {
@@ -4641,6 +4633,21 @@ cmd_bookmark(ProfWin *window, const char *const command, gchar **args)
         return TRUE;
     }
 
+    if (strcmp(cmd, "order") == 0) {
+        if (g_strcmp0(args[1], "activity") == 0) {
+            prefs_set_string(PREF_BOOKMARK_AUTOJOIN_ORDER, "activity");
+            cons_show("Autojoin rooms with recent activity first.");
+        } else if (g_strcmp0(args[1], "server") == 0) {
+            prefs_set_string(PREF_BOOKMARK_AUTOJOIN_ORDER, "server");
+            cons_show("Autojoin rooms in the order stored on the server.");
+        } else {
+            cons_bad_cmd_usage(command);
+            cons_show("");
+        }
+        cons_alert();
+        return TRUE;
+    }
+
     if (strcmp(cmd, "list") == 0) {
         GList *bookmarks = bookmark_get_list();
         cons_show_bookmarks(bookmarks);
@@ -4949,6 +4956,72 @@ cmd_alias(ProfWin *window, const char *const command, gchar **args)
     }
 }
 
+typedef struct cmd_tiny_request_t {
+    win_type_t type;
+    char *identifier;
+} CmdTinyRequest;
+
+static void
+_cmd_tiny_done(const char *const tiny, void *userdata)
+{
+    CmdTinyRequest *request = (CmdTinyRequest*)userdata;
+
+    // the window may have been closed while waiting for the reply
+    ProfWin *window = NULL;
+    switch (request->type) {
+    case WIN_CHAT:
+        window = (ProfWin*)wins_get_chat(request->identifier);
+        break;
+    case WIN_PRIVATE:
+        window = (ProfWin*)wins_get_private(request->identifier);
+        break;
+    case WIN_MUC:
+        window = (ProfWin*)wins_get_muc(request->identifier);
+        break;
+    default:
+        break;
+    }
+
+    if (window == NULL) {
+        log_debug("Tinyurl received for closed window: %s", request->identifier);
+    } else if (!tiny) {
+        win_println(window, THEME_ERROR, '-', "Couldn't create tinyurl.");
+    } else {
+        switch (window->type){
+        case WIN_CHAT:
+        {
+            ProfChatWin *chatwin = (ProfChatWin*)window;
+            assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
+            cl_ev_send_msg(chatwin, tiny, NULL);
+            break;
+        }
+        case WIN_PRIVATE:
+        {
+            ProfPrivateWin *privatewin = (ProfPrivateWin*)window;
+            assert(privatewin->memcheck == PROFPRIVATEWIN_MEMCHECK);
+            cl_ev_send_priv_msg(privatewin, tiny, NULL);
+            break;
+        }
+        case WIN_MUC:
+        {
+            ProfMucWin *mucwin = (ProfMucWin*)window;
+            assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
+            cl_ev_send_muc_msg(mucwin, tiny, NULL);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+static void
+_cmd_tiny_request_free(CmdTinyRequest *request)
+{
+    free(request->identifier);
+    free(request);
+}
+
 gboolean
 cmd_tiny(ProfWin *window, const char *const command, gchar **args)
 {
@@ -4964,39 +5037,10 @@ cmd_tiny(ProfWin *window, const char *const command, gchar **args)
         return TRUE;
     }
 
-    char *tiny = tinyurl_get(url);
-    if (!tiny) {
-        win_println(window, THEME_ERROR, '-', "Couldn't create tinyurl.");
-        return TRUE;
-    }
-
-    switch (window->type){
-    case WIN_CHAT:
-    {
-        ProfChatWin *chatwin = (ProfChatWin*)window;
-        assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
-        cl_ev_send_msg(chatwin, tiny, NULL);
-        break;
-    }
-    case WIN_PRIVATE:
-    {
-        ProfPrivateWin *privatewin = (ProfPrivateWin*)window;
-        assert(privatewin->memcheck == PROFPRIVATEWIN_MEMCHECK);
-        cl_ev_send_priv_msg(privatewin, tiny, NULL);
-        break;
-    }
-    case WIN_MUC:
-    {
-        ProfMucWin *mucwin = (ProfMucWin*)window;
-        assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
-        cl_ev_send_muc_msg(mucwin, tiny, NULL);
-        break;
-    }
-    default:
-        break;
-    }
-
-    free(tiny);
+    CmdTinyRequest *request = malloc(sizeof(CmdTinyRequest));
+    request->type = window->type;
+    request->identifier = win_get_tab_identifier(window);
+    tinyurl_get(url, _cmd_tiny_done, request, (GDestroyNotify)_cmd_tiny_request_free);
 
     return TRUE;
 }
@@ -5438,6 +5482,7 @@ cmd_gone(ProfWin *window, const char *const command, gchar **args)
 
     gint period = atoi(value);
     prefs_set_gone(period);
+    chat_state_reschedule_all();
     if (period == 0) {
         cons_show("Automatic leaving conversations after period disabled.");
     } else if (period == 1) {
@@ -6540,13 +6585,66 @@ gboolean
 cmd_xmlconsole(ProfWin *window, const char *const command, gchar **args)
 {
     ProfXMLWin *xmlwin = wins_get_xmlconsole();
-    if (xmlwin) {
+
+    if (args[0] == NULL) {
+        if (xmlwin) {
+            ui_focus_win((ProfWin*)xmlwin);
+        } else {
+            ProfWin *window = wins_new_xmlconsole();
+            ui_focus_win(window);
+        }
+        return TRUE;
+    }
+
+    if (xmlwin == NULL) {
+        cons_show("The XML console is not open, use /xmlconsole to open it.");
+        return TRUE;
+    }
+
+    if (g_strcmp0(args[0], "filter") == 0) {
+        if (args[1] == NULL) {
+            xmlwin_show_filters(xmlwin);
+        } else if (g_strcmp0(args[1], "clear") == 0) {
+            if (args[2] == NULL) {
+                xmlwin_clear_filters(xmlwin);
+            } else if (!xmlwin_set_filter(xmlwin, args[2], NULL)) {
+                cons_bad_cmd_usage(command);
+            }
+        } else if (args[2] == NULL || !xmlwin_set_filter(xmlwin, args[1], args[2])) {
+            cons_bad_cmd_usage(command);
+        }
         ui_focus_win((ProfWin*)xmlwin);
-    } else {
-        ProfWin *window = wins_new_xmlconsole();
-        ui_focus_win(window);
+        return TRUE;
     }
 
+    if (g_strcmp0(args[0], "save") == 0) {
+        if (args[1] == NULL) {
+            cons_bad_cmd_usage(command);
+            return TRUE;
+        }
+
+        char *path = args[1];
+
+        // expand ~ to $HOME
+        if (path[0] == '~' && path[1] == '/') {
+            if (asprintf(&path, "%s/%s", getenv("HOME"), path+2) == -1) {
+                return TRUE;
+            }
+        } else {
+            path = strdup(path);
+        }
+
+        int count = 0;
+        if (xmlwin_save(xmlwin, path, &count)) {
+            cons_show("Saved %d stanzas to %s.", count, path);
+        } else {
+            cons_show_error("Could not save XML console to %s: %s", path, strerror(errno));
+        }
+        free(path);
+        return TRUE;
+    }
+
+    cons_bad_cmd_usage(command);
     return TRUE;
 }
 
@@ -6562,43 +6660,19 @@ cmd_tray(ProfWin *window, const char *const command, gchar **args)
 {
 #ifdef HAVE_GTK
     if (g_strcmp0(args[0], "timer") == 0) {
-        if (args[1] == NULL) {
-            cons_bad_cmd_usage(command);
-            return TRUE;
-        }
-
-        if (prefs_get_boolean(PREF_TRAY) == FALSE) {
-            cons_show("Tray icon not currently enabled, see /help tray");
-            return TRUE;
-        }
-
-        int intval = 0;
-        char *err_msg = NULL;
-        gboolean res = strtoi_range(args[1], &intval, 1, 10, &err_msg);
-        if (res) {
-            if (intval == 1) {
-                cons_show("Tray timer set to 1 second.");
-            } else {
-                cons_show("Tray timer set to %d seconds.", intval);
-            }
-            prefs_set_tray_timer(intval);
-            if (prefs_get_boolean(PREF_TRAY)) {
-                tray_set_timer(intval);
-            }
-        } else {
-            cons_show(err_msg);
-            free(err_msg);
-        }
-
+        // kept so existing scripts keep working
+        cons_show("The tray icon follows unread messages as they arrive, /tray timer is no longer needed.");
         return TRUE;
     } else if (g_strcmp0(args[0], "read") == 0) {
         if (prefs_get_boolean(PREF_TRAY) == FALSE) {
             cons_show("Tray icon not currently enabled, see /help tray");
         } else if (g_strcmp0(args[1], "on") == 0) {
             prefs_set_boolean(PREF_TRAY_READ, TRUE);
+            tray_update_icon();
             cons_show("Tray icon enabled when no unread messages.");
         } else if (g_strcmp0(args[1], "off") == 0) {
             prefs_set_boolean(PREF_TRAY_READ, FALSE);
+            tray_update_icon();
             cons_show("Tray icon disabled when no unread messages.");
         } else {
             cons_bad_cmd_usage(command);
@@ -6679,6 +6753,23 @@ cmd_logging(ProfWin *window, const char *const command, gchar **args)
         }
     } else if (strcmp(args[0], "group") == 0) {
         _cmd_set_boolean_preference(args[1], command, "Groupchat logging", PREF_GRLOG);
+    } else if (strcmp(args[0], "compress") == 0) {
+        if (strcmp(args[1], "off") == 0) {
+            prefs_set_log_compress_days(0);
+            cons_show("Chat log compression disabled.");
+        } else {
+            int days = 0;
+            char *err_msg = NULL;
+            if (!strtoi_range(args[1], &days, 1, 36500, &err_msg)) {
+                cons_show(err_msg);
+                cons_bad_cmd_usage(command);
+                free(err_msg);
+                return TRUE;
+            }
+            prefs_set_log_compress_days(days);
+            cons_show("Compressing chat logs older than %d days.", days);
+        }
+        chat_log_compress();
     } else {
         cons_bad_cmd_usage(command);
     }
@@ -6686,6 +6777,114 @@ cmd_logging(ProfWin *window, const char *const command, gchar **args)
     return TRUE;
 }
 
+gboolean
+cmd_memory(ProfWin *window, const char *const command, gchar **args)
+{
+    if (args[0] == NULL) {
+        cons_show_memory();
+        return TRUE;
+    }
+
+    if (strcmp(args[0], "trim") == 0) {
+        int trimmed = wins_trim((gint64)prefs_get_memory_budget() * 1024);
+        cons_show("Trimmed %d windows.", trimmed);
+        return TRUE;
+    }
+
+    if (args[1] == NULL) {
+        cons_bad_cmd_usage(command);
+        return TRUE;
+    }
+
+    if (strcmp(args[0], "budget") == 0) {
+        if (strcmp(args[1], "off") == 0) {
+            prefs_set_memory_budget(0);
+            cons_show("Window memory budget disabled.");
+        } else {
+            int kb = 0;
+            char *err_msg = NULL;
+            if (!strtoi_range(args[1], &kb, 1, 4 * 1024 * 1024, &err_msg)) {
+                cons_show(err_msg);
+                cons_bad_cmd_usage(command);
+                free(err_msg);
+                return TRUE;
+            }
+            prefs_set_memory_budget(kb);
+            cons_show("Window memory budget set to %d KB.", kb);
+        }
+    } else if (strcmp(args[0], "log") == 0) {
+        if (strcmp(args[1], "off") == 0) {
+            prefs_set_memory_log(0);
+            cons_show("Memory logging disabled.");
+        } else {
+            int minutes = 0;
+            char *err_msg = NULL;
+            if (!strtoi_range(args[1], &minutes, 1, 10080, &err_msg)) {
+                cons_show(err_msg);
+                cons_bad_cmd_usage(command);
+                free(err_msg);
+                return TRUE;
+            }
+            prefs_set_memory_log(minutes);
+            cons_show("Logging memory use every %d minutes.", minutes);
+        }
+    } else {
+        cons_bad_cmd_usage(command);
+    }
+
+    return TRUE;
+}
+
+static void
+_cmd_history_search(ProfWin *window, const char *const text)
+{
+    const char *peer = NULL;
+    if (window->type == WIN_CHAT) {
+        ProfChatWin *chatwin = (ProfChatWin*)window;
+        assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
+        peer = chatwin->barejid;
+    } else if (window->type == WIN_MUC) {
+        ProfMucWin *mucwin = (ProfMucWin*)window;
+        assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
+        peer = mucwin->roomjid;
+    } else {
+        cons_show("History can only be searched in chat and room windows.");
+        return;
+    }
+
+    if (!log_database_history_ready()) {
+        win_println(window, THEME_DEFAULT, '!', "The message store is not available.");
+        return;
+    }
+
+    jabber_conn_status_t conn_status = connection_get_status();
+    if (conn_status != JABBER_CONNECTED) {
+        cons_show("You are not currently connected.");
+        return;
+    }
+
+    Jid *jidp = jid_create(connection_get_fulljid());
+    GSList *found = log_database_search(jidp->barejid, peer, text, HISTORY_SEARCH_MAX);
+    jid_destroy(jidp);
+
+    if (found == NULL) {
+        win_println(window, THEME_DEFAULT, '-', "No messages found containing \"%s\".", text);
+        return;
+    }
+
+    win_println(window, THEME_DEFAULT, '-', "Messages containing \"%s\":", text);
+    GSList *curr = found;
+    while (curr) {
+        ProfDbMessage *entry = curr->data;
+        const char *from = entry->direction == PROF_OUT_LOG ? "me" : (entry->resource ? entry->resource : peer);
+        gchar *date_fmt = g_date_time_format(entry->timestamp, "%d/%m/%Y %H:%M:%S");
+        win_println(window, THEME_DEFAULT, '-', "  %s - %s: %s", date_fmt, from, entry->message);
+        g_free(date_fmt);
+        curr = g_slist_next(curr);
+    }
+    g_slist_free_full(found, (GDestroyNotify)log_database_free_message);
+}
+
 gboolean
 cmd_history(ProfWin *window, const char *const command, gchar **args)
 {
@@ -6693,6 +6892,15 @@ cmd_history(ProfWin *window, const char *const command, gchar **args)
         return FALSE;
     }
 
+    if (g_strcmp0(args[0], "search") == 0) {
+        if (args[1] == NULL) {
+            cons_bad_cmd_usage(command);
+        } else {
+            _cmd_history_search(window, args[1]);
+        }
+        return TRUE;
+    }
+
     _cmd_set_boolean_preference(args[0], command, "Chat history", PREF_HISTORY);
 
     // if set to on, set chlog
@@ -7972,6 +8180,16 @@ _cmd_execute_default(ProfWin *window, const char *inp)
 
     jabber_conn_status_t status = connection_get_status();
     if (status != JABBER_CONNECTED) {
+        // plain chat messages written while reconnecting are sent once back online
+        if (window->type == WIN_CHAT && session_reconnecting()) {
+            ProfChatWin *chatwin = (ProfChatWin*)window;
+            assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
+            if (!chatwin->is_otr && !chatwin->pgp_send && !chatwin->is_omemo) {
+                win_println(window, THEME_DEFAULT, '-', "Not connected, the message will be sent after reconnecting.");
+                cl_ev_send_msg(chatwin, inp, NULL);
+                return TRUE;
+            }
+        }
         win_println(window, THEME_DEFAULT, '-', "You are not currently connected.");
         return TRUE;
     }
@@ -8018,9 +8236,7 @@ _cmd_execute_alias(ProfWin *window, const char *const inp, gboolean *ran)
         return TRUE;
     }
 
-    char *alias = strdup(inp+1);
-    char *value = prefs_get_alias(alias);
-    free(alias);
+    char *value = prefs_get_alias(inp+1);
     if (value) {
         *ran = TRUE;
         gboolean result = cmd_process_input(window, value);
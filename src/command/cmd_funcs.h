@@ -130,6 +130,7 @@ gboolean cmd_who(ProfWin *window, const char *const command, gchar **args);
 gboolean cmd_win(ProfWin *window, const char *const command, gchar **args);
 gboolean cmd_alias(ProfWin *window, const char *const command, gchar **args);
 gboolean cmd_xmlconsole(ProfWin *window, const char *const command, gchar **args);
+gboolean cmd_memory(ProfWin *window, const char *const command, gchar **args);
 gboolean cmd_ping(ProfWin *window, const char *const command, gchar **args);
 gboolean cmd_form(ProfWin *window, const char *const command, gchar **args);
 gboolean cmd_occupants(ProfWin *window, const char *const command, gchar **args);
@@ -45,8 +45,6 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
-#include <curl/curl.h>
-#include <curl/easy.h>
 #include <glib.h>
 #include <gio/gio.h>
 
@@ -59,14 +57,6 @@
 #include "log.h"
 #include "common.h"
 
-struct curl_data_t
-{
-    char *buffer;
-    size_t size;
-};
-
-static size_t _data_callback(void *ptr, size_t size, size_t nmemb, void *data);
-
 gboolean
 create_dir(char *name)
 {
@@ -268,32 +258,6 @@ file_getline(FILE *stream)
     return s;
 }
 
-char*
-release_get_latest(void)
-{
-    char *url = "https://profanity-im.github.io/profanity_version.txt";
-
-    CURL *handle = curl_easy_init();
-    struct curl_data_t output;
-    output.buffer = NULL;
-    output.size = 0;
-
-    curl_easy_setopt(handle, CURLOPT_URL, url);
-    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, _data_callback);
-    curl_easy_setopt(handle, CURLOPT_TIMEOUT, 2);
-    curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void *)&output);
-
-    curl_easy_perform(handle);
-    curl_easy_cleanup(handle);
-
-    if (output.buffer) {
-        output.buffer[output.size++] = '\0';
-        return output.buffer;
-    } else {
-        return NULL;
-    }
-}
-
 gboolean
 release_is_new(char *found_version)
 {
@@ -320,22 +284,6 @@ release_is_new(char *found_version)
     }
 }
 
-static size_t
-_data_callback(void *ptr, size_t size, size_t nmemb, void *data)
-{
-    size_t realsize = size * nmemb;
-    struct curl_data_t *mem = (struct curl_data_t *) data;
-    mem->buffer = realloc(mem->buffer, mem->size + realsize + 1);
-
-    if ( mem->buffer )
-    {
-        memcpy( &( mem->buffer[ mem->size ] ), ptr, realsize );
-        mem->size += realsize;
-        mem->buffer[ mem->size ] = 0;
-    }
-
-    return realsize;
-}
 
 char*
 get_file_or_linked(char *loc, char *basedir)
@@ -90,7 +90,6 @@ gboolean strtoi_range(char *str, int *saveptr, int min, int max, char **err_msg)
 int utf8_display_len(const char *const str);
 char* file_getline(FILE *stream);
 
-char* release_get_latest(void);
 gboolean release_is_new(char *found_version);
 
 char* get_file_or_linked(char *loc, char *basedir);
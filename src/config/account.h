@@ -80,7 +80,6 @@ ProfAccount* account_new(const gchar *const name, const gchar *const jid,
     GList *omemo_disabled, const gchar *const pgp_keyid, const char *const startscript,
     const char *const theme, gchar *tls_policy);
 char* account_create_connect_jid(ProfAccount *account);
-gboolean account_eval_password(ProfAccount *account);
 void account_free(ProfAccount *account);
 void account_set_server(ProfAccount *account, const char *server);
 void account_set_port(ProfAccount *account, int port);
@@ -55,6 +55,9 @@
 #define DIR_PGP "pgp"
 #define DIR_OMEMO "omemo"
 #define DIR_PLUGINS "plugins"
+#define DIR_DATABASE "database"
+#define DIR_ROOMS "rooms"
+#define DIR_SCROLLBACK "scrollback"
 
 void files_create_directories(void);
 
@@ -568,6 +568,42 @@ prefs_set_max_log_size(gint value)
     g_key_file_set_integer(prefs, PREF_GROUP_LOGGING, "maxsize", value);
 }
 
+gint
+prefs_get_log_compress_days(void)
+{
+    return g_key_file_get_integer(prefs, PREF_GROUP_LOGGING, "compress", NULL);
+}
+
+void
+prefs_set_log_compress_days(gint value)
+{
+    g_key_file_set_integer(prefs, PREF_GROUP_LOGGING, "compress", value);
+}
+
+gint
+prefs_get_memory_budget(void)
+{
+    return g_key_file_get_integer(prefs, PREF_GROUP_UI, "memory.budget", NULL);
+}
+
+void
+prefs_set_memory_budget(gint value)
+{
+    g_key_file_set_integer(prefs, PREF_GROUP_UI, "memory.budget", value);
+}
+
+gint
+prefs_get_memory_log(void)
+{
+    return g_key_file_get_integer(prefs, PREF_GROUP_LOGGING, "memory", NULL);
+}
+
+void
+prefs_set_memory_log(gint value)
+{
+    g_key_file_set_integer(prefs, PREF_GROUP_LOGGING, "memory", value);
+}
+
 gint
 prefs_get_inpblock(void)
 {
@@ -663,24 +699,6 @@ prefs_set_autoxa_time(gint value)
     g_key_file_set_integer(prefs, PREF_GROUP_PRESENCE, "autoaway.xatime", value);
 }
 
-void
-prefs_set_tray_timer(gint value)
-{
-    g_key_file_set_integer(prefs, PREF_GROUP_NOTIFICATIONS, "tray.timer", value);
-}
-
-gint
-prefs_get_tray_timer(void)
-{
-    gint result = g_key_file_get_integer(prefs, PREF_GROUP_NOTIFICATIONS, "tray.timer", NULL);
-
-    if (result == 0) {
-        return 5;
-    } else {
-        return result;
-    }
-}
-
 gint
 prefs_get_statusbartabs(void)
 {
@@ -1767,6 +1785,7 @@ _get_group(preference_t pref)
         case PREF_PGP_LOG:
             return PREF_GROUP_PGP;
         case PREF_BOOKMARK_INVITE:
+        case PREF_BOOKMARK_AUTOJOIN_ORDER:
         case PREF_ROOM_LIST_CACHE:
             return PREF_GROUP_MUC;
         case PREF_PLUGINS_SOURCEPATH:
@@ -1992,6 +2011,8 @@ _get_key(preference_t pref)
             return "color.occupants.nick";
         case PREF_BOOKMARK_INVITE:
             return "bookmark.invite";
+        case PREF_BOOKMARK_AUTOJOIN_ORDER:
+            return "bookmark.autojoin.order";
         case PREF_PLUGINS_SOURCEPATH:
             return "sourcepath";
         case PREF_ROOM_LIST_CACHE:
@@ -2137,6 +2158,8 @@ _get_default_string(preference_t pref)
             return "redact";
         case PREF_OMEMO_POLICY:
             return "automatic";
+        case PREF_BOOKMARK_AUTOJOIN_ORDER:
+            return "activity";
         default:
             return NULL;
     }
@@ -161,6 +161,7 @@ typedef enum {
     PREF_OMEMO_LOG,
     PREF_OMEMO_POLICY,
     PREF_OCCUPANTS_WRAP,
+    PREF_BOOKMARK_AUTOJOIN_ORDER,
 } preference_t;
 
 typedef struct prof_alias_t {
@@ -197,6 +198,12 @@ gint prefs_get_notify_remind(void);
 
 void prefs_set_max_log_size(gint value);
 gint prefs_get_max_log_size(void);
+void prefs_set_log_compress_days(gint value);
+gint prefs_get_log_compress_days(void);
+void prefs_set_memory_budget(gint value);
+gint prefs_get_memory_budget(void);
+void prefs_set_memory_log(gint value);
+gint prefs_get_memory_log(void);
 gint prefs_get_priority(void);
 void prefs_set_reconnect(gint value);
 gint prefs_get_reconnect(void);
@@ -270,8 +277,6 @@ void prefs_set_occupants_indent(gint value);
 
 void prefs_add_login(const char *jid);
 
-void prefs_set_tray_timer(gint value);
-gint prefs_get_tray_timer(void);
 
 gboolean prefs_add_alias(const char *const name, const char *const value);
 gboolean prefs_remove_alias(const char *const name);
@@ -0,0 +1,844 @@
+/*
+ * database.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sqlite3.h>
+#include <glib.h>
+
+#include "log.h"
+#include "common.h"
+#include "config/files.h"
+#include "log_compress.h"
+#include "database.h"
+
+#define DB_FILENAME "chatlog.db"
+
+// maximum number of writes committed in one transaction
+#define DB_BATCH_MAX 256
+// time the writer waits for further writes before committing a batch
+#define DB_BATCH_LINGER (100 * G_TIME_SPAN_MILLISECOND)
+// user_version once the text chat logs have been imported
+#define DB_VERSION_IMPORTED 1
+
+typedef enum {
+    DB_OP_INSERT,
+    DB_OP_RECEIPT,
+    DB_OP_IMPORT,
+    DB_OP_STOP
+} db_op_type_t;
+
+typedef struct db_op_t {
+    db_op_type_t type;
+    char *account;
+    char *peer;
+    char *resource;
+    prof_db_type_t msg_type;
+    chat_log_direction_t direction;
+    gint64 timestamp;
+    char *id;
+    prof_enc_t enc;
+    char *message;
+} DbOp;
+
+static sqlite3 *db_reader = NULL;
+static sqlite3 *db_writer = NULL;
+static sqlite3_stmt *insert_stmt = NULL;
+static sqlite3_stmt *receipt_stmt = NULL;
+static GAsyncQueue *pending = NULL;
+static pthread_t writer_thread;
+static gint failed_writes = 0;
+static gint history_imported = 0;
+static gint imported_logs = 0;
+static gint failed_imports = 0;
+
+static const char *const schema =
+    "CREATE TABLE IF NOT EXISTS `ChatLogs` ("
+        "`id` INTEGER PRIMARY KEY AUTOINCREMENT, "
+        "`account` TEXT NOT NULL, "
+        "`peer` TEXT NOT NULL, "
+        "`resource` TEXT, "
+        "`type` TEXT NOT NULL, "
+        "`direction` INTEGER NOT NULL, "
+        "`timestamp` INTEGER NOT NULL, "
+        "`stanza_id` TEXT, "
+        "`encryption` TEXT NOT NULL, "
+        "`receipt` INTEGER NOT NULL DEFAULT 0, "
+        "`message` TEXT);"
+    "CREATE INDEX IF NOT EXISTS `ChatLogs_peer_timestamp` "
+        "ON `ChatLogs` (`account`, `peer`, `timestamp`);"
+    "CREATE UNIQUE INDEX IF NOT EXISTS `ChatLogs_stanza_id` "
+        "ON `ChatLogs` (`account`, `peer`, `stanza_id`) WHERE `stanza_id` IS NOT NULL;";
+
+static sqlite3* _db_open(const char *const filename, int flags);
+static void _log_database_report(void);
+static void* _writer_run(void *data);
+static void _writer_apply(DbOp *op);
+static void _db_op_free(DbOp *op);
+static void _import_text_logs(const char *const chatlogs_dir, gint64 before);
+static GSList* _query_messages(sqlite3_stmt *stmt, const char *const peer);
+static const char* _type_to_str(prof_db_type_t type);
+static const char* _enc_to_str(prof_enc_t enc);
+static prof_enc_t _enc_from_str(const char *const enc);
+static gint64 _timestamp_to_usec(GDateTime *timestamp);
+static GDateTime* _timestamp_from_usec(gint64 usec);
+
+gboolean
+log_database_init(void)
+{
+    if (pending) {
+        return TRUE;
+    }
+
+    char *database_dir = files_get_data_path(DIR_DATABASE);
+    if (!mkdir_recursive(database_dir)) {
+        log_error("Could not create message store directory %s", database_dir);
+        free(database_dir);
+        return FALSE;
+    }
+
+    GString *filename = g_string_new(database_dir);
+    g_string_append(filename, "/" DB_FILENAME);
+    free(database_dir);
+
+    db_writer = _db_open(filename->str, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    if (!db_writer) {
+        g_string_free(filename, TRUE);
+        return FALSE;
+    }
+
+    // WAL lets the main thread read history while the writer commits
+    char *err_msg = NULL;
+    if (sqlite3_exec(db_writer, "PRAGMA journal_mode=WAL;", NULL, NULL, &err_msg) != SQLITE_OK
+            || sqlite3_exec(db_writer, schema, NULL, NULL, &err_msg) != SQLITE_OK) {
+        log_error("Could not initialise message store: %s", err_msg);
+        sqlite3_free(err_msg);
+        sqlite3_close(db_writer);
+        db_writer = NULL;
+        g_string_free(filename, TRUE);
+        return FALSE;
+    }
+
+    sqlite3_prepare_v2(db_writer,
+        "INSERT OR IGNORE INTO `ChatLogs` (`account`, `peer`, `resource`, `type`, `direction`, `timestamp`, "
+        "`stanza_id`, `encryption`, `message`) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)", -1, &insert_stmt, NULL);
+    sqlite3_prepare_v2(db_writer,
+        "UPDATE `ChatLogs` SET `receipt` = 1 WHERE `account` = ? AND `peer` = ? AND `stanza_id` = ? "
+        "AND `direction` = 1", -1, &receipt_stmt, NULL);
+
+    db_reader = _db_open(filename->str, SQLITE_OPEN_READONLY);
+    g_string_free(filename, TRUE);
+    if (!db_reader || !insert_stmt || !receipt_stmt) {
+        log_error("Could not prepare message store: %s", sqlite3_errmsg(db_writer));
+        sqlite3_finalize(insert_stmt);
+        sqlite3_finalize(receipt_stmt);
+        insert_stmt = NULL;
+        receipt_stmt = NULL;
+        sqlite3_close(db_reader);
+        sqlite3_close(db_writer);
+        db_reader = NULL;
+        db_writer = NULL;
+        return FALSE;
+    }
+
+    pending = g_async_queue_new_full((GDestroyNotify)_db_op_free);
+
+    // the first time the store is opened it is filled from the text logs
+    // written so far, the writer does this before any other write
+    int version = 0;
+    sqlite3_stmt *version_stmt = NULL;
+    if (sqlite3_prepare_v2(db_writer, "PRAGMA user_version", -1, &version_stmt, NULL) == SQLITE_OK
+            && sqlite3_step(version_stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(version_stmt, 0);
+    }
+    sqlite3_finalize(version_stmt);
+
+    if (version < DB_VERSION_IMPORTED) {
+        DbOp *import = malloc(sizeof(DbOp));
+        memset(import, 0, sizeof(DbOp));
+        import->type = DB_OP_IMPORT;
+        import->timestamp = g_get_real_time();
+        import->message = files_get_data_path(DIR_CHATLOGS);
+        g_async_queue_push(pending, import);
+    } else {
+        g_atomic_int_set(&history_imported, 1);
+    }
+
+    if (pthread_create(&writer_thread, NULL, _writer_run, NULL) != 0) {
+        log_error("Could not start message store writer");
+        g_async_queue_unref(pending);
+        pending = NULL;
+        log_database_close();
+        return FALSE;
+    }
+
+    log_info("Initialised message store");
+    return TRUE;
+}
+
+gboolean
+log_database_is_open(void)
+{
+    return pending != NULL;
+}
+
+/*
+ * Whether the store holds the history from the text logs, until the first
+ * import has finished history has to be read from the text logs
+ */
+gboolean
+log_database_history_ready(void)
+{
+    return pending != NULL && g_atomic_int_get(&history_imported);
+}
+
+void
+log_database_add(const char *const account, const char *const peer, const char *const resource,
+    prof_db_type_t type, chat_log_direction_t direction, GDateTime *timestamp, const char *const id,
+    prof_enc_t enc, const char *const message)
+{
+    if (!pending || !account || !peer) {
+        return;
+    }
+
+    _log_database_report();
+
+    DbOp *op = malloc(sizeof(DbOp));
+    op->type = DB_OP_INSERT;
+    op->account = strdup(account);
+    op->peer = strdup(peer);
+    op->resource = resource ? strdup(resource) : NULL;
+    op->msg_type = type;
+    op->direction = direction;
+    if (timestamp) {
+        op->timestamp = _timestamp_to_usec(timestamp);
+    } else {
+        op->timestamp = g_get_real_time();
+    }
+    op->id = id ? strdup(id) : NULL;
+    op->enc = enc;
+    op->message = message ? strdup(message) : NULL;
+
+    g_async_queue_push(pending, op);
+}
+
+void
+log_database_mark_receipt(const char *const account, const char *const peer, const char *const id)
+{
+    if (!pending || !account || !peer || !id) {
+        return;
+    }
+
+    DbOp *op = malloc(sizeof(DbOp));
+    memset(op, 0, sizeof(DbOp));
+    op->type = DB_OP_RECEIPT;
+    op->account = strdup(account);
+    op->peer = strdup(peer);
+    op->id = strdup(id);
+
+    g_async_queue_push(pending, op);
+}
+
+/*
+ * Chat messages with peer logged at or after since, oldest first
+ */
+GSList*
+log_database_get_previous_chat(const char *const account, const char *const peer, GDateTime *since)
+{
+    if (!db_reader || !account || !peer) {
+        return NULL;
+    }
+
+    sqlite3_stmt *stmt = NULL;
+    int rc = sqlite3_prepare_v2(db_reader,
+        "SELECT `resource`, `direction`, `timestamp`, `stanza_id`, `encryption`, `receipt`, `message` "
+        "FROM `ChatLogs` WHERE `account` = ? AND `peer` = ? AND `type` = 'chat' AND `timestamp` >= ? "
+        "ORDER BY `timestamp` DESC", -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        log_error("Could not query message store: %s", sqlite3_errmsg(db_reader));
+        return NULL;
+    }
+
+    sqlite3_bind_text(stmt, 1, account, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, peer, -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 3, since ? _timestamp_to_usec(since) : 0);
+
+    return _query_messages(stmt, peer);
+}
+
+/*
+ * Up to limit messages with peer containing text, newest last
+ */
+GSList*
+log_database_search(const char *const account, const char *const peer, const char *const text, int limit)
+{
+    if (!db_reader || !account || !peer || !text) {
+        return NULL;
+    }
+
+    sqlite3_stmt *stmt = NULL;
+    int rc = sqlite3_prepare_v2(db_reader,
+        "SELECT `resource`, `direction`, `timestamp`, `stanza_id`, `encryption`, `receipt`, `message` "
+        "FROM `ChatLogs` WHERE `account` = ? AND `peer` = ? AND `message` LIKE ? ESCAPE '\\' "
+        "ORDER BY `timestamp` DESC LIMIT ?", -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        log_error("Could not query message store: %s", sqlite3_errmsg(db_reader));
+        return NULL;
+    }
+
+    GString *pattern = g_string_new("%");
+    const char *c;
+    for (c = text; *c; c++) {
+        if (*c == '%' || *c == '_' || *c == '\\') {
+            g_string_append_c(pattern, '\\');
+        }
+        g_string_append_c(pattern, *c);
+    }
+    g_string_append_c(pattern, '%');
+
+    sqlite3_bind_text(stmt, 1, account, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, peer, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, pattern->str, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 4, limit);
+    g_string_free(pattern, TRUE);
+
+    return _query_messages(stmt, peer);
+}
+
+/*
+ * Time of the newest logged message with peer, in microseconds since the epoch, 0 if none
+ */
+gint64
+log_database_get_last_activity(const char *const account, const char *const peer)
+{
+    if (!db_reader || !account || !peer) {
+        return 0;
+    }
+
+    sqlite3_stmt *stmt = NULL;
+    int rc = sqlite3_prepare_v2(db_reader,
+        "SELECT MAX(`timestamp`) FROM `ChatLogs` WHERE `account` = ? AND `peer` = ?", -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        log_error("Could not query message store: %s", sqlite3_errmsg(db_reader));
+        return 0;
+    }
+
+    sqlite3_bind_text(stmt, 1, account, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, peer, -1, SQLITE_STATIC);
+
+    gint64 last = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        last = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+
+    return last;
+}
+
+void
+log_database_free_message(ProfDbMessage *message)
+{
+    if (message) {
+        free(message->peer);
+        free(message->resource);
+        if (message->timestamp) {
+            g_date_time_unref(message->timestamp);
+        }
+        free(message->id);
+        free(message->message);
+        free(message);
+    }
+}
+
+void
+log_database_close(void)
+{
+    if (pending) {
+        DbOp *stop = malloc(sizeof(DbOp));
+        memset(stop, 0, sizeof(DbOp));
+        stop->type = DB_OP_STOP;
+        g_async_queue_push(pending, stop);
+        pthread_join(writer_thread, NULL);
+
+        g_async_queue_unref(pending);
+        pending = NULL;
+    }
+    g_atomic_int_set(&history_imported, 0);
+
+    _log_database_report();
+
+    if (insert_stmt) {
+        sqlite3_finalize(insert_stmt);
+        insert_stmt = NULL;
+    }
+    if (receipt_stmt) {
+        sqlite3_finalize(receipt_stmt);
+        receipt_stmt = NULL;
+    }
+    if (db_reader) {
+        sqlite3_close(db_reader);
+        db_reader = NULL;
+    }
+    if (db_writer) {
+        sqlite3_close(db_writer);
+        db_writer = NULL;
+    }
+}
+
+/*
+ * Log what the writer thread has counted since the last report, the writer
+ * thread itself must not log
+ */
+static void
+_log_database_report(void)
+{
+    int errors = g_atomic_int_get(&failed_writes);
+    if (errors > 0) {
+        g_atomic_int_add(&failed_writes, -errors);
+        log_error("Message store failed to write %d entries", errors);
+    }
+
+    int imported = g_atomic_int_get(&imported_logs);
+    if (imported > 0) {
+        g_atomic_int_add(&imported_logs, -imported);
+        log_info("Imported %d chat logs into the message store", imported);
+    }
+
+    int failed = g_atomic_int_get(&failed_imports);
+    if (failed > 0) {
+        g_atomic_int_add(&failed_imports, -failed);
+        log_error("Could not read %d chat logs into the message store", failed);
+    }
+}
+
+static sqlite3*
+_db_open(const char *const filename, int flags)
+{
+    sqlite3 *db = NULL;
+    if (sqlite3_open_v2(filename, &db, flags, NULL) != SQLITE_OK) {
+        log_error("Could not open message store %s: %s", filename, db ? sqlite3_errmsg(db) : "out of memory");
+        sqlite3_close(db);
+        return NULL;
+    }
+    sqlite3_busy_timeout(db, 1000);
+
+    return db;
+}
+
+static void*
+_writer_run(void *data)
+{
+    gboolean running = TRUE;
+
+    while (running) {
+        DbOp *op = g_async_queue_pop(pending);
+        int count = 0;
+
+        sqlite3_exec(db_writer, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+        while (op) {
+            if (op->type == DB_OP_STOP) {
+                running = FALSE;
+                _db_op_free(op);
+                break;
+            }
+
+            _writer_apply(op);
+            _db_op_free(op);
+
+            if (++count == DB_BATCH_MAX) {
+                break;
+            }
+            op = g_async_queue_timeout_pop(pending, DB_BATCH_LINGER);
+        }
+
+        if (sqlite3_exec(db_writer, "COMMIT;", NULL, NULL, NULL) != SQLITE_OK) {
+            g_atomic_int_add(&failed_writes, count);
+        }
+    }
+
+    return NULL;
+}
+
+static void
+_writer_apply(DbOp *op)
+{
+    sqlite3_stmt *stmt = NULL;
+
+    switch (op->type) {
+    case DB_OP_INSERT:
+        stmt = insert_stmt;
+        sqlite3_bind_text(stmt, 1, op->account, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, op->peer, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, op->resource, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, _type_to_str(op->msg_type), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 5, op->direction == PROF_OUT_LOG ? 1 : 0);
+        sqlite3_bind_int64(stmt, 6, op->timestamp);
+        sqlite3_bind_text(stmt, 7, op->id, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 8, _enc_to_str(op->enc), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 9, op->message, -1, SQLITE_STATIC);
+        break;
+    case DB_OP_RECEIPT:
+        stmt = receipt_stmt;
+        sqlite3_bind_text(stmt, 1, op->account, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, op->peer, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, op->id, -1, SQLITE_STATIC);
+        break;
+    case DB_OP_IMPORT:
+        _import_text_logs(op->message, op->timestamp);
+        return;
+    default:
+        return;
+    }
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        g_atomic_int_inc(&failed_writes);
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+}
+
+static void
+_db_op_free(DbOp *op)
+{
+    if (op) {
+        free(op->account);
+        free(op->peer);
+        free(op->resource);
+        free(op->id);
+        free(op->message);
+        free(op);
+    }
+}
+
+/*
+ * Add one entry parsed from a text log
+ */
+static void
+_import_entry(const char *const account, const char *const peer, prof_db_type_t type,
+    GDateTime *date, const char *const line, GString *message, gint64 before)
+{
+    int hh = 0, mm = 0, ss = 0;
+    sscanf(line, "%2d:%2d:%2d", &hh, &mm, &ss);
+    GDateTime *timestamp = g_date_time_new_local(g_date_time_get_year(date), g_date_time_get_month(date),
+        g_date_time_get_day_of_month(date), hh, mm, ss);
+    if (timestamp == NULL) {
+        return;
+    }
+
+    // this session writes to the store itself, skip what it has logged
+    // while the import was running
+    if (_timestamp_to_usec(timestamp) >= before) {
+        g_date_time_unref(timestamp);
+        return;
+    }
+
+    // "HH:MM:SS - from: message" or "HH:MM:SS - *from message" for /me
+    const char *text = line + 11;
+    char *from = NULL;
+    char *body = NULL;
+    if (text[0] == '*' && strchr(text, ' ')) {
+        const char *space = strchr(text, ' ');
+        from = g_strndup(text + 1, space - text - 1);
+        body = g_strdup_printf("/me %s", space + 1);
+    } else if (strstr(text, ": ")) {
+        const char *sep = strstr(text, ": ");
+        from = g_strndup(text, sep - text);
+        body = g_strdup(sep + 2);
+    }
+
+    if (from && body) {
+        if (message->len > 0) {
+            char *full = g_strconcat(body, message->str, NULL);
+            g_free(body);
+            body = full;
+        }
+
+        DbOp op;
+        memset(&op, 0, sizeof(DbOp));
+        op.type = DB_OP_INSERT;
+        op.account = (char*)account;
+        op.peer = (char*)peer;
+        op.msg_type = type;
+        op.timestamp = _timestamp_to_usec(timestamp);
+        op.enc = PROF_MSG_ENC_PLAIN;
+        op.message = body;
+        if (type == PROF_DB_MUC) {
+            op.resource = from;
+            op.direction = PROF_IN_LOG;
+        } else {
+            op.direction = g_strcmp0(from, "me") == 0 ? PROF_OUT_LOG : PROF_IN_LOG;
+        }
+        _writer_apply(&op);
+    }
+
+    g_free(from);
+    g_free(body);
+    g_date_time_unref(timestamp);
+}
+
+static void
+_import_file(const char *const account, const char *const peer, prof_db_type_t type,
+    const char *const filename, GDateTime *date, gint64 before)
+{
+    gboolean failed = FALSE;
+    FILE *logp = log_compress_read(filename, &failed);
+    if (failed) {
+        g_atomic_int_inc(&failed_imports);
+    }
+    if (logp == NULL) {
+        return;
+    }
+
+    // lines without a timestamp continue the message before them
+    char *entry = NULL;
+    GString *continued = g_string_new(NULL);
+    char *line;
+    while ((line = file_getline(logp)) != NULL) {
+        gboolean stamped = strlen(line) > 11 && line[2] == ':' && line[5] == ':' && strncmp(line + 8, " - ", 3) == 0;
+        if (!stamped && entry) {
+            g_string_append_printf(continued, "\n%s", line);
+            free(line);
+            continue;
+        }
+        if (entry) {
+            _import_entry(account, peer, type, date, entry, continued, before);
+            free(entry);
+            entry = NULL;
+            g_string_truncate(continued, 0);
+        }
+        if (stamped) {
+            entry = line;
+        } else {
+            free(line);
+        }
+    }
+    if (entry) {
+        _import_entry(account, peer, type, date, entry, continued, before);
+        free(entry);
+    }
+    g_string_free(continued, TRUE);
+    fclose(logp);
+    g_atomic_int_inc(&imported_logs);
+}
+
+static void
+_import_dir(const char *const account, const char *const dir_name, prof_db_type_t type,
+    const char *const path, gint64 before)
+{
+    GDir *dir = g_dir_open(path, 0, NULL);
+    if (dir == NULL) {
+        return;
+    }
+
+    char *peer = str_replace(dir_name, "_at_", "@");
+    const gchar *name;
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        // compressed logs are read through their plain name, a log still
+        // being compressed is only read once, from its plain file
+        gchar *log_name = g_strdup(name);
+        if (g_str_has_suffix(log_name, LOG_COMPRESS_SUFFIX)) {
+            log_name[strlen(log_name) - strlen(LOG_COMPRESS_SUFFIX)] = '\0';
+            char *plain = g_strdup_printf("%s/%s", path, log_name);
+            gboolean has_plain = g_file_test(plain, G_FILE_TEST_EXISTS);
+            g_free(plain);
+            if (has_plain) {
+                g_free(log_name);
+                continue;
+            }
+        }
+
+        int year, month, day;
+        if (strlen(log_name) != strlen("YYYY_MM_DD.log") || !g_str_has_suffix(log_name, ".log")
+                || sscanf(log_name, "%4d_%2d_%2d", &year, &month, &day) != 3) {
+            g_free(log_name);
+            continue;
+        }
+
+        GDateTime *date = g_date_time_new_local(year, month, day, 0, 0, 0);
+        if (date) {
+            char *filename = g_strdup_printf("%s/%s", path, log_name);
+            _import_file(account, peer, type, filename, date, before);
+            g_free(filename);
+            g_date_time_unref(date);
+        }
+        g_free(log_name);
+
+        // keep transactions small, the main thread may be waiting to read
+        sqlite3_exec(db_writer, "COMMIT; BEGIN TRANSACTION;", NULL, NULL, NULL);
+    }
+
+    free(peer);
+    g_dir_close(dir);
+}
+
+/*
+ * Fill the store from the dated text logs, chatlogs/<account>/<contact>/ and
+ * chatlogs/<account>/rooms/<room>/, up to the time the store was first opened
+ */
+static void
+_import_text_logs(const char *const chatlogs_dir, gint64 before)
+{
+    GDir *accounts = g_dir_open(chatlogs_dir, 0, NULL);
+    if (accounts) {
+        const gchar *account_dir;
+        while ((account_dir = g_dir_read_name(accounts)) != NULL) {
+            char *account = str_replace(account_dir, "_at_", "@");
+            char *account_path = g_strdup_printf("%s/%s", chatlogs_dir, account_dir);
+            GDir *peers = g_dir_open(account_path, 0, NULL);
+            if (peers) {
+                const gchar *peer_dir;
+                while ((peer_dir = g_dir_read_name(peers)) != NULL) {
+                    char *peer_path = g_strdup_printf("%s/%s", account_path, peer_dir);
+                    if (g_strcmp0(peer_dir, "rooms") == 0) {
+                        GDir *rooms = g_dir_open(peer_path, 0, NULL);
+                        if (rooms) {
+                            const gchar *room_dir;
+                            while ((room_dir = g_dir_read_name(rooms)) != NULL) {
+                                char *room_path = g_strdup_printf("%s/%s", peer_path, room_dir);
+                                _import_dir(account, room_dir, PROF_DB_MUC, room_path, before);
+                                g_free(room_path);
+                            }
+                            g_dir_close(rooms);
+                        }
+                    } else {
+                        _import_dir(account, peer_dir, PROF_DB_CHAT, peer_path, before);
+                    }
+                    g_free(peer_path);
+                }
+                g_dir_close(peers);
+            }
+            g_free(account_path);
+            free(account);
+        }
+        g_dir_close(accounts);
+    }
+
+    char *version = g_strdup_printf("PRAGMA user_version = %d; COMMIT; BEGIN TRANSACTION;", DB_VERSION_IMPORTED);
+    sqlite3_exec(db_writer, version, NULL, NULL, NULL);
+    g_free(version);
+    g_atomic_int_set(&history_imported, 1);
+}
+
+/*
+ * Read the rows of a history query, the columns are those selected by
+ * log_database_get_previous_chat. Rows come newest first and are returned
+ * oldest first
+ */
+static GSList*
+_query_messages(sqlite3_stmt *stmt, const char *const peer)
+{
+    GSList *history = NULL;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *resource = (const char*)sqlite3_column_text(stmt, 0);
+        const char *id = (const char*)sqlite3_column_text(stmt, 3);
+        const char *message = (const char*)sqlite3_column_text(stmt, 6);
+
+        ProfDbMessage *entry = malloc(sizeof(ProfDbMessage));
+        entry->peer = strdup(peer);
+        entry->resource = resource ? strdup(resource) : NULL;
+        entry->direction = sqlite3_column_int(stmt, 1) ? PROF_OUT_LOG : PROF_IN_LOG;
+        entry->timestamp = _timestamp_from_usec(sqlite3_column_int64(stmt, 2));
+        entry->id = id ? strdup(id) : NULL;
+        entry->enc = _enc_from_str((const char*)sqlite3_column_text(stmt, 4));
+        entry->receipt = sqlite3_column_int(stmt, 5) ? TRUE : FALSE;
+        entry->message = message ? strdup(message) : NULL;
+
+        history = g_slist_prepend(history, entry);
+    }
+    sqlite3_finalize(stmt);
+
+    return history;
+}
+
+static const char*
+_type_to_str(prof_db_type_t type)
+{
+    switch (type) {
+    case PROF_DB_MUC:
+        return "muc";
+    case PROF_DB_MUCPM:
+        return "mucpm";
+    default:
+        return "chat";
+    }
+}
+
+static const char*
+_enc_to_str(prof_enc_t enc)
+{
+    switch (enc) {
+    case PROF_MSG_ENC_OTR:
+        return "otr";
+    case PROF_MSG_ENC_PGP:
+        return "pgp";
+    case PROF_MSG_ENC_OMEMO:
+        return "omemo";
+    default:
+        return "none";
+    }
+}
+
+static prof_enc_t
+_enc_from_str(const char *const enc)
+{
+    if (g_strcmp0(enc, "otr") == 0) {
+        return PROF_MSG_ENC_OTR;
+    } else if (g_strcmp0(enc, "pgp") == 0) {
+        return PROF_MSG_ENC_PGP;
+    } else if (g_strcmp0(enc, "omemo") == 0) {
+        return PROF_MSG_ENC_OMEMO;
+    } else {
+        return PROF_MSG_ENC_PLAIN;
+    }
+}
+
+static gint64
+_timestamp_to_usec(GDateTime *timestamp)
+{
+    return g_date_time_to_unix(timestamp) * G_USEC_PER_SEC + g_date_time_get_microsecond(timestamp);
+}
+
+static GDateTime*
+_timestamp_from_usec(gint64 usec)
+{
+    GDateTime *seconds = g_date_time_new_from_unix_local(usec / G_USEC_PER_SEC);
+    GDateTime *timestamp = g_date_time_add(seconds, usec % G_USEC_PER_SEC);
+    g_date_time_unref(seconds);
+
+    return timestamp;
+}
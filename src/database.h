@@ -0,0 +1,74 @@
+/*
+ * database.h
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef DATABASE_H
+#define DATABASE_H
+
+#include <glib.h>
+
+#include "log.h"
+#include "xmpp/xmpp.h"
+
+typedef enum {
+    PROF_DB_CHAT,
+    PROF_DB_MUC,
+    PROF_DB_MUCPM
+} prof_db_type_t;
+
+typedef struct prof_db_message_t {
+    char *peer;
+    char *resource;
+    chat_log_direction_t direction;
+    GDateTime *timestamp;
+    char *id;
+    prof_enc_t enc;
+    gboolean receipt;
+    char *message;
+} ProfDbMessage;
+
+gboolean log_database_init(void);
+gboolean log_database_is_open(void);
+gboolean log_database_history_ready(void);
+void log_database_add(const char *const account, const char *const peer, const char *const resource,
+    prof_db_type_t type, chat_log_direction_t direction, GDateTime *timestamp, const char *const id,
+    prof_enc_t enc, const char *const message);
+void log_database_mark_receipt(const char *const account, const char *const peer, const char *const id);
+GSList* log_database_get_previous_chat(const char *const account, const char *const peer, GDateTime *since);
+GSList* log_database_search(const char *const account, const char *const peer, const char *const text, int limit);
+gint64 log_database_get_last_activity(const char *const account, const char *const peer);
+void log_database_free_message(ProfDbMessage *message);
+void log_database_close(void);
+
+#endif
@@ -145,14 +145,14 @@ cl_ev_send_msg(ProfChatWin *chatwin, const char *const msg, const char *const oo
 #ifndef HAVE_OMEMO
     if (chatwin->pgp_send) {
         char *id = message_send_chat_pgp(chatwin->barejid, plugin_msg, request_receipt);
-        chat_log_pgp_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_pgp_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PGP, request_receipt);
         free(id);
     } else {
         gboolean handled = otr_on_message_send(chatwin, plugin_msg, request_receipt);
         if (!handled) {
             char *id = message_send_chat(chatwin->barejid, plugin_msg, oob_url, request_receipt);
-            chat_log_msg_out(chatwin->barejid, plugin_msg, NULL);
+            chat_log_msg_out(chatwin->barejid, plugin_msg, NULL, id);
             chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PLAIN, request_receipt);
             free(id);
         }
@@ -172,7 +172,7 @@ cl_ev_send_msg(ProfChatWin *chatwin, const char *const msg, const char *const oo
     gboolean handled = otr_on_message_send(chatwin, plugin_msg, request_receipt);
     if (!handled) {
         char *id = message_send_chat(chatwin->barejid, plugin_msg, oob_url, request_receipt);
-        chat_log_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PLAIN, request_receipt);
         free(id);
     }
@@ -190,12 +190,12 @@ cl_ev_send_msg(ProfChatWin *chatwin, const char *const msg, const char *const oo
 #ifndef HAVE_OMEMO
     if (chatwin->pgp_send) {
         char *id = message_send_chat_pgp(chatwin->barejid, plugin_msg, request_receipt);
-        chat_log_pgp_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_pgp_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PGP, request_receipt);
         free(id);
     } else {
         char *id = message_send_chat(chatwin->barejid, plugin_msg, oob_url, request_receipt);
-        chat_log_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PLAIN, request_receipt);
         free(id);
     }
@@ -213,12 +213,12 @@ cl_ev_send_msg(ProfChatWin *chatwin, const char *const msg, const char *const oo
 #ifdef HAVE_OMEMO
     if (chatwin->is_omemo) {
         char *id = omemo_on_message_send((ProfWin *)chatwin, plugin_msg, request_receipt, FALSE);
-        chat_log_omemo_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_omemo_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_OMEMO, request_receipt);
         free(id);
     } else {
         char *id = message_send_chat(chatwin->barejid, plugin_msg, oob_url, request_receipt);
-        chat_log_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PLAIN, request_receipt);
         free(id);
     }
@@ -236,14 +236,14 @@ cl_ev_send_msg(ProfChatWin *chatwin, const char *const msg, const char *const oo
 #ifdef HAVE_OMEMO
     if (chatwin->is_omemo) {
         char *id = omemo_on_message_send((ProfWin *)chatwin, plugin_msg, request_receipt, FALSE);
-        chat_log_omemo_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_omemo_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_OMEMO, request_receipt);
         free(id);
     } else {
         gboolean handled = otr_on_message_send(chatwin, plugin_msg, request_receipt);
         if (!handled) {
             char *id = message_send_chat(chatwin->barejid, plugin_msg, oob_url, request_receipt);
-            chat_log_msg_out(chatwin->barejid, plugin_msg, NULL);
+            chat_log_msg_out(chatwin->barejid, plugin_msg, NULL, id);
             chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PLAIN, request_receipt);
             free(id);
         }
@@ -262,17 +262,17 @@ cl_ev_send_msg(ProfChatWin *chatwin, const char *const msg, const char *const oo
 #ifdef HAVE_OMEMO
     if (chatwin->is_omemo) {
         char *id = omemo_on_message_send((ProfWin *)chatwin, plugin_msg, request_receipt, FALSE);
-        chat_log_omemo_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_omemo_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_OMEMO, request_receipt);
         free(id);
     } else if (chatwin->pgp_send) {
         char *id = message_send_chat_pgp(chatwin->barejid, plugin_msg, request_receipt);
-        chat_log_pgp_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_pgp_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PGP, request_receipt);
         free(id);
     } else {
         char *id = message_send_chat(chatwin->barejid, plugin_msg, oob_url, request_receipt);
-        chat_log_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PLAIN, request_receipt);
         free(id);
     }
@@ -290,19 +290,19 @@ cl_ev_send_msg(ProfChatWin *chatwin, const char *const msg, const char *const oo
 #ifdef HAVE_OMEMO
     if (chatwin->is_omemo) {
         char *id = omemo_on_message_send((ProfWin *)chatwin, plugin_msg, request_receipt, FALSE);
-        chat_log_omemo_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_omemo_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_OMEMO, request_receipt);
         free(id);
     } else if (chatwin->pgp_send) {
         char *id = message_send_chat_pgp(chatwin->barejid, plugin_msg, request_receipt);
-        chat_log_pgp_msg_out(chatwin->barejid, plugin_msg, NULL);
+        chat_log_pgp_msg_out(chatwin->barejid, plugin_msg, NULL, id);
         chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PGP, request_receipt);
         free(id);
     } else {
         gboolean handled = otr_on_message_send(chatwin, plugin_msg, request_receipt);
         if (!handled) {
             char *id = message_send_chat(chatwin->barejid, plugin_msg, oob_url, request_receipt);
-            chat_log_msg_out(chatwin->barejid, plugin_msg, NULL);
+            chat_log_msg_out(chatwin->barejid, plugin_msg, NULL, id);
             chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PLAIN, request_receipt);
             free(id);
         }
@@ -320,7 +320,7 @@ cl_ev_send_msg(ProfChatWin *chatwin, const char *const msg, const char *const oo
 #ifndef HAVE_LIBGPGME
 #ifndef HAVE_OMEMO
     char *id = message_send_chat(chatwin->barejid, plugin_msg, oob_url, request_receipt);
-    chat_log_msg_out(chatwin->barejid, plugin_msg, NULL);
+    chat_log_msg_out(chatwin->barejid, plugin_msg, NULL, id);
     chatwin_outgoing_msg(chatwin, plugin_msg, id, PROF_MSG_ENC_PLAIN, request_receipt);
     free(id);
 
@@ -343,12 +343,12 @@ cl_ev_send_muc_msg(ProfMucWin *mucwin, const char *const msg, const char *const
 #ifdef HAVE_OMEMO
     if (mucwin->is_omemo) {
         char *id = omemo_on_message_send((ProfWin *)mucwin, plugin_msg, FALSE, TRUE);
-        groupchat_log_omemo_msg_out(mucwin->roomjid, plugin_msg);
+        groupchat_log_omemo_msg_out(mucwin->roomjid, plugin_msg, id);
         mucwin_outgoing_msg(mucwin, plugin_msg, id, PROF_MSG_ENC_OMEMO);
         free(id);
     } else {
         char *id = message_send_groupchat(mucwin->roomjid, plugin_msg, oob_url);
-        groupchat_log_msg_out(mucwin->roomjid, plugin_msg);
+        groupchat_log_msg_out(mucwin->roomjid, plugin_msg, id);
         mucwin_outgoing_msg(mucwin, plugin_msg, id, PROF_MSG_ENC_PLAIN);
         free(id);
     }
@@ -360,7 +360,7 @@ cl_ev_send_muc_msg(ProfMucWin *mucwin, const char *const msg, const char *const
 
 #ifndef HAVE_OMEMO
     char *id = message_send_groupchat(mucwin->roomjid, plugin_msg, oob_url);
-    groupchat_log_msg_out(mucwin->roomjid, plugin_msg);
+    groupchat_log_msg_out(mucwin->roomjid, plugin_msg, id);
     mucwin_outgoing_msg(mucwin, plugin_msg, id, PROF_MSG_ENC_PLAIN);
     free(id);
 
@@ -382,7 +382,7 @@ cl_ev_send_priv_msg(ProfPrivateWin *privwin, const char *const msg, const char *
         Jid *jidp = jid_create(privwin->fulljid);
 
         message_send_private(privwin->fulljid, plugin_msg, oob_url);
-        chat_log_msg_out(jidp->barejid, plugin_msg, jidp->resourcepart);
+        chat_log_msg_out(jidp->barejid, plugin_msg, jidp->resourcepart, NULL);
         privwin_outgoing_msg(privwin, plugin_msg);
 
         plugins_post_priv_message_send(privwin->fulljid, plugin_msg);
@@ -51,6 +51,7 @@
 #include "plugins/plugins.h"
 #include "ui/window_list.h"
 #include "xmpp/xmpp.h"
+#include "xmpp/autojoin.h"
 #include "xmpp/muc.h"
 #include "xmpp/chat_session.h"
 #include "xmpp/roster_list.h"
@@ -95,13 +96,13 @@ sv_ev_login_account_success(char *account_name, gboolean secured)
 
     ui_handle_login_account_success(account, secured);
 
-    // attempt to rejoin all rooms
+    // attempt to rejoin all rooms, a few at a time
     GList *rooms = muc_rooms();
     GList *curr = rooms;
     while (curr) {
         char *password = muc_password(curr->data);
         char *nick = muc_nick(curr->data);
-        presence_join_room(curr->data, nick, password);
+        autojoin_add(curr->data, nick, password, TRUE);
         curr = g_list_next(curr);
     }
     g_list_free(rooms);
@@ -236,6 +237,12 @@ sv_ev_failed_login(void)
     tlscerts_clear_current();
 }
 
+void
+sv_ev_password_eval_failed(void)
+{
+    cons_show_error("Error evaluating password, see logs for details.");
+}
+
 void
 sv_ev_room_invite(jabber_invite_t invite_type, const char *const invitor, const char *const room,
     const char *const reason, const char *const password)
@@ -294,9 +301,11 @@ sv_ev_room_history(ProfMessage *message)
 static void _log_muc(ProfMessage *message)
 {
     if (message->enc == PROF_MSG_ENC_OMEMO) {
-        groupchat_log_omemo_msg_in(message->jid->barejid, message->jid->resourcepart, message->plain);
+        groupchat_log_omemo_msg_in(message->jid->barejid, message->jid->resourcepart, message->plain,
+            message->timestamp, message->id);
     } else {
-        groupchat_log_msg_in(message->jid->barejid, message->jid->resourcepart, message->plain);
+        groupchat_log_msg_in(message->jid->barejid, message->jid->resourcepart, message->plain,
+            message->timestamp, message->id);
     }
 }
 
@@ -360,14 +369,7 @@ sv_ev_room_message(ProfMessage *message)
 
         cons_show_incoming_room_message(message->jid->resourcepart, mucwin->roomjid, num, mention, triggers, mucwin->unread);
 
-        mucwin->unread++;
-
-        if (mention) {
-            mucwin->unread_mentions = TRUE;
-        }
-        if (triggers) {
-            mucwin->unread_triggers = TRUE;
-        }
+        wins_unread_inc(window, mention, triggers != NULL);
     }
 
     // save timestamp of last received muc message
@@ -451,9 +453,9 @@ sv_ev_outgoing_carbon(ProfMessage *message)
     if (message->plain) {
         if (message->mucuser) {
             // MUC PM, should have resource (nick) in filename
-            chat_log_msg_out(message->jid->barejid, message->plain, message->jid->resourcepart);
+            chat_log_msg_out(message->jid->barejid, message->plain, message->jid->resourcepart, message->id);
         } else {
-            chat_log_msg_out(message->jid->barejid, message->plain, NULL);
+            chat_log_msg_out(message->jid->barejid, message->plain, NULL, message->id);
         }
     }
 
@@ -827,6 +829,8 @@ sv_ev_incoming_carbon(ProfMessage *message)
 void
 sv_ev_message_receipt(const char *const barejid, const char *const id)
 {
+    chat_log_msg_receipt(barejid, id);
+
     ProfChatWin *chatwin = wins_get_chat(barejid);
     if (!chatwin)
         return;
@@ -1426,11 +1430,7 @@ sv_ev_bookmark_autojoin(Bookmark *bookmark)
 
     log_debug("Autojoin %s with nick=%s", bookmark->barejid, nick);
     if (!muc_active(bookmark->barejid)) {
-        presence_join_room(bookmark->barejid, nick, bookmark->password);
-        muc_join(bookmark->barejid, nick, bookmark->password, TRUE);
-        iq_room_affiliation_list(bookmark->barejid, "member", false);
-        iq_room_affiliation_list(bookmark->barejid, "admin", false);
-        iq_room_affiliation_list(bookmark->barejid, "owner", false);
+        autojoin_add(bookmark->barejid, nick, bookmark->password, FALSE);
     }
 
     free(nick);
@@ -42,6 +42,7 @@
 void sv_ev_login_account_success(char *account_name, gboolean secured);
 void sv_ev_lost_connection(void);
 void sv_ev_failed_login(void);
+void sv_ev_password_eval_failed(void);
 void sv_ev_room_invite(jabber_invite_t invite_type,
     const char *const invitor, const char *const room,
     const char *const reason, const char *const password);
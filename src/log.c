@@ -47,6 +47,8 @@
 
 #include "log.h"
 #include "common.h"
+#include "database.h"
+#include "log_compress.h"
 #include "config/files.h"
 #include "config/preferences.h"
 #include "xmpp/xmpp.h"
@@ -91,9 +93,11 @@ static char* _get_groupchat_log_filename(const char *const room, const char *con
 static void _rotate_log_file(void);
 static char* _log_string_from_level(log_level_t level);
 static void _chat_log_chat(const char *const login, const char *const other, const gchar *const msg,
-    chat_log_direction_t direction, GDateTime *timestamp, const char *const resourcepart);
+    chat_log_direction_t direction, GDateTime *timestamp, const char *const resourcepart, const char *const id,
+    prof_enc_t enc);
 static void _groupchat_log_chat(const gchar *const login, const gchar *const room, const gchar *const nick,
-    const gchar *const msg);
+    const gchar *const msg, chat_log_direction_t direction, GDateTime *timestamp, const char *const id,
+    prof_enc_t enc);
 
 void
 log_debug(const char *const msg, ...)
@@ -257,6 +261,16 @@ chat_log_init(void)
     log_info("Initialising chat logs");
     logs = g_hash_table_new_full(g_str_hash, (GEqualFunc) _key_equals, free,
         (GDestroyNotify)_free_chat_log);
+    log_database_init();
+    chat_log_compress();
+}
+
+void
+chat_log_compress(void)
+{
+    char *chatlogs_dir = files_get_data_path(DIR_CHATLOGS);
+    log_compress_start(chatlogs_dir, prefs_get_log_compress_days());
+    free(chatlogs_dir);
 }
 
 void
@@ -268,27 +282,29 @@ groupchat_log_init(void)
 }
 
 void
-chat_log_msg_out(const char *const barejid, const char *const msg, const char *const resource)
+chat_log_msg_out(const char *const barejid, const char *const msg, const char *const resource,
+    const char *const id)
 {
     if (prefs_get_boolean(PREF_CHLOG)) {
         const char *jid = connection_get_fulljid();
         Jid *jidp = jid_create(jid);
-        _chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL, resource);
+        _chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL, resource, id, PROF_MSG_ENC_PLAIN);
         jid_destroy(jidp);
     }
 }
 
 void
-chat_log_otr_msg_out(const char *const barejid, const char *const msg, const char *const resource)
+chat_log_otr_msg_out(const char *const barejid, const char *const msg, const char *const resource,
+    const char *const id)
 {
     if (prefs_get_boolean(PREF_CHLOG)) {
         const char *jid = connection_get_fulljid();
         Jid *jidp = jid_create(jid);
         char *pref_otr_log = prefs_get_string(PREF_OTR_LOG);
         if (strcmp(pref_otr_log, "on") == 0) {
-            _chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL, resource);
+            _chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL, resource, id, PROF_MSG_ENC_OTR);
         } else if (strcmp(pref_otr_log, "redact") == 0) {
-            _chat_log_chat(jidp->barejid, barejid, "[redacted]", PROF_OUT_LOG, NULL, resource);
+            _chat_log_chat(jidp->barejid, barejid, "[redacted]", PROF_OUT_LOG, NULL, resource, id, PROF_MSG_ENC_OTR);
         }
         prefs_free_string(pref_otr_log);
         jid_destroy(jidp);
@@ -296,16 +312,17 @@ chat_log_otr_msg_out(const char *const barejid, const char *const msg, const cha
 }
 
 void
-chat_log_pgp_msg_out(const char *const barejid, const char *const msg, const char *const resource)
+chat_log_pgp_msg_out(const char *const barejid, const char *const msg, const char *const resource,
+    const char *const id)
 {
     if (prefs_get_boolean(PREF_CHLOG)) {
         const char *jid = connection_get_fulljid();
         Jid *jidp = jid_create(jid);
         char *pref_pgp_log = prefs_get_string(PREF_PGP_LOG);
         if (strcmp(pref_pgp_log, "on") == 0) {
-            _chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL, resource);
+            _chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL, resource, id, PROF_MSG_ENC_PGP);
         } else if (strcmp(pref_pgp_log, "redact") == 0) {
-            _chat_log_chat(jidp->barejid, barejid, "[redacted]", PROF_OUT_LOG, NULL, resource);
+            _chat_log_chat(jidp->barejid, barejid, "[redacted]", PROF_OUT_LOG, NULL, resource, id, PROF_MSG_ENC_PGP);
         }
         prefs_free_string(pref_pgp_log);
         jid_destroy(jidp);
@@ -313,16 +330,17 @@ chat_log_pgp_msg_out(const char *const barejid, const char *const msg, const cha
 }
 
 void
-chat_log_omemo_msg_out(const char *const barejid, const char *const msg, const char *const resource)
+chat_log_omemo_msg_out(const char *const barejid, const char *const msg, const char *const resource,
+    const char *const id)
 {
     if (prefs_get_boolean(PREF_CHLOG)) {
         const char *jid = connection_get_fulljid();
         Jid *jidp = jid_create(jid);
         char *pref_omemo_log = prefs_get_string(PREF_OMEMO_LOG);
         if (strcmp(pref_omemo_log, "on") == 0) {
-            _chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL, resource);
+            _chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL, resource, id, PROF_MSG_ENC_OMEMO);
         } else if (strcmp(pref_omemo_log, "redact") == 0) {
-            _chat_log_chat(jidp->barejid, barejid, "[redacted]", PROF_OUT_LOG, NULL, resource);
+            _chat_log_chat(jidp->barejid, barejid, "[redacted]", PROF_OUT_LOG, NULL, resource, id, PROF_MSG_ENC_OMEMO);
         }
         prefs_free_string(pref_omemo_log);
         jid_destroy(jidp);
@@ -338,15 +356,19 @@ chat_log_otr_msg_in(ProfMessage *message)
         char *pref_otr_log = prefs_get_string(PREF_OTR_LOG);
         if (message->enc == PROF_MSG_ENC_PLAIN || (strcmp(pref_otr_log, "on") == 0)) {
             if (message->mucuser) {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, message->jid->resourcepart);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, message->jid->resourcepart,
+                    message->id, message->enc);
             } else {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, NULL);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, NULL, message->id,
+                    message->enc);
             }
         } else if (strcmp(pref_otr_log, "redact") == 0) {
             if (message->mucuser) {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, message->jid->resourcepart);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, message->jid->resourcepart,
+                    message->id, message->enc);
             } else {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, NULL);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, NULL, message->id,
+                    message->enc);
             }
         }
         prefs_free_string(pref_otr_log);
@@ -363,15 +385,19 @@ chat_log_pgp_msg_in(ProfMessage *message)
         char *pref_pgp_log = prefs_get_string(PREF_PGP_LOG);
         if (strcmp(pref_pgp_log, "on") == 0) {
             if (message->mucuser) {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, message->jid->resourcepart);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, message->jid->resourcepart,
+                    message->id, message->enc);
             } else {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, NULL);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, NULL, message->id,
+                    message->enc);
             }
         } else if (strcmp(pref_pgp_log, "redact") == 0) {
             if (message->mucuser) {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, message->jid->resourcepart);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, message->jid->resourcepart,
+                    message->id, message->enc);
             } else {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, NULL);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, NULL, message->id,
+                    message->enc);
             }
         }
         prefs_free_string(pref_pgp_log);
@@ -388,15 +414,19 @@ chat_log_omemo_msg_in(ProfMessage *message)
         char *pref_omemo_log = prefs_get_string(PREF_OMEMO_LOG);
         if (strcmp(pref_omemo_log, "on") == 0) {
             if (message->mucuser) {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, message->jid->resourcepart);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, message->jid->resourcepart,
+                    message->id, message->enc);
             } else {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, NULL);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, NULL, message->id,
+                    message->enc);
             }
         } else if (strcmp(pref_omemo_log, "redact") == 0) {
             if (message->mucuser) {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, message->jid->resourcepart);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, message->jid->resourcepart,
+                    message->id, message->enc);
             } else {
-                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, message->jid->resourcepart);
+                _chat_log_chat(jidp->barejid, message->jid->barejid, "[redacted]", PROF_IN_LOG, message->timestamp, message->jid->resourcepart,
+                    message->id, message->enc);
             }
         }
         prefs_free_string(pref_omemo_log);
@@ -412,18 +442,35 @@ chat_log_msg_in(ProfMessage *message)
         Jid *jidp = jid_create(jid);
 
         if (message->mucuser) {
-            _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, message->jid->resourcepart);
+            _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, message->jid->resourcepart,
+                message->id, message->enc);
         } else {
-            _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, NULL);
+            _chat_log_chat(jidp->barejid, message->jid->barejid, message->plain, PROF_IN_LOG, message->timestamp, NULL, message->id,
+                message->enc);
         }
         jid_destroy(jidp);
     }
 }
 
+void
+chat_log_msg_receipt(const char *const barejid, const char *const id)
+{
+    if (prefs_get_boolean(PREF_CHLOG)) {
+        const char *jid = connection_get_fulljid();
+        Jid *jidp = jid_create(jid);
+        log_database_mark_receipt(jidp->barejid, barejid, id);
+        jid_destroy(jidp);
+    }
+}
+
 static void
 _chat_log_chat(const char *const login, const char *const other, const char *const msg,
-    chat_log_direction_t direction, GDateTime *timestamp, const char *const resourcepart)
+    chat_log_direction_t direction, GDateTime *timestamp, const char *const resourcepart, const char *const id,
+    prof_enc_t enc)
 {
+    log_database_add(login, other, resourcepart, resourcepart ? PROF_DB_MUCPM : PROF_DB_CHAT, direction, timestamp,
+        id, enc, msg);
+
     char *other_name;
     GString *other_str = NULL;
 
@@ -502,30 +549,31 @@ _chat_log_chat(const char *const login, const char *const other, const char *con
 }
 
 void
-groupchat_log_msg_out(const gchar *const room, const gchar *const msg)
+groupchat_log_msg_out(const gchar *const room, const gchar *const msg, const char *const id)
 {
     if (prefs_get_boolean(PREF_GRLOG)) {
         const char *jid = connection_get_fulljid();
         Jid *jidp = jid_create(jid);
         char *mynick = muc_nick(room);
-        _groupchat_log_chat(jidp->barejid, room, mynick, msg);
+        _groupchat_log_chat(jidp->barejid, room, mynick, msg, PROF_OUT_LOG, NULL, id, PROF_MSG_ENC_PLAIN);
         jid_destroy(jidp);
     }
 }
 
 void
-groupchat_log_msg_in(const gchar *const room, const gchar *const nick, const gchar *const msg)
+groupchat_log_msg_in(const gchar *const room, const gchar *const nick, const gchar *const msg,
+    GDateTime *timestamp, const char *const id)
 {
     if (prefs_get_boolean(PREF_GRLOG)) {
         const char *jid = connection_get_fulljid();
         Jid *jidp = jid_create(jid);
-        _groupchat_log_chat(jidp->barejid, room, nick, msg);
+        _groupchat_log_chat(jidp->barejid, room, nick, msg, PROF_IN_LOG, timestamp, id, PROF_MSG_ENC_PLAIN);
         jid_destroy(jidp);
     }
 }
 
 void
-groupchat_log_omemo_msg_out(const gchar *const room, const gchar *const msg)
+groupchat_log_omemo_msg_out(const gchar *const room, const gchar *const msg, const char *const id)
 {
     if (prefs_get_boolean(PREF_CHLOG)) {
         const char *jid = connection_get_fulljid();
@@ -533,9 +581,10 @@ groupchat_log_omemo_msg_out(const gchar *const room, const gchar *const msg)
         char *pref_omemo_log = prefs_get_string(PREF_OMEMO_LOG);
         char *mynick = muc_nick(room);
         if (strcmp(pref_omemo_log, "on") == 0) {
-            _groupchat_log_chat(jidp->barejid, room, mynick, msg);
+            _groupchat_log_chat(jidp->barejid, room, mynick, msg, PROF_OUT_LOG, NULL, id, PROF_MSG_ENC_OMEMO);
         } else if (strcmp(pref_omemo_log, "redact") == 0) {
-            _groupchat_log_chat(jidp->barejid, room, mynick, "[redacted]");
+            _groupchat_log_chat(jidp->barejid, room, mynick, "[redacted]", PROF_OUT_LOG, NULL, id,
+                PROF_MSG_ENC_OMEMO);
         }
         prefs_free_string(pref_omemo_log);
         jid_destroy(jidp);
@@ -543,16 +592,18 @@ groupchat_log_omemo_msg_out(const gchar *const room, const gchar *const msg)
 }
 
 void
-groupchat_log_omemo_msg_in(const gchar *const room, const gchar *const nick, const gchar *const msg)
+groupchat_log_omemo_msg_in(const gchar *const room, const gchar *const nick, const gchar *const msg,
+    GDateTime *timestamp, const char *const id)
 {
     if (prefs_get_boolean(PREF_CHLOG)) {
         const char *jid = connection_get_fulljid();
         Jid *jidp = jid_create(jid);
         char *pref_omemo_log = prefs_get_string(PREF_OMEMO_LOG);
         if (strcmp(pref_omemo_log, "on") == 0) {
-            _groupchat_log_chat(jidp->barejid, room, nick, msg);
+            _groupchat_log_chat(jidp->barejid, room, nick, msg, PROF_IN_LOG, timestamp, id, PROF_MSG_ENC_OMEMO);
         } else if (strcmp(pref_omemo_log, "redact") == 0) {
-            _groupchat_log_chat(jidp->barejid, room, nick, "[redacted]");
+            _groupchat_log_chat(jidp->barejid, room, nick, "[redacted]", PROF_IN_LOG, timestamp, id,
+                PROF_MSG_ENC_OMEMO);
         }
         prefs_free_string(pref_omemo_log);
         jid_destroy(jidp);
@@ -561,8 +612,11 @@ groupchat_log_omemo_msg_in(const gchar *const room, const gchar *const nick, con
 
 void
 _groupchat_log_chat(const gchar *const login, const gchar *const room, const gchar *const nick,
-    const gchar *const msg)
+    const gchar *const msg, chat_log_direction_t direction, GDateTime *timestamp, const char *const id,
+    prof_enc_t enc)
 {
+    log_database_add(login, room, nick, PROF_DB_MUC, direction, timestamp, id, enc, msg);
+
     struct dated_chat_log *dated_log = g_hash_table_lookup(groupchat_logs, room);
 
     // no log for room
@@ -576,7 +630,12 @@ _groupchat_log_chat(const gchar *const login, const gchar *const room, const gch
         g_hash_table_replace(logs, strdup(room), dated_log);
     }
 
-    GDateTime *dt = g_date_time_new_now_local();
+    GDateTime *dt = NULL;
+    if (timestamp == NULL) {
+        dt = g_date_time_new_now_local();
+    } else {
+        dt = g_date_time_to_local(timestamp);
+    }
 
     gchar *date_fmt = g_date_time_format(dt, "%H:%M:%S");
 
@@ -600,6 +659,20 @@ _groupchat_log_chat(const gchar *const login, const gchar *const room, const gch
     g_date_time_unref(dt);
 }
 
+/*
+ * Start of the day the session was started, history shown in chat windows
+ * covers the time since then
+ */
+GDateTime*
+chat_log_get_history_start(void)
+{
+    return g_date_time_new(tz,
+        g_date_time_get_year(session_started),
+        g_date_time_get_month(session_started),
+        g_date_time_get_day_of_month(session_started),
+        0, 0, 0);
+}
+
 GSList*
 chat_log_get_previous(const gchar *const login, const gchar *const recipient)
 {
@@ -617,7 +690,7 @@ chat_log_get_previous(const gchar *const login, const gchar *const recipient)
     while (g_date_time_compare(log_date, now) != 1) {
         char *filename = _get_log_filename(recipient, login, log_date, FALSE);
 
-        FILE *logp = fopen(filename, "r");
+        FILE *logp = log_compress_open(filename);
         if (logp) {
             GString *header = g_string_new("");
             g_string_append_printf(header, "%d/%d/%d:",
@@ -651,6 +724,8 @@ chat_log_get_previous(const gchar *const login, const gchar *const recipient)
 void
 chat_log_close(void)
 {
+    log_compress_stop();
+    log_database_close();
     g_hash_table_destroy(logs);
     g_hash_table_destroy(groupchat_logs);
     g_date_time_unref(session_started);
@@ -0,0 +1,359 @@
+/*
+ * log_compress.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "log.h"
+#include "log_compress.h"
+
+// each block is written as an independent frame
+#define LOG_COMPRESS_BLOCK (128 * 1024)
+#define LOG_COMPRESS_LEVEL 9
+
+#ifdef HAVE_ZSTD
+typedef struct compress_job_t {
+    char *dir;
+    GDate *cutoff;
+} CompressJob;
+
+static pthread_t compress_thread;
+static gboolean compress_running = FALSE;
+static gint compress_cancel = 0;
+static gint compressed_files = 0;
+static gint failed_files = 0;
+
+static void* _log_compress_run(void *data);
+static void _log_compress_dir(ZSTD_CCtx *cctx, const char *const dir, const GDate *const cutoff);
+static gboolean _log_compress_due(const char *const name, const GDate *const cutoff);
+static gboolean _log_compress_file(ZSTD_CCtx *cctx, const char *const path);
+#endif
+
+static FILE* _log_compress_open(const char *const filename, gchar **error);
+
+void
+log_compress_start(const char *const dir, int days)
+{
+    log_compress_stop();
+
+    if (days <= 0) {
+        return;
+    }
+
+#ifdef HAVE_ZSTD
+    CompressJob *job = malloc(sizeof(CompressJob));
+    job->dir = strdup(dir);
+    job->cutoff = g_date_new();
+    g_date_set_time_t(job->cutoff, time(NULL));
+    g_date_subtract_days(job->cutoff, days);
+
+    g_atomic_int_set(&compress_cancel, 0);
+    if (pthread_create(&compress_thread, NULL, _log_compress_run, job) != 0) {
+        log_error("Could not start chat log compression");
+        free(job->dir);
+        g_date_free(job->cutoff);
+        free(job);
+        return;
+    }
+    compress_running = TRUE;
+    log_info("Compressing chat logs older than %d days", days);
+#else
+    log_info("Chat log compression not supported in this build");
+#endif
+}
+
+void
+log_compress_stop(void)
+{
+#ifdef HAVE_ZSTD
+    if (!compress_running) {
+        return;
+    }
+
+    g_atomic_int_set(&compress_cancel, 1);
+    pthread_join(compress_thread, NULL);
+    compress_running = FALSE;
+
+    int compressed = g_atomic_int_get(&compressed_files);
+    int failed = g_atomic_int_get(&failed_files);
+    g_atomic_int_set(&compressed_files, 0);
+    g_atomic_int_set(&failed_files, 0);
+    if (compressed > 0) {
+        log_info("Compressed %d chat logs", compressed);
+    }
+    if (failed > 0) {
+        log_error("Failed to compress %d chat logs", failed);
+    }
+#endif
+}
+
+FILE*
+log_compress_open(const char *const filename)
+{
+    gchar *error = NULL;
+    FILE *logp = _log_compress_open(filename, &error);
+    if (error) {
+        log_error("%s", error);
+        g_free(error);
+    }
+
+    return logp;
+}
+
+/*
+ * Open a log like log_compress_open, without logging, for use off the main
+ * thread, failed is set when a compressed log could not be read in full
+ */
+FILE*
+log_compress_read(const char *const filename, gboolean *failed)
+{
+    gchar *error = NULL;
+    FILE *logp = _log_compress_open(filename, &error);
+    *failed = error != NULL;
+    g_free(error);
+
+    return logp;
+}
+
+static FILE*
+_log_compress_open(const char *const filename, gchar **error)
+{
+    // a log being compressed keeps its plain file until the compressed one is complete
+    FILE *logp = fopen(filename, "r");
+    if (logp) {
+        return logp;
+    }
+
+#ifdef HAVE_ZSTD
+    gchar *compressed = g_strconcat(filename, LOG_COMPRESS_SUFFIX, NULL);
+    FILE *in = fopen(compressed, "r");
+    if (!in) {
+        g_free(compressed);
+        return NULL;
+    }
+
+    // decompressed next to the log, so it stays in the user's private
+    // chat log directory, and unlinked straight away
+    gchar *temp = g_strconcat(filename, ".XXXXXX", NULL);
+    int fd = g_mkstemp(temp);
+    FILE *out = fd != -1 ? fdopen(fd, "w+") : NULL;
+    if (fd != -1) {
+        unlink(temp);
+    }
+    g_free(temp);
+    if (!out) {
+        *error = g_strdup_printf("Could not create temporary file to read %s", compressed);
+        if (fd != -1) {
+            close(fd);
+        }
+        fclose(in);
+        g_free(compressed);
+        return NULL;
+    }
+
+    ZSTD_DStream *stream = ZSTD_createDStream();
+    ZSTD_initDStream(stream);
+    size_t in_size = ZSTD_DStreamInSize();
+    size_t out_size = ZSTD_DStreamOutSize();
+    char *in_buf = malloc(in_size);
+    char *out_buf = malloc(out_size);
+
+    gboolean ok = TRUE;
+    size_t read;
+    while (ok && (read = fread(in_buf, 1, in_size, in)) > 0) {
+        ZSTD_inBuffer input = { in_buf, read, 0 };
+        while (input.pos < input.size) {
+            ZSTD_outBuffer output = { out_buf, out_size, 0 };
+            size_t ret = ZSTD_decompressStream(stream, &output, &input);
+            if (ZSTD_isError(ret)) {
+                *error = g_strdup_printf("Could not decompress %s: %s", compressed, ZSTD_getErrorName(ret));
+                ok = FALSE;
+                break;
+            }
+            fwrite(out_buf, 1, output.pos, out);
+        }
+    }
+
+    free(in_buf);
+    free(out_buf);
+    ZSTD_freeDStream(stream);
+    fclose(in);
+    g_free(compressed);
+
+    // show whatever could be read from a damaged file
+    rewind(out);
+    return out;
+#else
+    return NULL;
+#endif
+}
+
+#ifdef HAVE_ZSTD
+static void*
+_log_compress_run(void *data)
+{
+    CompressJob *job = data;
+
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    _log_compress_dir(cctx, job->dir, job->cutoff);
+    ZSTD_freeCCtx(cctx);
+
+    free(job->dir);
+    g_date_free(job->cutoff);
+    free(job);
+
+    return NULL;
+}
+
+static void
+_log_compress_dir(ZSTD_CCtx *cctx, const char *const dir, const GDate *const cutoff)
+{
+    GDir *gdir = g_dir_open(dir, 0, NULL);
+    if (!gdir) {
+        return;
+    }
+
+    const gchar *name;
+    while (!g_atomic_int_get(&compress_cancel) && (name = g_dir_read_name(gdir)) != NULL) {
+        gchar *path = g_build_filename(dir, name, NULL);
+        if (g_file_test(path, G_FILE_TEST_IS_DIR)) {
+            _log_compress_dir(cctx, path, cutoff);
+        } else if (_log_compress_due(name, cutoff)) {
+            if (_log_compress_file(cctx, path)) {
+                g_atomic_int_inc(&compressed_files);
+            } else if (!g_atomic_int_get(&compress_cancel)) {
+                g_atomic_int_inc(&failed_files);
+            }
+        }
+        g_free(path);
+    }
+
+    g_dir_close(gdir);
+}
+
+static gboolean
+_log_compress_due(const char *const name, const GDate *const cutoff)
+{
+    // only dated logs, as named by _get_log_filename, are ever compressed
+    int year, month, day;
+    char trailing;
+    if (sscanf(name, "%4d_%2d_%2d.log%c", &year, &month, &day, &trailing) != 3) {
+        return FALSE;
+    }
+    if (!g_str_has_suffix(name, ".log") || !g_date_valid_dmy(day, month, year)) {
+        return FALSE;
+    }
+
+    GDate date;
+    g_date_clear(&date, 1);
+    g_date_set_dmy(&date, day, month, year);
+
+    return g_date_compare(&date, cutoff) < 0;
+}
+
+static gboolean
+_log_compress_file(ZSTD_CCtx *cctx, const char *const path)
+{
+    gchar *target = g_strconcat(path, LOG_COMPRESS_SUFFIX, NULL);
+    gchar *partial = g_strconcat(target, ".part", NULL);
+
+    FILE *in = fopen(path, "r");
+    FILE *out = in ? fopen(partial, "w") : NULL;
+    gboolean ok = in && out;
+    if (out) {
+        g_chmod(partial, S_IRUSR | S_IWUSR);
+    }
+
+    size_t bound = ZSTD_compressBound(LOG_COMPRESS_BLOCK);
+    char *in_buf = malloc(LOG_COMPRESS_BLOCK);
+    char *out_buf = malloc(bound);
+
+    while (ok) {
+        if (g_atomic_int_get(&compress_cancel)) {
+            ok = FALSE;
+            break;
+        }
+
+        size_t read = fread(in_buf, 1, LOG_COMPRESS_BLOCK, in);
+        if (read == 0) {
+            ok = !ferror(in);
+            break;
+        }
+
+        size_t written = ZSTD_compressCCtx(cctx, out_buf, bound, in_buf, read, LOG_COMPRESS_LEVEL);
+        if (ZSTD_isError(written) || fwrite(out_buf, 1, written, out) != written) {
+            ok = FALSE;
+        }
+    }
+
+    free(in_buf);
+    free(out_buf);
+    if (in) {
+        fclose(in);
+    }
+    if (out && fclose(out) != 0) {
+        ok = FALSE;
+    }
+
+    // the plain log is only removed once the compressed copy is in place
+    if (ok && rename(partial, target) == 0) {
+        unlink(path);
+    } else {
+        ok = FALSE;
+        if (out) {
+            unlink(partial);
+        }
+    }
+
+    g_free(partial);
+    g_free(target);
+
+    return ok;
+}
+#endif
@@ -36,6 +36,7 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <string.h>
 #include <glib.h>
 
@@ -58,11 +59,16 @@
 #include "profanity.h"
 #include "common.h"
 #include "command/cmd_defs.h"
+#include "xmpp/recorder.h"
 
 static gboolean version = FALSE;
 static char *log = "INFO";
 static char *account_name = NULL;
 static char *config_file = NULL;
+static char *record_file = NULL;
+static char *replay_file = NULL;
+static double replay_speed = 1.0;
+static gboolean trace_startup = FALSE;
 
 int
 main(int argc, char **argv)
@@ -78,6 +84,10 @@ main(int argc, char **argv)
         { "account", 'a', 0, G_OPTION_ARG_STRING, &account_name, "Auto connect to an account on startup" },
         { "log",'l', 0, G_OPTION_ARG_STRING, &log, "Set logging levels, DEBUG, INFO (default), WARN, ERROR", "LEVEL" },
         { "config",'c', 0, G_OPTION_ARG_STRING, &config_file, "Use an alternative configuration file", NULL },
+        { "record", 0, 0, G_OPTION_ARG_FILENAME, &record_file, "Record all sent and received stanzas to a file", "FILE" },
+        { "replay", 0, 0, G_OPTION_ARG_FILENAME, &replay_file, "Replay the received stanzas of a recording once connected", "FILE" },
+        { "replay-speed", 0, 0, G_OPTION_ARG_DOUBLE, &replay_speed, "Replay speed multiplier, 0 replays as fast as possible", "N" },
+        { "trace-startup", 0, 0, G_OPTION_ARG_NONE, &trace_startup, "Show the time spent in each startup phase", NULL },
         { NULL }
     };
 
@@ -170,10 +180,26 @@ main(int argc, char **argv)
         g_print("GTK icons: Disabled\n");
 #endif
 
+#ifdef HAVE_ZSTD
+        g_print("Chat log compression: Enabled\n");
+#else
+        g_print("Chat log compression: Disabled\n");
+#endif
+
         return 0;
     }
 
-    prof_run(log, account_name, config_file);
+    if (record_file && !recorder_record_start(record_file)) {
+        g_print("Could not open record file %s: %s\n", record_file, strerror(errno));
+        return 1;
+    }
+
+    if (replay_file && !recorder_replay_start(replay_file, replay_speed)) {
+        g_print("Could not open replay file %s: %s\n", replay_file, strerror(errno));
+        return 1;
+    }
+
+    prof_run(log, account_name, config_file, trace_startup);
 
     return 0;
 }
@@ -1440,7 +1440,7 @@ _load_identity(void)
             size_t pre_key_len;
             unsigned char *pre_key = g_base64_decode(pre_key_b64, &pre_key_len);
             g_free(pre_key_b64);
-            signal_buffer *buffer = signal_buffer_create(pre_key, pre_key_len);
+            signal_buffer *buffer = store_record_new(pre_key, pre_key_len);
             g_free(pre_key);
             g_hash_table_insert(omemo_ctx.pre_key_store, GINT_TO_POINTER(strtoul(keys[i], NULL, 10)), buffer);
         }
@@ -1462,7 +1462,7 @@ _load_identity(void)
             size_t signed_pre_key_len;
             unsigned char *signed_pre_key = g_base64_decode(signed_pre_key_b64, &signed_pre_key_len);
             g_free(signed_pre_key_b64);
-            signal_buffer *buffer = signal_buffer_create(signed_pre_key, signed_pre_key_len);
+            signal_buffer *buffer = store_record_new(signed_pre_key, signed_pre_key_len);
             g_free(signed_pre_key);
             g_hash_table_insert(omemo_ctx.signed_pre_key_store, GINT_TO_POINTER(strtoul(keys[i], NULL, 10)), buffer);
             omemo_ctx.signed_pre_key_id = strtoul(keys[i], NULL, 10);
@@ -1494,7 +1494,7 @@ _load_trust(void)
 
             trusted = g_hash_table_lookup(omemo_ctx.identity_key_store.trusted, groups[i]);
             if (!trusted) {
-                trusted = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)signal_buffer_free);
+                trusted = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)store_record_free);
                 g_hash_table_insert(omemo_ctx.identity_key_store.trusted, strdup(groups[i]), trusted);
             }
 
@@ -1505,7 +1505,7 @@ _load_trust(void)
                 size_t key_len;
                 unsigned char *key = g_base64_decode(key_b64, &key_len);
                 g_free(key_b64);
-                signal_buffer *buffer = signal_buffer_create(key, key_len);
+                signal_buffer *buffer = store_record_new(key, key_len);
                 g_free(key);
                 uint32_t device_id = strtoul(keys[j], NULL, 10);
                 g_hash_table_insert(trusted, GINT_TO_POINTER(device_id), buffer);
@@ -1528,7 +1528,7 @@ _load_sessions(void)
 
             device_store = g_hash_table_lookup(omemo_ctx.session_store, groups[i]);
             if (!device_store) {
-                device_store = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)signal_buffer_free);
+                device_store = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)store_record_free);
                 g_hash_table_insert(omemo_ctx.session_store, strdup(groups[i]), device_store);
             }
 
@@ -1539,7 +1539,7 @@ _load_sessions(void)
                 size_t record_len;
                 unsigned char *record = g_base64_decode(record_b64, &record_len);
                 g_free(record_b64);
-                signal_buffer *buffer = signal_buffer_create(record, record_len);
+                signal_buffer *buffer = store_record_new(record, record_len);
                 g_free(record);
                 g_hash_table_insert(device_store, GINT_TO_POINTER(id), buffer);
             }
@@ -38,9 +38,30 @@
 #include "config.h"
 #include "omemo/omemo.h"
 #include "omemo/store.h"
+#include "tools/memory.h"
 
 static void _g_hash_table_free(GHashTable *hash_table);
 
+signal_buffer*
+store_record_new(const uint8_t *data, size_t len)
+{
+    signal_buffer *buffer = signal_buffer_create(data, len);
+    if (buffer) {
+        memory_add(MEMORY_OMEMO, sizeof(size_t) + len, 1);
+    }
+
+    return buffer;
+}
+
+void
+store_record_free(signal_buffer *buffer)
+{
+    if (buffer) {
+        memory_add(MEMORY_OMEMO, -(gint64)(sizeof(size_t) + signal_buffer_len(buffer)), -1);
+        signal_buffer_free(buffer);
+    }
+}
+
 GHashTable *
 session_store_new(void)
 {
@@ -50,19 +71,19 @@ session_store_new(void)
 GHashTable *
 pre_key_store_new(void)
 {
-    return g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)signal_buffer_free);
+    return g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)store_record_free);
 }
 
 GHashTable *
 signed_pre_key_store_new(void)
 {
-    return g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)signal_buffer_free);
+    return g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)store_record_free);
 }
 
 void
 identity_key_store_new(identity_key_store_t *identity_key_store)
 {
-    identity_key_store->trusted = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)signal_buffer_free);
+    identity_key_store->trusted = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)_g_hash_table_free);
     identity_key_store->private = NULL;
     identity_key_store->public = NULL;
 }
@@ -136,11 +157,11 @@ store_session(const signal_protocol_address *address,
 
     device_store = g_hash_table_lookup(session_store, (void *)address->name);
     if (!device_store) {
-        device_store = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)signal_buffer_free);
+        device_store = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)store_record_free);
         g_hash_table_insert(session_store, strdup(address->name), device_store);
     }
 
-    signal_buffer *buffer = signal_buffer_create(record, record_len);
+    signal_buffer *buffer = store_record_new(record, record_len);
     g_hash_table_insert(device_store, GINT_TO_POINTER(address->device_id), buffer);
 
 
@@ -231,7 +252,7 @@ store_pre_key(uint32_t pre_key_id, uint8_t *record, size_t record_len,
 {
     GHashTable *pre_key_store = (GHashTable *)user_data;
 
-    signal_buffer *buffer = signal_buffer_create(record, record_len);
+    signal_buffer *buffer = store_record_new(record, record_len);
     g_hash_table_insert(pre_key_store, GINT_TO_POINTER(pre_key_id), buffer);
 
     /* Long term storage */
@@ -297,7 +318,7 @@ store_signed_pre_key(uint32_t signed_pre_key_id, uint8_t *record,
 {
     GHashTable *signed_pre_key_store = (GHashTable *)user_data;
 
-    signal_buffer *buffer = signal_buffer_create(record, record_len);
+    signal_buffer *buffer = store_record_new(record, record_len);
     g_hash_table_insert(signed_pre_key_store, GINT_TO_POINTER(signed_pre_key_id), buffer);
 
     /* Long term storage */
@@ -377,11 +398,11 @@ save_identity(const signal_protocol_address *address, uint8_t *key_data,
         }
     }
 
-    signal_buffer *buffer = signal_buffer_create(key_data, key_len);
+    signal_buffer *buffer = store_record_new(key_data, key_len);
 
     GHashTable *trusted = g_hash_table_lookup(identity_key_store->trusted, address->name);
     if (!trusted) {
-        trusted = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)signal_buffer_free);
+        trusted = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)store_record_free);
         g_hash_table_insert(identity_key_store->trusted, strdup(address->name), trusted);
     }
     g_hash_table_insert(trusted, GINT_TO_POINTER(address->device_id), buffer);
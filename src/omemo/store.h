@@ -57,6 +57,21 @@ GHashTable * pre_key_store_new(void);
 GHashTable * signed_pre_key_store_new(void);
 void identity_key_store_new(identity_key_store_t *identity_key_store);
 
+/**
+ * Copy a record to be kept in one of the stores, records are accounted
+ * as OMEMO memory until freed with store_record_free.
+ *
+ * @param data the serialized record
+ * @param len length of the serialized record
+ * @return the new buffer, NULL on failure
+ */
+signal_buffer* store_record_new(const uint8_t *data, size_t len);
+
+/**
+ * Free a record created with store_record_new.
+ */
+void store_record_free(signal_buffer *buffer);
+
 /**
  * Returns a copy of the serialized session record corresponding to the
  * provided recipient ID + device ID tuple.
@@ -60,6 +60,11 @@ static OtrlMessageAppOps ops;
 static char *jid;
 static gboolean data_loaded;
 static GHashTable *smp_initiators;
+// "account\ncontact\ninstance tag" -> ConnContext, contexts live as long as user_state
+static GHashTable *contexts;
+
+static ConnContext* _otr_context_find(const char *const recipient);
+static void _otr_contexts_clear(void);
 
 OtrlUserState
 otr_userstate(void)
@@ -194,6 +199,7 @@ otr_init(void)
 void
 otr_shutdown(void)
 {
+    _otr_contexts_clear();
     if (jid) {
         free(jid);
         jid = NULL;
@@ -231,10 +237,12 @@ otr_on_connect(ProfAccount *account)
         return;
     }
 
+    _otr_contexts_clear();
     if (user_state) {
         otrl_userstate_free(user_state);
     }
     user_state = otrl_userstate_create();
+    otrlib_init_timer();
 
     gcry_error_t err = 0;
 
@@ -347,7 +355,7 @@ otr_on_message_send(ProfChatWin *chatwin, const char *const message, gboolean re
         char *encrypted = otr_encrypt_message(chatwin->barejid, message);
         if (encrypted) {
             id = message_send_chat_otr(chatwin->barejid, encrypted, request_receipt);
-            chat_log_otr_msg_out(chatwin->barejid, message, NULL);
+            chat_log_otr_msg_out(chatwin->barejid, message, NULL, id);
             chatwin_outgoing_msg(chatwin, message, id, PROF_MSG_ENC_OTR, request_receipt);
             otr_free_message(encrypted);
             free(id);
@@ -369,7 +377,7 @@ otr_on_message_send(ProfChatWin *chatwin, const char *const message, gboolean re
         char *otr_tagged_msg = otr_tag_message(message);
         id = message_send_chat_otr(chatwin->barejid, otr_tagged_msg, request_receipt);
         chatwin_outgoing_msg(chatwin, message, id, PROF_MSG_ENC_PLAIN, request_receipt);
-        chat_log_msg_out(chatwin->barejid, message, NULL);
+        chat_log_msg_out(chatwin->barejid, message, NULL, id);
         free(otr_tagged_msg);
         free(id);
         return TRUE;
@@ -488,7 +496,7 @@ otr_tag_message(const char *const msg)
 gboolean
 otr_is_secure(const char *const recipient)
 {
-    ConnContext *context = otrlib_context_find(user_state, recipient, jid);
+    ConnContext *context = _otr_context_find(recipient);
 
     if (context == NULL) {
         return FALSE;
@@ -504,7 +512,7 @@ otr_is_secure(const char *const recipient)
 gboolean
 otr_is_trusted(const char *const recipient)
 {
-    ConnContext *context = otrlib_context_find(user_state, recipient, jid);
+    ConnContext *context = _otr_context_find(recipient);
 
     if (context == NULL) {
         return FALSE;
@@ -530,7 +538,7 @@ otr_is_trusted(const char *const recipient)
 void
 otr_trust(const char *const recipient)
 {
-    ConnContext *context = otrlib_context_find(user_state, recipient, jid);
+    ConnContext *context = _otr_context_find(recipient);
 
     if (context == NULL) {
         return;
@@ -554,7 +562,7 @@ otr_trust(const char *const recipient)
 void
 otr_untrust(const char *const recipient)
 {
-    ConnContext *context = otrlib_context_find(user_state, recipient, jid);
+    ConnContext *context = _otr_context_find(recipient);
 
     if (context == NULL) {
         return;
@@ -578,7 +586,7 @@ otr_untrust(const char *const recipient)
 void
 otr_smp_secret(const char *const recipient, const char *secret)
 {
-    ConnContext *context = otrlib_context_find(user_state, recipient, jid);
+    ConnContext *context = _otr_context_find(recipient);
 
     if (context == NULL) {
         return;
@@ -607,7 +615,7 @@ otr_smp_secret(const char *const recipient, const char *secret)
 void
 otr_smp_question(const char *const recipient, const char *question, const char *answer)
 {
-    ConnContext *context = otrlib_context_find(user_state, recipient, jid);
+    ConnContext *context = _otr_context_find(recipient);
 
     if (context == NULL) {
         return;
@@ -627,7 +635,7 @@ otr_smp_question(const char *const recipient, const char *question, const char *
 void
 otr_smp_answer(const char *const recipient, const char *answer)
 {
-    ConnContext *context = otrlib_context_find(user_state, recipient, jid);
+    ConnContext *context = _otr_context_find(recipient);
 
     if (context == NULL) {
         return;
@@ -660,7 +668,7 @@ otr_get_my_fingerprint(void)
 char*
 otr_get_their_fingerprint(const char *const recipient)
 {
-    ConnContext *context = otrlib_context_find(user_state, recipient, jid);
+    ConnContext *context = _otr_context_find(recipient);
 
     if (context) {
         Fingerprint *fingerprint = context->active_fingerprint;
@@ -756,7 +764,7 @@ otr_decrypt_message(const char *const from, const char *const message, gboolean
 
     // internal libotr message
     if (result == 1) {
-        ConnContext *context = otrlib_context_find(user_state, from, jid);
+        ConnContext *context = _otr_context_find(from);
 
         // common tlv handling
         OtrlTLV *tlv = otrl_tlv_find(tlvs, OTRL_TLV_DISCONNECTED);
@@ -797,3 +805,41 @@ otr_free_message(char *message)
 {
     otrl_message_free(message);
 }
+
+static ConnContext*
+_otr_context_find(const char *const recipient)
+{
+    if (user_state == NULL || jid == NULL) {
+        return NULL;
+    }
+
+    if (contexts == NULL) {
+        contexts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+
+    gchar *key = g_strdup_printf("%s\n%s\n%u", jid, recipient, otrlib_instag());
+    ConnContext *context = g_hash_table_lookup(contexts, key);
+    if (context) {
+        g_free(key);
+        return context;
+    }
+
+    // misses are not remembered, libotr may create the context later on
+    context = otrlib_context_find(user_state, recipient, jid);
+    if (context) {
+        g_hash_table_insert(contexts, key, context);
+    } else {
+        g_free(key);
+    }
+
+    return context;
+}
+
+static void
+_otr_contexts_clear(void)
+{
+    if (contexts) {
+        g_hash_table_destroy(contexts);
+        contexts = NULL;
+    }
+}
@@ -45,6 +45,7 @@ void otrlib_init_ops(OtrlMessageAppOps *ops);
 void otrlib_init_timer(void);
 void otrlib_poll(void);
 
+unsigned int otrlib_instag(void);
 ConnContext* otrlib_context_find(OtrlUserState user_state, const char *const recipient, char *jid);
 
 void otrlib_end_session(OtrlUserState user_state, const char *const recipient, char *jid, OtrlMessageAppOps *ops);
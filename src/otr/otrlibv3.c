@@ -77,6 +77,12 @@ otrlib_init_ops(OtrlMessageAppOps *ops)
     ops->display_otr_message = cb_display_otr_message;
 }
 
+unsigned int
+otrlib_instag(void)
+{
+    return 0;
+}
+
 ConnContext*
 otrlib_context_find(OtrlUserState user_state, const char *const recipient, char *jid)
 {
@@ -43,8 +43,10 @@
 #include "ui/ui.h"
 #include "ui/window_list.h"
 
-static GTimer *timer;
+// seconds between otrl_message_poll calls requested by libotr, 0 when there is nothing to expire
 static unsigned int current_interval;
+// monotonic time of the next poll, 0 when not scheduled
+static gint64 next_poll;
 
 OtrlPolicy
 otrlib_policy(void)
@@ -55,22 +57,29 @@ otrlib_policy(void)
 void
 otrlib_init_timer(void)
 {
-    OtrlUserState user_state = otr_userstate();
-    timer = g_timer_new();
-    current_interval = otrl_message_poll_get_default_interval(user_state);
+    // libotr asks for the timer through timer_control once a context needs it
+    current_interval = 0;
+    next_poll = 0;
 }
 
 void
 otrlib_poll(void)
 {
-    gdouble elapsed = g_timer_elapsed(timer, NULL);
+    if (next_poll == 0) {
+        return;
+    }
 
-    if (current_interval != 0 && elapsed > current_interval) {
-        OtrlUserState user_state = otr_userstate();
-        OtrlMessageAppOps *ops = otr_messageops();
-        otrl_message_poll(user_state, ops, NULL);
-        g_timer_start(timer);
+    gint64 now = g_get_monotonic_time();
+    if (now < next_poll) {
+        return;
     }
+
+    // reschedule first, polling may call timer_control
+    next_poll = now + current_interval * G_TIME_SPAN_SECOND;
+
+    OtrlUserState user_state = otr_userstate();
+    OtrlMessageAppOps *ops = otr_messageops();
+    otrl_message_poll(user_state, ops, NULL);
 }
 
 char*
@@ -107,6 +116,11 @@ static void
 cb_timer_control(void *opdata, unsigned int interval)
 {
     current_interval = interval;
+    if (interval == 0) {
+        next_poll = 0;
+    } else {
+        next_poll = g_get_monotonic_time() + interval * G_TIME_SPAN_SECOND;
+    }
 }
 
 static void
@@ -254,6 +268,12 @@ otrlib_init_ops(OtrlMessageAppOps *ops)
     ops->timer_control = cb_timer_control;
 }
 
+unsigned int
+otrlib_instag(void)
+{
+    return OTRL_INSTAG_MASTER;
+}
+
 ConnContext*
 otrlib_context_find(OtrlUserState user_state, const char *const recipient, char *jid)
 {
@@ -67,6 +67,7 @@ static char *passphrase;
 static char *passphrase_attempt;
 
 static Autocomplete key_ac;
+static gboolean key_ac_loaded;
 
 static char* _remove_header_footer(char *str, const char *const footer);
 static char* _add_header_footer(const char *const str, const char *const header, const char *const footer);
@@ -117,9 +118,9 @@ p_gpg_init(void)
 
     pubkeys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_p_gpg_free_pubkeyid);
 
+    // listing keys starts the gpg engine, so it is left until keys are first needed
     key_ac = autocomplete_new();
-    GHashTable *keys = p_gpg_list_keys();
-    p_gpg_free_keys(keys);
+    key_ac_loaded = FALSE;
 
     passphrase = NULL;
     passphrase_attempt = NULL;
@@ -401,6 +402,7 @@ p_gpg_list_keys(void)
         curr = curr->next;
     }
     g_list_free(ids);
+    key_ac_loaded = TRUE;
 
     return result;
 }
@@ -755,6 +757,11 @@ p_gpg_free_decrypted(char *decrypted)
 char*
 p_gpg_autocomplete_key(const char *const search_str, gboolean previous)
 {
+    if (!key_ac_loaded) {
+        GHashTable *keys = p_gpg_list_keys();
+        p_gpg_free_keys(keys);
+    }
+
     return autocomplete_complete(key_ac, search_str, TRUE, previous);
 }
 
@@ -161,6 +161,19 @@ api_register_timed(const char *const plugin_name, void *callback, int interval_s
     callbacks_add_timed(plugin_name, timed_function);
 }
 
+void
+api_register_events(const char *const plugin_name, void *callback, int interval_ms,
+    void (*callback_exec)(PluginEventsFunction *events_function, GPtrArray *events), void(*callback_destroy)(void *callback))
+{
+    PluginEventsFunction *events_function = malloc(sizeof(PluginEventsFunction));
+    events_function->callback = callback;
+    events_function->callback_exec = callback_exec;
+    events_function->callback_destroy = callback_destroy;
+    events_function->interval_ms = interval_ms < 0 ? 0 : interval_ms;
+
+    callbacks_add_events(plugin_name, events_function);
+}
+
 void
 api_completer_add(const char *const plugin_name, const char *key, char **items)
 {
@@ -380,6 +393,30 @@ api_win_show(const char *tag, const char *line)
     return 1;
 }
 
+int
+api_win_show_lines(const char *tag, char **lines)
+{
+    if (tag == NULL) {
+        log_warning("%s", "prof_win_show_lines failed, tag is NULL");
+        return 0;
+    }
+    if (lines == NULL) {
+        log_warning("%s", "prof_win_show_lines failed, lines is NULL");
+        return 0;
+    }
+
+    ProfPluginWin *pluginwin = wins_get_plugin(tag);
+    if (pluginwin == NULL) {
+        log_warning("prof_win_show_lines failed, no window with tag: %s", tag);
+        return 0;
+    }
+
+    ProfWin *window = (ProfWin*)pluginwin;
+    win_println_lines(window, THEME_DEFAULT, '!', lines);
+
+    return 1;
+}
+
 int
 api_win_show_themed(const char *tag, const char *const group, const char *const key, const char *const def, const char *line)
 {
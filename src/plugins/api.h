@@ -58,6 +58,8 @@ void api_register_command(const char *const plugin_name, const char *command_nam
     void *callback, void(*callback_func)(PluginCommand *command, gchar **args), void(*callback_destroy)(void *callback));
 void api_register_timed(const char *const plugin_name, void *callback, int interval_seconds,
     void (*callback_func)(PluginTimedFunction *timed_function), void(*callback_destroy)(void *callback));
+void api_register_events(const char *const plugin_name, void *callback, int interval_ms,
+    void (*callback_func)(PluginEventsFunction *events_function, GPtrArray *events), void(*callback_destroy)(void *callback));
 
 void api_completer_add(const char *const plugin_name, const char *key, char **items);
 void api_completer_remove(const char *const plugin_name, const char *key, char **items);
@@ -78,6 +80,7 @@ void api_win_create(
     void(*destroy)(void *callback));
 int api_win_focus(const char *tag);
 int api_win_show(const char *tag, const char *line);
+int api_win_show_lines(const char *tag, char **lines);
 int api_win_show_themed(const char *tag, const char *const group, const char *const key, const char *const def, const char *line);
 
 int api_send_stanza(const char *const stanza);
@@ -33,6 +33,7 @@
  *
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <glib.h>
@@ -40,9 +41,70 @@
 #include "tools/autocomplete.h"
 #include "command/cmd_ac.h"
 
+typedef struct plugin_ac_t {
+    char *key;
+    Autocomplete ac;
+} PluginAc;
+
 static GHashTable *plugin_to_acs;
 static GHashTable *plugin_to_filepath_acs;
 
+// command name to the PluginAc entries and filepath prefixes starting with it,
+// the keys, prefixes and autocompleters are owned by the tables above
+static GHashTable *command_to_acs;
+static GHashTable *command_to_filepaths;
+
+static void
+_free_index_list(GList *list)
+{
+    g_list_free_full(list, free);
+}
+
+static void
+_free_prefix_list(GList *list)
+{
+    g_list_free(list);
+}
+
+static char*
+_command_name(const char *const input)
+{
+    return g_strndup(input, strcspn(input, " "));
+}
+
+static void
+_index_ac(char *key, Autocomplete ac)
+{
+    char *command = _command_name(key);
+    GList *acs = g_hash_table_lookup(command_to_acs, command);
+
+    PluginAc *plugin_ac = malloc(sizeof(PluginAc));
+    plugin_ac->key = key;
+    plugin_ac->ac = ac;
+
+    // appending to a non empty list keeps its head
+    if (acs) {
+        g_list_append(acs, plugin_ac);
+        g_free(command);
+    } else {
+        g_hash_table_insert(command_to_acs, command, g_list_append(NULL, plugin_ac));
+    }
+}
+
+static void
+_index_filepath(char *prefix)
+{
+    char *command = _command_name(prefix);
+    GList *prefixes = g_hash_table_lookup(command_to_filepaths, command);
+
+    if (prefixes) {
+        g_list_append(prefixes, prefix);
+        g_free(command);
+    } else {
+        g_hash_table_insert(command_to_filepaths, command, g_list_append(NULL, prefix));
+    }
+}
+
 static void
 _free_autocompleters(GHashTable *key_to_ac)
 {
@@ -60,6 +122,8 @@ autocompleters_init(void)
 {
     plugin_to_acs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_autocompleters);
     plugin_to_filepath_acs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_filepath_autocompleters);
+    command_to_acs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_index_list);
+    command_to_filepaths = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_prefix_list);
 }
 
 void
@@ -73,14 +137,18 @@ autocompleters_add(const char *const plugin_name, const char *key, char **items)
         } else {
             Autocomplete new_ac = autocomplete_new();
             autocomplete_add_all(new_ac, items);
-            g_hash_table_insert(key_to_ac, strdup(key), new_ac);
+            char *new_key = strdup(key);
+            g_hash_table_insert(key_to_ac, new_key, new_ac);
+            _index_ac(new_key, new_ac);
         }
     } else {
         key_to_ac = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)autocomplete_free);
         Autocomplete new_ac = autocomplete_new();
         autocomplete_add_all(new_ac, items);
-        g_hash_table_insert(key_to_ac, strdup(key), new_ac);
+        char *new_key = strdup(key);
+        g_hash_table_insert(key_to_ac, new_key, new_ac);
         g_hash_table_insert(plugin_to_acs, strdup(plugin_name), key_to_ac);
+        _index_ac(new_key, new_ac);
     }
 }
 
@@ -120,67 +188,49 @@ void
 autocompleters_filepath_add(const char *const plugin_name, const char *prefix)
 {
     GHashTable *prefixes = g_hash_table_lookup(plugin_to_filepath_acs, plugin_name);
-    if (prefixes) {
-        g_hash_table_add(prefixes, strdup(prefix));
-    } else {
+    if (prefixes == NULL) {
         prefixes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
-        g_hash_table_add(prefixes, strdup(prefix));
         g_hash_table_insert(plugin_to_filepath_acs, strdup(plugin_name), prefixes);
+    } else if (g_hash_table_contains(prefixes, prefix)) {
+        return;
     }
+
+    char *new_prefix = strdup(prefix);
+    g_hash_table_add(prefixes, new_prefix);
+    _index_filepath(new_prefix);
 }
 
 char*
 autocompleters_complete(const char * const input, gboolean previous)
 {
     char *result = NULL;
+    char *command = _command_name(input);
 
-    GList *ac_hashes = g_hash_table_get_values(plugin_to_acs);
-    GList *curr_hash = ac_hashes;
-    while (curr_hash) {
-        GHashTable *key_to_ac = curr_hash->data;
-
-        GList *keys = g_hash_table_get_keys(key_to_ac);
-        GList *curr = keys;
-        while (curr) {
-            result = autocomplete_param_with_ac(input, curr->data, g_hash_table_lookup(key_to_ac, curr->data), TRUE, previous);
-            if (result) {
-                g_list_free(ac_hashes);
-                g_list_free(keys);
-                return result;
-            }
-            curr = g_list_next(curr);
+    GList *curr = g_hash_table_lookup(command_to_acs, command);
+    while (curr) {
+        PluginAc *plugin_ac = curr->data;
+        result = autocomplete_param_with_ac(input, plugin_ac->key, plugin_ac->ac, TRUE, previous);
+        if (result) {
+            g_free(command);
+            return result;
         }
-        g_list_free(keys);
-
-        curr_hash = g_list_next(curr_hash);
+        curr = g_list_next(curr);
     }
-    g_list_free(ac_hashes);
 
-    GList *filepath_hashes = g_hash_table_get_values(plugin_to_filepath_acs);
-    curr_hash = filepath_hashes;
-    while (curr_hash) {
-        GHashTable *prefixes_hash = curr_hash->data;
-        GList *prefixes = g_hash_table_get_keys(prefixes_hash);
-        GList *curr_prefix = prefixes;
-        while (curr_prefix) {
-            char *prefix = curr_prefix->data;
-            if (g_str_has_prefix(input, prefix)) {
-                result = cmd_ac_complete_filepath(input, prefix, previous);
-                if (result) {
-                    g_list_free(filepath_hashes);
-                    g_list_free(prefixes);
-                    return result;
-                }
+    curr = g_hash_table_lookup(command_to_filepaths, command);
+    while (curr) {
+        char *prefix = curr->data;
+        if (g_str_has_prefix(input, prefix)) {
+            result = cmd_ac_complete_filepath(input, prefix, previous);
+            if (result) {
+                g_free(command);
+                return result;
             }
-
-            curr_prefix = g_list_next(curr_prefix);
         }
-        g_list_free(prefixes);
-
-        curr_hash = g_list_next(curr_hash);
+        curr = g_list_next(curr);
     }
-    g_list_free(filepath_hashes);
 
+    g_free(command);
     return NULL;
 }
 
@@ -206,6 +256,10 @@ autocompleters_reset(void)
 
 void autocompleters_destroy(void)
 {
+    g_hash_table_destroy(command_to_acs);
+    g_hash_table_destroy(command_to_filepaths);
+    command_to_acs = NULL;
+    command_to_filepaths = NULL;
     g_hash_table_destroy(plugin_to_acs);
     g_hash_table_destroy(plugin_to_filepath_acs);
     plugin_to_acs = NULL;
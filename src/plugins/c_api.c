@@ -51,6 +51,10 @@ typedef struct timed_wrapper_t {
     void(*func)(void);
 } TimedWrapper;
 
+typedef struct events_wrapper_t {
+    void(*func)(PROF_EVENT *events, int count);
+} EventsWrapper;
+
 typedef struct window_wrapper_t {
     void(*func)(char *tag, char *line);
 } WindowWrapper;
@@ -110,6 +114,19 @@ c_api_register_timed(const char *filename, void(*callback)(void), int interval_s
     free(plugin_name);
 }
 
+static void
+c_api_register_events(const char *filename, void(*callback)(PROF_EVENT *events, int count), int interval_ms)
+{
+    char *plugin_name = _c_plugin_name(filename);
+    log_debug("Register events for %s", plugin_name);
+
+    EventsWrapper *wrapper = malloc(sizeof(EventsWrapper));
+    wrapper->func = callback;
+    api_register_events(plugin_name, wrapper, interval_ms, c_events_callback, free);
+
+    free(plugin_name);
+}
+
 static void
 c_api_completer_add(const char *filename, const char *key, char **items)
 {
@@ -256,6 +273,12 @@ c_api_win_show(char *tag, char *line)
     return api_win_show(tag, line);
 }
 
+static int
+c_api_win_show_lines(char *tag, char **lines)
+{
+    return api_win_show_lines(tag, lines);
+}
+
 static int
 c_api_win_show_themed(char *tag, char *group, char *key, char *def, char *line)
 {
@@ -450,6 +473,27 @@ c_timed_callback(PluginTimedFunction *timed_function)
     f();
 }
 
+void
+c_events_callback(PluginEventsFunction *events_function, GPtrArray *events)
+{
+    EventsWrapper *wrapper = events_function->callback;
+    void(*f)(PROF_EVENT *events, int count) = wrapper->func;
+
+    PROF_EVENT *c_events = malloc(sizeof(PROF_EVENT) * events->len);
+    guint i;
+    for (i = 0; i < events->len; i++) {
+        PluginEvent *event = g_ptr_array_index(events, i);
+        c_events[i].type = event->type;
+        c_events[i].barejid = event->barejid;
+        c_events[i].resource = event->resource;
+        c_events[i].message = event->message;
+        c_events[i].presence = event->presence;
+        c_events[i].priority = event->priority;
+    }
+    f(c_events, events->len);
+    free(c_events);
+}
+
 void
 c_window_callback(PluginWindowCallback *window_callback, char *tag, char *line)
 {
@@ -467,6 +511,7 @@ c_api_init(void)
     prof_cons_bad_cmd_usage = c_api_cons_bad_cmd_usage;
     _prof_register_command = c_api_register_command;
     _prof_register_timed = c_api_register_timed;
+    _prof_register_events = c_api_register_events;
     _prof_completer_add = c_api_completer_add;
     _prof_completer_remove = c_api_completer_remove;
     _prof_completer_clear = c_api_completer_clear;
@@ -487,6 +532,7 @@ c_api_init(void)
     prof_win_exists = c_api_win_exists;
     prof_win_focus = c_api_win_focus;
     prof_win_show = c_api_win_show;
+    prof_win_show_lines = c_api_win_show_lines;
     prof_win_show_themed = c_api_win_show_themed;
     prof_send_stanza = c_api_send_stanza;
     prof_settings_boolean_get = c_api_settings_boolean_get;
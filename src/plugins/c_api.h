@@ -42,6 +42,7 @@ void c_api_init(void);
 
 void c_command_callback(PluginCommand *command, gchar **args);
 void c_timed_callback(PluginTimedFunction *timed_function);
+void c_events_callback(PluginEventsFunction *events_function, GPtrArray *events);
 void c_window_callback(PluginWindowCallback *window_callback, char *tag, char *line);
 
 #endif
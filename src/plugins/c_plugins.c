@@ -34,6 +34,7 @@
  */
 
 #include <dlfcn.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
@@ -51,12 +52,74 @@
 #include "plugins/c_api.h"
 #include "ui/ui.h"
 
+// reads the libraries ahead of c_plugin_create
+static GThread *preload_thread = NULL;
+
+static gpointer _c_plugins_preload(gpointer data);
+
 void
 c_env_init(void)
 {
     c_api_init();
 }
 
+/*
+ * Read the libraries of the C plugins about to be loaded on a background
+ * thread, so the dlopen in c_plugin_create finds them in the page cache.
+ * dlopen itself stays on the main thread, plugin constructors may call into
+ * code that is not thread safe.
+ */
+void
+c_plugins_preload(GSList *filenames)
+{
+    char *plugins_dir = files_get_data_path(DIR_PLUGINS);
+    GSList *paths = NULL;
+    GSList *curr = filenames;
+    while (curr) {
+        if (g_str_has_suffix(curr->data, ".so")) {
+            paths = g_slist_append(paths, g_strdup_printf("%s/%s", plugins_dir, (char*)curr->data));
+        }
+        curr = g_slist_next(curr);
+    }
+    free(plugins_dir);
+
+    if (paths) {
+        preload_thread = g_thread_new("c-plugin-preload", _c_plugins_preload, paths);
+    }
+}
+
+void
+c_plugins_preload_release(void)
+{
+    if (preload_thread == NULL) {
+        return;
+    }
+
+    g_thread_join(preload_thread);
+    preload_thread = NULL;
+}
+
+static gpointer
+_c_plugins_preload(gpointer data)
+{
+    GSList *paths = data;
+    char buf[65536];
+
+    // failures are left for c_plugin_create to report, logging is not thread safe
+    GSList *curr = paths;
+    while (curr) {
+        FILE *fp = fopen(curr->data, "rb");
+        if (fp) {
+            while (fread(buf, 1, sizeof(buf), fp) == sizeof(buf));
+            fclose(fp);
+        }
+        curr = g_slist_next(curr);
+    }
+    g_slist_free_full(paths, g_free);
+
+    return NULL;
+}
+
 ProfPlugin*
 c_plugin_create(const char *const filename)
 {
@@ -39,6 +39,8 @@
 #include "plugins/plugins.h"
 
 void c_env_init(void);
+void c_plugins_preload(GSList *filenames);
+void c_plugins_preload_release(void);
 
 ProfPlugin* c_plugin_create(const char *const filename);
 void c_plugin_destroy(ProfPlugin *plugin);
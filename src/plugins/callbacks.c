@@ -47,8 +47,14 @@
 
 static GHashTable *p_commands = NULL;
 static GHashTable *p_timed_functions = NULL;
+static GHashTable *p_events_functions = NULL;
 static GHashTable *p_window_callbacks = NULL;
 
+// events held for a plugin before its batch is delivered early
+#define CALLBACKS_EVENTS_MAX 1000
+
+static void _callbacks_deliver_events(PluginEventsFunction *events_function);
+
 static void
 _free_window_callback(PluginWindowCallback *window_callback)
 {
@@ -131,11 +137,35 @@ _free_timed_function_list(GList *timed_functions)
     g_list_free_full(timed_functions, (GDestroyNotify)_free_timed_function);
 }
 
+static void
+_free_event(PluginEvent *event)
+{
+    free(event->type);
+    free(event->barejid);
+    free(event->resource);
+    free(event->message);
+    free(event->presence);
+    free(event);
+}
+
+static void
+_free_events_function(PluginEventsFunction *events_function)
+{
+    if (events_function->callback_destroy) {
+        events_function->callback_destroy(events_function->callback);
+    }
+
+    g_ptr_array_free(events_function->events, TRUE);
+
+    free(events_function);
+}
+
 void
 callbacks_init(void)
 {
     p_commands = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)_free_command_hash);
     p_timed_functions = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)_free_timed_function_list);
+    p_events_functions = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)_free_events_function);
     p_window_callbacks = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)_free_window_callbacks);
 }
 
@@ -157,6 +187,7 @@ callbacks_remove(const char *const plugin_name)
 
     g_hash_table_remove(p_commands, plugin_name);
     g_hash_table_remove(p_timed_functions, plugin_name);
+    g_hash_table_remove(p_events_functions, plugin_name);
 
     GHashTable *tag_to_win_cb_hash = g_hash_table_lookup(p_window_callbacks, plugin_name);
     if (tag_to_win_cb_hash) {
@@ -177,6 +208,7 @@ callbacks_close(void)
 {
     g_hash_table_destroy(p_commands);
     g_hash_table_destroy(p_timed_functions);
+    g_hash_table_destroy(p_events_functions);
     g_hash_table_destroy(p_window_callbacks);
 }
 
@@ -208,6 +240,51 @@ callbacks_add_timed(const char *const plugin_name, PluginTimedFunction *timed_fu
     }
 }
 
+/*
+ * A plugin has one batched event callback, registering again replaces it
+ */
+void
+callbacks_add_events(const char *const plugin_name, PluginEventsFunction *events_function)
+{
+    events_function->events = g_ptr_array_new_with_free_func((GDestroyNotify)_free_event);
+    events_function->last_run = g_get_monotonic_time();
+    g_hash_table_replace(p_events_functions, strdup(plugin_name), events_function);
+}
+
+/*
+ * Hold an event for every plugin collecting them, costs nothing when none do
+ */
+void
+callbacks_queue_event(const char *const type, const char *const barejid, const char *const resource,
+    const char *const message, const char *const presence, int priority)
+{
+    if (g_hash_table_size(p_events_functions) == 0) {
+        return;
+    }
+
+    GList *events_functions = g_hash_table_get_values(p_events_functions);
+    GList *curr = events_functions;
+    while (curr) {
+        PluginEventsFunction *events_function = curr->data;
+
+        PluginEvent *event = malloc(sizeof(PluginEvent));
+        event->type = strdup(type);
+        event->barejid = barejid ? strdup(barejid) : NULL;
+        event->resource = resource ? strdup(resource) : NULL;
+        event->message = message ? strdup(message) : NULL;
+        event->presence = presence ? strdup(presence) : NULL;
+        event->priority = priority;
+        g_ptr_array_add(events_function->events, event);
+
+        if (events_function->events->len >= CALLBACKS_EVENTS_MAX) {
+            _callbacks_deliver_events(events_function);
+        }
+
+        curr = g_list_next(curr);
+    }
+    g_list_free(events_functions);
+}
+
 gboolean
 callbacks_win_exists(const char *const plugin_name, const char *tag)
 {
@@ -271,25 +348,29 @@ callbacks_get_window_handler(const char *tag)
 gboolean
 plugins_run_command(const char * const input)
 {
-    gchar **split = g_strsplit(input, " ", -1);
+    ParserToken token;
+    if (parse_tokens(input, 0, &token, 1) == 0) {
+        return FALSE;
+    }
+    char command_name[token.len + 1];
+    memcpy(command_name, &input[token.start], token.len);
+    command_name[token.len] = '\0';
 
     GList *command_hashes = g_hash_table_get_values(p_commands);
     GList *curr_hash = command_hashes;
     while (curr_hash) {
         GHashTable *command_hash = curr_hash->data;
 
-        PluginCommand *command = g_hash_table_lookup(command_hash, split[0]);
+        PluginCommand *command = g_hash_table_lookup(command_hash, command_name);
         if (command) {
             gboolean result;
             gchar **args = parse_args_with_freetext(input, command->min_args, command->max_args, &result);
             if (result == FALSE) {
                 ui_invalid_command_usage(command->command_name, NULL);
-                g_strfreev(split);
                 g_list_free(command_hashes);
                 return TRUE;
             } else {
                 command->callback_exec(command, args);
-                g_strfreev(split);
                 g_strfreev(args);
                 g_list_free(command_hashes);
                 return TRUE;
@@ -300,7 +381,6 @@ plugins_run_command(const char * const input)
     }
 
     g_list_free(command_hashes);
-    g_strfreev(split);
     return FALSE;
 }
 
@@ -353,6 +433,46 @@ plugins_run_timed(void)
     g_list_free(timed_functions_lists);
 }
 
+/*
+ * Hand each plugin the events collected since its last batch, every main loop
+ * iteration or after the interval it registered with
+ */
+void
+plugins_run_events(void)
+{
+    if (g_hash_table_size(p_events_functions) == 0) {
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+
+    GList *events_functions = g_hash_table_get_values(p_events_functions);
+    GList *curr = events_functions;
+    while (curr) {
+        PluginEventsFunction *events_function = curr->data;
+        if (now - events_function->last_run >= (gint64)events_function->interval_ms * 1000) {
+            _callbacks_deliver_events(events_function);
+        }
+        curr = g_list_next(curr);
+    }
+    g_list_free(events_functions);
+}
+
+static void
+_callbacks_deliver_events(PluginEventsFunction *events_function)
+{
+    events_function->last_run = g_get_monotonic_time();
+    if (events_function->events->len == 0) {
+        return;
+    }
+
+    // events raised by the callback itself go into the next batch
+    GPtrArray *events = events_function->events;
+    events_function->events = g_ptr_array_new_with_free_func((GDestroyNotify)_free_event);
+    events_function->callback_exec(events_function, events);
+    g_ptr_array_free(events, TRUE);
+}
+
 GList*
 plugins_get_command_names(void)
 {
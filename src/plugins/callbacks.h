@@ -58,6 +58,25 @@ typedef struct p_timed_function {
     GTimer *timer;
 } PluginTimedFunction;
 
+// one received message, presence or stanza, as delivered to batched event callbacks
+typedef struct p_event {
+    char *type;
+    char *barejid;
+    char *resource;
+    char *message;
+    char *presence;
+    int priority;
+} PluginEvent;
+
+typedef struct p_events_function {
+    void *callback;
+    void (*callback_exec)(struct p_events_function *events_function, GPtrArray *events);
+    void (*callback_destroy)(void *callback);
+    int interval_ms;
+    gint64 last_run;
+    GPtrArray *events;
+} PluginEventsFunction;
+
 typedef struct p_window_input_callback {
     void *callback;
     void (*callback_exec)(struct p_window_input_callback *window_callback, const char *tag, const char * const line);
@@ -70,6 +89,9 @@ void callbacks_close(void);
 
 void callbacks_add_command(const char *const plugin_name, PluginCommand *command);
 void callbacks_add_timed(const char *const plugin_name, PluginTimedFunction *timed_function);
+void callbacks_add_events(const char *const plugin_name, PluginEventsFunction *events_function);
+void callbacks_queue_event(const char *const type, const char *const barejid, const char *const resource,
+    const char *const message, const char *const presence, int priority);
 gboolean callbacks_win_exists(const char *const plugin_name, const char *tag);
 void callbacks_add_window_handler(const char *const plugin_name, const char *tag, PluginWindowCallback *window_callback);
 void * callbacks_get_window_handler(const char *tag);
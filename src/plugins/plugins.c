@@ -64,6 +64,14 @@
 #endif
 
 static GHashTable *plugins;
+static GSList *pending_plugins;
+// loaded at startup, prof_on_start runs once all of them are initialised
+static GSList *unstarted_plugins;
+static GSList *load_times;
+static gboolean plugins_env_ready = FALSE;
+
+static void _plugins_env_init(void);
+static ProfPlugin* _plugins_create(const char *const name);
 
 void
 plugins_init(void)
@@ -74,61 +82,130 @@ plugins_init(void)
     plugin_themes_init();
     plugin_settings_init();
 
-#ifdef HAVE_PYTHON
-    python_env_init();
-#endif
-#ifdef HAVE_C
-    c_env_init();
-#endif
-
-    // load plugins
+    // interpreters and plugins are loaded by plugins_load_pending once the UI is up
+    pending_plugins = NULL;
+    unstarted_plugins = NULL;
+    load_times = NULL;
     gchar **plugins_pref = prefs_get_plugins();
     if (plugins_pref) {
         int i;
-        for (i = 0; i < g_strv_length(plugins_pref); i++)
-        {
-            gboolean loaded = FALSE;
-            gchar *filename = plugins_pref[i];
-#ifdef HAVE_PYTHON
-            if (g_str_has_suffix(filename, ".py")) {
-                ProfPlugin *plugin = python_plugin_create(filename);
-                if (plugin) {
-                    g_hash_table_insert(plugins, strdup(filename), plugin);
-                    loaded = TRUE;
-                }
-            }
+        for (i = 0; i < g_strv_length(plugins_pref); i++) {
+            pending_plugins = g_slist_append(pending_plugins, strdup(plugins_pref[i]));
+        }
+    }
+
+    prefs_free_plugins(plugins_pref);
+
+#ifdef HAVE_C
+    // read the C libraries from disk in the background meanwhile
+    c_plugins_preload(pending_plugins);
 #endif
+}
+
+/*
+ * Load and initialise the next plugin from the preferences, and once none are
+ * left run their prof_on_start. Returns TRUE while there is more to do.
+ */
+gboolean
+plugins_load_pending(void)
+{
+    if (pending_plugins == NULL) {
 #ifdef HAVE_C
-            if (g_str_has_suffix(filename, ".so")) {
-                ProfPlugin *plugin = c_plugin_create(filename);
-                if (plugin) {
-                    g_hash_table_insert(plugins, strdup(filename), plugin);
-                    loaded = TRUE;
-                }
-            }
+        c_plugins_preload_release();
 #endif
-            if (loaded) {
-                log_info("Loaded plugin: %s", filename);
-            } else {
-                log_info("Failed to load plugin: %s", filename);
+        GSList *curr = unstarted_plugins;
+        while (curr) {
+            // may have been unloaded by the user meanwhile
+            ProfPlugin *plugin = g_hash_table_lookup(plugins, curr->data);
+            if (plugin) {
+                plugin->on_start_func(plugin);
             }
+            curr = g_slist_next(curr);
         }
+        g_slist_free_full(unstarted_plugins, free);
+        unstarted_plugins = NULL;
 
-        // initialise plugins
-        GList *values = g_hash_table_get_values(plugins);
-        GList *curr = values;
-        while (curr) {
-            ProfPlugin *plugin = curr->data;
+        return FALSE;
+    }
+
+    char *filename = pending_plugins->data;
+    pending_plugins = g_slist_delete_link(pending_plugins, pending_plugins);
+
+    if (g_hash_table_lookup(plugins, filename)) {
+        free(filename);
+        return TRUE;
+    }
+
+    gint64 started = g_get_monotonic_time();
+    ProfPlugin *plugin = _plugins_create(filename);
+    if (plugin) {
+        g_hash_table_insert(plugins, strdup(filename), plugin);
+        if (connection_get_status() == JABBER_CONNECTED) {
+            const char *account_name = session_get_account_name();
+            const char *fulljid = connection_get_fulljid();
+            plugin->init_func(plugin, PACKAGE_VERSION, PACKAGE_STATUS, account_name, fulljid);
+        } else {
             plugin->init_func(plugin, PACKAGE_VERSION, PACKAGE_STATUS, NULL, NULL);
-            curr = g_list_next(curr);
         }
-        g_list_free(values);
+        unstarted_plugins = g_slist_append(unstarted_plugins, filename);
 
+        double elapsed_ms = (g_get_monotonic_time() - started) / 1000.0;
+        load_times = g_slist_append(load_times, g_strdup_printf("%-20s %10.2f ms", filename, elapsed_ms));
+        log_info("Loaded plugin: %s in %.2f ms", filename, elapsed_ms);
+    } else {
+        log_info("Failed to load plugin: %s", filename);
+        free(filename);
     }
 
-    prefs_free_plugins(plugins_pref);
+    return TRUE;
+}
+
+/*
+ * How long each plugin loaded at startup took to import and initialise, the
+ * list is handed to the caller to free
+ */
+GSList*
+plugins_take_load_times(void)
+{
+    GSList *times = load_times;
+    load_times = NULL;
 
-    return;
+    return times;
+}
+
+static void
+_plugins_env_init(void)
+{
+    if (plugins_env_ready) {
+        return;
+    }
+
+#ifdef HAVE_PYTHON
+    python_env_init();
+#endif
+#ifdef HAVE_C
+    c_env_init();
+#endif
+    plugins_env_ready = TRUE;
+}
+
+static ProfPlugin*
+_plugins_create(const char *const name)
+{
+    _plugins_env_init();
+
+#ifdef HAVE_PYTHON
+    if (g_str_has_suffix(name, ".py")) {
+        return python_plugin_create(name);
+    }
+#endif
+#ifdef HAVE_C
+    if (g_str_has_suffix(name, ".so")) {
+        return c_plugin_create(name);
+    }
+#endif
+
+    return NULL;
 }
 
 void
@@ -245,7 +322,7 @@ plugins_load(const char *const name, GString *error_message)
 
     if (g_str_has_suffix(name, ".py")) {
 #ifdef HAVE_PYTHON
-        plugin = python_plugin_create(name);
+        plugin = _plugins_create(name);
 #else
         g_string_assign(error_message, "Python plugins support is disabled.");
 #endif
@@ -253,7 +330,7 @@ plugins_load(const char *const name, GString *error_message)
 
     if (g_str_has_suffix(name, ".so")) {
 #ifdef HAVE_C
-        plugin = c_plugin_create(name);
+        plugin = _plugins_create(name);
 #else
         g_string_assign(error_message, "C plugins support is disabled.");
 #endif
@@ -431,19 +508,6 @@ plugins_close_win(const char *const plugin_name, const char *const tag)
     callbacks_remove_win(plugin_name, tag);
 }
 
-void
-plugins_on_start(void)
-{
-    GList *values = g_hash_table_get_values(plugins);
-    GList *curr = values;
-    while (curr) {
-        ProfPlugin *plugin = curr->data;
-        plugin->on_start_func(plugin);
-        curr = g_list_next(curr);
-    }
-    g_list_free(values);
-}
-
 void
 plugins_on_shutdown(void)
 {
@@ -509,6 +573,8 @@ plugins_pre_chat_message_display(const char * const barejid, const char *const r
 void
 plugins_post_chat_message_display(const char * const barejid, const char *const resource, const char *message)
 {
+    callbacks_queue_event("chat", barejid, resource, message, NULL, 0);
+
     GList *values = g_hash_table_get_values(plugins);
     GList *curr = values;
     while (curr) {
@@ -588,6 +654,8 @@ plugins_pre_room_message_display(const char * const barejid, const char * const
 void
 plugins_post_room_message_display(const char * const barejid, const char * const nick, const char *message)
 {
+    callbacks_queue_event("room", barejid, nick, message, NULL, 0);
+
     GList *values = g_hash_table_get_values(plugins);
     GList *curr = values;
     while (curr) {
@@ -693,6 +761,7 @@ void
 plugins_post_priv_message_display(const char * const fulljid, const char *message)
 {
     Jid *jidp = jid_create(fulljid);
+    callbacks_queue_event("private", jidp->barejid, jidp->resourcepart, message, NULL, 0);
 
     GList *values = g_hash_table_get_values(plugins);
     GList *curr = values;
@@ -782,6 +851,8 @@ plugins_on_message_stanza_send(const char *const text)
 gboolean
 plugins_on_message_stanza_receive(const char *const text)
 {
+    callbacks_queue_event("message_stanza", NULL, NULL, text, NULL, 0);
+
     gboolean cont = TRUE;
 
     GList *values = g_hash_table_get_values(plugins);
@@ -825,6 +896,8 @@ plugins_on_presence_stanza_send(const char *const text)
 gboolean
 plugins_on_presence_stanza_receive(const char *const text)
 {
+    callbacks_queue_event("presence_stanza", NULL, NULL, text, NULL, 0);
+
     gboolean cont = TRUE;
 
     GList *values = g_hash_table_get_values(plugins);
@@ -868,6 +941,8 @@ plugins_on_iq_stanza_send(const char *const text)
 gboolean
 plugins_on_iq_stanza_receive(const char *const text)
 {
+    callbacks_queue_event("iq_stanza", NULL, NULL, text, NULL, 0);
+
     gboolean cont = TRUE;
 
     GList *values = g_hash_table_get_values(plugins);
@@ -888,6 +963,8 @@ plugins_on_iq_stanza_receive(const char *const text)
 void
 plugins_on_contact_offline(const char *const barejid, const char *const resource, const char *const status)
 {
+    callbacks_queue_event("offline", barejid, resource, status, NULL, 0);
+
     GList *values = g_hash_table_get_values(plugins);
     GList *curr = values;
     while (curr) {
@@ -901,6 +978,8 @@ plugins_on_contact_offline(const char *const barejid, const char *const resource
 void
 plugins_on_contact_presence(const char *const barejid, const char *const resource, const char *const presence, const char *const status, const int priority)
 {
+    callbacks_queue_event("presence", barejid, resource, status, presence, priority);
+
     GList *values = g_hash_table_get_values(plugins);
     GList *curr = values;
     while (curr) {
@@ -946,6 +1025,10 @@ plugins_get_disco_features(void)
 void
 plugins_shutdown(void)
 {
+#ifdef HAVE_C
+    c_plugins_preload_release();
+#endif
+
     GList *values = g_hash_table_get_values(plugins);
     GList *curr = values;
 
@@ -964,12 +1047,21 @@ plugins_shutdown(void)
         curr = g_list_next(curr);
     }
     g_list_free(values);
+    if (plugins_env_ready) {
 #ifdef HAVE_PYTHON
-    python_shutdown();
+        python_shutdown();
 #endif
 #ifdef HAVE_C
-    c_shutdown();
+        c_shutdown();
 #endif
+        plugins_env_ready = FALSE;
+    }
+    g_slist_free_full(pending_plugins, free);
+    pending_plugins = NULL;
+    g_slist_free_full(unstarted_plugins, free);
+    unstarted_plugins = NULL;
+    g_slist_free_full(load_times, g_free);
+    load_times = NULL;
 
     autocompleters_destroy();
     plugin_themes_close();
@@ -107,6 +107,8 @@ typedef struct prof_plugin_t {
 } ProfPlugin;
 
 void plugins_init(void);
+gboolean plugins_load_pending(void);
+GSList* plugins_take_load_times(void);
 GSList *plugins_unloaded_list(void);
 GList *plugins_loaded_list(void);
 char* plugins_autocomplete(const char *const input, gboolean previous);
@@ -126,7 +128,6 @@ gboolean plugins_unload_all(void);
 gboolean plugins_reload(const char *const name, GString *error_message);
 void plugins_reload_all(void);
 
-void plugins_on_start(void);
 void plugins_on_shutdown(void);
 
 void plugins_on_connect(const char *const account_name, const char *const fulljid);
@@ -170,6 +171,7 @@ void plugins_on_room_win_focus(const char *const barejid);
 
 gboolean plugins_run_command(const char * const cmd);
 void plugins_run_timed(void);
+void plugins_run_events(void);
 GList* plugins_get_command_names(void);
 gchar * plugins_get_dir(void);
 CommandHelp* plugins_get_help(const char *const cmd);
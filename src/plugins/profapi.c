@@ -49,6 +49,8 @@ void (*_prof_register_command)(const char *filename, const char *command_name, i
 
 void (*_prof_register_timed)(const char *filename, TIMED_CB callback, int interval_seconds) = NULL;
 
+void (*_prof_register_events)(const char *filename, EVENTS_CB callback, int interval_ms) = NULL;
+
 void (*_prof_completer_add)(const char *filename, const char *key, char **items) = NULL;
 void (*_prof_completer_remove)(const char *filename, const char *key, char **items) = NULL;
 void (*_prof_completer_clear)(const char *filename, const char *key) = NULL;
@@ -75,6 +77,7 @@ void (*_prof_win_create)(const char *filename, PROF_WIN_TAG win, WINDOW_CB input
 int (*prof_win_exists)(PROF_WIN_TAG win) = NULL;
 int (*prof_win_focus)(PROF_WIN_TAG win) = NULL;
 int (*prof_win_show)(PROF_WIN_TAG win, char *line) = NULL;
+int (*prof_win_show_lines)(PROF_WIN_TAG win, char **lines) = NULL;
 int (*prof_win_show_themed)(PROF_WIN_TAG tag, char *group, char *key, char *def, char *line) = NULL;
 
 int (*prof_send_stanza)(char *stanza) = NULL;
@@ -38,6 +38,7 @@
 
 #define prof_register_command(command_name, min_args, max_args, synopsis, description, arguments, examples, callback) _prof_register_command(__FILE__, command_name, min_args, max_args, synopsis, description, arguments, examples, callback)
 #define prof_register_timed(callback, interval_seconds) _prof_register_timed(__FILE__, callback, interval_seconds)
+#define prof_register_events(callback, interval_ms) _prof_register_events(__FILE__, callback, interval_ms)
 #define prof_completer_add(key, items) _prof_completer_add(__FILE__, key, items)
 #define prof_completer_remove(key, items) _prof_completer_remove(__FILE__, key, items)
 #define prof_completer_clear(key) _prof_completer_clear(__FILE__, key)
@@ -50,6 +51,16 @@ typedef void(*CMD_CB)(char **args);
 typedef void(*TIMED_CB)(void);
 typedef void(*WINDOW_CB)(PROF_WIN_TAG win, char *line);
 
+typedef struct prof_event_t {
+    const char *type;
+    const char *barejid;
+    const char *resource;
+    const char *message;
+    const char *presence;
+    int priority;
+} PROF_EVENT;
+typedef void(*EVENTS_CB)(PROF_EVENT *events, int count);
+
 void (*prof_cons_alert)(void);
 int (*prof_cons_show)(const char * const message);
 int (*prof_cons_show_themed)(const char *const group, const char *const item, const char *const def, const char *const message);
@@ -61,6 +72,8 @@ void (*_prof_register_command)(const char *filename, const char *command_name, i
 
 void (*_prof_register_timed)(const char *filename, TIMED_CB callback, int interval_seconds);
 
+void (*_prof_register_events)(const char *filename, EVENTS_CB callback, int interval_ms);
+
 void (*_prof_completer_add)(const char *filename, const char *key, char **items);
 void (*_prof_completer_remove)(const char *filename, const char *key, char **items);
 void (*_prof_completer_clear)(const char *filename, const char *key);
@@ -87,6 +100,7 @@ void (*_prof_win_create)(const char *filename, PROF_WIN_TAG win, WINDOW_CB input
 int (*prof_win_exists)(PROF_WIN_TAG win);
 int (*prof_win_focus)(PROF_WIN_TAG win);
 int (*prof_win_show)(PROF_WIN_TAG win, char *line);
+int (*prof_win_show_lines)(PROF_WIN_TAG win, char **lines);
 int (*prof_win_show_themed)(PROF_WIN_TAG tag, char *group, char *key, char *def, char *line);
 
 int (*prof_send_stanza)(char *stanza);
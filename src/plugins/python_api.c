@@ -236,6 +236,30 @@ python_api_register_timed(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
+static PyObject *
+python_api_register_events(PyObject *self, PyObject *args)
+{
+    PyObject *p_callback = NULL;
+    int interval_ms = 0;
+
+    if (!PyArg_ParseTuple(args, "O|i", &p_callback, &interval_ms)) {
+        Py_RETURN_NONE;
+    }
+
+    char *plugin_name = _python_plugin_name();
+    log_debug("Register events for %s", plugin_name);
+
+    if (p_callback && PyCallable_Check(p_callback)) {
+        allow_python_threads();
+        api_register_events(plugin_name, p_callback, interval_ms, python_events_callback, NULL);
+        disable_python_threads();
+    }
+
+    free(plugin_name);
+
+    Py_RETURN_NONE;
+}
+
 static PyObject *
 python_api_completer_add(PyObject *self, PyObject *args)
 {
@@ -654,6 +678,56 @@ python_api_win_show(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
+static PyObject *
+python_api_win_show_lines(PyObject *self, PyObject *args)
+{
+    PyObject *tag = NULL;
+    PyObject *lines = NULL;
+
+    if (!PyArg_ParseTuple(args, "OO", &tag, &lines)) {
+        Py_RETURN_NONE;
+    }
+
+    char *tag_str = python_str_or_unicode_to_string(tag);
+
+    Py_ssize_t len = PyList_Size(lines);
+    if (len < 0) {
+        python_check_error();
+        free(tag_str);
+        Py_RETURN_NONE;
+    }
+
+    // items that are not strings are skipped, they would end the list early
+    char **c_lines = malloc(sizeof(char*) * (len + 1));
+    Py_ssize_t count = 0;
+    Py_ssize_t i = 0;
+    for (i = 0; i < len; i++) {
+        PyObject *item = PyList_GetItem(lines, i);
+#if PY_MAJOR_VERSION >= 3
+        gboolean is_str = PyUnicode_Check(item) || PyBytes_Check(item);
+#else
+        gboolean is_str = PyUnicode_Check(item) || PyString_Check(item);
+#endif
+        if (is_str) {
+            c_lines[count++] = python_str_or_unicode_to_string(item);
+        } else {
+            log_warning("win_show_lines: skipping item %zd, not a string", i);
+        }
+    }
+    c_lines[count] = NULL;
+
+    allow_python_threads();
+    api_win_show_lines(tag_str, c_lines);
+    free(tag_str);
+    for (i = 0; i < count; i++) {
+        free(c_lines[i]);
+    }
+    free(c_lines);
+    disable_python_threads();
+
+    Py_RETURN_NONE;
+}
+
 static PyObject *
 python_api_win_show_themed(PyObject *self, PyObject *args)
 {
@@ -1456,6 +1530,44 @@ python_timed_callback(PluginTimedFunction *timed_function)
     allow_python_threads();
 }
 
+/*
+ * Hand a batch of events to the plugin as one list of dicts
+ */
+void
+python_events_callback(PluginEventsFunction *events_function, GPtrArray *events)
+{
+    disable_python_threads();
+    PyObject *p_events = PyList_New(events->len);
+    guint i;
+    for (i = 0; i < events->len; i++) {
+        PluginEvent *event = g_ptr_array_index(events, i);
+        PyObject *p_event = Py_BuildValue("{s:s,s:s,s:s,s:s,s:s,s:i}",
+            "type", event->type,
+            "barejid", event->barejid,
+            "resource", event->resource,
+            "message", event->message,
+            "presence", event->presence,
+            "priority", event->priority);
+        if (p_event == NULL) {
+            python_check_error();
+            Py_INCREF(Py_None);
+            p_event = Py_None;
+        }
+        PyList_SET_ITEM(p_events, i, p_event);
+    }
+
+    PyObject *p_args = Py_BuildValue("(O)", p_events);
+    PyObject_CallObject(events_function->callback, p_args);
+    Py_XDECREF(p_args);
+    Py_XDECREF(p_events);
+
+    if (PyErr_Occurred()) {
+        PyErr_Print();
+        PyErr_Clear();
+    }
+    allow_python_threads();
+}
+
 void
 python_window_callback(PluginWindowCallback *window_callback, char *tag, char *line)
 {
@@ -1479,6 +1591,7 @@ static PyMethodDef apiMethods[] = {
     { "cons_bad_cmd_usage", python_api_cons_bad_cmd_usage, METH_VARARGS, "Show invalid command message in console" },
     { "register_command", python_api_register_command, METH_VARARGS, "Register a command." },
     { "register_timed", python_api_register_timed, METH_VARARGS, "Register a timed function." },
+    { "register_events", python_api_register_events, METH_VARARGS, "Register a function receiving events in batches." },
     { "completer_add", python_api_completer_add, METH_VARARGS, "Add items to an autocompleter." },
     { "completer_remove", python_api_completer_remove, METH_VARARGS, "Remove items from an autocompleter." },
     { "completer_clear", python_api_completer_clear, METH_VARARGS, "Remove all items from an autocompleter." },
@@ -1499,6 +1612,7 @@ static PyMethodDef apiMethods[] = {
     { "win_create", python_api_win_create, METH_VARARGS, "Create a new window." },
     { "win_focus", python_api_win_focus, METH_VARARGS, "Focus a window." },
     { "win_show", python_api_win_show, METH_VARARGS, "Show text in the window." },
+    { "win_show_lines", python_api_win_show_lines, METH_VARARGS, "Show several lines of text in the window." },
     { "win_show_themed", python_api_win_show_themed, METH_VARARGS, "Show themed text in the window." },
     { "send_stanza", python_api_send_stanza, METH_VARARGS, "Send an XMPP stanza." },
     { "settings_boolean_get", python_api_settings_boolean_get, METH_VARARGS, "Get a boolean setting." },
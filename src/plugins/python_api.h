@@ -42,6 +42,7 @@ void python_shutdown(void);
 
 void python_command_callback(PluginCommand *command, gchar **args);
 void python_timed_callback(PluginTimedFunction *timed_function);
+void python_events_callback(PluginEventsFunction *events_function, GPtrArray *events);
 void python_window_callback(PluginWindowCallback *window_callback, char *tag, char *line);
 
 char* python_str_or_unicode_to_string(void *obj);
@@ -61,6 +61,8 @@
 #include "config/tlscerts.h"
 #include "config/scripts.h"
 #include "command/cmd_defs.h"
+#include "tools/http_client.h"
+#include "tools/memory.h"
 #include "plugins/plugins.h"
 #include "event/client_events.h"
 #include "ui/ui.h"
@@ -71,6 +73,7 @@
 #include "xmpp/muc.h"
 #include "xmpp/chat_session.h"
 #include "xmpp/chat_state.h"
+#include "xmpp/jid.h"
 #include "xmpp/contact.h"
 #include "xmpp/roster_list.h"
 
@@ -89,23 +92,49 @@
 static void _init(char *log_level, char *config_file);
 static void _shutdown(void);
 static void _connect_default(const char * const account);
+static void _trace_phase(const char *const phase);
+static void _trace_report(void);
+static void _memory_check(void);
 
 static gboolean cont = TRUE;
 static gboolean force_quit = FALSE;
 
+static gboolean trace_startup = FALSE;
+static gint64 trace_started;
+static gint64 trace_mark;
+static GSList *trace_phases = NULL;
+
+// seconds between checks of the window memory budget
+#define MEMORY_CHECK_PERIOD 10
+static gint64 memory_checked;
+static gint64 memory_logged;
+
 void
-prof_run(char *log_level, char *account_name, char *config_file)
+prof_run(char *log_level, char *account_name, char *config_file, gboolean trace)
 {
+    trace_startup = trace;
+    trace_started = g_get_monotonic_time();
+    trace_mark = trace_started;
+
     _init(log_level, config_file);
-    plugins_on_start();
     _connect_default(account_name);
+    _trace_phase("connect");
 
     ui_update();
+    _trace_phase("first frame");
+    _trace_report();
 
     log_info("Starting main event loop");
 
     session_init_activity();
 
+    memory_checked = g_get_monotonic_time();
+    memory_logged = memory_checked;
+
+    // plugins load one per iteration so the UI keeps responding meanwhile
+    gboolean plugins_pending = TRUE;
+    gint64 plugins_started = g_get_monotonic_time();
+
     char *line = NULL;
     while(cont && !force_quit) {
         log_stderr_handler();
@@ -124,9 +153,31 @@ prof_run(char *log_level, char *account_name, char *config_file)
 #ifdef HAVE_LIBOTR
         otr_poll();
 #endif
+        if (plugins_pending) {
+            plugins_pending = plugins_load_pending();
+            if (plugins_pending) {
+                inp_nonblocking(TRUE);
+            } else {
+                GSList *load_times = plugins_take_load_times();
+                if (trace_startup) {
+                    cons_show("Startup trace: plugins loaded after %.2f ms",
+                        (g_get_monotonic_time() - plugins_started) / 1000.0);
+                    GSList *curr = load_times;
+                    while (curr) {
+                        cons_show("  %s", curr->data);
+                        curr = g_slist_next(curr);
+                    }
+                    cons_show("");
+                }
+                g_slist_free_full(load_times, g_free);
+            }
+        }
         plugins_run_timed();
         notify_remind();
+        _memory_check();
         session_process_events();
+        plugins_run_events();
+        http_client_process();
         iq_autoping_check();
         ui_update();
 #ifdef HAVE_GTK
@@ -173,6 +224,7 @@ _init(char *log_level, char *config_file)
     files_create_directories();
     log_level_t prof_log_level = log_level_from_string(log_level);
     prefs_load(config_file);
+    _trace_phase("preferences");
     log_init(prof_log_level);
     log_stderr_init(PROF_LEVEL_ERROR);
     if (strcmp(PACKAGE_STATUS, "development") == 0) {
@@ -184,35 +236,116 @@ _init(char *log_level, char *config_file)
     } else {
         log_info("Starting Profanity (%s)...", PACKAGE_VERSION);
     }
+    _trace_phase("logging");
     chat_log_init();
     groupchat_log_init();
+    _trace_phase("chat logs");
     accounts_load();
+    _trace_phase("accounts");
     char *theme = prefs_get_string(PREF_THEME);
     theme_init(theme);
     prefs_free_string(theme);
+    _trace_phase("theme");
+    http_client_init();
     ui_init();
+    _trace_phase("ui");
     session_init();
     cmd_init();
+    _trace_phase("commands");
     log_info("Initialising contact list");
     muc_init();
     tlscerts_init();
     scripts_init();
+    _trace_phase("muc, certs, scripts");
 #ifdef HAVE_LIBOTR
     otr_init();
+    _trace_phase("otr");
 #endif
 #ifdef HAVE_LIBGPGME
     p_gpg_init();
+    _trace_phase("pgp");
 #endif
 #ifdef HAVE_OMEMO
     omemo_init();
+    _trace_phase("omemo");
 #endif
     atexit(_shutdown);
     plugins_init();
+    _trace_phase("plugins");
 #ifdef HAVE_GTK
     tray_init();
+    _trace_phase("tray");
 #endif
     inp_nonblocking(TRUE);
     ui_resize();
+    _trace_phase("resize");
+}
+
+static void
+_trace_phase(const char *const phase)
+{
+    if (!trace_startup) {
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    trace_phases = g_slist_append(trace_phases,
+        g_strdup_printf("%-20s %10.2f ms", phase, (now - trace_mark) / 1000.0));
+    trace_mark = now;
+}
+
+static void
+_trace_report(void)
+{
+    if (!trace_startup) {
+        return;
+    }
+
+    cons_show("Startup trace:");
+    GSList *curr = trace_phases;
+    while (curr) {
+        cons_show("  %s", curr->data);
+        log_info("Startup trace: %s", curr->data);
+        curr = g_slist_next(curr);
+    }
+    cons_show("  %-20s %10.2f ms", "total", (g_get_monotonic_time() - trace_started) / 1000.0);
+    cons_show("");
+
+    g_slist_free_full(trace_phases, g_free);
+    trace_phases = NULL;
+}
+
+/*
+ * Trim the history of windows over the memory budget and log the memory
+ * used by each subsystem, at most every MEMORY_CHECK_PERIOD seconds
+ */
+static void
+_memory_check(void)
+{
+    gint64 now = g_get_monotonic_time();
+    if (now - memory_checked < MEMORY_CHECK_PERIOD * G_USEC_PER_SEC) {
+        return;
+    }
+    memory_checked = now;
+
+    gint budget = prefs_get_memory_budget();
+    if (budget > 0) {
+        gint64 budget_bytes = (gint64)budget * 1024;
+        if (memory_bytes(MEMORY_BUFFERS) + memory_bytes(MEMORY_PADS) > budget_bytes) {
+            int trimmed = wins_trim(budget_bytes);
+            if (trimmed > 0) {
+                log_info("Memory budget of %d KB exceeded, trimmed %d windows", budget, trimmed);
+            }
+        }
+    }
+
+    gint log_minutes = prefs_get_memory_log();
+    if (log_minutes > 0 && now - memory_logged >= (gint64)log_minutes * 60 * G_USEC_PER_SEC) {
+        memory_logged = now;
+        char *summary = memory_summary();
+        log_info("Memory: %s", summary);
+        g_free(summary);
+    }
 }
 
 static void
@@ -234,6 +367,7 @@ _shutdown(void)
     tray_shutdown();
 #endif
     session_shutdown();
+    http_client_close();
     plugins_on_shutdown();
     muc_close();
     caps_close();
@@ -247,6 +381,7 @@ _shutdown(void)
     omemo_close();
 #endif
     chat_log_close();
+    jid_cache_clear();
     theme_close();
     accounts_close();
     tlscerts_close();
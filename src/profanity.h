@@ -40,7 +40,7 @@
 #include <pthread.h>
 #include <glib.h>
 
-void prof_run(char *log_level, char *account_name, char * config_file);
+void prof_run(char *log_level, char *account_name, char * config_file, gboolean trace_startup);
 void prof_set_quit(void);
 
 pthread_mutex_t lock;
@@ -0,0 +1,336 @@
+/*
+ * http_client.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <curl/curl.h>
+#include <glib.h>
+
+#include "log.h"
+#include "config/preferences.h"
+#include "tools/http_client.h"
+
+#define HTTP_CLIENT_USER_AGENT "profanity"
+#define HTTP_CLIENT_CONNECT_TIMEOUT 10L
+
+// uploads have no overall timeout, but give up when stalled for this long
+#define HTTP_CLIENT_STALL_TIME 60L
+
+// poll interval while curl has no socket to wait on, e.g. during name resolution
+#define HTTP_CLIENT_IDLE_POLL 100L
+
+struct http_request_t {
+    CURL *handle;
+    struct curl_slist *headers;
+    char *buffer;
+    size_t size;
+    char error[CURL_ERROR_SIZE];
+    HttpProgressCallback progress;
+    HttpDoneCallback done;
+    void *userdata;
+    GDestroyNotify destroy;
+};
+
+static CURLM *multi = NULL;
+static GSList *requests = NULL;
+
+static HttpRequest* _http_request_new(const char *const url, HttpDoneCallback done, void *userdata,
+    GDestroyNotify destroy);
+static void _http_request_start(HttpRequest *request);
+static void _http_request_free(HttpRequest *request);
+static size_t _http_write(void *ptr, size_t size, size_t nmemb, void *data);
+static int _http_xferinfo(void *userdata, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+#if LIBCURL_VERSION_NUM < 0x072000
+static int _http_older_progress(void *userdata, double dltotal, double dlnow, double ultotal, double ulnow);
+#endif
+
+void
+http_client_init(void)
+{
+    curl_global_init(CURL_GLOBAL_ALL);
+    // a single multi handle keeps connections open for reuse between requests
+    multi = curl_multi_init();
+}
+
+void
+http_client_close(void)
+{
+    while (requests) {
+        http_client_cancel(requests->data);
+    }
+    if (multi) {
+        curl_multi_cleanup(multi);
+        multi = NULL;
+    }
+    curl_global_cleanup();
+}
+
+/*
+ * Start a GET request, done is called from http_client_process once it has
+ * finished. userdata is released with destroy when the request is freed,
+ * whether it finished or was cancelled
+ */
+HttpRequest*
+http_client_get(const char *const url, long timeout, HttpDoneCallback done, void *userdata,
+    GDestroyNotify destroy)
+{
+    HttpRequest *request = _http_request_new(url, done, userdata, destroy);
+    if (timeout > 0) {
+        curl_easy_setopt(request->handle, CURLOPT_TIMEOUT, timeout);
+    }
+    _http_request_start(request);
+
+    return request;
+}
+
+HttpRequest*
+http_client_put_file(const char *const url, FILE *file, curl_off_t size, const char *const content_type,
+    HttpProgressCallback progress, HttpDoneCallback done, void *userdata, GDestroyNotify destroy)
+{
+    HttpRequest *request = _http_request_new(url, done, userdata, destroy);
+    request->progress = progress;
+
+    curl_easy_setopt(request->handle, CURLOPT_CUSTOMREQUEST, "PUT");
+
+    gchar *content_type_header = g_strdup_printf("Content-Type: %s", content_type);
+    request->headers = curl_slist_append(request->headers, content_type_header);
+    request->headers = curl_slist_append(request->headers, "Expect:");
+    g_free(content_type_header);
+    curl_easy_setopt(request->handle, CURLOPT_HTTPHEADER, request->headers);
+
+    if (progress) {
+#if LIBCURL_VERSION_NUM >= 0x072000
+        curl_easy_setopt(request->handle, CURLOPT_XFERINFOFUNCTION, _http_xferinfo);
+        curl_easy_setopt(request->handle, CURLOPT_XFERINFODATA, request);
+#else
+        curl_easy_setopt(request->handle, CURLOPT_PROGRESSFUNCTION, _http_older_progress);
+        curl_easy_setopt(request->handle, CURLOPT_PROGRESSDATA, request);
+#endif
+        curl_easy_setopt(request->handle, CURLOPT_NOPROGRESS, 0L);
+    }
+
+    curl_easy_setopt(request->handle, CURLOPT_READDATA, file);
+    curl_easy_setopt(request->handle, CURLOPT_INFILESIZE_LARGE, size);
+    curl_easy_setopt(request->handle, CURLOPT_UPLOAD, 1L);
+    curl_easy_setopt(request->handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+    curl_easy_setopt(request->handle, CURLOPT_LOW_SPEED_TIME, HTTP_CLIENT_STALL_TIME);
+
+    _http_request_start(request);
+
+    return request;
+}
+
+/*
+ * Abort a request, its done callback will not be called but its userdata is
+ * still released
+ */
+void
+http_client_cancel(HttpRequest *request)
+{
+    if (g_slist_find(requests, request) == NULL) {
+        return;
+    }
+
+    curl_multi_remove_handle(multi, request->handle);
+    requests = g_slist_remove(requests, request);
+    _http_request_free(request);
+}
+
+/*
+ * Add the sockets of running transfers to the sets the input loop waits on,
+ * and shorten the wait when curl has a timeout to handle sooner
+ */
+void
+http_client_fdset(fd_set *read_fds, fd_set *write_fds, fd_set *exc_fds, long *timeout)
+{
+    if (requests == NULL) {
+        return;
+    }
+
+    int max_fd = -1;
+    curl_multi_fdset(multi, read_fds, write_fds, exc_fds, &max_fd);
+
+    long curl_timeout = -1;
+    curl_multi_timeout(multi, &curl_timeout);
+    if (max_fd == -1 && (curl_timeout < 0 || curl_timeout > HTTP_CLIENT_IDLE_POLL)) {
+        curl_timeout = HTTP_CLIENT_IDLE_POLL;
+    }
+
+    if (curl_timeout >= 0 && curl_timeout < *timeout) {
+        *timeout = curl_timeout;
+    }
+}
+
+/*
+ * Drive running transfers and call the done callback of finished ones,
+ * returns TRUE while transfers are still running
+ */
+gboolean
+http_client_process(void)
+{
+    if (requests == NULL) {
+        return FALSE;
+    }
+
+    int running = 0;
+    curl_multi_perform(multi, &running);
+
+    CURLMsg *msg = NULL;
+    int queued = 0;
+    while ((msg = curl_multi_info_read(multi, &queued)) != NULL) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        CURL *handle = msg->easy_handle;
+        CURLcode result = msg->data.result;
+
+        HttpRequest *request = NULL;
+        curl_easy_getinfo(handle, CURLINFO_PRIVATE, (char**)&request);
+        curl_multi_remove_handle(multi, handle);
+        requests = g_slist_remove(requests, request);
+
+        HttpResponse response;
+        response.status = 0;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response.status);
+        response.body = request->buffer;
+        response.size = request->size;
+        response.error = NULL;
+        if (result != CURLE_OK) {
+            response.error = request->error[0] != '\0' ? request->error : curl_easy_strerror(result);
+            log_debug("HTTP request failed: %s", response.error);
+        }
+
+        if (request->done) {
+            request->done(&response, request->userdata);
+        }
+        _http_request_free(request);
+    }
+
+    return requests != NULL;
+}
+
+static HttpRequest*
+_http_request_new(const char *const url, HttpDoneCallback done, void *userdata, GDestroyNotify destroy)
+{
+    HttpRequest *request = malloc(sizeof(struct http_request_t));
+    request->handle = curl_easy_init();
+    request->headers = NULL;
+    request->buffer = NULL;
+    request->size = 0;
+    request->error[0] = '\0';
+    request->progress = NULL;
+    request->done = done;
+    request->userdata = userdata;
+    request->destroy = destroy;
+
+    curl_easy_setopt(request->handle, CURLOPT_URL, url);
+    curl_easy_setopt(request->handle, CURLOPT_PRIVATE, request);
+    curl_easy_setopt(request->handle, CURLOPT_ERRORBUFFER, request->error);
+    curl_easy_setopt(request->handle, CURLOPT_WRITEFUNCTION, _http_write);
+    curl_easy_setopt(request->handle, CURLOPT_WRITEDATA, request);
+    curl_easy_setopt(request->handle, CURLOPT_USERAGENT, HTTP_CLIENT_USER_AGENT);
+    curl_easy_setopt(request->handle, CURLOPT_CONNECTTIMEOUT, HTTP_CLIENT_CONNECT_TIMEOUT);
+    curl_easy_setopt(request->handle, CURLOPT_NOSIGNAL, 1L);
+
+    char *cert_path = prefs_get_string(PREF_TLS_CERTPATH);
+    if (cert_path) {
+        curl_easy_setopt(request->handle, CURLOPT_CAPATH, cert_path);
+    }
+    prefs_free_string(cert_path);
+
+    return request;
+}
+
+static void
+_http_request_start(HttpRequest *request)
+{
+    requests = g_slist_append(requests, request);
+    curl_multi_add_handle(multi, request->handle);
+
+    // get name resolution and connecting going straight away
+    int running = 0;
+    curl_multi_perform(multi, &running);
+}
+
+static void
+_http_request_free(HttpRequest *request)
+{
+    curl_easy_cleanup(request->handle);
+    curl_slist_free_all(request->headers);
+    free(request->buffer);
+    if (request->destroy) {
+        request->destroy(request->userdata);
+    }
+    free(request);
+}
+
+static size_t
+_http_write(void *ptr, size_t size, size_t nmemb, void *data)
+{
+    size_t realsize = size * nmemb;
+    HttpRequest *request = (HttpRequest*)data;
+
+    char *buffer = realloc(request->buffer, request->size + realsize + 1);
+    if (buffer == NULL) {
+        return 0;
+    }
+
+    request->buffer = buffer;
+    memcpy(&request->buffer[request->size], ptr, realsize);
+    request->size += realsize;
+    request->buffer[request->size] = '\0';
+
+    return realsize;
+}
+
+static int
+_http_xferinfo(void *userdata, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+{
+    HttpRequest *request = (HttpRequest*)userdata;
+
+    return request->progress(ultotal, ulnow, request->userdata);
+}
+
+#if LIBCURL_VERSION_NUM < 0x072000
+static int
+_http_older_progress(void *userdata, double dltotal, double dlnow, double ultotal, double ulnow)
+{
+    return _http_xferinfo(userdata, (curl_off_t)dltotal, (curl_off_t)dlnow, (curl_off_t)ultotal, (curl_off_t)ulnow);
+}
+#endif
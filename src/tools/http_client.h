@@ -0,0 +1,73 @@
+/*
+ * http_client.h
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef TOOLS_HTTP_CLIENT_H
+#define TOOLS_HTTP_CLIENT_H
+
+#ifdef PLATFORM_CYGWIN
+#define SOCKET int
+#endif
+
+#include <stdio.h>
+#include <sys/select.h>
+#include <curl/curl.h>
+#include <glib.h>
+
+typedef struct http_request_t HttpRequest;
+
+typedef struct http_response_t {
+    long status;
+    char *body;
+    size_t size;
+    // NULL when the transfer completed, the HTTP status may still be an error
+    const char *error;
+} HttpResponse;
+
+typedef void (*HttpDoneCallback)(const HttpResponse *const response, void *userdata);
+typedef int (*HttpProgressCallback)(curl_off_t total, curl_off_t now, void *userdata);
+
+void http_client_init(void);
+void http_client_close(void);
+
+HttpRequest* http_client_get(const char *const url, long timeout, HttpDoneCallback done, void *userdata,
+    GDestroyNotify destroy);
+HttpRequest* http_client_put_file(const char *const url, FILE *file, curl_off_t size, const char *const content_type,
+    HttpProgressCallback progress, HttpDoneCallback done, void *userdata, GDestroyNotify destroy);
+void http_client_cancel(HttpRequest *request);
+
+void http_client_fdset(fd_set *read_fds, fd_set *write_fds, fd_set *exc_fds, long *timeout);
+gboolean http_client_process(void);
+
+#endif
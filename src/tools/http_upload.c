@@ -44,11 +44,10 @@
 #include <sys/types.h>
 #include <curl/curl.h>
 #include <gio/gio.h>
-#include <pthread.h>
 #include <assert.h>
 
-#include "profanity.h"
 #include "event/client_events.h"
+#include "tools/http_client.h"
 #include "tools/http_upload.h"
 #include "config/preferences.h"
 #include "ui/ui.h"
@@ -56,30 +55,19 @@
 #include "common.h"
 
 #define FALLBACK_MIMETYPE "application/octet-stream"
-#define FALLBACK_CONTENTTYPE_HEADER "Content-Type: application/octet-stream"
 #define FALLBACK_MSG ""
 #define FILE_HEADER_BYTES 512
 
-struct curl_data_t {
-    char *buffer;
-    size_t size;
-};
-
-
 static int
-_xferinfo(void *userdata, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+_http_upload_progress(curl_off_t ultotal, curl_off_t ulnow, void *userdata)
 {
     HTTPUpload *upload = (HTTPUpload *)userdata;
 
-    pthread_mutex_lock(&lock);
-
     if (upload->cancel) {
-        pthread_mutex_unlock(&lock);
         return 1;
     }
 
     if (upload->bytes_sent == ulnow) {
-        pthread_mutex_unlock(&lock);
         return 0;
     } else {
         upload->bytes_sent = ulnow;
@@ -97,146 +85,39 @@ _xferinfo(void *userdata, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultot
     win_update_entry_message(upload->window, upload->put_url, msg);
     free(msg);
 
-    pthread_mutex_unlock(&lock);
-
     return 0;
 }
 
-#if LIBCURL_VERSION_NUM < 0x072000
-static int
-_older_progress(void *p, double dltotal, double dlnow, double ultotal, double ulnow)
+static void
+_http_upload_free(HTTPUpload *upload)
 {
-    return _xferinfo(p, (curl_off_t)dltotal, (curl_off_t)dlnow, (curl_off_t)ultotal, (curl_off_t)ulnow);
-}
-#endif
-
-static size_t
-_data_callback(void *ptr, size_t size, size_t nmemb, void *data)
-{
-    size_t realsize = size * nmemb;
-    struct curl_data_t *mem = (struct curl_data_t *) data;
-    mem->buffer = realloc(mem->buffer, mem->size + realsize + 1);
+    upload_processes = g_slist_remove(upload_processes, upload);
 
-    if (mem->buffer)
-    {
-        memcpy( &( mem->buffer[ mem->size ] ), ptr, realsize );
-        mem->size += realsize;
-        mem->buffer[ mem->size ] = 0;
+    if (upload->fd) {
+        fclose(upload->fd);
     }
-
-    return realsize;
+    free(upload->filename);
+    free(upload->mime_type);
+    free(upload->get_url);
+    free(upload->put_url);
+    free(upload);
 }
 
-void *
-http_file_put(void *userdata)
+static void
+_http_upload_done(const HttpResponse *const response, void *userdata)
 {
     HTTPUpload *upload = (HTTPUpload *)userdata;
 
-    FILE *fd = NULL;
-
     char *err = NULL;
-    char *content_type_header;
-
-    CURL *curl;
-    CURLcode res;
-
-    upload->cancel = 0;
-    upload->bytes_sent = 0;
-
-    pthread_mutex_lock(&lock);
-    char* msg;
-    if (asprintf(&msg, "Uploading '%s': 0%%", upload->filename) == -1) {
-        msg = strdup(FALLBACK_MSG);
-    }
-    win_print_http_upload(upload->window, msg, upload->put_url);
-    free(msg);
-
-    char *cert_path = prefs_get_string(PREF_TLS_CERTPATH);
-    pthread_mutex_unlock(&lock);
-
-    curl_global_init(CURL_GLOBAL_ALL);
-    curl = curl_easy_init();
-
-    curl_easy_setopt(curl, CURLOPT_URL, upload->put_url);
-    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
-
-    struct curl_slist *headers = NULL;
-    if (asprintf(&content_type_header, "Content-Type: %s", upload->mime_type) == -1) {
-        content_type_header = strdup(FALLBACK_CONTENTTYPE_HEADER);
-    }
-    headers = curl_slist_append(headers, content_type_header);
-    headers = curl_slist_append(headers, "Expect:");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-    #if LIBCURL_VERSION_NUM >= 0x072000
-    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, _xferinfo);
-    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, upload);
-    #else
-    curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, _older_progress);
-    curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, upload);
-    #endif
-    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
-
-    struct curl_data_t output;
-    output.buffer = NULL;
-    output.size = 0;
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _data_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&output);
-
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "profanity");
-
-    if (!(fd = fopen(upload->filename, "rb"))) {
-        if (asprintf(&err, "failed to open '%s'", upload->filename) == -1) {
-            err = NULL;
-        }
-        goto end;
-    }
-
-    if (cert_path) {
-        curl_easy_setopt(curl, CURLOPT_CAPATH, cert_path);
-    }
-
-    curl_easy_setopt(curl, CURLOPT_READDATA, fd);
-    curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)(upload->filesize));
-    curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
-
-    if ((res = curl_easy_perform(curl)) != CURLE_OK) {
-        err = strdup(curl_easy_strerror(res));
-    } else {
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-        if (output.buffer) {
-            output.buffer[output.size++] = '\0';
-        }
-
+    if (response->error) {
+        err = strdup(response->error);
+    } else if (response->status != 200 && response->status != 201) {
         // XEP-0363 specifies 201 but prosody returns 200
-        if (http_code != 200 && http_code != 201) {
-            if (asprintf(&err, "Server returned %lu", http_code) == -1) {
-                err = NULL;
-            }
+        if (asprintf(&err, "Server returned %lu", response->status) == -1) {
+            err = NULL;
         }
-
-        #if 0
-        printf("HTTP Status: %lu\n", http_code);
-        printf("%s\n", output.buffer);
-        printf("%lu bytes retrieved\n", (long)output.size);
-        #endif
     }
 
-end:
-    curl_easy_cleanup(curl);
-    curl_global_cleanup();
-    curl_slist_free_all(headers);
-    if (fd) {
-        fclose(fd);
-    }
-    free(content_type_header);
-    free(output.buffer);
-
-    pthread_mutex_lock(&lock);
-    prefs_free_string(cert_path);
-
     if (err) {
         char *msg;
         if (upload->cancel) {
@@ -252,53 +133,72 @@ end:
         cons_show_error(msg);
         free(msg);
         free(err);
-    } else {
-        if (!upload->cancel) {
-            if (asprintf(&msg, "Uploading '%s': 100%%", upload->filename) == -1) {
-                msg = strdup(FALLBACK_MSG);
-            }
-            win_update_entry_message(upload->window, upload->put_url, msg);
-            win_mark_received(upload->window, upload->put_url);
-            free(msg);
+    } else if (!upload->cancel) {
+        char *msg;
+        if (asprintf(&msg, "Uploading '%s': 100%%", upload->filename) == -1) {
+            msg = strdup(FALLBACK_MSG);
+        }
+        win_update_entry_message(upload->window, upload->put_url, msg);
+        win_mark_received(upload->window, upload->put_url);
+        free(msg);
 
-            switch (upload->window->type) {
-            case WIN_CHAT:
-            {
-                ProfChatWin *chatwin = (ProfChatWin*)(upload->window);
-                assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
-                cl_ev_send_msg(chatwin, upload->get_url, upload->get_url);
-                break;
-            }
-            case WIN_PRIVATE:
-            {
-                ProfPrivateWin *privatewin = (ProfPrivateWin*)(upload->window);
-                assert(privatewin->memcheck == PROFPRIVATEWIN_MEMCHECK);
-                cl_ev_send_priv_msg(privatewin, upload->get_url, upload->get_url);
-                break;
-            }
-            case WIN_MUC:
-            {
-                ProfMucWin *mucwin = (ProfMucWin*)(upload->window);
-                assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
-                cl_ev_send_muc_msg(mucwin, upload->get_url, upload->get_url);
-                break;
-            }
-            default:
-                break;
-            }
+        switch (upload->window->type) {
+        case WIN_CHAT:
+        {
+            ProfChatWin *chatwin = (ProfChatWin*)(upload->window);
+            assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
+            cl_ev_send_msg(chatwin, upload->get_url, upload->get_url);
+            break;
+        }
+        case WIN_PRIVATE:
+        {
+            ProfPrivateWin *privatewin = (ProfPrivateWin*)(upload->window);
+            assert(privatewin->memcheck == PROFPRIVATEWIN_MEMCHECK);
+            cl_ev_send_priv_msg(privatewin, upload->get_url, upload->get_url);
+            break;
+        }
+        case WIN_MUC:
+        {
+            ProfMucWin *mucwin = (ProfMucWin*)(upload->window);
+            assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
+            cl_ev_send_muc_msg(mucwin, upload->get_url, upload->get_url);
+            break;
+        }
+        default:
+            break;
         }
     }
+}
 
-    upload_processes = g_slist_remove(upload_processes, upload);
-    pthread_mutex_unlock(&lock);
+void
+http_file_put(HTTPUpload *upload)
+{
+    upload->cancel = 0;
+    upload->bytes_sent = 0;
+    upload->fd = NULL;
+    upload_processes = g_slist_append(upload_processes, upload);
 
-    free(upload->filename);
-    free(upload->mime_type);
-    free(upload->get_url);
-    free(upload->put_url);
-    free(upload);
+    char* msg;
+    if (asprintf(&msg, "Uploading '%s': 0%%", upload->filename) == -1) {
+        msg = strdup(FALLBACK_MSG);
+    }
+    win_print_http_upload(upload->window, msg, upload->put_url);
+    free(msg);
+
+    if (!(upload->fd = fopen(upload->filename, "rb"))) {
+        if (asprintf(&msg, "Uploading '%s' failed: failed to open '%s'", upload->filename, upload->filename) == -1) {
+            msg = strdup(FALLBACK_MSG);
+        }
+        win_update_entry_message(upload->window, upload->put_url, msg);
+        cons_show_error(msg);
+        free(msg);
+        _http_upload_free(upload);
+        return;
+    }
 
-    return NULL;
+    // the transfer runs from the main loop, progress and completion arrive on the UI thread
+    http_client_put_file(upload->put_url, upload->fd, (curl_off_t)(upload->filesize), upload->mime_type,
+        _http_upload_progress, _http_upload_done, upload, (GDestroyNotify)_http_upload_free);
 }
 
 char*
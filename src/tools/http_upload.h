@@ -53,13 +53,13 @@ typedef struct http_upload_t {
     char *get_url;
     char *put_url;
     ProfWin *window;
-    pthread_t worker;
+    FILE *fd;
     int cancel;
 } HTTPUpload;
 
 GSList *upload_processes;
 
-void* http_file_put(void *userdata);
+void http_file_put(HTTPUpload *upload);
 
 char* file_mime_type(const char* const file_name);
 off_t file_size(const char* const file_name);
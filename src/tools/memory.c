@@ -0,0 +1,125 @@
+/*
+ * memory.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <glib.h>
+
+#include "tools/memory.h"
+
+// approximate footprint per subsystem, maintained by the subsystems when
+// their objects are created and freed
+static gint64 bytes[MEMORY_SUBSYSTEMS];
+static gint64 objects[MEMORY_SUBSYSTEMS];
+
+static const char *names[MEMORY_SUBSYSTEMS] = {
+    "buffers",
+    "pads",
+    "roster",
+    "muc",
+    "caps",
+    "omemo"
+};
+
+void
+memory_add(memory_subsystem_t subsystem, gint64 size, gint64 count)
+{
+    bytes[subsystem] += size;
+    objects[subsystem] += count;
+}
+
+gint64
+memory_bytes(memory_subsystem_t subsystem)
+{
+    return bytes[subsystem];
+}
+
+gint64
+memory_objects(memory_subsystem_t subsystem)
+{
+    return objects[subsystem];
+}
+
+gint64
+memory_total(void)
+{
+    gint64 total = 0;
+    int i;
+    for (i = 0; i < MEMORY_SUBSYSTEMS; i++) {
+        total += bytes[i];
+    }
+
+    return total;
+}
+
+const char*
+memory_subsystem_name(memory_subsystem_t subsystem)
+{
+    return names[subsystem];
+}
+
+char*
+memory_format_bytes(gint64 size)
+{
+    if (size < 1024) {
+        return g_strdup_printf("%" G_GINT64_FORMAT " B", size);
+    } else if (size < 1024 * 1024) {
+        return g_strdup_printf("%.1f KB", size / 1024.0);
+    } else {
+        return g_strdup_printf("%.1f MB", size / (1024.0 * 1024.0));
+    }
+}
+
+/*
+ * One line summary of all subsystems, e.g. for the log
+ */
+char*
+memory_summary(void)
+{
+    GString *summary = g_string_new("");
+
+    int i;
+    for (i = 0; i < MEMORY_SUBSYSTEMS; i++) {
+        char *size = memory_format_bytes(bytes[i]);
+        g_string_append_printf(summary, "%s %s (%" G_GINT64_FORMAT "), ", names[i], size, objects[i]);
+        g_free(size);
+    }
+
+    char *total = memory_format_bytes(memory_total());
+    g_string_append_printf(summary, "total %s", total);
+    g_free(total);
+
+    char *result = summary->str;
+    g_string_free(summary, FALSE);
+    return result;
+}
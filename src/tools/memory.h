@@ -0,0 +1,59 @@
+/*
+ * memory.h
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef TOOLS_MEMORY_H
+#define TOOLS_MEMORY_H
+
+#include <glib.h>
+
+typedef enum {
+    MEMORY_BUFFERS,
+    MEMORY_PADS,
+    MEMORY_ROSTER,
+    MEMORY_MUC,
+    MEMORY_CAPS,
+    MEMORY_OMEMO,
+    MEMORY_SUBSYSTEMS
+} memory_subsystem_t;
+
+void memory_add(memory_subsystem_t subsystem, gint64 size, gint64 count);
+gint64 memory_bytes(memory_subsystem_t subsystem);
+gint64 memory_objects(memory_subsystem_t subsystem);
+gint64 memory_total(void);
+const char* memory_subsystem_name(memory_subsystem_t subsystem);
+char* memory_format_bytes(gint64 bytes);
+char* memory_summary(void);
+
+#endif
@@ -39,135 +39,161 @@
 #include <glib.h>
 
 #include "common.h"
+#include "tools/parser.h"
 
 /*
- * Take a full line of input and return an array of strings representing
- * the arguments of a command.
- * If the number of arguments found is less than min, or more than max
- * NULL is returned.
+ * Split a line of input into tokens, without copying it. Tokens are separated
+ * by spaces, a token starting with a double quote runs up to the next double
+ * quote. Leading and trailing whitespace of the line is ignored.
  *
  * inp - The line of input
- * min - The minimum allowed number of arguments
- * max - The maximum allowed number of arguments
+ * freetext - The number of the token, counting the command as 1, from which the
+ *     rest of the line is a single token, or 0 if there is no free text
+ * tokens - Filled with the first max_tokens tokens found
+ * max_tokens - The size of tokens
  *
- * Returns - An NULL terminated array of strings representing the arguments
- * of the command, or NULL if the validation fails.
- *
- * E.g. the following input line:
- *
- * /cmd arg1 arg2
- *
- * Will return a pointer to the following array:
- *
- * { "arg1", "arg2", NULL }
+ * Returns - The number of tokens found, which may be more than max_tokens
  *
+ * The scan is byte wise, spaces and quotes never occur inside a multibyte
+ * UTF-8 sequence.
  */
-gchar**
-parse_args(const char *const inp, int min, int max, gboolean *result)
+int
+parse_tokens(const char *const inp, int freetext, ParserToken *tokens, int max_tokens)
 {
-    if (inp == NULL) {
-        *result = FALSE;
-        return NULL;
+    int begin = 0;
+    int end = strlen(inp);
+    while (begin < end && g_ascii_isspace(inp[begin])) {
+        begin++;
+    }
+    while (end > begin && g_ascii_isspace(inp[end - 1])) {
+        end--;
     }
 
-    // copy and strip input of leading/trailing whitespace
-    char *copy = strdup(inp);
-    g_strstrip(copy);
-
-    int inp_size = g_utf8_strlen(copy, -1);
     gboolean in_token = FALSE;
+    gboolean in_freetext = FALSE;
     gboolean in_quotes = FALSE;
-    char *token_start = &copy[0];
+    int token_start = begin;
     int token_size = 0;
-    GSList *tokens = NULL;
+    int num_tokens = 0;
 
-    // add tokens to GSList
-    int i;
-    for (i = 0; i < inp_size; i++) {
-        gchar *curr_ch = g_utf8_offset_to_pointer(copy, i);
-        gunichar curr_uni = g_utf8_get_char(curr_ch);
+    int i = begin;
+    while (i < end) {
+        char curr = inp[i];
+        int curr_len = g_utf8_skip[(guchar)curr];
 
         if (!in_token) {
-            if (curr_uni  == ' ') {
+            if (curr == ' ') {
+                i += curr_len;
+                continue;
+            }
+            in_token = TRUE;
+            num_tokens++;
+            if (freetext && num_tokens == freetext && curr != '"') {
+                in_freetext = TRUE;
+            }
+            if (curr == '"') {
+                // the character after the opening quote always starts the token
+                in_quotes = TRUE;
+                token_start = i + 1;
+                int next_len = token_start < end ? g_utf8_skip[(guchar)inp[token_start]] : 1;
+                token_size += next_len;
+                i += curr_len + next_len;
                 continue;
-            } else {
-                in_token = TRUE;
-                if (curr_uni == '"') {
-                    in_quotes = TRUE;
-                    i++;
-                    gchar *next_ch = g_utf8_next_char(curr_ch);
-                    gunichar next_uni = g_utf8_get_char(next_ch);
-                    token_start = next_ch;
-                    token_size += g_unichar_to_utf8(next_uni, NULL);
-                } else {
-                    token_start = curr_ch;
-                    token_size += g_unichar_to_utf8(curr_uni, NULL);
-                }
             }
-        } else {
-            if (in_quotes) {
-                if (curr_uni == '"') {
-                    tokens = g_slist_append(tokens, g_strndup(token_start,
-                        token_size));
-                    token_size = 0;
-                    in_token = FALSE;
-                    in_quotes = FALSE;
-                } else {
-                    token_size += g_unichar_to_utf8(curr_uni, NULL);
+            token_start = i;
+            token_size += curr_len;
+        } else if (in_quotes) {
+            if (curr == '"') {
+                if (num_tokens <= max_tokens) {
+                    tokens[num_tokens - 1].start = token_start;
+                    tokens[num_tokens - 1].len = MIN(token_size, end - token_start);
                 }
+                token_size = 0;
+                in_token = FALSE;
+                in_quotes = FALSE;
             } else {
-                if (curr_uni == ' ') {
-                    tokens = g_slist_append(tokens, g_strndup(token_start,
-                        token_size));
-                    token_size = 0;
-                    in_token = FALSE;
-                } else {
-                    token_size += g_unichar_to_utf8(curr_uni, NULL);
-                }
+                token_size += curr_len;
             }
+        } else if (in_freetext) {
+            token_size += curr_len;
+        } else if (curr == ' ') {
+            if (num_tokens <= max_tokens) {
+                tokens[num_tokens - 1].start = token_start;
+                tokens[num_tokens - 1].len = MIN(token_size, end - token_start);
+            }
+            token_size = 0;
+            in_token = FALSE;
+        } else if (!freetext || curr != '"') {
+            token_size += curr_len;
         }
+
+        i += curr_len;
     }
 
-    if (in_token) {
-        tokens = g_slist_append(tokens, g_strndup(token_start, token_size));
+    if (in_token && num_tokens <= max_tokens) {
+        tokens[num_tokens - 1].start = token_start;
+        tokens[num_tokens - 1].len = MAX(0, MIN(token_size, end - token_start));
+    }
+
+    return num_tokens;
+}
+
+static gchar**
+_parse_args(const char *const inp, int min, int max, int freetext, gboolean *result)
+{
+    if (inp == NULL) {
+        *result = FALSE;
+        return NULL;
     }
 
-    int num = g_slist_length(tokens) - 1;
+    // the command and at most max arguments are kept
+    int max_tokens = MAX(max, 0) + 1;
+    ParserToken tokens[max_tokens];
+    int num = parse_tokens(inp, freetext, tokens, max_tokens) - 1;
 
     // if num args not valid return NULL
     if ((num < min) || (num > max)) {
-        g_slist_free_full(tokens, free);
-        g_free(copy);
         *result = FALSE;
         return NULL;
+    }
 
-    // if min allowed is 0 and 0 found, return empty char* array
-    } else if (min == 0 && num == 0) {
-        g_slist_free_full(tokens, free);
-        gchar **args = malloc((num + 1) * sizeof(*args));
-        args[0] = NULL;
-        g_free(copy);
-        *result = TRUE;
-        return args;
-
-    // otherwise return args array
-    } else {
-        gchar **args = malloc((num + 1) * sizeof(*args));
-        GSList *token = tokens;
-        token = g_slist_next(token);
-        int arg_count = 0;
-
-        while (token) {
-            args[arg_count++] = strdup(token->data);
-            token = g_slist_next(token);
-        }
-
-        args[arg_count] = NULL;
-        g_slist_free_full(tokens, free);
-        g_free(copy);
-        *result = TRUE;
-        return args;
+    gchar **args = malloc((num + 1) * sizeof(*args));
+    int i;
+    for (i = 0; i < num; i++) {
+        args[i] = g_strndup(&inp[tokens[i + 1].start], tokens[i + 1].len);
     }
+    args[num] = NULL;
+
+    *result = TRUE;
+    return args;
+}
+
+/*
+ * Take a full line of input and return an array of strings representing
+ * the arguments of a command.
+ * If the number of arguments found is less than min, or more than max
+ * NULL is returned.
+ *
+ * inp - The line of input
+ * min - The minimum allowed number of arguments
+ * max - The maximum allowed number of arguments
+ *
+ * Returns - An NULL terminated array of strings representing the arguments
+ * of the command, or NULL if the validation fails.
+ *
+ * E.g. the following input line:
+ *
+ * /cmd arg1 arg2
+ *
+ * Will return a pointer to the following array:
+ *
+ * { "arg1", "arg2", NULL }
+ *
+ */
+gchar**
+parse_args(const char *const inp, int min, int max, gboolean *result)
+{
+    return _parse_args(inp, min, max, 0, result);
 }
 
 /*
@@ -199,127 +225,12 @@ parse_args(const char *const inp, int min, int max, gboolean *result)
 gchar**
 parse_args_with_freetext(const char *const inp, int min, int max, gboolean *result)
 {
-    if (inp == NULL) {
-        *result = FALSE;
-        return NULL;
-    }
-
-    // copy and strip input of leading/trailing whitepsace
-    char *copy = strdup(inp);
-    g_strstrip(copy);
-
-    int inp_size = g_utf8_strlen(copy, -1);
-    gboolean in_token = FALSE;
-    gboolean in_freetext = FALSE;
-    gboolean in_quotes = FALSE;
-    char *token_start = &copy[0];
-    int token_size = 0;
-    int num_tokens = 0;
-    GSList *tokens = NULL;
-
-    // add tokens to GSList
-    int i;
-    for (i = 0; i < inp_size; i++) {
-        gchar *curr_ch = g_utf8_offset_to_pointer(copy, i);
-        gunichar curr_uni = g_utf8_get_char(curr_ch);
-
-        if (!in_token) {
-            if (curr_uni == ' ') {
-                continue;
-            } else {
-                in_token = TRUE;
-                num_tokens++;
-                if ((num_tokens == max + 1) && (curr_uni != '"')) {
-                    in_freetext = TRUE;
-                } else if (curr_uni == '"') {
-                    in_quotes = TRUE;
-                    i++;
-                    gchar *next_ch = g_utf8_next_char(curr_ch);
-                    gunichar next_uni = g_utf8_get_char(next_ch);
-                    token_start = next_ch;
-                    token_size += g_unichar_to_utf8(next_uni, NULL);
-                }
-                if (curr_uni == '"') {
-                    gchar *next_ch = g_utf8_next_char(curr_ch);
-                    token_start = next_ch;
-                } else {
-                    token_start = curr_ch;
-                    token_size += g_unichar_to_utf8(curr_uni, NULL);
-                }
-            }
-        } else {
-            if (in_quotes) {
-                if (curr_uni == '"') {
-                    tokens = g_slist_append(tokens, g_strndup(token_start,
-                        token_size));
-                    token_size = 0;
-                    in_token = FALSE;
-                    in_quotes = FALSE;
-                } else {
-                    if (curr_uni != '"') {
-                        token_size += g_unichar_to_utf8(curr_uni, NULL);
-                    }
-                }
-            } else {
-                if (in_freetext) {
-                    token_size += g_unichar_to_utf8(curr_uni, NULL);
-                } else if (curr_uni == ' ') {
-                    tokens = g_slist_append(tokens, g_strndup(token_start,
-                        token_size));
-                    token_size = 0;
-                    in_token = FALSE;
-                } else if (curr_uni != '"') {
-                    token_size += g_unichar_to_utf8(curr_uni, NULL);
-                }
-            }
-        }
-    }
-
-    if (in_token) {
-        tokens = g_slist_append(tokens, g_strndup(token_start, token_size));
-    }
-
-    free(copy);
-
-    int num = g_slist_length(tokens) - 1;
-
-    // if num args not valid return NULL
-    if ((num < min) || (num > max)) {
-        g_slist_free_full(tokens, free);
-        *result = FALSE;
-        return NULL;
-
-    // if min allowed is 0 and 0 found, return empty char* array
-    } else if (min == 0 && num == 0) {
-        g_slist_free_full(tokens, free);
-        gchar **args = malloc((num + 1) * sizeof(*args));
-        args[0] = NULL;
-        *result = TRUE;
-        return args;
-
-    // otherwise return args array
-    } else {
-        gchar **args = malloc((num + 1) * sizeof(*args));
-        GSList *token = tokens;
-        token = g_slist_next(token);
-        int arg_count = 0;
-
-        while (token) {
-            args[arg_count++] = strdup(token->data);
-            token = g_slist_next(token);
-        }
-
-        args[arg_count] = NULL;
-        g_slist_free_full(tokens, free);
-        *result = TRUE;
-        return args;
-    }
+    return _parse_args(inp, min, max, MAX(max, 0) + 1, result);
 }
 
 int
 count_tokens(const char *const string)
 {
-    int length = g_utf8_strlen(string, -1);
     gboolean in_quotes = FALSE;
     int num_tokens = 0;
     int i = 0;
@@ -327,20 +238,13 @@ count_tokens(const char *const string)
     // include first token
     num_tokens++;
 
-    for (i = 0; i < length; i++) {
-        gchar *curr_ch = g_utf8_offset_to_pointer(string, i);
-        gunichar curr_uni = g_utf8_get_char(curr_ch);
-
-        if (curr_uni == ' ') {
+    for (i = 0; string[i] != '\0'; i++) {
+        if (string[i] == ' ') {
             if (!in_quotes) {
                 num_tokens++;
             }
-        } else if (curr_uni == '"') {
-            if (in_quotes) {
-                in_quotes = FALSE;
-            } else {
-                in_quotes = TRUE;
-            }
+        } else if (string[i] == '"') {
+            in_quotes = !in_quotes;
         }
     }
 
@@ -350,44 +254,28 @@ count_tokens(const char *const string)
 char*
 get_start(const char *const string, int tokens)
 {
-    GString *result = g_string_new("");
-    int length = g_utf8_strlen(string, -1);
     gboolean in_quotes = FALSE;
-    char *result_str = NULL;
     int num_tokens = 0;
+    int length = 0;
     int i = 0;
 
     // include first token
     num_tokens++;
 
-    for (i = 0; i < length; i++) {
-        gchar *curr_ch = g_utf8_offset_to_pointer(string, i);
-        gunichar curr_uni = g_utf8_get_char(curr_ch);
-
+    for (i = 0; string[i] != '\0'; i++) {
         if (num_tokens < tokens) {
-            gchar *uni_char = malloc(7);
-            int len = g_unichar_to_utf8(curr_uni, uni_char);
-            uni_char[len] = '\0';
-            g_string_append(result, uni_char);
-            free(uni_char);
+            length = i + 1;
         }
-        if (curr_uni == ' ') {
+        if (string[i] == ' ') {
             if (!in_quotes) {
                 num_tokens++;
             }
-        } else if (curr_uni == '"') {
-            if (in_quotes) {
-                in_quotes = FALSE;
-            } else {
-                in_quotes = TRUE;
-            }
+        } else if (string[i] == '"') {
+            in_quotes = !in_quotes;
         }
     }
 
-    result_str = result->str;
-    g_string_free(result, FALSE);
-
-    return result_str;
+    return g_strndup(string, length);
 }
 
 GHashTable*
@@ -38,6 +38,13 @@
 
 #include <glib.h>
 
+// a token of a line of input, as a byte range of that line
+typedef struct parser_token_t {
+    int start;
+    int len;
+} ParserToken;
+
+int parse_tokens(const char *const inp, int freetext, ParserToken *tokens, int max_tokens);
 gchar** parse_args(const char *const inp, int min, int max, gboolean *result);
 gchar** parse_args_with_freetext(const char *const inp, int min, int max, gboolean *result);
 int count_tokens(const char *const string);
@@ -35,19 +35,22 @@
 
 #include <stdlib.h>
 #include <string.h>
-#include <sys/select.h>
 
-#include <curl/curl.h>
-#include <curl/easy.h>
 #include <glib.h>
 
-struct curl_data_t
-{
-    char *buffer;
-    size_t size;
-};
+#include "tools/http_client.h"
+#include "tools/tinyurl.h"
+
+#define TINYURL_TIMEOUT 10L
+
+typedef struct tinyurl_request_t {
+    TinyurlCallback callback;
+    void *userdata;
+    GDestroyNotify destroy;
+} TinyurlRequest;
 
-static size_t _data_callback(void *ptr, size_t size, size_t nmemb, void *data);
+static void _tinyurl_done(const HttpResponse *const response, void *userdata);
+static void _tinyurl_request_free(TinyurlRequest *request);
 
 gboolean
 tinyurl_valid(char *url)
@@ -56,47 +59,43 @@ tinyurl_valid(char *url)
         g_str_has_prefix(url, "https://"));
 }
 
-char*
-tinyurl_get(char *url)
+/*
+ * Shorten url, callback gets the short url or NULL on failure. userdata is
+ * released with destroy afterwards, or when the request is cancelled
+ */
+void
+tinyurl_get(char *url, TinyurlCallback callback, void *userdata, GDestroyNotify destroy)
 {
     GString *full_url = g_string_new("http://tinyurl.com/api-create.php?url=");
     g_string_append(full_url, url);
 
-    CURL *handle = curl_easy_init();
-    struct curl_data_t output;
-    output.buffer = NULL;
-    output.size = 0;
-
-    curl_easy_setopt(handle, CURLOPT_URL, full_url->str);
-    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, _data_callback);
-    curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void *)&output);
+    TinyurlRequest *request = malloc(sizeof(TinyurlRequest));
+    request->callback = callback;
+    request->userdata = userdata;
+    request->destroy = destroy;
 
-    curl_easy_perform(handle);
-    curl_easy_cleanup(handle);
+    http_client_get(full_url->str, TINYURL_TIMEOUT, _tinyurl_done, request, (GDestroyNotify)_tinyurl_request_free);
 
     g_string_free(full_url, TRUE);
+}
+
+static void
+_tinyurl_done(const HttpResponse *const response, void *userdata)
+{
+    TinyurlRequest *request = (TinyurlRequest*)userdata;
 
-    if (output.buffer) {
-        output.buffer[output.size++] = '\0';
-        return output.buffer;
+    if (response->error == NULL && response->status == 200 && response->body) {
+        request->callback(response->body, request->userdata);
     } else {
-        return NULL;
+        request->callback(NULL, request->userdata);
     }
 }
 
-static size_t
-_data_callback(void *ptr, size_t size, size_t nmemb, void *data)
+static void
+_tinyurl_request_free(TinyurlRequest *request)
 {
-    size_t realsize = size * nmemb;
-    struct curl_data_t *mem = (struct curl_data_t *) data;
-    mem->buffer = realloc(mem->buffer, mem->size + realsize + 1);
-
-    if ( mem->buffer )
-    {
-        memcpy( &( mem->buffer[ mem->size ] ), ptr, realsize );
-        mem->size += realsize;
-        mem->buffer[ mem->size ] = 0;
+    if (request->destroy) {
+        request->destroy(request->userdata);
     }
-
-    return realsize;
+    free(request);
 }
@@ -38,7 +38,9 @@
 
 #include <glib.h>
 
+typedef void (*TinyurlCallback)(const char *const tiny, void *userdata);
+
 gboolean tinyurl_valid(char *url);
-char* tinyurl_get(char *url);
+void tinyurl_get(char *url, TinyurlCallback callback, void *userdata, GDestroyNotify destroy);
 
 #endif
@@ -35,10 +35,12 @@
 
 #include "config.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include <glib.h>
 #ifdef HAVE_NCURSESW_NCURSES_H
@@ -47,22 +49,58 @@
 #include <ncurses.h>
 #endif
 
+#include "common.h"
+#include "log.h"
+#include "config/files.h"
+#include "tools/memory.h"
 #include "ui/window.h"
 #include "ui/buffer.h"
 
 #define BUFF_SIZE 1200
+// every SPILL_INDEX_STRIDE spilled entries the file offset is remembered
+#define SPILL_INDEX_STRIDE 64
+// number of spilled entries read back from disk at once
+#define SPILL_PAGE_SIZE 256
+// spilled entries are collected in memory and written once this many bytes are pending
+#define SPILL_FLUSH_SIZE 16384
 
 struct prof_buff_t {
     GSList *entries;
+    // whether entries appended from now on may be spilled to disk
+    gboolean spill_enabled;
+    // entries evicted from the buffer, oldest first, in an unlinked file
+    // only readable by the user
+    FILE *spill;
+    int spilled;
+    GArray *spill_index;
+    // spilled entries not written yet, and the size of the file without them
+    GByteArray *spill_pending;
+    off_t spill_written;
+    // spilled entries paged back in, starting at spill_cache_first
+    GPtrArray *spill_cache;
+    int spill_cache_first;
 };
 
 static void _free_entry(ProfBuffEntry *entry);
+static gint64 _entry_size(ProfBuffEntry *entry);
+static void _buffer_evict(ProfBuff buffer);
+static void _buffer_spill(ProfBuff buffer, ProfBuffEntry *entry);
+static gboolean _buffer_spill_flush(ProfBuff buffer);
+static void _buffer_load_spilled(ProfBuff buffer, int first);
 
 ProfBuff
 buffer_create(void)
 {
     ProfBuff new_buff = malloc(sizeof(struct prof_buff_t));
     new_buff->entries = NULL;
+    new_buff->spill_enabled = FALSE;
+    new_buff->spill = NULL;
+    new_buff->spilled = 0;
+    new_buff->spill_index = NULL;
+    new_buff->spill_pending = NULL;
+    new_buff->spill_written = 0;
+    new_buff->spill_cache = NULL;
+    new_buff->spill_cache_first = 0;
     return new_buff;
 }
 
@@ -76,9 +114,30 @@ void
 buffer_free(ProfBuff buffer)
 {
     g_slist_free_full(buffer->entries, (GDestroyNotify)_free_entry);
+    buffer_release_spilled(buffer);
+    if (buffer->spill) {
+        fclose(buffer->spill);
+    }
+    if (buffer->spill_index) {
+        g_array_free(buffer->spill_index, TRUE);
+    }
+    if (buffer->spill_pending) {
+        g_byte_array_free(buffer->spill_pending, TRUE);
+    }
     free(buffer);
 }
 
+/*
+ * Set whether entries appended from now on may be written to the spill file
+ * once they are evicted. Entries appended while spilling is disabled are
+ * dropped on eviction instead. Disabled for new buffers
+ */
+void
+buffer_set_spill(ProfBuff buffer, gboolean spill)
+{
+    buffer->spill_enabled = spill;
+}
+
 void
 buffer_append(ProfBuff buffer, const char show_char, int pad_indent, GDateTime *time,
     int flags, theme_item_t theme_item, const char *const from, const char *const message, DeliveryReceipt *receipt, const char *const id)
@@ -97,10 +156,11 @@ buffer_append(ProfBuff buffer, const char show_char, int pad_indent, GDateTime *
     } else {
         e->id = NULL;
     }
+    e->memory_only = !buffer->spill_enabled;
+    memory_add(MEMORY_BUFFERS, _entry_size(e), 1);
 
     if (g_slist_length(buffer->entries) == BUFF_SIZE) {
-        _free_entry(buffer->entries->data);
-        buffer->entries = g_slist_delete_link(buffer->entries, buffer->entries);
+        _buffer_evict(buffer);
     }
 
     buffer->entries = g_slist_append(buffer->entries, e);
@@ -111,14 +171,54 @@ buffer_remove_entry_by_id(ProfBuff buffer, const char *const id)
 {
     GSList *entries = buffer->entries;
     while (entries) {
+        GSList *next = g_slist_next(entries);
         ProfBuffEntry *entry = entries->data;
         if (entry->id && (g_strcmp0(entry->id, id) == 0)) {
+            _free_entry(entry);
             buffer->entries = g_slist_delete_link(buffer->entries, entries);
         }
-        entries = g_slist_next(entries);
+        entries = next;
     }
 }
 
+gboolean
+buffer_update_entry_message(ProfBuff buffer, const char *const id, const char *const message)
+{
+    ProfBuffEntry *entry = buffer_get_entry_by_id(buffer, id);
+    if (entry == NULL) {
+        return FALSE;
+    }
+
+    memory_add(MEMORY_BUFFERS, (gint64)strlen(message) - (gint64)strlen(entry->message), 0);
+    free(entry->message);
+    entry->message = strdup(message);
+
+    return TRUE;
+}
+
+/*
+ * Move all but the newest keep entries to the spill file, they stay
+ * available to scrollback through buffer_get_spilled_entry. Entries that
+ * must not go to disk are kept, trimming stops at the first one so the
+ * order of the buffer holds. Returns the number of entries moved
+ */
+int
+buffer_trim(ProfBuff buffer, int keep)
+{
+    int size = g_slist_length(buffer->entries);
+    int trimmed = 0;
+    while (size - trimmed > keep) {
+        ProfBuffEntry *entry = buffer->entries->data;
+        if (entry->memory_only) {
+            break;
+        }
+        _buffer_evict(buffer);
+        trimmed++;
+    }
+
+    return trimmed;
+}
+
 gboolean
 buffer_mark_received(ProfBuff buffer, const char *const id)
 {
@@ -159,9 +259,307 @@ buffer_get_entry_by_id(ProfBuff buffer, const char *const id)
     return NULL;
 }
 
+/*
+ * Number of entries evicted from the buffer to disk, they are indexed from 0
+ * (oldest) and precede the entries returned by buffer_get_entry
+ */
+int
+buffer_spilled_size(ProfBuff buffer)
+{
+    return buffer->spilled;
+}
+
+/*
+ * Get a spilled entry, reading it back from disk when not already paged in.
+ * The entry is owned by the buffer and valid until the next call or
+ * buffer_release_spilled
+ */
+ProfBuffEntry*
+buffer_get_spilled_entry(ProfBuff buffer, int entry)
+{
+    if (entry < 0 || entry >= buffer->spilled) {
+        return NULL;
+    }
+
+    if (buffer->spill_cache == NULL || entry < buffer->spill_cache_first
+            || entry >= buffer->spill_cache_first + (int)buffer->spill_cache->len) {
+        _buffer_load_spilled(buffer, entry);
+    }
+
+    if (buffer->spill_cache == NULL || entry - buffer->spill_cache_first >= (int)buffer->spill_cache->len) {
+        return NULL;
+    }
+
+    return g_ptr_array_index(buffer->spill_cache, entry - buffer->spill_cache_first);
+}
+
+/*
+ * Free the spilled entries paged back in, once the window is not showing them
+ */
+void
+buffer_release_spilled(ProfBuff buffer)
+{
+    if (buffer->spill_cache) {
+        g_ptr_array_free(buffer->spill_cache, TRUE);
+        buffer->spill_cache = NULL;
+    }
+}
+
+static void
+_spill_write_string(GByteArray *pending, const char *const str)
+{
+    guint32 len = str ? strlen(str) : G_MAXUINT32;
+    g_byte_array_append(pending, (guint8*)&len, sizeof(len));
+    if (str) {
+        g_byte_array_append(pending, (guint8*)str, len);
+    }
+}
+
+static gboolean
+_spill_read_string(FILE *spill, char **str)
+{
+    guint32 len;
+    if (fread(&len, sizeof(len), 1, spill) != 1) {
+        return FALSE;
+    }
+
+    if (len == G_MAXUINT32) {
+        *str = NULL;
+        return TRUE;
+    }
+
+    *str = malloc(len + 1);
+    if (fread(*str, 1, len, spill) != len) {
+        free(*str);
+        *str = NULL;
+        return FALSE;
+    }
+    (*str)[len] = '\0';
+
+    return TRUE;
+}
+
+/*
+ * Remove the oldest entry, writing it to the spill file unless it was
+ * appended while spilling was disabled
+ */
+static void
+_buffer_evict(ProfBuff buffer)
+{
+    ProfBuffEntry *entry = buffer->entries->data;
+    if (!entry->memory_only) {
+        _buffer_spill(buffer, entry);
+    }
+    _free_entry(entry);
+    buffer->entries = g_slist_delete_link(buffer->entries, buffer->entries);
+}
+
+/*
+ * Create the spill file in the data directory, it is unlinked straight away
+ * so nothing is left behind, and only the user can read it while it is open
+ */
+static FILE*
+_spill_open(void)
+{
+    char *spill_dir = files_get_data_path(DIR_SCROLLBACK);
+    if (!mkdir_recursive(spill_dir)) {
+        log_error("Could not create scrollback directory %s", spill_dir);
+        free(spill_dir);
+        return NULL;
+    }
+
+    gchar *filename = g_strdup_printf("%s/spill-XXXXXX", spill_dir);
+    free(spill_dir);
+
+    // g_mkstemp creates the file with mode 0600
+    int fd = g_mkstemp(filename);
+    if (fd == -1) {
+        log_error("Could not create scrollback file %s", filename);
+        g_free(filename);
+        return NULL;
+    }
+    unlink(filename);
+    g_free(filename);
+
+    FILE *spill = fdopen(fd, "w+b");
+    if (spill == NULL) {
+        close(fd);
+    }
+
+    return spill;
+}
+
+static void
+_buffer_spill(ProfBuff buffer, ProfBuffEntry *entry)
+{
+    if (buffer->spill == NULL) {
+        buffer->spill = _spill_open();
+        if (buffer->spill == NULL) {
+            return;
+        }
+        buffer->spill_index = g_array_new(FALSE, FALSE, sizeof(off_t));
+        buffer->spill_pending = g_byte_array_sized_new(SPILL_FLUSH_SIZE);
+    }
+
+    GByteArray *pending = buffer->spill_pending;
+    if (buffer->spilled % SPILL_INDEX_STRIDE == 0) {
+        off_t offset = buffer->spill_written + pending->len;
+        g_array_append_val(buffer->spill_index, offset);
+    }
+
+    gint64 time = g_date_time_to_unix(entry->time) * G_USEC_PER_SEC + g_date_time_get_microsecond(entry->time);
+    gint32 fields[3] = { entry->pad_indent, entry->flags, entry->theme_item };
+    char receipt = entry->receipt ? (entry->receipt->received ? 2 : 1) : 0;
+
+    g_byte_array_append(pending, (guint8*)&entry->show_char, 1);
+    g_byte_array_append(pending, (guint8*)&receipt, 1);
+    g_byte_array_append(pending, (guint8*)fields, sizeof(fields));
+    g_byte_array_append(pending, (guint8*)&time, sizeof(time));
+    _spill_write_string(pending, entry->from);
+    _spill_write_string(pending, entry->message);
+    _spill_write_string(pending, entry->id);
+
+    buffer->spilled++;
+
+    if (pending->len >= SPILL_FLUSH_SIZE) {
+        _buffer_spill_flush(buffer);
+    }
+}
+
+/*
+ * Write the pending spilled entries to the end of the spill file
+ */
+static gboolean
+_buffer_spill_flush(ProfBuff buffer)
+{
+    GByteArray *pending = buffer->spill_pending;
+    if (pending == NULL || pending->len == 0) {
+        return TRUE;
+    }
+
+    if (fseeko(buffer->spill, buffer->spill_written, SEEK_SET) != 0
+            || fwrite(pending->data, 1, pending->len, buffer->spill) != pending->len) {
+        log_error("Could not write to scrollback file");
+        return FALSE;
+    }
+
+    buffer->spill_written += pending->len;
+    g_byte_array_set_size(pending, 0);
+
+    return TRUE;
+}
+
+static ProfBuffEntry*
+_buffer_read_spilled(FILE *spill)
+{
+    char show_char;
+    char receipt;
+    gint32 fields[3];
+    gint64 time;
+
+    if (fread(&show_char, 1, 1, spill) != 1 || fread(&receipt, 1, 1, spill) != 1
+            || fread(fields, sizeof(fields), 1, spill) != 1 || fread(&time, sizeof(time), 1, spill) != 1) {
+        return NULL;
+    }
+
+    ProfBuffEntry *e = malloc(sizeof(struct prof_buff_entry_t));
+    e->show_char = show_char;
+    e->pad_indent = fields[0];
+    e->flags = fields[1];
+    e->theme_item = fields[2];
+    e->receipt = NULL;
+    e->from = NULL;
+    e->message = NULL;
+    e->id = NULL;
+    e->memory_only = FALSE;
+
+    GDateTime *utc = g_date_time_new_from_unix_utc(time / G_USEC_PER_SEC);
+    GDateTime *with_usec = g_date_time_add(utc, time % G_USEC_PER_SEC);
+    e->time = g_date_time_to_local(with_usec);
+    g_date_time_unref(with_usec);
+    g_date_time_unref(utc);
+
+    if (receipt) {
+        e->receipt = malloc(sizeof(struct delivery_receipt_t));
+        e->receipt->received = receipt == 2;
+    }
+
+    gboolean read = _spill_read_string(spill, &e->from) && _spill_read_string(spill, &e->message)
+        && _spill_read_string(spill, &e->id) && e->message != NULL;
+    memory_add(MEMORY_BUFFERS, _entry_size(e), 1);
+    if (!read) {
+        _free_entry(e);
+        return NULL;
+    }
+
+    return e;
+}
+
+/*
+ * Page in up to SPILL_PAGE_SIZE spilled entries starting at the index entry
+ * closest before first
+ */
+static void
+_buffer_load_spilled(ProfBuff buffer, int first)
+{
+    buffer_release_spilled(buffer);
+
+    if (!_buffer_spill_flush(buffer)) {
+        return;
+    }
+
+    int stride = first / SPILL_INDEX_STRIDE;
+    off_t offset = g_array_index(buffer->spill_index, off_t, stride);
+    if (fseeko(buffer->spill, offset, SEEK_SET) != 0) {
+        return;
+    }
+
+    buffer->spill_cache = g_ptr_array_new_with_free_func((GDestroyNotify)_free_entry);
+    buffer->spill_cache_first = stride * SPILL_INDEX_STRIDE;
+
+    int last = first + SPILL_PAGE_SIZE;
+    if (last > buffer->spilled) {
+        last = buffer->spilled;
+    }
+
+    int i;
+    for (i = buffer->spill_cache_first; i < last; i++) {
+        ProfBuffEntry *e = _buffer_read_spilled(buffer->spill);
+        if (e == NULL) {
+            break;
+        }
+        g_ptr_array_add(buffer->spill_cache, e);
+    }
+}
+
+/*
+ * Approximate heap used by an entry and its list node, the timestamp is
+ * shared with the caller and not counted
+ */
+static gint64
+_entry_size(ProfBuffEntry *entry)
+{
+    gint64 size = sizeof(ProfBuffEntry) + sizeof(GSList);
+    if (entry->message) {
+        size += strlen(entry->message) + 1;
+    }
+    if (entry->from) {
+        size += strlen(entry->from) + 1;
+    }
+    if (entry->id) {
+        size += strlen(entry->id) + 1;
+    }
+    if (entry->receipt) {
+        size += sizeof(DeliveryReceipt);
+    }
+
+    return size;
+}
+
 static void
 _free_entry(ProfBuffEntry *entry)
 {
+    memory_add(MEMORY_BUFFERS, -_entry_size(entry), -1);
     free(entry->message);
     free(entry->from);
     free(entry->id);
@@ -56,18 +56,26 @@ typedef struct prof_buff_entry_t {
     DeliveryReceipt *receipt;
     // message id, in case we have it
     char *id;
+    // never written to the spill file
+    gboolean memory_only;
 } ProfBuffEntry;
 
 typedef struct prof_buff_t *ProfBuff;
 
 ProfBuff buffer_create();
 void buffer_free(ProfBuff buffer);
+void buffer_set_spill(ProfBuff buffer, gboolean spill);
 void buffer_append(ProfBuff buffer, const char show_char, int pad_indent, GDateTime *time,
     int flags, theme_item_t theme_item, const char *const from, const char *const message, DeliveryReceipt *receipt, const char *const id);
 void buffer_remove_entry_by_id(ProfBuff buffer, const char *const id);
+gboolean buffer_update_entry_message(ProfBuff buffer, const char *const id, const char *const message);
+int buffer_trim(ProfBuff buffer, int keep);
 int buffer_size(ProfBuff buffer);
 ProfBuffEntry* buffer_get_entry(ProfBuff buffer, int entry);
 ProfBuffEntry* buffer_get_entry_by_id(ProfBuff buffer, const char *const id);
 gboolean buffer_mark_received(ProfBuff buffer, const char *const id);
+int buffer_spilled_size(ProfBuff buffer);
+ProfBuffEntry* buffer_get_spilled_entry(ProfBuff buffer, int entry);
+void buffer_release_spilled(ProfBuff buffer);
 
 #endif
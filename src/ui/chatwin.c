@@ -43,6 +43,7 @@
 #include "window_list.h"
 #include "xmpp/roster_list.h"
 #include "log.h"
+#include "database.h"
 #include "config/preferences.h"
 #include "ui/ui.h"
 #include "ui/window.h"
@@ -56,6 +57,8 @@
 #endif
 
 static void _chatwin_history(ProfChatWin *chatwin, const char *const contact);
+static gboolean _chatwin_history_from_store(ProfChatWin *chatwin, const char *const login, const char *const contact);
+static void _chatwin_history_from_logs(ProfChatWin *chatwin, const char *const login, const char *const contact);
 
 ProfChatWin*
 chatwin_new(const char *const barejid)
@@ -272,7 +275,7 @@ chatwin_incoming_msg(ProfChatWin *chatwin, ProfMessage *message, gboolean win_cr
             flash();
         }
 
-        chatwin->unread++;
+        wins_unread_inc(window, FALSE, FALSE);
 
         if (prefs_get_boolean(PREF_CHLOG) && prefs_get_boolean(PREF_HISTORY)) {
             _chatwin_history(chatwin, chatwin->barejid);
@@ -466,33 +469,70 @@ _chatwin_history(ProfChatWin *chatwin, const char *const contact)
 {
     if (!chatwin->history_shown) {
         Jid *jid = jid_create(connection_get_fulljid());
-        GSList *history = chat_log_get_previous(jid->barejid, contact);
-        jid_destroy(jid);
-        GSList *curr = history;
-        int idd = 0;
-        int imo = 0;
-        int iyy = 0;
-
-        while (curr) {
-            char *line = curr->data;
-            // entry, containing the actual entries with date followed by text
-            if (line[2] == ':') {
-                char hh[3]; memcpy(hh, &line[0], 2); hh[2] = '\0'; int ihh = atoi(hh);
-                char mm[3]; memcpy(mm, &line[3], 2); mm[2] = '\0'; int imm = atoi(mm);
-                char ss[3]; memcpy(ss, &line[6], 2); ss[2] = '\0'; int iss = atoi(ss);
-                GDateTime *timestamp = g_date_time_new_local(iyy, imo, idd, ihh, imm, iss);
-                win_print_history((ProfWin*)chatwin, timestamp, "%s", curr->data+11);
-                g_date_time_unref(timestamp);
-            // header, containing the date from filename "21/10/2019:"
-            } else {
-                char dd[3]; memcpy(dd, &line[0], 2); dd[2] = '\0'; idd = atoi(dd);
-                char mm[3]; memcpy(mm, &line[3], 2); mm[2] = '\0'; imo = atoi(mm);
-                char yy[5]; memcpy(yy, &line[6], 4); yy[4] = '\0'; iyy = atoi(yy);
-            }
-            curr = g_slist_next(curr);
+        // the text logs are read until the store has imported them, and when
+        // the store has nothing for the contact
+        if (!log_database_history_ready() || !_chatwin_history_from_store(chatwin, jid->barejid, contact)) {
+            _chatwin_history_from_logs(chatwin, jid->barejid, contact);
         }
+        jid_destroy(jid);
         chatwin->history_shown = TRUE;
+    }
+}
 
-        g_slist_free_full(history, free);
+static gboolean
+_chatwin_history_from_store(ProfChatWin *chatwin, const char *const login, const char *const contact)
+{
+    GDateTime *since = chat_log_get_history_start();
+    GSList *history = log_database_get_previous_chat(login, contact, since);
+    g_date_time_unref(since);
+    if (history == NULL) {
+        return FALSE;
     }
+
+    GSList *curr = history;
+    while (curr) {
+        ProfDbMessage *entry = curr->data;
+        const char *from = entry->direction == PROF_OUT_LOG ? "me" : contact;
+        if (entry->message && strncmp(entry->message, "/me ", 4) == 0) {
+            win_print_history((ProfWin*)chatwin, entry->timestamp, "*%s %s", from, entry->message + 4);
+        } else if (entry->message) {
+            win_print_history((ProfWin*)chatwin, entry->timestamp, "%s: %s", from, entry->message);
+        }
+        curr = g_slist_next(curr);
+    }
+
+    g_slist_free_full(history, (GDestroyNotify)log_database_free_message);
+
+    return TRUE;
+}
+
+static void
+_chatwin_history_from_logs(ProfChatWin *chatwin, const char *const login, const char *const contact)
+{
+    GSList *history = chat_log_get_previous(login, contact);
+    GSList *curr = history;
+    int idd = 0;
+    int imo = 0;
+    int iyy = 0;
+
+    while (curr) {
+        char *line = curr->data;
+        // entry, containing the actual entries with date followed by text
+        if (line[2] == ':') {
+            char hh[3]; memcpy(hh, &line[0], 2); hh[2] = '\0'; int ihh = atoi(hh);
+            char mm[3]; memcpy(mm, &line[3], 2); mm[2] = '\0'; int imm = atoi(mm);
+            char ss[3]; memcpy(ss, &line[6], 2); ss[2] = '\0'; int iss = atoi(ss);
+            GDateTime *timestamp = g_date_time_new_local(iyy, imo, idd, ihh, imm, iss);
+            win_print_history((ProfWin*)chatwin, timestamp, "%s", curr->data+11);
+            g_date_time_unref(timestamp);
+        // header, containing the date from filename "21/10/2019:"
+        } else {
+            char dd[3]; memcpy(dd, &line[0], 2); dd[2] = '\0'; idd = atoi(dd);
+            char mm[3]; memcpy(mm, &line[3], 2); mm[2] = '\0'; imo = atoi(mm);
+            char yy[5]; memcpy(yy, &line[6], 4); yy[4] = '\0'; iyy = atoi(yy);
+        }
+        curr = g_slist_next(curr);
+    }
+
+    g_slist_free_full(history, free);
 }
@@ -50,6 +50,8 @@
 #include "config/preferences.h"
 #include "config/theme.h"
 #include "command/cmd_defs.h"
+#include "tools/http_client.h"
+#include "tools/memory.h"
 #include "ui/window_list.h"
 #include "ui/ui.h"
 #include "ui/window.h"
@@ -62,6 +64,9 @@
 #include "gitversion.h"
 #endif
 
+#define RELEASE_URL "https://profanity-im.github.io/profanity_version.txt"
+#define RELEASE_TIMEOUT 10L
+
 static void _cons_splash_logo(void);
 void _show_roster_contacts(GSList *list, gboolean show_groups);
 
@@ -433,31 +438,41 @@ cons_about(void)
     cons_alert();
 }
 
-void
-cons_check_version(gboolean not_available_msg)
+static void
+_cons_check_version_done(const HttpResponse *const response, void *userdata)
 {
-    ProfWin *console = wins_get_console();
-    char *latest_release = release_get_latest();
+    gboolean not_available_msg = GPOINTER_TO_INT(userdata);
 
-    if (latest_release) {
-        gboolean relase_valid = g_regex_match_simple("^\\d+\\.\\d+\\.\\d+$", latest_release, 0, 0);
+    if (response->error || response->status != 200 || response->body == NULL) {
+        return;
+    }
 
-        if (relase_valid) {
-            if (release_is_new(latest_release)) {
-                win_println(console, THEME_DEFAULT, '-', "A new version of Profanity is available: %s", latest_release);
-                win_println(console, THEME_DEFAULT, '-', "Check <https://profanity-im.github.io> for details.");
+    ProfWin *console = wins_get_console();
+    char *latest_release = g_strstrip(g_strdup(response->body));
+    gboolean relase_valid = g_regex_match_simple("^\\d+\\.\\d+\\.\\d+$", latest_release, 0, 0);
+
+    if (relase_valid) {
+        if (release_is_new(latest_release)) {
+            win_println(console, THEME_DEFAULT, '-', "A new version of Profanity is available: %s", latest_release);
+            win_println(console, THEME_DEFAULT, '-', "Check <https://profanity-im.github.io> for details.");
+            win_println(console, THEME_DEFAULT, '-', "");
+        } else {
+            if (not_available_msg) {
+                win_println(console, THEME_DEFAULT, '-', "No new version available.");
                 win_println(console, THEME_DEFAULT, '-', "");
-            } else {
-                if (not_available_msg) {
-                    win_println(console, THEME_DEFAULT, '-', "No new version available.");
-                    win_println(console, THEME_DEFAULT, '-', "");
-                }
             }
-
-            cons_alert();
         }
-        free(latest_release);
+
+        cons_alert();
     }
+    g_free(latest_release);
+}
+
+void
+cons_check_version(gboolean not_available_msg)
+{
+    http_client_get(RELEASE_URL, RELEASE_TIMEOUT, _cons_check_version_done, GINT_TO_POINTER(not_available_msg),
+        NULL);
 }
 
 void
@@ -722,6 +737,10 @@ cons_show_bookmarks(const GList *list)
         cons_show("Automatic invite bookmarking (/bookmark invites): OFF");
     }
 
+    char *order = prefs_get_string(PREF_BOOKMARK_AUTOJOIN_ORDER);
+    cons_show("Autojoin order (/bookmark order): %s", order);
+    prefs_free_string(order);
+
     cons_alert();
 }
 
@@ -1222,13 +1241,6 @@ cons_tray_setting(void)
         cons_show("Tray icon read (/tray)              : ON");
     else
         cons_show("Tray icon read (/tray)              : OFF");
-
-    int seconds = prefs_get_tray_timer();
-    if (seconds == 1) {
-        cons_show("Tray timer (/tray)                  : 1 second");
-    } else {
-        cons_show("Tray timer (/tray)                  : %d seconds", seconds);
-    }
 }
 
 void
@@ -1862,6 +1874,47 @@ cons_logging_setting(void)
         cons_show("Groupchat logging (/logging group)  : ON");
     else
         cons_show("Groupchat logging (/logging group)  : OFF");
+
+    gint compress_days = prefs_get_log_compress_days();
+    if (compress_days > 0)
+        cons_show("Log compression (/logging compress) : %d days", compress_days);
+    else
+        cons_show("Log compression (/logging compress) : OFF");
+}
+
+void
+cons_memory_setting(void)
+{
+    gint budget = prefs_get_memory_budget();
+    if (budget > 0)
+        cons_show("Window memory budget (/memory budget) : %d KB", budget);
+    else
+        cons_show("Window memory budget (/memory budget) : OFF");
+
+    gint log_minutes = prefs_get_memory_log();
+    if (log_minutes > 0)
+        cons_show("Memory logging (/memory log)          : every %d minutes", log_minutes);
+    else
+        cons_show("Memory logging (/memory log)          : OFF");
+}
+
+void
+cons_show_memory(void)
+{
+    cons_show("Approximate memory use:");
+    int i;
+    for (i = 0; i < MEMORY_SUBSYSTEMS; i++) {
+        char *size = memory_format_bytes(memory_bytes(i));
+        cons_show("  %-8s %10s  %" G_GINT64_FORMAT " objects", memory_subsystem_name(i), size, memory_objects(i));
+        g_free(size);
+    }
+    char *total = memory_format_bytes(memory_total());
+    cons_show("  %-8s %10s", "total", total);
+    g_free(total);
+    cons_show("");
+    cons_memory_setting();
+
+    cons_alert();
 }
 
 void
@@ -132,6 +132,11 @@ ui_update(void)
         win_move_to_end(current);
     }
 
+    ProfXMLWin *xmlwin = wins_get_xmlconsole();
+    if (xmlwin) {
+        xmlwin_update(xmlwin);
+    }
+
     win_update_virtual(current);
 
     if (prefs_get_boolean(PREF_WINTITLE_SHOW)) {
@@ -62,10 +62,12 @@
 #include "config/accounts.h"
 #include "config/preferences.h"
 #include "config/theme.h"
+#include "tools/http_client.h"
 #include "ui/ui.h"
 #include "ui/screen.h"
 #include "ui/statusbar.h"
 #include "ui/inputwin.h"
+#include "ui/tray.h"
 #include "ui/window.h"
 #include "ui/window_list.h"
 #include "xmpp/xmpp.h"
@@ -86,12 +88,21 @@ static fd_set fds;
 static int r;
 static char *inp_line = NULL;
 static gboolean get_password = FALSE;
+static gboolean in_paste = FALSE;
+// stdin is left alone while another program prompts on the terminal
+static gboolean suspended = FALSE;
+
+/* Maximum number of keys handed to readline per select() wakeup. */
+#define INP_DRAIN_MAX 4096
+/* How long to wait for the rest of a bracketed paste, in ms. */
+#define INP_PASTE_TIMEOUT 500
 
 static void _inp_win_update_virtual(void);
 static int _inp_edited(const wint_t ch);
 static void _inp_win_handle_scroll(void);
 static int _inp_offset_to_col(char *str, int offset);
 static void _inp_write(char *line, int offset);
+static gboolean _inp_stdin_ready(long timeout_ms);
 
 static void _inp_rl_addfuncs(void);
 static int _inp_rl_getc(FILE *stream);
@@ -129,6 +140,7 @@ static int _inp_rl_subwin_pageup_handler(int count, int key);
 static int _inp_rl_subwin_pagedown_handler(int count, int key);
 static int _inp_rl_startup_hook(void);
 static int _inp_rl_down_arrow_handler(int count, int key);
+static int _inp_rl_paste_begin_handler(int count, int key);
 
 void
 create_input_window(void)
@@ -151,6 +163,10 @@ create_input_window(void)
     keypad(inp_win, TRUE);
     wmove(inp_win, 0, 0);
 
+    // readline writes its own bracketed paste request to rl_outstream, which is discarded
+    fputs("\033[?2004h", stdout);
+    fflush(stdout);
+
     _inp_win_update_virtual();
 }
 
@@ -159,14 +175,35 @@ inp_readline(void)
 {
     free(inp_line);
     inp_line = NULL;
-    p_rl_timeout.tv_sec = inp_timeout / 1000;
-    p_rl_timeout.tv_usec = inp_timeout % 1000 * 1000;
     FD_ZERO(&fds);
-    FD_SET(fileno(rl_instream), &fds);
+    if (!suspended) {
+        FD_SET(fileno(rl_instream), &fds);
+    }
+
+    // wake up for running HTTP transfers and the tray icon as well as for input
+    fd_set write_fds;
+    fd_set exc_fds;
+    FD_ZERO(&write_fds);
+    FD_ZERO(&exc_fds);
+    long timeout = inp_timeout;
+    http_client_fdset(&fds, &write_fds, &exc_fds, &timeout);
+#ifdef HAVE_GTK
+    tray_fdset(&fds, &write_fds, &exc_fds, &timeout);
+#endif
+
+    p_rl_timeout.tv_sec = timeout / 1000;
+    p_rl_timeout.tv_usec = timeout % 1000 * 1000;
     errno = 0;
     pthread_mutex_unlock(&lock);
-    r = select(FD_SETSIZE, &fds, NULL, NULL, &p_rl_timeout);
+    r = select(FD_SETSIZE, &fds, &write_fds, &exc_fds, &p_rl_timeout);
     pthread_mutex_lock(&lock);
+#ifdef HAVE_GTK
+    if (r < 0) {
+        tray_check(NULL, NULL, NULL);
+    } else {
+        tray_check(&fds, &write_fds, &exc_fds);
+    }
+#endif
     if (r < 0) {
         if (errno != EINTR) {
             char *err_msg = strerror(errno);
@@ -176,7 +213,12 @@ inp_readline(void)
     }
 
     if (FD_ISSET(fileno(rl_instream), &fds)) {
-        rl_callback_read_char();
+        // drain everything already typed or pasted, repaint once for the batch
+        int keys = 0;
+        do {
+            rl_callback_read_char();
+            keys++;
+        } while (!inp_line && keys < INP_DRAIN_MAX && _inp_stdin_ready(0));
 
         if (rl_line_buffer &&
                 rl_line_buffer[0] != '/' &&
@@ -220,6 +262,28 @@ inp_win_resize(void)
     _inp_win_update_virtual();
 }
 
+/*
+ * Stop reading keys, so a command run in the background (e.g. eval_password
+ * asking through pinentry) gets what is typed on the terminal
+ */
+void
+inp_suspend(void)
+{
+    suspended = TRUE;
+}
+
+/*
+ * Read keys again and repaint whatever the command drew over
+ */
+void
+inp_resume(void)
+{
+    if (suspended) {
+        suspended = FALSE;
+        ui_resize();
+    }
+}
+
 void
 inp_nonblocking(gboolean reset)
 {
@@ -249,6 +313,8 @@ inp_nonblocking(gboolean reset)
 void
 inp_close(void)
 {
+    fputs("\033[?2004l", stdout);
+    fflush(stdout);
     rl_callback_handler_remove();
     fclose(discard);
 }
@@ -306,7 +372,18 @@ _inp_write(char *line, int offset)
 {
     int col = _inp_offset_to_col(line, offset);
     werase(inp_win);
-    waddstr(inp_win, line);
+
+    // pasted newlines stay in the buffer, show each as a single marker cell
+    char *curr = line;
+    char *newline = strchr(curr, '\n');
+    while (newline) {
+        waddnstr(inp_win, curr, newline - curr);
+        waddch(inp_win, ACS_BULLET);
+        curr = newline + 1;
+        newline = strchr(curr, '\n');
+    }
+    waddstr(inp_win, curr);
+
     wmove(inp_win, 0, col);
     _inp_win_handle_scroll();
 
@@ -314,6 +391,20 @@ _inp_write(char *line, int offset)
     doupdate();
 }
 
+static gboolean
+_inp_stdin_ready(long timeout_ms)
+{
+    fd_set ready;
+    FD_ZERO(&ready);
+    FD_SET(fileno(rl_instream), &ready);
+
+    struct timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = timeout_ms % 1000 * 1000;
+
+    return select(fileno(rl_instream) + 1, &ready, NULL, NULL, &timeout) > 0;
+}
+
 static int
 _inp_edited(const wint_t ch)
 {
@@ -480,6 +571,8 @@ _inp_rl_startup_hook(void)
 
     rl_bind_keyseq("\\e[1;5B", _inp_rl_down_arrow_handler); // ctrl+arrow down
 
+    rl_bind_keyseq("\\e[200~", _inp_rl_paste_begin_handler);
+
     // unbind unwanted mappings
     rl_bind_keyseq("\\e=", NULL);
 
@@ -514,6 +607,10 @@ _inp_rl_getc(FILE *stream)
 {
     int ch = rl_getc(stream);
 
+    if (in_paste) {
+        return ch;
+    }
+
     // 27, 91, 90 = Shift tab
     if (ch == 27) {
         shift_tab = TRUE;
@@ -535,6 +632,60 @@ _inp_rl_getc(FILE *stream)
     return ch;
 }
 
+static int
+_inp_rl_paste_begin_handler(int count, int key)
+{
+    // read the whole paste up to ESC[201~ and insert it with one edit, so a
+    // multi-line paste becomes a single message instead of one per line
+    static const char *paste_end = "\033[201~";
+    size_t end_len = strlen(paste_end);
+    size_t matched = 0;
+    gboolean prev_cr = FALSE;
+    GString *paste = g_string_new("");
+
+    in_paste = TRUE;
+    while (matched < end_len) {
+        if (!_inp_stdin_ready(INP_PASTE_TIMEOUT)) {
+            log_warning("Bracketed paste not terminated, inserting %zu bytes", paste->len);
+            break;
+        }
+        int ch = rl_read_key();
+        if (ch == EOF) {
+            break;
+        }
+        if (ch == paste_end[matched]) {
+            matched++;
+            continue;
+        }
+        if (matched > 0) {
+            g_string_append_len(paste, paste_end, matched);
+            matched = ch == paste_end[0] ? 1 : 0;
+            if (matched) {
+                continue;
+            }
+        }
+        // terminals send CR or CRLF for pasted line breaks
+        gboolean crlf = ch == '\n' && prev_cr;
+        prev_cr = ch == '\r';
+        if (ch == '\r' || ch == '\n') {
+            if (crlf || get_password) {
+                continue;
+            }
+            ch = '\n';
+        }
+        g_string_append_c(paste, ch);
+    }
+    in_paste = FALSE;
+
+    rl_insert_text(paste->str);
+    g_string_free(paste, TRUE);
+
+    ProfWin *window = wins_get_current();
+    cmd_ac_reset(window);
+
+    return 0;
+}
+
 static int
 _inp_rl_win_clear_handler(int count, int key)
 {
@@ -107,6 +107,10 @@ void
 occupantswin_occupants(const char *const roomjid)
 {
     ProfMucWin *mucwin = wins_get_muc(roomjid);
+    // rendered again when the room is shown
+    if (mucwin && !mucwin->window.layout->pad_loaded) {
+        return;
+    }
     if (mucwin) {
         GList *occupants = muc_roster(roomjid);
         if (occupants) {
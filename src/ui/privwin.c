@@ -72,7 +72,7 @@ privwin_incoming_msg(ProfPrivateWin *privatewin, ProfMessage *message)
         win_insert_last_read_position_marker((ProfWin*)privatewin, privatewin->fulljid);
         win_print_incoming(window, jidp->resourcepart, message);
 
-        privatewin->unread++;
+        wins_unread_inc(window, FALSE, FALSE);
 
         if (prefs_get_boolean(PREF_FLASH)) {
             flash();
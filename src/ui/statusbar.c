@@ -60,6 +60,9 @@ typedef struct _status_bar_tab_t {
     char *identifier;
     gboolean highlight;
     char *display_name;
+    // name as drawn in the bar, computed on first draw
+    char *render_name;
+    int render_len;
 } StatusBarTab;
 
 typedef struct _status_bar_t {
@@ -67,7 +70,13 @@ typedef struct _status_bar_t {
     char *prompt;
     char *fulljid;
     GHashTable *tabs;
+    // numbers of the tabs with new messages
+    GHashTable *new_tabs;
     int current_tab;
+    // set when the bar must be redrawn before the next clock tick
+    gboolean dirty;
+    gint64 next_tick;
+    int tabs_width;
 } StatusBar;
 
 static GTimeZone *tz;
@@ -81,8 +90,12 @@ static int _status_bar_draw_extended_tabs(int pos);
 static int _status_bar_draw_tab(StatusBarTab *tab, int pos, int num);
 static void _destroy_tab(StatusBarTab *tab);
 static int _tabs_width(void);
+static int _tabs_width_calc(void);
 static char* _display_name(StatusBarTab *tab);
+static const char* _render_name(StatusBarTab *tab);
 static gboolean _extended_new(void);
+static void _status_bar_invalidate(void);
+static void _status_bar_schedule_tick(const char *const time_pref);
 
 void
 status_bar_init(void)
@@ -94,12 +107,16 @@ status_bar_init(void)
     statusbar->prompt = NULL;
     statusbar->fulljid = NULL;
     statusbar->tabs = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)_destroy_tab);
+    statusbar->new_tabs = g_hash_table_new(g_direct_hash, g_direct_equal);
     StatusBarTab *console = calloc(1, sizeof(StatusBarTab));
     console->window_type = WIN_CONSOLE;
     console->identifier = strdup("console");
     console->display_name = NULL;
     g_hash_table_insert(statusbar->tabs, GINT_TO_POINTER(1), console);
     statusbar->current_tab = 1;
+    statusbar->dirty = TRUE;
+    statusbar->next_tick = 0;
+    statusbar->tabs_width = -1;
 
     int row = screen_statusbar_row();
     int cols = getmaxx(stdscr);
@@ -127,6 +144,9 @@ status_bar_close(void)
         if (statusbar->tabs) {
             g_hash_table_destroy(statusbar->tabs);
         }
+        if (statusbar->new_tabs) {
+            g_hash_table_destroy(statusbar->new_tabs);
+        }
         free(statusbar);
     }
 }
@@ -140,6 +160,17 @@ status_bar_resize(void)
     wresize(statusbar_win, 1, cols);
     mvwin(statusbar_win, row, 0);
 
+    // preferences and theme changes end up here, drop everything rendered so far
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, statusbar->tabs);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        StatusBarTab *tab = value;
+        free(tab->render_name);
+        tab->render_name = NULL;
+    }
+    _status_bar_invalidate();
+
     status_bar_draw();
 }
 
@@ -147,6 +178,8 @@ void
 status_bar_set_all_inactive(void)
 {
     g_hash_table_remove_all(statusbar->tabs);
+    g_hash_table_remove_all(statusbar->new_tabs);
+    _status_bar_invalidate();
 }
 
 void
@@ -157,6 +190,7 @@ status_bar_current(int i)
     } else {
         statusbar->current_tab = i;
     }
+    _status_bar_invalidate();
 
     status_bar_draw();
 }
@@ -170,6 +204,8 @@ status_bar_inactive(const int win)
     }
 
     g_hash_table_remove(statusbar->tabs, GINT_TO_POINTER(true_win));
+    g_hash_table_remove(statusbar->new_tabs, GINT_TO_POINTER(true_win));
+    _status_bar_invalidate();
 
     status_bar_draw();
 }
@@ -187,6 +223,8 @@ _create_tab(const int win, win_type_t wintype, char *identifier, gboolean highli
     tab->highlight = highlight;
     tab->window_type = wintype;
     tab->display_name = NULL;
+    tab->render_name = NULL;
+    tab->render_len = 0;
 
     if (tab->window_type == WIN_CHAT) {
         PContact contact = NULL;
@@ -211,6 +249,12 @@ _create_tab(const int win, win_type_t wintype, char *identifier, gboolean highli
     }
 
     g_hash_table_replace(statusbar->tabs, GINT_TO_POINTER(true_win), tab);
+    if (highlight) {
+        g_hash_table_add(statusbar->new_tabs, GINT_TO_POINTER(true_win));
+    } else {
+        g_hash_table_remove(statusbar->new_tabs, GINT_TO_POINTER(true_win));
+    }
+    _status_bar_invalidate();
 
     status_bar_draw();
 }
@@ -235,6 +279,7 @@ status_bar_set_prompt(const char *const prompt)
         statusbar->prompt = NULL;
     }
     statusbar->prompt = strdup(prompt);
+    _status_bar_invalidate();
 
     status_bar_draw();
 }
@@ -246,6 +291,7 @@ status_bar_clear_prompt(void)
         free(statusbar->prompt);
         statusbar->prompt = NULL;
     }
+    _status_bar_invalidate();
 
     status_bar_draw();
 }
@@ -258,6 +304,7 @@ status_bar_set_fulljid(const char *const fulljid)
         statusbar->fulljid = NULL;
     }
     statusbar->fulljid = strdup(fulljid);
+    _status_bar_invalidate();
 
     status_bar_draw();
 }
@@ -269,6 +316,7 @@ status_bar_clear_fulljid(void)
         free(statusbar->fulljid);
         statusbar->fulljid = NULL;
     }
+    _status_bar_invalidate();
 
     status_bar_draw();
 }
@@ -276,6 +324,12 @@ status_bar_clear_fulljid(void)
 void
 status_bar_draw(void)
 {
+    // called on every main loop iteration, nothing to do until something changed or the clock ticks
+    if (!statusbar->dirty && g_get_real_time() < statusbar->next_tick) {
+        return;
+    }
+    statusbar->dirty = FALSE;
+
     werase(statusbar_win);
     wbkgd(statusbar_win, theme_attrs(THEME_STATUS_TEXT));
 
@@ -313,10 +367,12 @@ _extended_new(void)
         return FALSE;
     }
 
-    int i = 0;
-    for (i = max_tabs + 1; i <= tabs_count; i++) {
-        StatusBarTab *tab = g_hash_table_lookup(statusbar->tabs, GINT_TO_POINTER(i));
-        if (tab && tab->highlight) {
+    // only tabs with new messages need checking, not every window
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, statusbar->new_tabs);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        if (GPOINTER_TO_INT(key) > max_tabs) {
             return TRUE;
         }
     }
@@ -388,10 +444,8 @@ _status_bar_draw_tab(StatusBarTab *tab, int pos, int num)
         pos++;
     }
     if (show_name) {
-        char *display_name = _display_name(tab);
-        mvwprintw(statusbar_win, 0, pos, display_name);
-        pos += utf8_display_len(display_name);
-        free(display_name);
+        mvwprintw(statusbar_win, 0, pos, _render_name(tab));
+        pos += tab->render_len;
     }
     wattroff(statusbar_win, status_attrs);
 
@@ -420,6 +474,7 @@ static int
 _status_bar_draw_time(int pos)
 {
     char *time_pref = prefs_get_string(PREF_TIME_STATUSBAR);
+    _status_bar_schedule_tick(time_pref);
     if (g_strcmp0(time_pref, "off") == 0) {
         prefs_free_string(time_pref);
         return pos;
@@ -502,6 +557,7 @@ _destroy_tab(StatusBarTab *tab)
         if (tab->display_name) {
             free(tab->display_name);
         }
+        free(tab->render_name);
         free(tab);
     }
     tab = NULL;
@@ -509,6 +565,16 @@ _destroy_tab(StatusBarTab *tab)
 
 static int
 _tabs_width(void)
+{
+    if (statusbar->tabs_width < 0) {
+        statusbar->tabs_width = _tabs_width_calc();
+    }
+
+    return statusbar->tabs_width;
+}
+
+static int
+_tabs_width_calc(void)
 {
     gboolean show_number = prefs_get_boolean(PREF_STATUSBAR_SHOW_NUMBER);
     gboolean show_name = prefs_get_boolean(PREF_STATUSBAR_SHOW_NAME);
@@ -520,10 +586,9 @@ _tabs_width(void)
         for (i = 1; i <= max_tabs; i++) {
             StatusBarTab *tab = g_hash_table_lookup(statusbar->tabs, GINT_TO_POINTER(i));
             if (tab) {
-                char *display_name = _display_name(tab);
-                width += utf8_display_len(display_name);
+                _render_name(tab);
+                width += tab->render_len;
                 width += 4;
-                free(display_name);
             }
         }
         return width;
@@ -535,10 +600,9 @@ _tabs_width(void)
         for (i = 1; i <= max_tabs; i++) {
             StatusBarTab *tab = g_hash_table_lookup(statusbar->tabs, GINT_TO_POINTER(i));
             if (tab) {
-                char *display_name = _display_name(tab);
-                width += utf8_display_len(display_name);
+                _render_name(tab);
+                width += tab->render_len;
                 width += 2;
-                free(display_name);
             }
         }
         return width;
@@ -550,6 +614,46 @@ _tabs_width(void)
     return g_hash_table_size(statusbar->tabs) * 3 + (g_hash_table_size(statusbar->tabs) > max_tabs ? 4 : 1);
 }
 
+static const char*
+_render_name(StatusBarTab *tab)
+{
+    if (tab->render_name == NULL) {
+        tab->render_name = _display_name(tab);
+        tab->render_len = utf8_display_len(tab->render_name);
+    }
+
+    return tab->render_name;
+}
+
+static void
+_status_bar_invalidate(void)
+{
+    statusbar->dirty = TRUE;
+    statusbar->tabs_width = -1;
+}
+
+/*
+ * Work out when the displayed time next changes, only formats showing
+ * seconds need redrawing every second
+ */
+static void
+_status_bar_schedule_tick(const char *const time_pref)
+{
+    if (g_strcmp0(time_pref, "off") == 0) {
+        statusbar->next_tick = G_MAXINT64;
+        return;
+    }
+
+    gint64 precision = 60;
+    if (time_pref && (strstr(time_pref, "%S") || strstr(time_pref, "%s") || strstr(time_pref, "%T")
+            || strstr(time_pref, "%r") || strstr(time_pref, "%X") || strstr(time_pref, "%c"))) {
+        precision = 1;
+    }
+
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    statusbar->next_tick = (now / precision + 1) * precision * G_USEC_PER_SEC;
+}
+
 static char*
 _display_name(StatusBarTab *tab)
 {
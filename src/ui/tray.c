@@ -53,7 +53,17 @@ static GString *icon_filename = NULL;
 static GString *icon_msg_filename = NULL;
 static gint unread_messages;
 static gboolean shutting_down;
-static guint timer;
+
+// GTK's main context is polled from the input select rather than pumped every loop
+static GMainContext *gtk_context = NULL;
+static GPollFD *poll_fds = NULL;
+static gint poll_fds_size = 0;
+static gint poll_nfds = 0;
+static gint poll_priority = 0;
+static gboolean poll_prepared = FALSE;
+static gboolean dispatch_ready = FALSE;
+
+static void _tray_unread_changed(int total_unread);
 
 /*
  * Get icons from installation share folder or (if defined) .locale user's folder
@@ -116,16 +126,13 @@ _get_icons(void)
 }
 
 /*
- * Callback for the timer
- *
- * This is the callback that the timer is calling in order to check if messages are there.
- *
+ * Show the icon matching the unread state
  */
-gboolean
-_tray_change_icon(gpointer data)
+static void
+_tray_change_icon(void)
 {
     if (shutting_down) {
-        return FALSE;
+        return;
     }
 
     unread_messages = wins_get_total_unread();
@@ -148,8 +155,6 @@ _tray_change_icon(gpointer data)
             prof_tray = NULL;
         }
     }
-
-    return TRUE;
 }
 
 void
@@ -162,19 +167,93 @@ tray_init(void)
         return;
     }
 
+    gtk_context = g_main_context_default();
+    if (!g_main_context_acquire(gtk_context)) {
+        log_error("Could not acquire the GTK main context, tray icon disabled");
+        gtk_ready = FALSE;
+        return;
+    }
+
     if (prefs_get_boolean(PREF_TRAY)) {
         log_debug("Building GTK icon");
         tray_enable();
     }
+}
+
+/*
+ * Add the descriptors GTK is waiting on to the input select, and shorten the
+ * timeout to its next timer, so GTK only runs when it has something to do
+ */
+void
+tray_fdset(fd_set *read_fds, fd_set *write_fds, fd_set *exc_fds, long *timeout)
+{
+    if (!gtk_ready) {
+        return;
+    }
+
+    if (g_main_context_prepare(gtk_context, &poll_priority)) {
+        *timeout = 0;
+    }
+
+    gint gtk_timeout = -1;
+    while ((poll_nfds = g_main_context_query(gtk_context, poll_priority, &gtk_timeout, poll_fds, poll_fds_size)) > poll_fds_size) {
+        poll_fds_size = poll_nfds;
+        poll_fds = g_renew(GPollFD, poll_fds, poll_fds_size);
+    }
+    poll_prepared = TRUE;
+
+    if (gtk_timeout >= 0 && gtk_timeout < *timeout) {
+        *timeout = gtk_timeout;
+    }
+
+    int i;
+    for (i = 0; i < poll_nfds; i++) {
+        if (poll_fds[i].events & G_IO_IN) {
+            FD_SET(poll_fds[i].fd, read_fds);
+        }
+        if (poll_fds[i].events & G_IO_OUT) {
+            FD_SET(poll_fds[i].fd, write_fds);
+        }
+        if (poll_fds[i].events & (G_IO_PRI | G_IO_ERR | G_IO_HUP)) {
+            FD_SET(poll_fds[i].fd, exc_fds);
+        }
+    }
+}
+
+/*
+ * Hand the select result back to GTK, passing NULL sets when select failed
+ */
+void
+tray_check(fd_set *read_fds, fd_set *write_fds, fd_set *exc_fds)
+{
+    if (!poll_prepared) {
+        return;
+    }
+    poll_prepared = FALSE;
+
+    int i;
+    for (i = 0; i < poll_nfds; i++) {
+        poll_fds[i].revents = 0;
+        if (read_fds && FD_ISSET(poll_fds[i].fd, read_fds)) {
+            poll_fds[i].revents |= G_IO_IN;
+        }
+        if (write_fds && FD_ISSET(poll_fds[i].fd, write_fds)) {
+            poll_fds[i].revents |= G_IO_OUT;
+        }
+        if (exc_fds && FD_ISSET(poll_fds[i].fd, exc_fds)) {
+            poll_fds[i].revents |= poll_fds[i].events & (G_IO_PRI | G_IO_ERR | G_IO_HUP);
+        }
+    }
 
-    gtk_main_iteration_do(FALSE);
+    dispatch_ready = g_main_context_check(gtk_context, poll_priority, poll_fds, poll_nfds);
 }
 
 void
 tray_update(void)
 {
-    if (gtk_ready) {
-        gtk_main_iteration_do(FALSE);
+    if (dispatch_ready) {
+        dispatch_ready = FALSE;
+        g_main_context_dispatch(gtk_context);
     }
 }
 
@@ -184,43 +263,59 @@ tray_shutdown(void)
     if (gtk_ready && prefs_get_boolean(PREF_TRAY)) {
         tray_disable();
     }
+    if (gtk_ready) {
+        g_main_context_release(gtk_context);
+    }
+    g_free(poll_fds);
+    poll_fds = NULL;
+    poll_fds_size = 0;
     g_string_free(icon_filename, TRUE);
     g_string_free(icon_msg_filename, TRUE);
 }
 
+/*
+ * Create tray icon, it follows the unread count from then on
+ */
 void
-tray_set_timer(int interval)
+tray_enable(void)
 {
-    g_source_remove(timer);
-    _tray_change_icon(NULL);
-    timer = g_timeout_add(interval * 1000, _tray_change_icon, NULL);
+    prof_tray = gtk_status_icon_new_from_file(icon_filename->str);
+    shutting_down = FALSE;
+    _tray_change_icon();
+    wins_unread_subscribe(_tray_unread_changed);
 }
 
 /*
- * Create tray icon
- *
- * This will initialize the timer that will be called in order to change the icons
- * and will search the icons in the defaults paths
+ * Show or hide the icon after the read setting changed
  */
 void
-tray_enable(void)
+tray_update_icon(void)
 {
-    prof_tray = gtk_status_icon_new_from_file(icon_filename->str);
-    shutting_down = FALSE;
-    _tray_change_icon(NULL);
-    int interval = prefs_get_tray_timer() * 1000;
-    timer = g_timeout_add(interval, _tray_change_icon, NULL);
+    if (gtk_ready && prefs_get_boolean(PREF_TRAY)) {
+        _tray_change_icon();
+    }
 }
 
 void
 tray_disable(void)
 {
     shutting_down = TRUE;
-    g_source_remove(timer);
+    wins_unread_unsubscribe(_tray_unread_changed);
     if (prof_tray) {
         g_clear_object(&prof_tray);
         prof_tray = NULL;
     }
 }
 
+/*
+ * Switch the icon as soon as messages arrive or are read
+ */
+static void
+_tray_unread_changed(int total_unread)
+{
+    if ((total_unread > 0) != (unread_messages > 0)) {
+        _tray_change_icon();
+    }
+}
+
 #endif
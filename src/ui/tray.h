@@ -37,14 +37,17 @@
 #define UI_TRAY_H
 
 #ifdef HAVE_GTK
+#include <sys/select.h>
+
 void tray_init(void);
+void tray_fdset(fd_set *read_fds, fd_set *write_fds, fd_set *exc_fds, long *timeout);
+void tray_check(fd_set *read_fds, fd_set *write_fds, fd_set *exc_fds);
 void tray_update(void);
 void tray_shutdown(void);
 
 void tray_enable(void);
 void tray_disable(void);
-
-void tray_set_timer(int interval);
+void tray_update_icon(void);
 #endif
 
 #endif
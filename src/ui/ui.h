@@ -226,11 +226,19 @@ char* confwin_get_string(ProfConfWin *confwin);
 
 // xml console
 void xmlwin_show(ProfXMLWin *xmlwin, const char *const msg);
+void xmlwin_update(ProfXMLWin *xmlwin);
+gboolean xmlwin_set_filter(ProfXMLWin *xmlwin, const char *const filter, const char *const value);
+void xmlwin_clear_filters(ProfXMLWin *xmlwin);
+void xmlwin_show_filters(ProfXMLWin *xmlwin);
+gboolean xmlwin_save(ProfXMLWin *xmlwin, const char *const path, int *count);
+void xmlwin_clear_capture(ProfXMLWin *xmlwin);
 char* xmlwin_get_string(ProfXMLWin *xmlwin);
 
 // Input window
 char* inp_readline(void);
 void inp_nonblocking(gboolean reset);
+void inp_suspend(void);
+void inp_resume(void);
 
 // Console window
 void cons_show(const char *const msg, ...);
@@ -245,6 +253,7 @@ void cons_show_ui_prefs(void);
 void cons_show_desktop_prefs(void);
 void cons_show_chat_prefs(void);
 void cons_show_log_prefs(void);
+void cons_show_memory(void);
 void cons_show_presence_prefs(void);
 void cons_show_connection_prefs(void);
 void cons_show_otr_prefs(void);
@@ -309,6 +318,7 @@ void cons_carbons_setting(void);
 void cons_receipts_setting(void);
 void cons_log_setting(void);
 void cons_logging_setting(void);
+void cons_memory_setting(void);
 void cons_autoaway_setting(void);
 void cons_reconnect_setting(void);
 void cons_autoping_setting(void);
@@ -351,6 +361,8 @@ ProfWin* win_create_config(const char *const title, DataForm *form, ProfConfWinC
 ProfWin* win_create_private(const char *const fulljid);
 ProfWin* win_create_plugin(const char *const plugin_name, const char *const tag);
 void win_update_virtual(ProfWin *window);
+void win_pad_acquire(ProfWin *window);
+gboolean win_trim(ProfWin *window);
 void win_free(ProfWin *window);
 gboolean win_notify_remind(ProfWin *window);
 int win_unread(ProfWin *window);
@@ -362,6 +374,7 @@ void win_refresh_with_subwin(ProfWin *window);
 
 void win_print(ProfWin *window, theme_item_t theme_item, const char ch, const char *const message, ...);
 void win_println(ProfWin *window, theme_item_t theme_item, const char ch, const char *const message, ...);
+void win_println_lines(ProfWin *window, theme_item_t theme_item, const char ch, char **lines);
 void win_println_indent(ProfWin *window, int pad, const char *const message, ...);
 
 void win_append(ProfWin *window, theme_item_t theme_item, const char *const message, ...);
@@ -112,6 +112,14 @@ typedef struct prof_layout_t {
     ProfBuff buffer;
     int y_pos;
     int paged;
+    // range of entries rendered while scrolled back into spilled history,
+    // scrollback_first is -1 when showing the buffer as usual
+    int scrollback_first;
+    int scrollback_last;
+    // FALSE while the window is outside the pad pool and win is a single cell
+    gboolean pad_loaded;
+    // monotonic time the window was last shown, 0 if never
+    gint64 last_shown;
 } ProfLayout;
 
 typedef struct prof_layout_simple_t {
@@ -199,8 +207,25 @@ typedef struct prof_private_win_t {
     gboolean room_left;
 } ProfPrivateWin;
 
+typedef struct prof_xml_stanza_t {
+    gboolean sent;
+    gint64 timestamp;
+    char *stanza;
+} ProfXMLStanza;
+
 typedef struct prof_xml_win_t {
     ProfWin window;
+    // ring buffer of captured stanzas, oldest at capture_head
+    ProfXMLStanza *capture;
+    int capture_head;
+    int capture_count;
+    // total stanzas captured, and how many of those have been rendered
+    unsigned long captured;
+    unsigned long rendered;
+    GTimer *render_timer;
+    char *filter_type;
+    char *filter_ns;
+    char *filter_jid;
     unsigned long memcheck;
 } ProfXMLWin;
 
@@ -51,6 +51,7 @@
 
 #include "config/theme.h"
 #include "config/preferences.h"
+#include "tools/memory.h"
 #include "ui/ui.h"
 #include "ui/window.h"
 #include "ui/screen.h"
@@ -62,11 +63,41 @@
 
 #define CEILING(X) (X-(int)(X) > 0 ? (int)(X+1) : (int)(X))
 
+// entries rendered before the current position when paging into history
+#define SCROLLBACK_CHUNK 200
+// rows left free at the end of the pad when rendering history
+#define SCROLLBACK_PAD_MARGIN 100
+// approximate size of a pad cell, ncursesw keeps a cchar_t per cell
+#define PAD_CELL_BYTES 28
+// buffer entries kept in memory when a window is trimmed, older ones are spilled
+#define TRIM_KEEP_ENTRIES 100
+
+// windows holding a full size pad, most recently shown first, the console
+// always keeps its pad and is never in the pool
+static GQueue *pad_pool = NULL;
+
 static void _win_printf(ProfWin *window, const char show_char, int pad_indent, GDateTime *timestamp,
     int flags, theme_item_t theme_item, const char *const from, const char *const message, ...);
 static void _win_print(ProfWin *window, const char show_char, int pad_indent, GDateTime *time,
     int flags, theme_item_t theme_item, const char *const from, const char *const message, DeliveryReceipt *receipt);
+static void _win_print_internal(ProfWin *window, const char show_char, int pad_indent, GDateTime *time,
+    int flags, theme_item_t theme_item, const char *const from, const char *const message, DeliveryReceipt *receipt);
+static void _win_print_entry(ProfWin *window, ProfBuffEntry *e);
+static void _win_buffer_append(ProfWin *window, const char show_char, int pad_indent, GDateTime *time,
+    int flags, theme_item_t theme_item, const char *const from, const char *const message, DeliveryReceipt *receipt,
+    const char *const id);
+static gboolean _win_scrollback_older(ProfWin *window);
+static gboolean _win_scrollback_newer(ProfWin *window);
+static void _win_scrollback_render(ProfWin *window, int first, int anchor, int *anchor_row);
+static int _win_scrollback_render_before(ProfWin *window, int lowest, int anchor);
+static void _win_scrollback_shift(ProfWin *window, int removed);
+static void _win_scrollback_exit(ProfWin *window);
 static void _win_print_wrapped(WINDOW *win, const char *const message, size_t indent, int pad_indent);
+static void _win_pad_unload(ProfWin *window);
+static WINDOW* _win_pad_new(int rows, int cols);
+static void _win_pad_resize(WINDOW *pad, int rows, int cols);
+static void _win_pad_free(WINDOW *pad);
+static gboolean _win_spill_allowed(ProfWin *window);
 
 int
 win_roster_cols(void)
@@ -87,15 +118,18 @@ win_occpuants_cols(void)
 static ProfLayout*
 _win_create_simple_layout(void)
 {
-    int cols = getmaxx(stdscr);
-
     ProfLayoutSimple *layout = malloc(sizeof(ProfLayoutSimple));
     layout->base.type = LAYOUT_SIMPLE;
-    layout->base.win = newpad(PAD_SIZE, cols);
+    // the full size pad is only allocated once the window is shown
+    layout->base.win = _win_pad_new(1, 1);
     wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
     layout->base.buffer = buffer_create();
     layout->base.y_pos = 0;
     layout->base.paged = 0;
+    layout->base.scrollback_first = -1;
+    layout->base.scrollback_last = -1;
+    layout->base.pad_loaded = FALSE;
+    layout->base.last_shown = 0;
     scrollok(layout->base.win, TRUE);
 
     return &layout->base;
@@ -108,11 +142,15 @@ _win_create_split_layout(void)
 
     ProfLayoutSplit *layout = malloc(sizeof(ProfLayoutSplit));
     layout->base.type = LAYOUT_SPLIT;
-    layout->base.win = newpad(PAD_SIZE, cols);
+    layout->base.win = _win_pad_new(PAD_SIZE, cols);
     wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
     layout->base.buffer = buffer_create();
     layout->base.y_pos = 0;
     layout->base.paged = 0;
+    layout->base.scrollback_first = -1;
+    layout->base.scrollback_last = -1;
+    layout->base.pad_loaded = TRUE;
+    layout->base.last_shown = 0;
     scrollok(layout->base.win, TRUE);
     layout->subwin = NULL;
     layout->sub_y_pos = 0;
@@ -147,7 +185,7 @@ win_create_chat(const char *const barejid)
     new_win->is_omemo = FALSE;
     new_win->history_shown = FALSE;
     new_win->unread = 0;
-    new_win->state = chat_state_new();
+    new_win->state = chat_state_new(barejid);
     new_win->enctext = NULL;
     new_win->incoming_char = NULL;
     new_win->outgoing_char = NULL;
@@ -161,22 +199,18 @@ ProfWin*
 win_create_muc(const char *const roomjid)
 {
     ProfMucWin *new_win = malloc(sizeof(ProfMucWin));
-    int cols = getmaxx(stdscr);
 
     new_win->window.type = WIN_MUC;
-    new_win->window.layout = _win_create_simple_layout();
     ProfLayoutSplit *layout = malloc(sizeof(ProfLayoutSplit));
     layout->base.type = LAYOUT_SPLIT;
 
+    // the full size pads are only allocated once the window is shown
+    layout->base.win = _win_pad_new(1, 1);
+    wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
     if (prefs_get_boolean(PREF_OCCUPANTS)) {
-        int subwin_cols = win_occpuants_cols();
-        layout->base.win = newpad(PAD_SIZE, cols - subwin_cols);
-        wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
-        layout->subwin = newpad(PAD_SIZE, subwin_cols);;
+        layout->subwin = _win_pad_new(1, 1);
         wbkgd(layout->subwin, theme_attrs(THEME_TEXT));
     } else {
-        layout->base.win = newpad(PAD_SIZE, (cols));
-        wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
         layout->subwin = NULL;
     }
     layout->sub_y_pos = 0;
@@ -184,6 +218,10 @@ win_create_muc(const char *const roomjid)
     layout->base.buffer = buffer_create();
     layout->base.y_pos = 0;
     layout->base.paged = 0;
+    layout->base.scrollback_first = -1;
+    layout->base.scrollback_last = -1;
+    layout->base.pad_loaded = FALSE;
+    layout->base.last_shown = 0;
     scrollok(layout->base.win, TRUE);
     new_win->window.layout = (ProfLayout*)layout;
 
@@ -246,6 +284,16 @@ win_create_xmlconsole(void)
     new_win->window.type = WIN_XML;
     new_win->window.layout = _win_create_simple_layout();
 
+    new_win->capture = NULL;
+    new_win->capture_head = 0;
+    new_win->capture_count = 0;
+    new_win->captured = 0;
+    new_win->rendered = 0;
+    new_win->render_timer = g_timer_new();
+    new_win->filter_type = NULL;
+    new_win->filter_ns = NULL;
+    new_win->filter_jid = NULL;
+
     new_win->memcheck = PROFXMLWIN_MEMCHECK;
 
     return &new_win->window;
@@ -425,16 +473,22 @@ win_hide_subwin(ProfWin *window)
     if (window->layout->type == LAYOUT_SPLIT) {
         ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
         if (layout->subwin) {
-            delwin(layout->subwin);
+            _win_pad_free(layout->subwin);
         }
         layout->subwin = NULL;
         layout->sub_y_pos = 0;
+        if (!layout->base.pad_loaded) {
+            return;
+        }
         int cols = getmaxx(stdscr);
-        wresize(layout->base.win, PAD_SIZE, cols);
+        _win_pad_resize(layout->base.win, PAD_SIZE, cols);
         win_redraw(window);
     } else {
+        if (!window->layout->pad_loaded) {
+            return;
+        }
         int cols = getmaxx(stdscr);
-        wresize(window->layout->win, PAD_SIZE, cols);
+        _win_pad_resize(window->layout->win, PAD_SIZE, cols);
         win_redraw(window);
     }
 }
@@ -456,25 +510,35 @@ win_show_subwin(ProfWin *window)
     }
 
     ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
-    layout->subwin = newpad(PAD_SIZE, subwin_cols);
+    if (!layout->base.pad_loaded) {
+        layout->subwin = _win_pad_new(1, 1);
+        wbkgd(layout->subwin, theme_attrs(THEME_TEXT));
+        return;
+    }
+
+    layout->subwin = _win_pad_new(PAD_SIZE, subwin_cols);
     wbkgd(layout->subwin, theme_attrs(THEME_TEXT));
-    wresize(layout->base.win, PAD_SIZE, cols - subwin_cols);
+    _win_pad_resize(layout->base.win, PAD_SIZE, cols - subwin_cols);
     win_redraw(window);
 }
 
 void
 win_free(ProfWin* window)
 {
+    if (pad_pool) {
+        g_queue_remove(pad_pool, window);
+    }
+
     if (window->layout->type == LAYOUT_SPLIT) {
         ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
         if (layout->subwin) {
-            delwin(layout->subwin);
+            _win_pad_free(layout->subwin);
         }
         buffer_free(layout->base.buffer);
-        delwin(layout->base.win);
+        _win_pad_free(layout->base.win);
     } else {
         buffer_free(window->layout->buffer);
-        delwin(window->layout->win);
+        _win_pad_free(window->layout->win);
     }
     free(window->layout);
 
@@ -512,6 +576,16 @@ win_free(ProfWin* window)
         free(privatewin->fulljid);
         break;
     }
+    case WIN_XML:
+    {
+        ProfXMLWin *xmlwin = (ProfXMLWin*)window;
+        xmlwin_clear_capture(xmlwin);
+        g_timer_destroy(xmlwin->render_timer);
+        free(xmlwin->filter_type);
+        free(xmlwin->filter_ns);
+        free(xmlwin->filter_jid);
+        break;
+    }
     case WIN_PLUGIN:
     {
         ProfPluginWin *pluginwin = (ProfPluginWin*)window;
@@ -534,6 +608,11 @@ win_page_up(ProfWin *window)
     int page_space = rows - 4;
     int *page_start = &(window->layout->y_pos);
 
+    // at the top of the pad, page in older entries spilled to disk
+    if (*page_start == 0 && _win_scrollback_older(window)) {
+        return;
+    }
+
     *page_start -= page_space;
 
     // went past beginning, show first page
@@ -557,6 +636,11 @@ win_page_down(ProfWin *window)
     int page_space = rows - 4;
     int *page_start = &(window->layout->y_pos);
 
+    // at the bottom of rendered history, render the next entries
+    if (window->layout->scrollback_first != -1 && _win_scrollback_newer(window)) {
+        return;
+    }
+
     *page_start += page_space;
 
     // only got half a screen, show full screen
@@ -570,9 +654,14 @@ win_page_down(ProfWin *window)
     window->layout->paged = 1;
     win_update_virtual(window);
 
-    // switch off page if last line and space line visible
+    // switch off page if last line and space line visible, unless there
+    // is more history to render
     if ((y) - *page_start == page_space) {
-        window->layout->paged = 0;
+        ProfBuff buffer = window->layout->buffer;
+        int total = buffer_spilled_size(buffer) + buffer_size(buffer);
+        if (window->layout->scrollback_first == -1 || window->layout->scrollback_last >= total) {
+            window->layout->paged = 0;
+        }
     }
 }
 
@@ -637,6 +726,11 @@ win_clear(ProfWin *window)
 void
 win_resize(ProfWin *window)
 {
+    // unloaded pads are sized when the window is shown again
+    if (!window->layout->pad_loaded) {
+        return;
+    }
+
     int cols = getmaxx(stdscr);
 
     if (window->layout->type == LAYOUT_SPLIT) {
@@ -649,9 +743,9 @@ win_resize(ProfWin *window)
                 subwin_cols = win_occpuants_cols();
             }
             wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
-            wresize(layout->base.win, PAD_SIZE, cols - subwin_cols);
+            _win_pad_resize(layout->base.win, PAD_SIZE, cols - subwin_cols);
             wbkgd(layout->subwin, theme_attrs(THEME_TEXT));
-            wresize(layout->subwin, PAD_SIZE, subwin_cols);
+            _win_pad_resize(layout->subwin, PAD_SIZE, subwin_cols);
             if (window->type == WIN_CONSOLE) {
                 rosterwin_roster();
             } else if (window->type == WIN_MUC) {
@@ -661,16 +755,131 @@ win_resize(ProfWin *window)
             }
         } else {
             wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
-            wresize(layout->base.win, PAD_SIZE, cols);
+            _win_pad_resize(layout->base.win, PAD_SIZE, cols);
         }
     } else {
         wbkgd(window->layout->win, theme_attrs(THEME_TEXT));
-        wresize(window->layout->win, PAD_SIZE, cols);
+        _win_pad_resize(window->layout->win, PAD_SIZE, cols);
     }
 
     win_redraw(window);
 }
 
+void
+win_pad_acquire(ProfWin *window)
+{
+    if (window->type == WIN_CONSOLE) {
+        return;
+    }
+
+    if (pad_pool == NULL) {
+        pad_pool = g_queue_new();
+    }
+
+    window->layout->last_shown = g_get_monotonic_time();
+
+    GList *link = g_queue_find(pad_pool, window);
+    if (link) {
+        g_queue_unlink(pad_pool, link);
+        g_queue_push_head_link(pad_pool, link);
+        return;
+    }
+
+    g_queue_push_head(pad_pool, window);
+    window->layout->pad_loaded = TRUE;
+    win_resize(window);
+
+    while (g_queue_get_length(pad_pool) > PAD_POOL_SIZE) {
+        ProfWin *evicted = g_queue_pop_tail(pad_pool);
+        _win_pad_unload(evicted);
+    }
+}
+
+static void
+_win_pad_unload(ProfWin *window)
+{
+    ProfLayout *layout = window->layout;
+    layout->pad_loaded = FALSE;
+    layout->y_pos = 0;
+    layout->paged = 0;
+    if (layout->scrollback_first != -1) {
+        layout->scrollback_first = -1;
+        layout->scrollback_last = -1;
+        buffer_release_spilled(layout->buffer);
+    }
+
+    werase(layout->win);
+    _win_pad_resize(layout->win, 1, 1);
+
+    if (layout->type == LAYOUT_SPLIT) {
+        ProfLayoutSplit *split_layout = (ProfLayoutSplit*)layout;
+        if (split_layout->subwin) {
+            werase(split_layout->subwin);
+            _win_pad_resize(split_layout->subwin, 1, 1);
+        }
+        split_layout->sub_y_pos = 0;
+    }
+}
+
+/*
+ * Release the pad of a window not currently shown and move all but its most
+ * recent entries to the spill file, returns FALSE when there was nothing to
+ * release. The entries stay in memory while the window is encrypted without
+ * logging, or not logged at all.
+ */
+gboolean
+win_trim(ProfWin *window)
+{
+    if (window->type == WIN_CONSOLE) {
+        return FALSE;
+    }
+
+    gboolean trimmed = FALSE;
+    if (window->layout->pad_loaded) {
+        g_queue_remove(pad_pool, window);
+        _win_pad_unload(window);
+        trimmed = TRUE;
+    }
+
+    if (_win_spill_allowed(window) && buffer_trim(window->layout->buffer, TRIM_KEEP_ENTRIES) > 0) {
+        trimmed = TRUE;
+    }
+
+    return trimmed;
+}
+
+static gint64
+_win_pad_size(WINDOW *pad)
+{
+    return (gint64)getmaxy(pad) * getmaxx(pad) * PAD_CELL_BYTES;
+}
+
+static WINDOW*
+_win_pad_new(int rows, int cols)
+{
+    WINDOW *pad = newpad(rows, cols);
+    if (pad) {
+        memory_add(MEMORY_PADS, _win_pad_size(pad), 1);
+    }
+
+    return pad;
+}
+
+static void
+_win_pad_resize(WINDOW *pad, int rows, int cols)
+{
+    gint64 size = _win_pad_size(pad);
+    wresize(pad, rows, cols);
+    memory_add(MEMORY_PADS, _win_pad_size(pad) - size, 0);
+}
+
+static void
+_win_pad_free(WINDOW *pad)
+{
+    memory_add(MEMORY_PADS, -_win_pad_size(pad), -1);
+    delwin(pad);
+}
+
 void
 win_update_virtual(ProfWin *window)
 {
@@ -733,6 +942,10 @@ win_refresh_with_subwin(ProfWin *window)
 void
 win_move_to_end(ProfWin *window)
 {
+    if (window->layout->scrollback_first != -1) {
+        _win_scrollback_exit(window);
+    }
+
     window->layout->paged = 0;
 
     int rows = getmaxy(stdscr);
@@ -1105,7 +1318,7 @@ win_println_them_message(ProfWin *window, char ch, int flags, const char *const
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, ch, 0, timestamp, flags | NO_ME, THEME_TEXT_THEM, them, fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, ch, 0, timestamp, flags | NO_ME, THEME_TEXT_THEM, them, fmt_msg->str, NULL, NULL);
 
     _win_print(window, ch, 0, timestamp, flags | NO_ME, THEME_TEXT_THEM, them, fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1125,7 +1338,7 @@ win_println_me_message(ProfWin *window, char ch, const char *const me, const cha
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, ch, 0, timestamp, 0, THEME_TEXT_ME, me, fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, ch, 0, timestamp, 0, THEME_TEXT_ME, me, fmt_msg->str, NULL, NULL);
 
     _win_print(window, ch, 0, timestamp, 0, THEME_TEXT_ME, me, fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1145,7 +1358,7 @@ win_print_outgoing(ProfWin *window, const char ch, const char *const message, ..
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, ch, 0, timestamp, 0, THEME_TEXT_ME, "me", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, ch, 0, timestamp, 0, THEME_TEXT_ME, "me", fmt_msg->str, NULL, NULL);
 
     _win_print(window, ch, 0, timestamp, 0, THEME_TEXT_ME, "me", fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1165,7 +1378,7 @@ win_print_history(ProfWin *window, GDateTime *timestamp, const char *const messa
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, '-', 0, timestamp, 0, THEME_TEXT_HISTORY, "", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, '-', 0, timestamp, 0, THEME_TEXT_HISTORY, "", fmt_msg->str, NULL, NULL);
     _win_print(window, '-', 0, timestamp, 0, THEME_TEXT_HISTORY, "", fmt_msg->str, NULL);
 
     inp_nonblocking(TRUE);
@@ -1185,7 +1398,7 @@ win_print(ProfWin *window, theme_item_t theme_item, const char ch, const char *c
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, ch, 0, timestamp, NO_EOL, theme_item, "", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, ch, 0, timestamp, NO_EOL, theme_item, "", fmt_msg->str, NULL, NULL);
 
     _win_print(window, ch, 0, timestamp, NO_EOL, theme_item, "", fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1205,7 +1418,7 @@ win_println(ProfWin *window, theme_item_t theme_item, const char ch, const char
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, ch, 0, timestamp, 0, theme_item, "", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, ch, 0, timestamp, 0, theme_item, "", fmt_msg->str, NULL, NULL);
 
     _win_print(window, ch, 0, timestamp, 0, theme_item, "", fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1215,6 +1428,23 @@ win_println(ProfWin *window, theme_item_t theme_item, const char ch, const char
     va_end(arg);
 }
 
+/*
+ * Print several lines at once, they share one timestamp and are not formatted
+ */
+void
+win_println_lines(ProfWin *window, theme_item_t theme_item, const char ch, char **lines)
+{
+    GDateTime *timestamp = g_date_time_new_now_local();
+
+    int i;
+    for (i = 0; lines[i] != NULL; i++) {
+        _win_buffer_append(window, ch, 0, timestamp, 0, theme_item, "", lines[i], NULL, NULL);
+        _win_print(window, ch, 0, timestamp, 0, theme_item, "", lines[i], NULL);
+    }
+    inp_nonblocking(TRUE);
+    g_date_time_unref(timestamp);
+}
+
 void
 win_println_indent(ProfWin *window, int pad, const char *const message, ...)
 {
@@ -1225,7 +1455,7 @@ win_println_indent(ProfWin *window, int pad, const char *const message, ...)
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, '-', pad, timestamp, 0, THEME_DEFAULT, "", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, '-', pad, timestamp, 0, THEME_DEFAULT, "", fmt_msg->str, NULL, NULL);
 
     _win_print(window, '-', pad, timestamp, 0, THEME_DEFAULT, "", fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1245,7 +1475,7 @@ win_append(ProfWin *window, theme_item_t theme_item, const char *const message,
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, '-', 0, timestamp, NO_DATE | NO_EOL, theme_item, "", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, '-', 0, timestamp, NO_DATE | NO_EOL, theme_item, "", fmt_msg->str, NULL, NULL);
 
     _win_print(window, '-', 0, timestamp, NO_DATE | NO_EOL, theme_item, "", fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1265,7 +1495,7 @@ win_appendln(ProfWin *window, theme_item_t theme_item, const char *const message
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, '-', 0, timestamp, NO_DATE, theme_item, "", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, '-', 0, timestamp, NO_DATE, theme_item, "", fmt_msg->str, NULL, NULL);
 
     _win_print(window, '-', 0, timestamp, NO_DATE, theme_item, "", fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1285,7 +1515,7 @@ win_append_highlight(ProfWin *window, theme_item_t theme_item, const char *const
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, '-', 0, timestamp, NO_DATE | NO_ME | NO_EOL, theme_item, "", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, '-', 0, timestamp, NO_DATE | NO_ME | NO_EOL, theme_item, "", fmt_msg->str, NULL, NULL);
 
     _win_print(window, '-', 0, timestamp, NO_DATE | NO_ME | NO_EOL, theme_item, "", fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1305,7 +1535,7 @@ win_appendln_highlight(ProfWin *window, theme_item_t theme_item, const char *con
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, '-', 0, timestamp, NO_DATE | NO_ME, theme_item, "", fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, '-', 0, timestamp, NO_DATE | NO_ME, theme_item, "", fmt_msg->str, NULL, NULL);
 
     _win_print(window, '-', 0, timestamp, NO_DATE | NO_ME, theme_item, "", fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1329,7 +1559,7 @@ win_print_with_receipt(ProfWin *window, const char show_char, const char *const
     DeliveryReceipt *receipt = malloc(sizeof(struct delivery_receipt_t));
     receipt->received = FALSE;
 
-    buffer_append(window->layout->buffer, show_char, 0, time, 0, THEME_TEXT_ME, from, message, receipt, id);
+    _win_buffer_append(window, show_char, 0, time, 0, THEME_TEXT_ME, from, message, receipt, id);
     _win_print(window, show_char, 0, time, 0, THEME_TEXT_ME, from, message, receipt);
     // TODO: cross-reference.. this should be replaced by a real event-based system
     inp_nonblocking(TRUE);
@@ -1348,10 +1578,7 @@ win_mark_received(ProfWin *window, const char *const id)
 void
 win_update_entry_message(ProfWin *window, const char *const id, const char *const message)
 {
-    ProfBuffEntry *entry = buffer_get_entry_by_id(window->layout->buffer, id);
-    if (entry) {
-        free(entry->message);
-        entry->message = strdup(message);
+    if (buffer_update_entry_message(window->layout->buffer, id, message)) {
         win_redraw(window);
     }
 }
@@ -1384,7 +1611,7 @@ _win_printf(ProfWin *window, const char show_char, int pad_indent, GDateTime *ti
     GString *fmt_msg = g_string_new(NULL);
     g_string_vprintf(fmt_msg, message, arg);
 
-    buffer_append(window->layout->buffer, show_char, pad_indent, timestamp, flags, theme_item, from, fmt_msg->str, NULL, NULL);
+    _win_buffer_append(window, show_char, pad_indent, timestamp, flags, theme_item, from, fmt_msg->str, NULL, NULL);
 
     _win_print(window, show_char, pad_indent, timestamp, flags, theme_item, from, fmt_msg->str, NULL);
     inp_nonblocking(TRUE);
@@ -1397,6 +1624,24 @@ _win_printf(ProfWin *window, const char show_char, int pad_indent, GDateTime *ti
 static void
 _win_print(ProfWin *window, const char show_char, int pad_indent, GDateTime *time,
     int flags, theme_item_t theme_item, const char *const from, const char *const message, DeliveryReceipt *receipt)
+{
+    // while scrolled back the pad holds history, new entries are only
+    // buffered and get drawn when returning to the end
+    if (window->layout->scrollback_first != -1) {
+        return;
+    }
+
+    // windows without a pad are drawn from the buffer when shown
+    if (!window->layout->pad_loaded) {
+        return;
+    }
+
+    _win_print_internal(window, show_char, pad_indent, time, flags, theme_item, from, message, receipt);
+}
+
+static void
+_win_print_internal(ProfWin *window, const char show_char, int pad_indent, GDateTime *time,
+    int flags, theme_item_t theme_item, const char *const from, const char *const message, DeliveryReceipt *receipt)
 {
     // flags : 1st bit =  0/1 - me/not me
     //         2nd bit =  0/1 - date/no date
@@ -1667,21 +1912,277 @@ win_print_separator(ProfWin *window)
 void
 win_redraw(ProfWin *window)
 {
+    if (!window->layout->pad_loaded) {
+        return;
+    }
+
+    if (window->layout->scrollback_first != -1) {
+        _win_scrollback_render(window, window->layout->scrollback_first, -1, NULL);
+        return;
+    }
+
     int i, size;
     werase(window->layout->win);
     size = buffer_size(window->layout->buffer);
 
     for (i = 0; i < size; i++) {
         ProfBuffEntry *e = buffer_get_entry(window->layout->buffer, i);
+        _win_print_entry(window, e);
+    }
+}
+
+static void
+_win_print_entry(ProfWin *window, ProfBuffEntry *e)
+{
+    if (e->from == NULL && e->message && e->message[0] == '-') {
+        // just an indicator to print the separator not the actual message
+        win_print_separator(window);
+    } else {
+        // regular thing to print
+        _win_print_internal(window, e->show_char, e->pad_indent, e->time, e->flags, e->theme_item, e->from, e->message, e->receipt);
+    }
+}
+
+static gboolean
+_win_log_pref_on(preference_t pref)
+{
+    char *pref_log = prefs_get_string(pref);
+    gboolean on = g_strcmp0(pref_log, "on") == 0;
+    prefs_free_string(pref_log);
+
+    return on;
+}
+
+/*
+ * Entries may only be spilled to disk when they would also be written to the
+ * chat log, so nothing encrypted or unlogged ends up on disk in plaintext
+ */
+static gboolean
+_win_spill_allowed(ProfWin *window)
+{
+    switch (window->type) {
+    case WIN_CHAT:
+    {
+        ProfChatWin *chatwin = (ProfChatWin*)window;
+        if (!prefs_get_boolean(PREF_CHLOG)) {
+            return FALSE;
+        }
+        if (chatwin->is_otr) {
+            return _win_log_pref_on(PREF_OTR_LOG);
+        }
+        if (chatwin->pgp_send || chatwin->pgp_recv) {
+            return _win_log_pref_on(PREF_PGP_LOG);
+        }
+        if (chatwin->is_omemo) {
+            return _win_log_pref_on(PREF_OMEMO_LOG);
+        }
+        return TRUE;
+    }
+    case WIN_MUC:
+    {
+        ProfMucWin *mucwin = (ProfMucWin*)window;
+        if (!prefs_get_boolean(PREF_GRLOG)) {
+            return FALSE;
+        }
+        if (mucwin->is_omemo) {
+            return _win_log_pref_on(PREF_OMEMO_LOG);
+        }
+        return TRUE;
+    }
+    case WIN_PRIVATE:
+        return prefs_get_boolean(PREF_CHLOG);
+    default:
+        return FALSE;
+    }
+}
+
+static void
+_win_buffer_append(ProfWin *window, const char show_char, int pad_indent, GDateTime *time,
+    int flags, theme_item_t theme_item, const char *const from, const char *const message, DeliveryReceipt *receipt,
+    const char *const id)
+{
+    ProfBuff buffer = window->layout->buffer;
+    int spilled = buffer_spilled_size(buffer);
+    int total = spilled + buffer_size(buffer);
+
+    buffer_set_spill(buffer, _win_spill_allowed(window));
+    buffer_append(buffer, show_char, pad_indent, time, flags, theme_item, from, message, receipt, id);
+
+    // a full buffer dropped its oldest entry without spilling it
+    if (buffer_spilled_size(buffer) + buffer_size(buffer) == total) {
+        _win_scrollback_shift(window, spilled);
+    }
+}
+
+/*
+ * Render entries from first, spilled or buffered, until the pad is nearly
+ * full. When anchor is rendered its first row is stored in anchor_row
+ */
+static void
+_win_scrollback_render(ProfWin *window, int first, int anchor, int *anchor_row)
+{
+    ProfBuff buffer = window->layout->buffer;
+    int spilled = buffer_spilled_size(buffer);
+    int total = spilled + buffer_size(buffer);
+
+    werase(window->layout->win);
+    window->layout->scrollback_first = first;
+
+    int i;
+    for (i = first; i < total; i++) {
+        int y = getcury(window->layout->win);
+        if (i == anchor && anchor_row) {
+            *anchor_row = y;
+        }
+        if (y >= PAD_SIZE - SCROLLBACK_PAD_MARGIN) {
+            break;
+        }
 
-        if (e->from == NULL && e->message && e->message[0] == '-') {
-            // just an indicator to print the separator not the actual message
-            win_print_separator(window);
+        ProfBuffEntry *e = NULL;
+        if (i < spilled) {
+            e = buffer_get_spilled_entry(buffer, i);
         } else {
-            // regular thing to print
-            _win_print(window, e->show_char, e->pad_indent, e->time, e->flags, e->theme_item, e->from, e->message, e->receipt);
+            e = buffer_get_entry(buffer, i - spilled);
+        }
+        if (e) {
+            _win_print_entry(window, e);
         }
     }
+
+    window->layout->scrollback_last = i;
+}
+
+/*
+ * Render the entries before the first one in the pad, returns FALSE when
+ * there is no older history
+ */
+static gboolean
+_win_scrollback_older(ProfWin *window)
+{
+    ProfLayout *layout = window->layout;
+    int page_space = getmaxy(stdscr) - 4;
+
+    int anchor = layout->scrollback_first;
+    if (anchor == -1) {
+        int spilled = buffer_spilled_size(layout->buffer);
+        if (getcury(layout->win) >= PAD_SIZE - 1 && buffer_size(layout->buffer) > 0) {
+            // the pad scrolled, its first row is no longer the first
+            // buffered entry, render the buffer from its first entry and
+            // show the end of what fitted
+            _win_scrollback_render(window, spilled, -1, NULL);
+            layout->y_pos = getcury(layout->win) - page_space;
+            if (layout->y_pos < 0) {
+                layout->y_pos = 0;
+            }
+            layout->paged = 1;
+            win_update_virtual(window);
+
+            return TRUE;
+        }
+        anchor = spilled;
+    }
+    if (anchor == 0) {
+        return FALSE;
+    }
+
+    int anchor_row = _win_scrollback_render_before(window, 0, anchor);
+
+    layout->y_pos = anchor_row - page_space;
+    if (layout->y_pos < 0) {
+        layout->y_pos = 0;
+    }
+    layout->paged = 1;
+    win_update_virtual(window);
+
+    return TRUE;
+}
+
+/*
+ * Render the entries after the last one in the pad once the end of the pad
+ * is visible, returns FALSE when there is nothing more to render
+ */
+static gboolean
+_win_scrollback_newer(ProfWin *window)
+{
+    ProfLayout *layout = window->layout;
+    ProfBuff buffer = layout->buffer;
+    int total = buffer_spilled_size(buffer) + buffer_size(buffer);
+    int page_space = getmaxy(stdscr) - 4;
+    int y = getcury(layout->win);
+
+    if (layout->y_pos + page_space < y || layout->scrollback_last >= total) {
+        return FALSE;
+    }
+
+    int anchor_row = _win_scrollback_render_before(window, layout->scrollback_first + 1, layout->scrollback_last);
+
+    y = getcury(layout->win);
+    layout->y_pos = anchor_row;
+    if (layout->y_pos > y - page_space) {
+        layout->y_pos = y - page_space;
+    }
+    if (layout->y_pos < 0) {
+        layout->y_pos = 0;
+    }
+    layout->paged = 1;
+    win_update_virtual(window);
+
+    return TRUE;
+}
+
+/*
+ * Render up to SCROLLBACK_CHUNK entries from no earlier than lowest before
+ * anchor, and anchor after them. Long entries may fill the pad before anchor
+ * is reached, fewer are then rendered before it. Returns the row of anchor
+ */
+static int
+_win_scrollback_render_before(ProfWin *window, int lowest, int anchor)
+{
+    ProfBuff buffer = window->layout->buffer;
+    int total = buffer_spilled_size(buffer) + buffer_size(buffer);
+
+    // every entry takes at least a row
+    int chunk = MIN(SCROLLBACK_CHUNK, PAD_SIZE - SCROLLBACK_PAD_MARGIN - 1);
+    int anchor_row = 0;
+    while (TRUE) {
+        int first = MAX(anchor - chunk, lowest);
+        _win_scrollback_render(window, first, anchor, &anchor_row);
+        if (window->layout->scrollback_last > anchor || window->layout->scrollback_last >= total || first == anchor) {
+            break;
+        }
+        chunk = (anchor - first) / 2;
+    }
+
+    return anchor_row;
+}
+
+/*
+ * The entry at removed left the buffer without being spilled, the scrollback
+ * positions after it move down with the entries
+ */
+static void
+_win_scrollback_shift(ProfWin *window, int removed)
+{
+    ProfLayout *layout = window->layout;
+    if (layout->scrollback_first == -1) {
+        return;
+    }
+
+    if (layout->scrollback_first > removed) {
+        layout->scrollback_first--;
+    }
+    if (layout->scrollback_last > removed) {
+        layout->scrollback_last--;
+    }
+}
+
+static void
+_win_scrollback_exit(ProfWin *window)
+{
+    window->layout->scrollback_first = -1;
+    window->layout->scrollback_last = -1;
+    buffer_release_spilled(window->layout->buffer);
+    win_redraw(window);
 }
 
 gboolean
@@ -1860,7 +2361,7 @@ win_insert_last_read_position_marker(ProfWin *window, char* id)
     // the separator will actually be print in win_redraw().
     // this only puts it in the buffer and win_redraw() will interpret it.
     // so that we have the correct length even when resizing.
-    buffer_append(window->layout->buffer, ' ', 0, time, 0, THEME_TEXT, NULL, "-", NULL, id);
+    _win_buffer_append(window, ' ', 0, time, 0, THEME_TEXT, NULL, "-", NULL, id);
     win_redraw(window);
 
     g_date_time_unref(time);
@@ -54,6 +54,8 @@
 #include "xmpp/muc.h"
 
 #define PAD_SIZE 1000
+// windows besides the console holding a full size pad at any time
+#define PAD_POOL_SIZE 5
 
 void win_move_to_end(ProfWin *window);
 void win_show_status_string(ProfWin *window, const char *const from,
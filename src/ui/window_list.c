@@ -46,6 +46,7 @@
 #include "config/preferences.h"
 #include "config/theme.h"
 #include "plugins/plugins.h"
+#include "tools/memory.h"
 #include "ui/ui.h"
 #include "ui/window_list.h"
 #include "xmpp/xmpp.h"
@@ -55,14 +56,26 @@ static GHashTable *windows;
 static int current;
 static Autocomplete wins_ac;
 static Autocomplete wins_close_ac;
+static ProfXMLWin *xmlconsole;
+
+// windows with unread messages and their total, kept up to date as messages arrive and are read
+static GHashTable *unread_windows;
+static int unread_total;
+static GSList *unread_subscribers;
 
 static int _wins_cmp_num(gconstpointer a, gconstpointer b);
+static gint _wins_cmp_last_shown(gconstpointer a, gconstpointer b);
 static int _wins_get_next_available_num(GList *used);
+static void _wins_free(ProfWin *window);
+static void _wins_unread_forget(ProfWin *window);
+static void _wins_unread_notify(void);
 
 void
 wins_init(void)
 {
-    windows = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)win_free);
+    windows = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)_wins_free);
+    unread_windows = g_hash_table_new(g_direct_hash, g_direct_equal);
+    unread_total = 0;
 
     ProfWin *console = win_create_console();
     g_hash_table_insert(windows, GINT_TO_POINTER(1), console);
@@ -340,21 +353,16 @@ wins_set_current_by_num(int i)
     ProfWin *window = g_hash_table_lookup(windows, GINT_TO_POINTER(i));
     if (window) {
         current = i;
+        win_pad_acquire(window);
+        wins_unread_clear(window);
         if (window->type == WIN_CHAT) {
             ProfChatWin *chatwin = (ProfChatWin*) window;
             assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
-            chatwin->unread = 0;
             plugins_on_chat_win_focus(chatwin->barejid);
         } else if (window->type == WIN_MUC) {
             ProfMucWin *mucwin = (ProfMucWin*) window;
             assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
-            mucwin->unread = 0;
-            mucwin->unread_mentions = FALSE;
-            mucwin->unread_triggers = FALSE;
             plugins_on_room_win_focus(mucwin->roomjid);
-        } else if (window->type == WIN_PRIVATE) {
-            ProfPrivateWin *privatewin = (ProfPrivateWin*) window;
-            privatewin->unread = 0;
         }
     }
 }
@@ -570,6 +578,7 @@ wins_close_by_num(int i)
             }
             case WIN_XML:
             {
+                xmlconsole = NULL;
                 autocomplete_remove(wins_ac, "xmlconsole");
                 autocomplete_remove(wins_close_ac, "xmlconsole");
                 break;
@@ -613,6 +622,7 @@ wins_new_xmlconsole(void)
     g_list_free(keys);
     ProfWin *newwin = win_create_xmlconsole();
     g_hash_table_insert(windows, GINT_TO_POINTER(result), newwin);
+    xmlconsole = (ProfXMLWin*)newwin;
     autocomplete_add(wins_ac, "xmlconsole");
     autocomplete_add(wins_close_ac, "xmlconsole");
     return newwin;
@@ -694,35 +704,100 @@ wins_new_plugin(const char *const plugin_name, const char * const tag)
 gboolean
 wins_do_notify_remind(void)
 {
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
+    GHashTableIter iter;
+    gpointer key;
 
-    while (curr) {
-        ProfWin *window = curr->data;
-        if (win_notify_remind(window)) {
-            g_list_free(values);
+    g_hash_table_iter_init(&iter, unread_windows);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        if (win_notify_remind(key)) {
             return TRUE;
         }
-        curr = g_list_next(curr);
     }
-    g_list_free(values);
+
     return FALSE;
 }
 
 int
 wins_get_total_unread(void)
 {
-    int result = 0;
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
+    return unread_total;
+}
 
-    while (curr) {
-        ProfWin *window = curr->data;
-        result += win_unread(window);
-        curr = g_list_next(curr);
+void
+wins_unread_inc(ProfWin *window, gboolean mention, gboolean trigger)
+{
+    switch (window->type) {
+    case WIN_CHAT:
+    {
+        ProfChatWin *chatwin = (ProfChatWin*) window;
+        assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
+        chatwin->unread++;
+        break;
+    }
+    case WIN_MUC:
+    {
+        ProfMucWin *mucwin = (ProfMucWin*) window;
+        assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
+        mucwin->unread++;
+        if (mention) {
+            mucwin->unread_mentions = TRUE;
+        }
+        if (trigger) {
+            mucwin->unread_triggers = TRUE;
+        }
+        break;
+    }
+    case WIN_PRIVATE:
+    {
+        ProfPrivateWin *privatewin = (ProfPrivateWin*) window;
+        assert(privatewin->memcheck == PROFPRIVATEWIN_MEMCHECK);
+        privatewin->unread++;
+        break;
+    }
+    default:
+        return;
+    }
+
+    g_hash_table_add(unread_windows, window);
+    unread_total++;
+    _wins_unread_notify();
+}
+
+void
+wins_unread_clear(ProfWin *window)
+{
+    if (!g_hash_table_contains(unread_windows, window)) {
+        return;
+    }
+
+    _wins_unread_forget(window);
+
+    if (window->type == WIN_CHAT) {
+        ProfChatWin *chatwin = (ProfChatWin*) window;
+        chatwin->unread = 0;
+    } else if (window->type == WIN_MUC) {
+        ProfMucWin *mucwin = (ProfMucWin*) window;
+        mucwin->unread = 0;
+        mucwin->unread_mentions = FALSE;
+        mucwin->unread_triggers = FALSE;
+    } else if (window->type == WIN_PRIVATE) {
+        ProfPrivateWin *privatewin = (ProfPrivateWin*) window;
+        privatewin->unread = 0;
     }
-    g_list_free(values);
-    return result;
+}
+
+void
+wins_unread_subscribe(ProfUnreadCallback callback)
+{
+    if (!g_slist_find(unread_subscribers, (gpointer)callback)) {
+        unread_subscribers = g_slist_append(unread_subscribers, (gpointer)callback);
+    }
+}
+
+void
+wins_unread_unsubscribe(ProfUnreadCallback callback)
+{
+    unread_subscribers = g_slist_remove(unread_subscribers, (gpointer)callback);
 }
 
 void
@@ -741,6 +816,32 @@ wins_resize_all(void)
     win_update_virtual(current_win);
 }
 
+/*
+ * Trim the least recently shown windows until the memory used by window
+ * buffers and pads is no more than budget bytes, the console and the current
+ * window are left alone. Returns the number of windows trimmed
+ */
+int
+wins_trim(gint64 budget)
+{
+    ProfWin *current_win = wins_get_current();
+    GList *values = g_hash_table_get_values(windows);
+    values = g_list_sort(values, _wins_cmp_last_shown);
+
+    int trimmed = 0;
+    GList *curr = values;
+    while (curr && memory_bytes(MEMORY_BUFFERS) + memory_bytes(MEMORY_PADS) > budget) {
+        ProfWin *window = curr->data;
+        if (window != current_win && win_trim(window)) {
+            trimmed++;
+        }
+        curr = g_list_next(curr);
+    }
+    g_list_free(values);
+
+    return trimmed;
+}
+
 void
 wins_hide_subwin(ProfWin *window)
 {
@@ -762,22 +863,11 @@ wins_show_subwin(ProfWin *window)
 ProfXMLWin*
 wins_get_xmlconsole(void)
 {
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
-
-    while (curr) {
-        ProfWin *window = curr->data;
-        if (window->type == WIN_XML) {
-            ProfXMLWin *xmlwin = (ProfXMLWin*)window;
-            assert(xmlwin->memcheck == PROFXMLWIN_MEMCHECK);
-            g_list_free(values);
-            return xmlwin;
-        }
-        curr = g_list_next(curr);
+    if (xmlconsole) {
+        assert(xmlconsole->memcheck == PROFXMLWIN_MEMCHECK);
     }
 
-    g_list_free(values);
-    return NULL;
+    return xmlconsole;
 }
 
 GSList*
@@ -939,6 +1029,21 @@ _wins_cmp_num(gconstpointer a, gconstpointer b)
     }
 }
 
+static gint
+_wins_cmp_last_shown(gconstpointer a, gconstpointer b)
+{
+    const ProfWin *win_a = a;
+    const ProfWin *win_b = b;
+
+    if (win_a->layout->last_shown < win_b->layout->last_shown) {
+        return -1;
+    } else if (win_a->layout->last_shown == win_b->layout->last_shown) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
 static int
 _wins_get_next_available_num(GList *used)
 {
@@ -1011,7 +1116,7 @@ wins_tidy(void)
     if (tidy_required) {
         status_bar_set_all_inactive();
         GHashTable *new_windows = g_hash_table_new_full(g_direct_hash,
-            g_direct_equal, NULL, (GDestroyNotify)win_free);
+            g_direct_equal, NULL, (GDestroyNotify)_wins_free);
 
         int num = 1;
         GList *curr = keys;
@@ -1119,7 +1224,13 @@ win_close_reset_search_attempts(void)
 void
 wins_destroy(void)
 {
+    g_slist_free(unread_subscribers);
+    unread_subscribers = NULL;
     g_hash_table_destroy(windows);
+    g_hash_table_destroy(unread_windows);
+    unread_windows = NULL;
+    unread_total = 0;
+    xmlconsole = NULL;
     autocomplete_free(wins_ac);
     autocomplete_free(wins_close_ac);
 }
@@ -1149,3 +1260,34 @@ wins_get_next_unread(void)
     g_list_free(values);
     return NULL;
 }
+
+static void
+_wins_free(ProfWin *window)
+{
+    if (g_hash_table_contains(unread_windows, window)) {
+        _wins_unread_forget(window);
+    }
+    win_free(window);
+}
+
+static void
+_wins_unread_forget(ProfWin *window)
+{
+    g_hash_table_remove(unread_windows, window);
+    int unread = win_unread(window);
+    if (unread > 0) {
+        unread_total -= unread;
+        _wins_unread_notify();
+    }
+}
+
+static void
+_wins_unread_notify(void)
+{
+    GSList *curr = unread_subscribers;
+    while (curr) {
+        ProfUnreadCallback callback = (ProfUnreadCallback)curr->data;
+        callback(unread_total);
+        curr = g_slist_next(curr);
+    }
+}
@@ -38,6 +38,8 @@
 
 #include "ui/ui.h"
 
+typedef void (*ProfUnreadCallback)(int total_unread);
+
 void wins_init(void);
 
 ProfWin* wins_new_xmlconsole(void);
@@ -81,7 +83,12 @@ void wins_close_by_num(int i);
 gboolean wins_is_current(ProfWin *window);
 gboolean wins_do_notify_remind(void);
 int wins_get_total_unread(void);
+void wins_unread_inc(ProfWin *window, gboolean mention, gboolean trigger);
+void wins_unread_clear(ProfWin *window);
+void wins_unread_subscribe(ProfUnreadCallback callback);
+void wins_unread_unsubscribe(ProfUnreadCallback callback);
 void wins_resize_all(void);
+int wins_trim(gint64 budget);
 GSList* wins_get_chat_recipients(void);
 GSList* wins_get_prune_wins(void);
 void wins_lost_connection(void);
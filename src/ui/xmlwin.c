@@ -34,26 +34,191 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <glib.h>
+
 #include "ui/win_types.h"
 #include "ui/window_list.h"
 
+// number of stanzas kept in the capture, independent of the window buffer
+#define XMLWIN_CAPTURE_SIZE 10000
+// minimum seconds between two renders of captured stanzas
+#define XMLWIN_RENDER_INTERVAL 0.25
+// maximum stanzas rendered in one go, older ones are summarised
+#define XMLWIN_RENDER_MAX 50
+
+static ProfXMLStanza* _xmlwin_get_stanza(ProfXMLWin *xmlwin, int index);
+static gboolean _xmlwin_matches(ProfXMLWin *xmlwin, ProfXMLStanza *stanza);
+static void _xmlwin_render(ProfXMLWin *xmlwin);
+static void _xmlwin_rerender(ProfXMLWin *xmlwin);
+
 void
 xmlwin_show(ProfXMLWin *xmlwin, const char *const msg)
 {
     assert(xmlwin != NULL);
 
-    ProfWin *window = (ProfWin*)xmlwin;
+    gboolean sent;
     if (g_str_has_prefix(msg, "SENT:")) {
-        win_println(window, THEME_DEFAULT, '-', "SENT:");
-        win_println(window, THEME_ONLINE, '-', "%s", &msg[6]);
-        win_println(window, THEME_ONLINE, '-', "");
+        sent = TRUE;
     } else if (g_str_has_prefix(msg, "RECV:")) {
-        win_println(window, THEME_DEFAULT, '-', "RECV:");
-        win_println(window, THEME_AWAY, '-', "%s", &msg[6]);
-        win_println(window, THEME_AWAY, '-', "");
+        sent = FALSE;
+    } else {
+        return;
+    }
+
+    if (xmlwin->capture == NULL) {
+        xmlwin->capture = calloc(XMLWIN_CAPTURE_SIZE, sizeof(ProfXMLStanza));
+    }
+
+    ProfXMLStanza *stanza = NULL;
+    if (xmlwin->capture_count == XMLWIN_CAPTURE_SIZE) {
+        // overwrite the oldest entry
+        stanza = &xmlwin->capture[xmlwin->capture_head];
+        free(stanza->stanza);
+        xmlwin->capture_head = (xmlwin->capture_head + 1) % XMLWIN_CAPTURE_SIZE;
+    } else {
+        int index = (xmlwin->capture_head + xmlwin->capture_count) % XMLWIN_CAPTURE_SIZE;
+        stanza = &xmlwin->capture[index];
+        xmlwin->capture_count++;
+    }
+
+    stanza->sent = sent;
+    stanza->timestamp = g_get_real_time();
+    stanza->stanza = strdup(&msg[6]);
+    xmlwin->captured++;
+
+    xmlwin_update(xmlwin);
+}
+
+void
+xmlwin_update(ProfXMLWin *xmlwin)
+{
+    assert(xmlwin != NULL);
+
+    if (xmlwin->rendered == xmlwin->captured) {
+        return;
+    }
+
+    if (g_timer_elapsed(xmlwin->render_timer, NULL) < XMLWIN_RENDER_INTERVAL) {
+        return;
+    }
+
+    _xmlwin_render(xmlwin);
+    g_timer_start(xmlwin->render_timer);
+}
+
+gboolean
+xmlwin_set_filter(ProfXMLWin *xmlwin, const char *const filter, const char *const value)
+{
+    assert(xmlwin != NULL);
+
+    char **field = NULL;
+    if (g_strcmp0(filter, "type") == 0) {
+        field = &xmlwin->filter_type;
+    } else if (g_strcmp0(filter, "ns") == 0) {
+        field = &xmlwin->filter_ns;
+    } else if (g_strcmp0(filter, "jid") == 0) {
+        field = &xmlwin->filter_jid;
+    } else {
+        return FALSE;
+    }
+
+    free(*field);
+    *field = value ? strdup(value) : NULL;
+    _xmlwin_rerender(xmlwin);
+
+    return TRUE;
+}
+
+void
+xmlwin_clear_filters(ProfXMLWin *xmlwin)
+{
+    assert(xmlwin != NULL);
+
+    free(xmlwin->filter_type);
+    xmlwin->filter_type = NULL;
+    free(xmlwin->filter_ns);
+    xmlwin->filter_ns = NULL;
+    free(xmlwin->filter_jid);
+    xmlwin->filter_jid = NULL;
+    _xmlwin_rerender(xmlwin);
+}
+
+void
+xmlwin_show_filters(ProfXMLWin *xmlwin)
+{
+    assert(xmlwin != NULL);
+
+    ProfWin *window = (ProfWin*)xmlwin;
+    if (!xmlwin->filter_type && !xmlwin->filter_ns && !xmlwin->filter_jid) {
+        win_println(window, THEME_DEFAULT, '-', "No XML console filters set, %d stanzas captured.", xmlwin->capture_count);
+        return;
+    }
+
+    win_println(window, THEME_DEFAULT, '-', "XML console filters, %d stanzas captured:", xmlwin->capture_count);
+    if (xmlwin->filter_type) {
+        win_println(window, THEME_DEFAULT, '-', "  type : %s", xmlwin->filter_type);
+    }
+    if (xmlwin->filter_ns) {
+        win_println(window, THEME_DEFAULT, '-', "  ns   : %s", xmlwin->filter_ns);
+    }
+    if (xmlwin->filter_jid) {
+        win_println(window, THEME_DEFAULT, '-', "  jid  : %s", xmlwin->filter_jid);
+    }
+}
+
+/*
+ * Write every captured stanza, regardless of the current filters, to path.
+ * On success count is set to the number of stanzas written
+ */
+gboolean
+xmlwin_save(ProfXMLWin *xmlwin, const char *const path, int *count)
+{
+    assert(xmlwin != NULL);
+
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return FALSE;
+    }
+
+    int i;
+    for (i = 0; i < xmlwin->capture_count; i++) {
+        ProfXMLStanza *stanza = _xmlwin_get_stanza(xmlwin, i);
+        GDateTime *time = g_date_time_new_from_unix_local(stanza->timestamp / G_USEC_PER_SEC);
+        gchar *date_fmt = g_date_time_format(time, "%Y-%m-%dT%H:%M:%S");
+        fprintf(file, "%s.%06d %s: %s\n", date_fmt, (int)(stanza->timestamp % G_USEC_PER_SEC),
+            stanza->sent ? "SENT" : "RECV", stanza->stanza);
+        g_free(date_fmt);
+        g_date_time_unref(time);
+    }
+
+    if (fclose(file) != 0) {
+        return FALSE;
+    }
+
+    *count = xmlwin->capture_count;
+
+    return TRUE;
+}
+
+void
+xmlwin_clear_capture(ProfXMLWin *xmlwin)
+{
+    assert(xmlwin != NULL);
+
+    int i;
+    for (i = 0; i < xmlwin->capture_count; i++) {
+        free(_xmlwin_get_stanza(xmlwin, i)->stanza);
     }
+    free(xmlwin->capture);
+    xmlwin->capture = NULL;
+    xmlwin->capture_head = 0;
+    xmlwin->capture_count = 0;
+    xmlwin->rendered = xmlwin->captured;
 }
 
 char*
@@ -63,3 +228,135 @@ xmlwin_get_string(ProfXMLWin *xmlwin)
 
     return strdup("XML console");
 }
+
+static ProfXMLStanza*
+_xmlwin_get_stanza(ProfXMLWin *xmlwin, int index)
+{
+    return &xmlwin->capture[(xmlwin->capture_head + index) % XMLWIN_CAPTURE_SIZE];
+}
+
+/*
+ * Check for attr='value' or attr="value" in the stanza text, when prefix is
+ * TRUE value is a jid and may also be followed by a resource
+ */
+static gboolean
+_xmlwin_has_attribute(const char *const stanza, const char *const attr, const char *const value, gboolean prefix)
+{
+    size_t attr_len = strlen(attr);
+    size_t value_len = strlen(value);
+    const char *pos = stanza;
+
+    while ((pos = strstr(pos, value)) != NULL) {
+        if ((size_t)(pos - stanza) >= attr_len + 2) {
+            char quote = *(pos - 1);
+            if ((quote == '\'' || quote == '"') && *(pos - 2) == '='
+                    && strncmp(pos - 2 - attr_len, attr, attr_len) == 0
+                    && (pos[value_len] == quote || (prefix && pos[value_len] == '/'))) {
+                return TRUE;
+            }
+        }
+        pos++;
+    }
+
+    return FALSE;
+}
+
+static gboolean
+_xmlwin_matches(ProfXMLWin *xmlwin, ProfXMLStanza *stanza)
+{
+    if (xmlwin->filter_type) {
+        const char *name = strchr(stanza->stanza, '<');
+        if (name == NULL) {
+            return FALSE;
+        }
+        name++;
+        size_t len = strlen(xmlwin->filter_type);
+        if (strncmp(name, xmlwin->filter_type, len) != 0) {
+            return FALSE;
+        }
+        if (name[len] != ' ' && name[len] != '>' && name[len] != '/') {
+            return FALSE;
+        }
+    }
+
+    if (xmlwin->filter_ns && !_xmlwin_has_attribute(stanza->stanza, "xmlns", xmlwin->filter_ns, FALSE)) {
+        return FALSE;
+    }
+
+    if (xmlwin->filter_jid && !_xmlwin_has_attribute(stanza->stanza, "from", xmlwin->filter_jid, TRUE)
+            && !_xmlwin_has_attribute(stanza->stanza, "to", xmlwin->filter_jid, TRUE)) {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void
+_xmlwin_render(ProfXMLWin *xmlwin)
+{
+    ProfWin *window = (ProfWin*)xmlwin;
+
+    unsigned long pending = xmlwin->captured - xmlwin->rendered;
+    int first = 0;
+    if (pending < (unsigned long)xmlwin->capture_count) {
+        first = xmlwin->capture_count - (int)pending;
+    }
+
+    int matched = 0;
+    int i;
+    for (i = first; i < xmlwin->capture_count; i++) {
+        if (_xmlwin_matches(xmlwin, _xmlwin_get_stanza(xmlwin, i))) {
+            matched++;
+        }
+    }
+
+    int skip = matched > XMLWIN_RENDER_MAX ? matched - XMLWIN_RENDER_MAX : 0;
+    if (skip > 0) {
+        win_println(window, THEME_DEFAULT, '-', "... %d stanzas not shown, use /xmlconsole save to see all traffic.", skip);
+        win_println(window, THEME_DEFAULT, '-', "");
+    }
+
+    for (i = first; i < xmlwin->capture_count; i++) {
+        ProfXMLStanza *stanza = _xmlwin_get_stanza(xmlwin, i);
+        if (!_xmlwin_matches(xmlwin, stanza)) {
+            continue;
+        }
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+
+        if (stanza->sent) {
+            win_println(window, THEME_DEFAULT, '-', "SENT:");
+            win_println(window, THEME_ONLINE, '-', "%s", stanza->stanza);
+            win_println(window, THEME_ONLINE, '-', "");
+        } else {
+            win_println(window, THEME_DEFAULT, '-', "RECV:");
+            win_println(window, THEME_AWAY, '-', "%s", stanza->stanza);
+            win_println(window, THEME_AWAY, '-', "");
+        }
+    }
+
+    xmlwin->rendered = xmlwin->captured;
+}
+
+/*
+ * Redraw the window from the capture, after the filters changed
+ */
+static void
+_xmlwin_rerender(ProfXMLWin *xmlwin)
+{
+    ProfWin *window = (ProfWin*)xmlwin;
+
+    buffer_free(window->layout->buffer);
+    window->layout->buffer = buffer_create();
+    window->layout->scrollback_first = -1;
+    window->layout->scrollback_last = -1;
+    werase(window->layout->win);
+
+    xmlwin->rendered = xmlwin->captured - xmlwin->capture_count;
+    _xmlwin_render(xmlwin);
+    g_timer_start(xmlwin->render_timer);
+
+    xmlwin_show_filters(xmlwin);
+}
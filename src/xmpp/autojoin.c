@@ -0,0 +1,259 @@
+/*
+ * autojoin.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "log.h"
+#include "database.h"
+#include "config/preferences.h"
+#include "ui/window_list.h"
+#include "xmpp/autojoin.h"
+#include "xmpp/connection.h"
+#include "xmpp/jid.h"
+#include "xmpp/muc.h"
+#include "xmpp/xmpp.h"
+
+// rooms joining at the same time
+#define AUTOJOIN_CONCURRENT 4
+// give up waiting for the self presence of a room after this long
+#define AUTOJOIN_TIMEOUT (30 * G_TIME_SPAN_SECOND)
+
+typedef enum {
+    AUTOJOIN_RANK_CURRENT,
+    AUTOJOIN_RANK_OPEN,
+    AUTOJOIN_RANK_OTHER
+} autojoin_rank_t;
+
+typedef struct autojoin_room_t {
+    char *room;
+    char *nick;
+    char *password;
+    // the room is still known from before the connection was lost
+    gboolean rejoin;
+    autojoin_rank_t rank;
+    gint64 activity;
+    guint seq;
+    gint64 started;
+} AutojoinRoom;
+
+// rooms not yet started, in join order
+static GList *waiting = NULL;
+// room jid -> AutojoinRoom, waiting for the self presence
+static GHashTable *joining = NULL;
+static guint next_seq = 0;
+
+static gboolean _autojoin_start(AutojoinRoom *entry);
+static gboolean _autojoin_known(const char *const room);
+static gint _autojoin_cmp(gconstpointer a, gconstpointer b);
+static void _autojoin_room_free(AutojoinRoom *entry);
+
+/*
+ * Queue a room to be joined, rooms are started a few at a time by autojoin_process()
+ */
+void
+autojoin_add(const char *const room, const char *const nick, const char *const password, gboolean rejoin)
+{
+    if (_autojoin_known(room)) {
+        return;
+    }
+
+    AutojoinRoom *entry = malloc(sizeof(AutojoinRoom));
+    entry->room = strdup(room);
+    entry->nick = strdup(nick);
+    entry->password = password ? strdup(password) : NULL;
+    entry->rejoin = rejoin;
+    entry->seq = next_seq++;
+    entry->started = 0;
+    entry->activity = 0;
+
+    ProfWin *current = wins_get_current();
+    ProfMucWin *mucwin = wins_get_muc(room);
+    if (mucwin && current == (ProfWin*)mucwin) {
+        entry->rank = AUTOJOIN_RANK_CURRENT;
+    } else if (mucwin) {
+        entry->rank = AUTOJOIN_RANK_OPEN;
+    } else {
+        entry->rank = AUTOJOIN_RANK_OTHER;
+    }
+
+    char *order = prefs_get_string(PREF_BOOKMARK_AUTOJOIN_ORDER);
+    if (g_strcmp0(order, "activity") == 0) {
+        Jid *myjid = jid_create(connection_get_fulljid());
+        if (myjid) {
+            entry->activity = log_database_get_last_activity(myjid->barejid, room);
+            jid_destroy(myjid);
+        }
+    }
+    prefs_free_string(order);
+
+    waiting = g_list_insert_sorted(waiting, entry, _autojoin_cmp);
+}
+
+/*
+ * The self presence or an error arrived for room, make way for the next one
+ */
+void
+autojoin_room_done(const char *const room)
+{
+    if (joining && g_hash_table_remove(joining, room)) {
+        log_debug("Autojoin: %s done, %d waiting", room, g_list_length(waiting));
+        autojoin_process();
+    }
+}
+
+void
+autojoin_process(void)
+{
+    if (waiting == NULL && (joining == NULL || g_hash_table_size(joining) == 0)) {
+        return;
+    }
+
+    if (joining == NULL) {
+        joining = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)_autojoin_room_free);
+    }
+
+    // a room that never answers must not hold up the rest
+    gint64 now = g_get_monotonic_time();
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, joining);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        AutojoinRoom *entry = value;
+        if (now - entry->started >= AUTOJOIN_TIMEOUT) {
+            log_warning("Autojoin: no response from %s, moving on", entry->room);
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+
+    while (waiting && g_hash_table_size(joining) < AUTOJOIN_CONCURRENT) {
+        AutojoinRoom *entry = waiting->data;
+        waiting = g_list_delete_link(waiting, waiting);
+
+        if (_autojoin_start(entry)) {
+            entry->started = now;
+            g_hash_table_insert(joining, entry->room, entry);
+        } else {
+            _autojoin_room_free(entry);
+        }
+    }
+}
+
+void
+autojoin_clear(void)
+{
+    g_list_free_full(waiting, (GDestroyNotify)_autojoin_room_free);
+    waiting = NULL;
+    if (joining) {
+        g_hash_table_destroy(joining);
+        joining = NULL;
+    }
+}
+
+static gboolean
+_autojoin_start(AutojoinRoom *entry)
+{
+    if (entry->rejoin) {
+        log_debug("Autojoin: rejoining %s with nick=%s", entry->room, entry->nick);
+        presence_autojoin_room(entry->room, entry->nick, entry->password);
+        return TRUE;
+    }
+
+    // joined by hand, or rejoined, while waiting
+    if (muc_active(entry->room)) {
+        return FALSE;
+    }
+
+    log_debug("Autojoin: joining %s with nick=%s", entry->room, entry->nick);
+    presence_autojoin_room(entry->room, entry->nick, entry->password);
+    muc_join(entry->room, entry->nick, entry->password, TRUE);
+    iq_room_affiliation_list(entry->room, "member", false);
+    iq_room_affiliation_list(entry->room, "admin", false);
+    iq_room_affiliation_list(entry->room, "owner", false);
+
+    return TRUE;
+}
+
+static gboolean
+_autojoin_known(const char *const room)
+{
+    if (joining && g_hash_table_contains(joining, room)) {
+        return TRUE;
+    }
+
+    GList *curr = waiting;
+    while (curr) {
+        AutojoinRoom *entry = curr->data;
+        if (g_strcmp0(entry->room, room) == 0) {
+            return TRUE;
+        }
+        curr = g_list_next(curr);
+    }
+
+    return FALSE;
+}
+
+static gint
+_autojoin_cmp(gconstpointer a, gconstpointer b)
+{
+    const AutojoinRoom *entry_a = a;
+    const AutojoinRoom *entry_b = b;
+
+    if (entry_a->rank != entry_b->rank) {
+        return entry_a->rank < entry_b->rank ? -1 : 1;
+    }
+
+    // most recent activity first, activity is only set for the "activity" order
+    if (entry_a->activity != entry_b->activity) {
+        return entry_a->activity > entry_b->activity ? -1 : 1;
+    }
+
+    return entry_a->seq < entry_b->seq ? -1 : 1;
+}
+
+static void
+_autojoin_room_free(AutojoinRoom *entry)
+{
+    if (entry) {
+        free(entry->room);
+        free(entry->nick);
+        free(entry->password);
+        free(entry);
+    }
+}
@@ -59,6 +59,7 @@
 #include "plugins/plugins.h"
 #include "config/files.h"
 #include "config/preferences.h"
+#include "tools/memory.h"
 #include "xmpp/xmpp.h"
 #include "xmpp/stanza.h"
 #include "xmpp/form.h"
@@ -77,6 +78,7 @@ static void _save_cache(void);
 static EntityCapabilities* _caps_by_ver(const char *const ver);
 static EntityCapabilities* _caps_by_jid(const char *const jid);
 static EntityCapabilities* _caps_copy(EntityCapabilities *caps);
+static gint64 _caps_size(EntityCapabilities *caps);
 
 void
 caps_init(void)
@@ -209,6 +211,7 @@ caps_create(const char *const category, const char *const type, const char *cons
         result->features = g_slist_append(result->features, strdup(curr->data));
         curr = g_slist_next(curr);
     }
+    memory_add(MEMORY_CAPS, _caps_size(result), 1);
 
     return result;
 }
@@ -431,6 +434,37 @@ _caps_copy(EntityCapabilities *caps)
     return caps_create(categoty, type, name, software, software_version, os, os_version, caps->features);
 }
 
+static gint64
+_string_size(const char *const str)
+{
+    return str ? strlen(str) + 1 : 0;
+}
+
+/*
+ * Approximate heap used by capabilities, they are not changed once created
+ */
+static gint64
+_caps_size(EntityCapabilities *caps)
+{
+    gint64 size = sizeof(EntityCapabilities);
+    if (caps->identity) {
+        size += sizeof(DiscoIdentity) + _string_size(caps->identity->category)
+            + _string_size(caps->identity->type) + _string_size(caps->identity->name);
+    }
+    if (caps->software_version) {
+        size += sizeof(SoftwareVersion) + _string_size(caps->software_version->software)
+            + _string_size(caps->software_version->software_version)
+            + _string_size(caps->software_version->os) + _string_size(caps->software_version->os_version);
+    }
+    GSList *curr = caps->features;
+    while (curr) {
+        size += sizeof(GSList) + _string_size(curr->data);
+        curr = g_slist_next(curr);
+    }
+
+    return size;
+}
+
 static void
 _disco_identity_destroy(DiscoIdentity *disco_identity)
 {
@@ -458,6 +492,7 @@ void
 caps_destroy(EntityCapabilities *caps)
 {
     if (caps) {
+        memory_add(MEMORY_CAPS, -_caps_size(caps), -1);
         _disco_identity_destroy(caps->identity);
         _software_version_destroy(caps->software_version);
         if (caps->features) {
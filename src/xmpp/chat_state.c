@@ -34,6 +34,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 #include <glib.h>
@@ -45,17 +46,35 @@
 #include "xmpp/chat_state.h"
 #include "xmpp/chat_session.h"
 
-#define PAUSED_TIMEOUT 10.0
-#define INACTIVE_TIMEOUT 30.0
+#define PAUSED_TIMEOUT (10 * G_TIME_SPAN_SECOND)
+#define INACTIVE_TIMEOUT (30 * G_TIME_SPAN_SECOND)
+
+// chat states waiting for their next transition, ordered by deadline
+static GSequence *deadlines = NULL;
+
+// every live chat state, including those without a deadline
+static GHashTable *states = NULL;
 
 static void _send_if_supported(const char *const barejid, void (*send_func)(const char *const));
+static void _transition(ChatState *state, chat_state_type_t type);
+static void _schedule(ChatState *state);
+static void _unschedule(ChatState *state);
+static gint _deadline_cmp(gconstpointer a, gconstpointer b, gpointer userdata);
 
 ChatState*
-chat_state_new(void)
+chat_state_new(const char *const barejid)
 {
     ChatState *new_state = malloc(sizeof(struct prof_chat_state_t));
     new_state->type = CHAT_STATE_GONE;
-    new_state->timer = g_timer_new();
+    new_state->barejid = strdup(barejid);
+    new_state->since = g_get_monotonic_time();
+    new_state->deadline = 0;
+    new_state->scheduled = NULL;
+
+    if (states == NULL) {
+        states = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+    g_hash_table_add(states, new_state);
 
     return new_state;
 }
@@ -63,8 +82,12 @@ chat_state_new(void)
 void
 chat_state_free(ChatState *state)
 {
-    if (state && state->timer!= NULL) {
-        g_timer_destroy(state->timer);
+    if (state) {
+        _unschedule(state);
+        if (states) {
+            g_hash_table_remove(states, state);
+        }
+        free(state->barejid);
     }
     free(state);
 }
@@ -72,12 +95,11 @@ chat_state_free(ChatState *state)
 void
 chat_state_handle_idle(const char *const barejid, ChatState *state)
 {
-    gdouble elapsed = g_timer_elapsed(state->timer, NULL);
+    gint64 elapsed = g_get_monotonic_time() - state->since;
 
     // TYPING -> PAUSED
-    if (state->type == CHAT_STATE_COMPOSING && elapsed > PAUSED_TIMEOUT) {
-        state->type = CHAT_STATE_PAUSED;
-        g_timer_start(state->timer);
+    if (state->type == CHAT_STATE_COMPOSING && elapsed >= PAUSED_TIMEOUT) {
+        _transition(state, CHAT_STATE_PAUSED);
         if (prefs_get_boolean(PREF_STATES) && prefs_get_boolean(PREF_OUTTYPE)) {
             _send_if_supported(barejid, message_send_paused);
         }
@@ -85,9 +107,8 @@ chat_state_handle_idle(const char *const barejid, ChatState *state)
     }
 
     // PAUSED|ACTIVE -> INACTIVE
-    if ((state->type == CHAT_STATE_PAUSED || state->type == CHAT_STATE_ACTIVE) && elapsed > INACTIVE_TIMEOUT) {
-        state->type = CHAT_STATE_INACTIVE;
-        g_timer_start(state->timer);
+    if ((state->type == CHAT_STATE_PAUSED || state->type == CHAT_STATE_ACTIVE) && elapsed >= INACTIVE_TIMEOUT) {
+        _transition(state, CHAT_STATE_INACTIVE);
         if (prefs_get_boolean(PREF_STATES)) {
             _send_if_supported(barejid, message_send_inactive);
         }
@@ -97,7 +118,7 @@ chat_state_handle_idle(const char *const barejid, ChatState *state)
 
     // INACTIVE -> GONE
     if (state->type == CHAT_STATE_INACTIVE) {
-        if (prefs_get_gone() != 0 && (elapsed > (prefs_get_gone() * 60.0))) {
+        if (prefs_get_gone() != 0 && (elapsed >= (prefs_get_gone() * G_TIME_SPAN_MINUTE))) {
             ChatSession *session = chat_session_get(barejid);
             if (session) {
                 // never move to GONE when resource override
@@ -106,19 +127,21 @@ chat_state_handle_idle(const char *const barejid, ChatState *state)
                         _send_if_supported(barejid, message_send_gone);
                     }
                     chat_session_remove(barejid);
-                    state->type = CHAT_STATE_GONE;
-                    g_timer_start(state->timer);
+                    _transition(state, CHAT_STATE_GONE);
+                    return;
                 }
             } else {
                 if (prefs_get_boolean(PREF_STATES)) {
                     message_send_gone(barejid);
                 }
-                state->type = CHAT_STATE_GONE;
-                g_timer_start(state->timer);
+                _transition(state, CHAT_STATE_GONE);
+                return;
             }
-            return;
         }
     }
+
+    // no transition, the timeouts may have changed since the deadline was set
+    _schedule(state);
 }
 
 void
@@ -126,8 +149,7 @@ chat_state_handle_typing(const char *const barejid, ChatState *state)
 {
     // ACTIVE|INACTIVE|PAUSED|GONE -> COMPOSING
     if (state->type != CHAT_STATE_COMPOSING) {
-        state->type = CHAT_STATE_COMPOSING;
-        g_timer_start(state->timer);
+        _transition(state, CHAT_STATE_COMPOSING);
         if (prefs_get_boolean(PREF_STATES) && prefs_get_boolean(PREF_OUTTYPE)) {
             _send_if_supported(barejid, message_send_composing);
         }
@@ -137,8 +159,7 @@ chat_state_handle_typing(const char *const barejid, ChatState *state)
 void
 chat_state_active(ChatState *state)
 {
-    state->type = CHAT_STATE_ACTIVE;
-    g_timer_start(state->timer);
+    _transition(state, CHAT_STATE_ACTIVE);
 }
 
 void
@@ -148,8 +169,7 @@ chat_state_gone(const char *const barejid, ChatState *state)
         if (prefs_get_boolean(PREF_STATES)) {
             _send_if_supported(barejid, message_send_gone);
         }
-        state->type = CHAT_STATE_GONE;
-        g_timer_start(state->timer);
+        _transition(state, CHAT_STATE_GONE);
     }
 }
 
@@ -157,23 +177,46 @@ void
 chat_state_idle(void)
 {
     jabber_conn_status_t status = connection_get_status();
-    if (status == JABBER_CONNECTED) {
-        GSList *recipients = wins_get_chat_recipients();
-        GSList *curr = recipients;
-
-        while (curr) {
-            char *barejid = curr->data;
-            ProfChatWin *chatwin = wins_get_chat(barejid);
-            chat_state_handle_idle(chatwin->barejid, chatwin->state);
-            curr = g_slist_next(curr);
+    if (status != JABBER_CONNECTED || deadlines == NULL) {
+        return;
+    }
+
+    // only chats whose next transition is due are visited
+    gint64 now = g_get_monotonic_time();
+    while (!g_sequence_is_empty(deadlines)) {
+        ChatState *state = g_sequence_get(g_sequence_get_begin_iter(deadlines));
+        if (state->deadline > now) {
+            break;
         }
 
-        if (recipients) {
-            g_slist_free(recipients);
+        chat_state_handle_idle(state->barejid, state);
+
+        // still due means there is nothing left to do until the state changes again
+        if (state->scheduled && state->deadline <= now) {
+            _unschedule(state);
         }
     }
 }
 
+/*
+ * Recompute all deadlines, used when the gone timeout changes.
+ * Inactive chats are not scheduled while the gone timeout is off, so all states are visited.
+ */
+void
+chat_state_reschedule_all(void)
+{
+    if (states == NULL) {
+        return;
+    }
+
+    GHashTableIter iter;
+    gpointer state;
+    g_hash_table_iter_init(&iter, states);
+    while (g_hash_table_iter_next(&iter, &state, NULL)) {
+        _schedule(state);
+    }
+}
+
 void
 chat_state_activity(void)
 {
@@ -208,3 +251,65 @@ _send_if_supported(const char *const barejid, void (*send_func)(const char *cons
 
     g_string_free(jid, TRUE);
 }
+
+static void
+_transition(ChatState *state, chat_state_type_t type)
+{
+    state->type = type;
+    state->since = g_get_monotonic_time();
+    _schedule(state);
+}
+
+static void
+_schedule(ChatState *state)
+{
+    _unschedule(state);
+
+    switch (state->type) {
+    case CHAT_STATE_COMPOSING:
+        state->deadline = state->since + PAUSED_TIMEOUT;
+        break;
+    case CHAT_STATE_PAUSED:
+    case CHAT_STATE_ACTIVE:
+        state->deadline = state->since + INACTIVE_TIMEOUT;
+        break;
+    case CHAT_STATE_INACTIVE:
+        if (prefs_get_gone() == 0) {
+            return;
+        }
+        state->deadline = state->since + prefs_get_gone() * G_TIME_SPAN_MINUTE;
+        break;
+    default:
+        return;
+    }
+
+    if (deadlines == NULL) {
+        deadlines = g_sequence_new(NULL);
+    }
+    state->scheduled = g_sequence_insert_sorted(deadlines, state, _deadline_cmp, NULL);
+}
+
+static void
+_unschedule(ChatState *state)
+{
+    if (state->scheduled) {
+        g_sequence_remove(state->scheduled);
+        state->scheduled = NULL;
+    }
+    state->deadline = 0;
+}
+
+static gint
+_deadline_cmp(gconstpointer a, gconstpointer b, gpointer userdata)
+{
+    const ChatState *state_a = a;
+    const ChatState *state_b = b;
+
+    if (state_a->deadline < state_b->deadline) {
+        return -1;
+    } else if (state_a->deadline > state_b->deadline) {
+        return 1;
+    } else {
+        return 0;
+    }
+}
@@ -48,14 +48,19 @@ typedef enum {
 
 typedef struct prof_chat_state_t {
     chat_state_type_t type;
-    GTimer *timer;
+    char *barejid;
+    // monotonic time of the last transition, and of the next one when scheduled
+    gint64 since;
+    gint64 deadline;
+    GSequenceIter *scheduled;
 } ChatState;
 
-ChatState* chat_state_new(void);
+ChatState* chat_state_new(const char *const barejid);
 void chat_state_free(ChatState *state);
 
 void chat_state_idle(void);
 void chat_state_activity(void);
+void chat_state_reschedule_all(void);
 
 void chat_state_handle_idle(const char *const barejid, ChatState *state);
 void chat_state_handle_typing(const char *const barejid, ChatState *state);
@@ -0,0 +1,219 @@
+/*
+ * chat_state_queue.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "xmpp/jid.h"
+#include "xmpp/stanza.h"
+#include "xmpp/message.h"
+#include "xmpp/chat_state_queue.h"
+
+// minimum spacing of chat state notifications to one contact
+#define CHAT_STATE_INTERVAL (2 * G_TIME_SPAN_SECOND)
+// how long paused and inactive are held back in case typing resumes
+#define CHAT_STATE_HOLD (2 * G_TIME_SPAN_SECOND)
+// at most CHAT_STATE_CAP notifications per contact within CHAT_STATE_CAP_WINDOW
+#define CHAT_STATE_CAP 10
+#define CHAT_STATE_CAP_WINDOW G_TIME_SPAN_MINUTE
+
+typedef struct p_outbound_chat_state_t {
+    char *jid;
+    // STANZA_NAME_* constants, NULL when none
+    const char *pending;
+    const char *sent;
+    gint64 due;
+    gint64 last_sent;
+    gint64 window_start;
+    int window_count;
+} OutboundChatState;
+
+// barejid -> OutboundChatState
+static GHashTable *outbound_states = NULL;
+
+static gboolean _outbound_chat_state_flush(OutboundChatState *out, gint64 now);
+static void _outbound_chat_state_free(OutboundChatState *out);
+
+/*
+ * Chat state notifications are coalesced per contact: a state that is superseded
+ * before it goes out is dropped, as is one the contact already knows about.
+ */
+void
+chat_state_queue_push(const char *const jid, const char *const state, gint64 now)
+{
+    if (outbound_states == NULL) {
+        outbound_states = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)_outbound_chat_state_free);
+    }
+
+    Jid *jidp = jid_create(jid);
+    if (jidp == NULL) {
+        return;
+    }
+
+    OutboundChatState *out = g_hash_table_lookup(outbound_states, jidp->barejid);
+    if (out == NULL) {
+        out = malloc(sizeof(OutboundChatState));
+        out->jid = NULL;
+        out->pending = NULL;
+        out->sent = NULL;
+        out->due = 0;
+        out->last_sent = 0;
+        out->window_start = 0;
+        out->window_count = 0;
+        g_hash_table_insert(outbound_states, strdup(jidp->barejid), out);
+    }
+    jid_destroy(jidp);
+
+    free(out->jid);
+    out->jid = strdup(jid);
+
+    // e.g. composing -> paused -> composing, nothing to tell
+    if (g_strcmp0(state, out->sent) == 0) {
+        out->pending = NULL;
+        return;
+    }
+
+    out->pending = state;
+    if (g_strcmp0(state, STANZA_NAME_PAUSED) == 0 || g_strcmp0(state, STANZA_NAME_INACTIVE) == 0) {
+        out->due = now + CHAT_STATE_HOLD;
+    } else {
+        out->due = now;
+    }
+
+    _outbound_chat_state_flush(out, now);
+}
+
+/*
+ * Send chat state notifications that were held back and are now due
+ */
+void
+chat_state_queue_flush(gint64 now)
+{
+    if (outbound_states == NULL) {
+        return;
+    }
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, outbound_states);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        OutboundChatState *out = value;
+        _outbound_chat_state_flush(out, now);
+
+        // nothing more to coalesce once the contact was told we left
+        if (out->pending == NULL && g_strcmp0(out->sent, STANZA_NAME_GONE) == 0) {
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+}
+
+/*
+ * A message carries its own chat state, anything still pending for the contact is stale
+ */
+void
+chat_state_queue_superseded(const char *const jid, const char *const state)
+{
+    if (outbound_states == NULL) {
+        return;
+    }
+
+    Jid *jidp = jid_create(jid);
+    if (jidp == NULL) {
+        return;
+    }
+
+    OutboundChatState *out = g_hash_table_lookup(outbound_states, jidp->barejid);
+    if (out) {
+        out->pending = NULL;
+        out->sent = state;
+        // typing after a message is news, don't hold it back
+        out->last_sent = 0;
+    }
+    jid_destroy(jidp);
+}
+
+void
+chat_state_queue_clear(void)
+{
+    if (outbound_states) {
+        g_hash_table_remove_all(outbound_states);
+    }
+}
+
+static gboolean
+_outbound_chat_state_flush(OutboundChatState *out, gint64 now)
+{
+    if (out->pending == NULL) {
+        return FALSE;
+    }
+
+    if (now - out->window_start >= CHAT_STATE_CAP_WINDOW) {
+        out->window_start = now;
+        out->window_count = 0;
+    }
+
+    // gone is final and sent at once, everything else waits for its turn
+    if (g_strcmp0(out->pending, STANZA_NAME_GONE) != 0) {
+        if (now < out->due) {
+            return FALSE;
+        }
+        if (now - out->last_sent < CHAT_STATE_INTERVAL) {
+            return FALSE;
+        }
+        if (out->window_count >= CHAT_STATE_CAP) {
+            return FALSE;
+        }
+    }
+
+    message_send_chat_state(out->jid, out->pending);
+
+    out->sent = out->pending;
+    out->pending = NULL;
+    out->last_sent = now;
+    out->window_count++;
+
+    return TRUE;
+}
+
+static void
+_outbound_chat_state_free(OutboundChatState *out)
+{
+    if (out) {
+        free(out->jid);
+        free(out);
+    }
+}
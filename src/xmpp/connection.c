@@ -57,8 +57,10 @@
 #include "config/preferences.h"
 #include "event/server_events.h"
 #include "xmpp/connection.h"
+#include "xmpp/connector.h"
 #include "xmpp/session.h"
 #include "xmpp/iq.h"
+#include "xmpp/recorder.h"
 
 typedef struct prof_conn_t {
     xmpp_log_t *xmpp_log;
@@ -82,6 +84,7 @@ static gchar *prof_identifier = NULL;
 static xmpp_log_t* _xmpp_get_file_logger(void);
 static void _xmpp_file_logger(void *const userdata, const xmpp_log_level_t level, const char *const area, const char *const msg);
 
+static void _connection_resolved(const char *const address, int port);
 static void _connection_handler(xmpp_conn_t *const xmpp_conn, const xmpp_conn_event_t status, const int error,
     xmpp_stream_error_t *const stream_error, void *const userdata);
 
@@ -115,20 +118,28 @@ connection_init(void)
 void
 connection_check_events(void)
 {
+    // still waiting for the password or the server address
+    if (conn.xmpp_ctx == NULL) {
+        return;
+    }
+
     conn.xmpp_in_event_loop = TRUE;
     xmpp_run_once(conn.xmpp_ctx, 10);
+    recorder_replay_process();
     conn.xmpp_in_event_loop = FALSE;
 }
 
 void
 connection_shutdown(void)
 {
+    connector_shutdown();
     connection_clear_data();
     xmpp_shutdown();
 
     free(conn.xmpp_log);
     conn.xmpp_log = NULL;
 
+    recorder_close();
 	_random_bytes_close();
 }
 
@@ -147,6 +158,7 @@ connection_connect(const char *const jid, const char *const passwd, const char *
     }
 
     _compute_identifier(jidp->barejid);
+    char *domain = strdup(jidp->domainpart);
     jid_destroy(jidp);
 
     log_info("Connecting as %s", jid);
@@ -165,11 +177,13 @@ connection_connect(const char *const jid, const char *const passwd, const char *
     conn.xmpp_ctx = xmpp_ctx_new(NULL, conn.xmpp_log);
     if (conn.xmpp_ctx == NULL) {
         log_warning("Failed to get libstrophe ctx during connect");
+        free(domain);
         return JABBER_DISCONNECTED;
     }
     conn.xmpp_conn = xmpp_conn_new(conn.xmpp_ctx);
     if (conn.xmpp_conn == NULL) {
         log_warning("Failed to get libstrophe conn during connect");
+        free(domain);
         return JABBER_DISCONNECTED;
     }
     xmpp_conn_set_jid(conn.xmpp_conn, jid);
@@ -192,35 +206,55 @@ connection_connect(const char *const jid, const char *const passwd, const char *
         xmpp_conn_tlscert_path(conn.xmpp_conn, cert_path);
         free(cert_path);
     }
+#endif
+
+    // look the server up in the background, libstrophe is handed its address
+    conn.conn_status = JABBER_CONNECTING;
+    connector_resolve(domain, altdomain, port, _connection_resolved);
+    free(domain);
+
+    return conn.conn_status;
+}
 
-    int connect_status = xmpp_connect_client(
-        conn.xmpp_conn,
-        altdomain,
-        port,
-        _connection_certfail_cb,
-        _connection_handler,
-        conn.xmpp_ctx);
+/*
+ * Second stage of connection_connect, open the stream once the server address is known
+ */
+static void
+_connection_resolved(const char *const address, int port)
+{
+    int connect_status = -1;
+    if (address) {
+        log_debug("Connecting to %s port %d", address, port);
+#ifdef HAVE_LIBMESODE
+        connect_status = xmpp_connect_client(
+            conn.xmpp_conn,
+            address,
+            port,
+            _connection_certfail_cb,
+            _connection_handler,
+            conn.xmpp_ctx);
 #else
-    int connect_status = xmpp_connect_client(
-        conn.xmpp_conn,
-        altdomain,
-        port,
-        _connection_handler,
-        conn.xmpp_ctx);
+        connect_status = xmpp_connect_client(
+            conn.xmpp_conn,
+            address,
+            port,
+            _connection_handler,
+            conn.xmpp_ctx);
 #endif
+    }
 
-    if (connect_status == 0) {
-        conn.conn_status = JABBER_CONNECTING;
-    } else {
+    if (connect_status != 0 && !connector_resolve_next()) {
         conn.conn_status = JABBER_DISCONNECTED;
+        session_login_failed();
     }
-
-    return conn.conn_status;
 }
 
 void
 connection_disconnect(void)
 {
+    // a connection attempt may still be resolving the server
+    connector_cancel();
+
     // don't disconnect already disconnected connection,
     // or we get infinite loop otherwise
     if (conn.conn_last_event == XMPP_CONN_CONNECT) {
@@ -251,6 +285,15 @@ connection_disconnect(void)
     prof_identifier = NULL;
 }
 
+/*
+ * A connection attempt is under way but has not reached libstrophe yet
+ */
+void
+connection_set_connecting(void)
+{
+    conn.conn_status = JABBER_CONNECTING;
+}
+
 void
 connection_set_disconnected(void)
 {
@@ -521,6 +564,8 @@ _connection_handler(xmpp_conn_t *const xmpp_conn, const xmpp_conn_event_t status
     case XMPP_CONN_CONNECT:
         log_debug("Connection handler: XMPP_CONN_CONNECT");
         conn.conn_status = JABBER_CONNECTED;
+        // the other addresses the server resolved to are not needed any more
+        connector_cancel();
 
         Jid *my_jid = jid_create(xmpp_conn_get_jid(conn.xmpp_conn));
         conn.domain = strdup(my_jid->domainpart);
@@ -544,6 +589,11 @@ _connection_handler(xmpp_conn_t *const xmpp_conn, const xmpp_conn_event_t status
 
         // login attempt failed
         } else if (conn.conn_status != JABBER_DISCONNECTING) {
+            // a socket error means the server was not reached, it may have other addresses
+            if (error != 0 && connector_resolve_next()) {
+                log_debug("Connection handler: Could not connect, trying the next address");
+                break;
+            }
             log_debug("Connection handler: Login failed");
             session_login_failed();
         }
@@ -628,6 +678,7 @@ _xmpp_file_logger(void *const userdata, const xmpp_log_level_t xmpp_level, const
     log_msg(prof_level, area, msg);
 
     if ((g_strcmp0(area, "xmpp") == 0) || (g_strcmp0(area, "conn")) == 0) {
+        recorder_record(msg);
         sv_ev_xmpp_stanza(msg);
     }
 }
@@ -45,6 +45,7 @@ void connection_check_events(void);
 jabber_conn_status_t connection_connect(const char *const fulljid, const char *const passwd, const char *const altdomain, int port,
     const char *const tls_policy);
 void connection_disconnect(void);
+void connection_set_connecting(void);
 void connection_set_disconnected(void);
 
 void connection_set_priority(const int priority);
@@ -0,0 +1,490 @@
+/*
+ * connector.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "log.h"
+#include "common.h"
+#include "ui/ui.h"
+#include "xmpp/connector.h"
+
+// seconds eval_password may run, it can be waiting on a pinentry prompt
+#define CONNECTOR_PASSWORD_TIMEOUT 60
+
+typedef enum {
+    CONNECTOR_IDLE,
+    CONNECTOR_PASSWORD,
+    CONNECTOR_SRV,
+    CONNECTOR_HOST
+} connector_stage_t;
+
+// the one stage running, a new connect attempt replaces it
+static struct {
+    connector_stage_t stage;
+    GCancellable *cancellable;
+    GSubprocess *process;
+    GSource *timeout;
+    char *host;
+    connector_password_cb password_cb;
+} pending;
+
+// what connector_resolve found, kept so connector_resolve_next can try the rest
+static struct {
+    // GSrvTarget, the ones not yet looked up
+    GList *targets;
+    // GInetAddress of the current host, the ones not yet handed out
+    GList *addresses;
+    int port;
+    connector_resolve_cb callback;
+} candidates;
+
+// results of the running stage are dispatched from here by connector_process
+static GMainContext *context = NULL;
+
+static void _connector_begin(connector_stage_t stage);
+static void _connector_end(void);
+static void _connector_schedule(GSource *source, GSourceFunc func);
+static gboolean _connector_is_stale(gpointer data);
+
+static void _connector_password_read(GObject *source, GAsyncResult *result, gpointer data);
+static gboolean _connector_password_timeout(gpointer data);
+static gboolean _connector_password_failed(gpointer data);
+static void _connector_password_finish(char *password);
+
+static void _connector_srv_resolved(GObject *source, GAsyncResult *result, gpointer data);
+static gboolean _connector_next_target(void);
+static void _connector_lookup_host(const char *const host);
+static void _connector_host_resolved(GObject *source, GAsyncResult *result, gpointer data);
+static gboolean _connector_next_address(gpointer data);
+static void _connector_resolve_finish(const char *const address, int port);
+static void _connector_forget_candidates(void);
+
+/*
+ * Run eval_password in the background, the callback gets the first line it
+ * prints or NULL if it fails or is still running after the timeout
+ */
+void
+connector_eval_password(const char *const command, connector_password_cb callback)
+{
+    _connector_begin(CONNECTOR_PASSWORD);
+    pending.password_cb = callback;
+
+    GError *error = NULL;
+    pending.process = g_subprocess_new(G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, &error,
+        "/bin/sh", "-c", command, NULL);
+    if (pending.process == NULL) {
+        log_error("Could not run eval_password: %s", error->message);
+        g_error_free(error);
+        _connector_schedule(g_idle_source_new(), _connector_password_failed);
+        return;
+    }
+
+    // the command may prompt on the terminal, it gets the keys until it finishes
+    inp_suspend();
+
+    g_main_context_push_thread_default(context);
+    g_subprocess_communicate_async(pending.process, NULL, pending.cancellable, _connector_password_read,
+        g_object_ref(pending.cancellable));
+    g_main_context_pop_thread_default(context);
+
+    _connector_schedule(g_timeout_source_new_seconds(CONNECTOR_PASSWORD_TIMEOUT), _connector_password_timeout);
+}
+
+/*
+ * Find the address to connect to without blocking: the alternative server
+ * when one is given, otherwise the domain's xmpp-client SRV records, falling
+ * back to the domain itself. A port of 0 leaves the default to libstrophe.
+ */
+void
+connector_resolve(const char *const domain, const char *const altdomain, int port, connector_resolve_cb callback)
+{
+    _connector_forget_candidates();
+    _connector_begin(altdomain ? CONNECTOR_HOST : CONNECTOR_SRV);
+    candidates.callback = callback;
+    candidates.port = port;
+
+    if (altdomain) {
+        _connector_lookup_host(altdomain);
+        return;
+    }
+
+    pending.host = strdup(domain);
+    GResolver *resolver = g_resolver_get_default();
+    g_main_context_push_thread_default(context);
+    g_resolver_lookup_service_async(resolver, "xmpp-client", "tcp", domain, pending.cancellable, _connector_srv_resolved,
+        g_object_ref(pending.cancellable));
+    g_main_context_pop_thread_default(context);
+    g_object_unref(resolver);
+}
+
+/*
+ * The last address could not be connected to, hand out the next one: the
+ * remaining addresses of the host first, then the hosts of the remaining SRV
+ * records. Returns FALSE when nothing is left, the callback is not called then.
+ */
+gboolean
+connector_resolve_next(void)
+{
+    if (candidates.callback == NULL) {
+        return FALSE;
+    }
+
+    if (candidates.addresses) {
+        // called from the connection handler, connect again from the event loop
+        _connector_begin(CONNECTOR_HOST);
+        _connector_schedule(g_idle_source_new(), _connector_next_address);
+        return TRUE;
+    }
+
+    _connector_begin(CONNECTOR_HOST);
+    if (_connector_next_target()) {
+        return TRUE;
+    }
+
+    _connector_end();
+    _connector_forget_candidates();
+    return FALSE;
+}
+
+/*
+ * Deliver finished stages, called from the event loop
+ */
+void
+connector_process(void)
+{
+    if (context == NULL) {
+        return;
+    }
+
+    while (g_main_context_iteration(context, FALSE));
+}
+
+gboolean
+connector_pending(void)
+{
+    return pending.stage != CONNECTOR_IDLE;
+}
+
+/*
+ * Abandon the running stage without calling back, a running eval_password is killed
+ */
+void
+connector_cancel(void)
+{
+    if (pending.stage != CONNECTOR_IDLE) {
+        log_debug("Connector: cancelling stage %d", pending.stage);
+    }
+    _connector_end();
+    _connector_forget_candidates();
+}
+
+void
+connector_shutdown(void)
+{
+    connector_cancel();
+    if (context) {
+        connector_process();
+        g_main_context_unref(context);
+        context = NULL;
+    }
+}
+
+static void
+_connector_begin(connector_stage_t stage)
+{
+    _connector_end();
+    if (context == NULL) {
+        context = g_main_context_new();
+    }
+    pending.stage = stage;
+    pending.cancellable = g_cancellable_new();
+}
+
+static void
+_connector_end(void)
+{
+    if (pending.stage == CONNECTOR_PASSWORD) {
+        inp_resume();
+    }
+    if (pending.timeout) {
+        g_source_destroy(pending.timeout);
+        g_source_unref(pending.timeout);
+        pending.timeout = NULL;
+    }
+    if (pending.process) {
+        g_subprocess_force_exit(pending.process);
+        g_object_unref(pending.process);
+        pending.process = NULL;
+    }
+    if (pending.cancellable) {
+        g_cancellable_cancel(pending.cancellable);
+        g_object_unref(pending.cancellable);
+        pending.cancellable = NULL;
+    }
+    FREE_SET_NULL(pending.host);
+    pending.password_cb = NULL;
+    pending.stage = CONNECTOR_IDLE;
+}
+
+static void
+_connector_schedule(GSource *source, GSourceFunc func)
+{
+    g_source_set_callback(source, func, NULL, NULL);
+    g_source_attach(source, context);
+    pending.timeout = source;
+}
+
+/*
+ * Results of a cancelled stage still arrive, they only release their reference
+ */
+static gboolean
+_connector_is_stale(gpointer data)
+{
+    GCancellable *cancellable = data;
+    gboolean stale = g_cancellable_is_cancelled(cancellable);
+    g_object_unref(cancellable);
+
+    return stale;
+}
+
+static void
+_connector_password_read(GObject *source, GAsyncResult *result, gpointer data)
+{
+    gboolean stale = _connector_is_stale(data);
+
+    GBytes *output = NULL;
+    GError *error = NULL;
+    gboolean res = g_subprocess_communicate_finish(G_SUBPROCESS(source), result, &output, NULL, &error);
+    if (stale) {
+        if (output) {
+            g_bytes_unref(output);
+        }
+        if (error) {
+            g_error_free(error);
+        }
+        return;
+    }
+
+    if (!res) {
+        log_error("Failed to read eval_password output: %s", error->message);
+        g_error_free(error);
+        _connector_password_finish(NULL);
+        return;
+    }
+
+    // only the first line counts, limited to READ_BUF_SIZE in case of a poorly chosen command
+    char *password = NULL;
+    gsize len = 0;
+    const char *text = g_bytes_get_data(output, &len);
+    if (len > 0) {
+        if (len > READ_BUF_SIZE - 1) {
+            len = READ_BUF_SIZE - 1;
+        }
+        const char *newline = memchr(text, '\n', len);
+        password = g_strndup(text, newline ? (gsize)(newline - text) : len);
+    } else {
+        log_error("No result from eval_password.");
+    }
+    g_bytes_unref(output);
+
+    _connector_password_finish(password);
+}
+
+static gboolean
+_connector_password_timeout(gpointer data)
+{
+    log_error("eval_password did not finish within %d seconds.", CONNECTOR_PASSWORD_TIMEOUT);
+    _connector_password_finish(NULL);
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+_connector_password_failed(gpointer data)
+{
+    _connector_password_finish(NULL);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+_connector_password_finish(char *password)
+{
+    connector_password_cb callback = pending.password_cb;
+    _connector_end();
+    callback(password);
+}
+
+static void
+_connector_srv_resolved(GObject *source, GAsyncResult *result, gpointer data)
+{
+    gboolean stale = _connector_is_stale(data);
+
+    GError *error = NULL;
+    GList *targets = g_resolver_lookup_service_finish(G_RESOLVER(source), result, &error);
+    if (stale) {
+        if (targets) {
+            g_resolver_free_targets(targets);
+        }
+        if (error) {
+            g_error_free(error);
+        }
+        return;
+    }
+
+    if (targets) {
+        // already sorted by priority and weight
+        candidates.targets = targets;
+        _connector_next_target();
+    } else {
+        log_debug("Connector: no SRV record for %s, using the domain: %s", pending.host, error->message);
+        g_error_free(error);
+        _connector_lookup_host(pending.host);
+    }
+}
+
+/*
+ * Look up the host of the next SRV record, FALSE when none is left
+ */
+static gboolean
+_connector_next_target(void)
+{
+    if (candidates.targets == NULL) {
+        return FALSE;
+    }
+
+    GSrvTarget *target = candidates.targets->data;
+    candidates.targets = g_list_delete_link(candidates.targets, candidates.targets);
+
+    log_debug("Connector: trying %s:%d", g_srv_target_get_hostname(target), g_srv_target_get_port(target));
+    candidates.port = g_srv_target_get_port(target);
+    _connector_lookup_host(g_srv_target_get_hostname(target));
+    g_srv_target_free(target);
+
+    return TRUE;
+}
+
+static void
+_connector_lookup_host(const char *const host)
+{
+    pending.stage = CONNECTOR_HOST;
+
+    GResolver *resolver = g_resolver_get_default();
+    g_main_context_push_thread_default(context);
+    g_resolver_lookup_by_name_async(resolver, host, pending.cancellable, _connector_host_resolved,
+        g_object_ref(pending.cancellable));
+    g_main_context_pop_thread_default(context);
+    g_object_unref(resolver);
+}
+
+static void
+_connector_host_resolved(GObject *source, GAsyncResult *result, gpointer data)
+{
+    gboolean stale = _connector_is_stale(data);
+
+    GError *error = NULL;
+    GList *addresses = g_resolver_lookup_by_name_finish(G_RESOLVER(source), result, &error);
+    if (stale) {
+        if (addresses) {
+            g_resolver_free_addresses(addresses);
+        }
+        if (error) {
+            g_error_free(error);
+        }
+        return;
+    }
+
+    if (addresses == NULL) {
+        log_error("Could not resolve server address: %s", error->message);
+        g_error_free(error);
+        if (!_connector_next_target()) {
+            _connector_resolve_finish(NULL, 0);
+        }
+        return;
+    }
+
+    candidates.addresses = addresses;
+    _connector_next_address(NULL);
+}
+
+/*
+ * Hand out the next address of the current host
+ */
+static gboolean
+_connector_next_address(gpointer data)
+{
+    GInetAddress *next = candidates.addresses->data;
+    candidates.addresses = g_list_delete_link(candidates.addresses, candidates.addresses);
+
+    // connect straight to the address so libstrophe has nothing left to look up
+    char *address = g_inet_address_to_string(next);
+    g_object_unref(next);
+    _connector_resolve_finish(address, candidates.port);
+    g_free(address);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+_connector_resolve_finish(const char *const address, int port)
+{
+    connector_resolve_cb callback = candidates.callback;
+    _connector_end();
+    if (address == NULL) {
+        _connector_forget_candidates();
+    }
+    callback(address, port);
+}
+
+static void
+_connector_forget_candidates(void)
+{
+    if (candidates.targets) {
+        g_resolver_free_targets(candidates.targets);
+        candidates.targets = NULL;
+    }
+    if (candidates.addresses) {
+        g_resolver_free_addresses(candidates.addresses);
+        candidates.addresses = NULL;
+    }
+    candidates.port = 0;
+    candidates.callback = NULL;
+}
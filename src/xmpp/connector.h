@@ -0,0 +1,54 @@
+/*
+ * connector.h
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef XMPP_CONNECTOR_H
+#define XMPP_CONNECTOR_H
+
+#include <glib.h>
+
+// receives the evaluated password, or NULL when the command failed, and must g_free it
+typedef void (*connector_password_cb)(char *password);
+// receives the address to connect to, or NULL when it could not be resolved
+typedef void (*connector_resolve_cb)(const char *const address, int port);
+
+void connector_eval_password(const char *const command, connector_password_cb callback);
+void connector_resolve(const char *const domain, const char *const altdomain, int port, connector_resolve_cb callback);
+gboolean connector_resolve_next(void);
+void connector_process(void);
+gboolean connector_pending(void);
+void connector_cancel(void);
+void connector_shutdown(void);
+
+#endif
@@ -72,6 +72,8 @@
 #include "xmpp/roster_list.h"
 #include "xmpp/roster.h"
 #include "xmpp/muc.h"
+#include "xmpp/outbound.h"
+#include "xmpp/room_directory.h"
 
 #ifdef HAVE_OMEMO
 #include "omemo/omemo.h"
@@ -103,6 +105,16 @@ typedef struct command_config_data_t {
     char *command;
 } CommandConfigData;
 
+typedef struct room_list_request_t {
+    char *service;
+    char *filter;
+    RoomDirectory *directory;
+    gboolean display;
+} RoomListRequest;
+
+// rooms requested per disco#items page on services supporting result set management
+#define ROOM_LIST_PAGE_SIZE 250
+
 static int _iq_handler(xmpp_conn_t *const conn, xmpp_stanza_t *const stanza, void *const userdata);
 
 static void _error_handler(xmpp_stanza_t *const stanza);
@@ -139,9 +151,13 @@ static int _command_list_result_handler(xmpp_stanza_t *const stanza, void *const
 static int _command_exec_response_handler(xmpp_stanza_t *const stanza, void *const userdata);
 
 static void _iq_free_room_data(ProfRoomInfoData *roominfo);
+static void _iq_free_room_list_request(RoomListRequest *request);
+static void _room_list_request_page(RoomListRequest *request, const char *const after);
+static void _room_list_show(RoomDirectory *directory, const char *const filter);
 static void _iq_free_affiliation_set(ProfPrivilegeSet *affiliation_set);
 static void _iq_free_affiliation_list(ProfAffiliationList *affiliation_list);
 static void _iq_id_handler_free(ProfIqHandler *handler);
+static void _iq_send(xmpp_stanza_t *const stanza, outbound_class_t class);
 
 // scheduled
 static int _autoping_timed_send(xmpp_conn_t *const conn, void *const userdata);
@@ -152,7 +168,6 @@ static void _item_destroy(DiscoItem *item);
 static gboolean autoping_wait = FALSE;
 static GTimer *autoping_time = NULL;
 static GHashTable *id_handlers;
-static GHashTable *rooms_cache = NULL;
 
 static int
 _iq_handler(xmpp_conn_t *const conn, xmpp_stanza_t *const stanza, void *const userdata)
@@ -244,7 +259,16 @@ iq_handlers_init(void)
     iq_handlers_clear();
 
     id_handlers = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)_iq_id_handler_free);
-    rooms_cache = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)xmpp_stanza_release);
+}
+
+/*
+ * Run an iq stanza through the iq handler as if it was received from the
+ * server, used to replay recorded traffic
+ */
+void
+iq_handle_stanza(xmpp_stanza_t *const stanza)
+{
+    _iq_handler(connection_get_conn(), stanza, NULL);
 }
 
 void
@@ -338,31 +362,35 @@ iq_set_autoping(const int seconds)
 void
 iq_rooms_cache_clear(void)
 {
-    if (rooms_cache) {
-        g_hash_table_remove_all(rooms_cache);
-        rooms_cache = NULL;
-    }
+    room_directory_clear();
 }
 
 void
 iq_room_list_request(gchar *conferencejid, gchar *filter)
 {
-    if (g_hash_table_contains(rooms_cache, conferencejid)) {
-        log_debug("Rooms request cached for: %s", conferencejid);
-        _room_list_id_handler(g_hash_table_lookup(rooms_cache, conferencejid), filter);
-        return;
+    RoomDirectory *cached = NULL;
+    if (prefs_get_boolean(PREF_ROOM_LIST_CACHE)) {
+        cached = room_directory_get(conferencejid);
     }
 
-    log_debug("Rooms request not cached for: %s", conferencejid);
-
-    xmpp_ctx_t * const ctx = connection_get_ctx();
-    char *id = connection_create_stanza_id();
-    xmpp_stanza_t *iq = stanza_create_disco_items_iq(ctx, id, conferencejid, NULL);
+    if (cached) {
+        log_debug("Rooms request cached for: %s", conferencejid);
+        _room_list_show(cached, filter);
+        if (!room_directory_is_stale(cached)) {
+            return;
+        }
+        log_debug("Rooms cache stale for: %s, refreshing", conferencejid);
+    } else {
+        log_debug("Rooms request not cached for: %s", conferencejid);
+    }
 
-    iq_id_handler_add(id, _room_list_id_handler, NULL, filter);
+    RoomListRequest *request = malloc(sizeof(RoomListRequest));
+    request->service = strdup(conferencejid);
+    request->filter = filter ? strdup(filter) : NULL;
+    request->directory = room_directory_new(conferencejid);
+    request->display = cached == NULL;
 
-    iq_send_stanza(iq);
-    xmpp_stanza_release(iq);
+    _room_list_request_page(request, NULL);
 }
 
 void
@@ -438,7 +466,7 @@ iq_disco_info_request_onconnect(gchar *jid)
 
     free(id);
 
-    iq_send_stanza(iq);
+    iq_send_stanza_bulk(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -498,7 +526,7 @@ iq_send_caps_request_for_jid(const char *const to, const char *const id,
 
     iq_id_handler_add(id, _caps_response_for_jid_id_handler, free, strdup(to));
 
-    iq_send_stanza(iq);
+    iq_send_stanza_bulk(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -524,7 +552,7 @@ iq_send_caps_request(const char *const to, const char *const id,
 
     iq_id_handler_add(id, _caps_response_id_handler, NULL, NULL);
 
-    iq_send_stanza(iq);
+    iq_send_stanza_bulk(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -550,7 +578,7 @@ iq_send_caps_request_legacy(const char *const to, const char *const id,
     iq_id_handler_add(id, _caps_response_legacy_id_handler, g_free, node_str->str);
     g_string_free(node_str, FALSE);
 
-    iq_send_stanza(iq);
+    iq_send_stanza_bulk(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -568,7 +596,7 @@ iq_disco_items_request_onconnect(gchar *jid)
 {
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_disco_items_iq(ctx, "discoitemsreq_onconnect", jid, NULL);
-    iq_send_stanza(iq);
+    iq_send_stanza_bulk(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -656,7 +684,11 @@ iq_room_affiliation_list(const char *const room, char *affiliation, bool show_ui
 
     iq_id_handler_add(id, _room_affiliation_list_result_id_handler, (ProfIqFreeCallback)_iq_free_affiliation_list, affiliation_list);
 
-    iq_send_stanza(iq);
+    if (show_ui_message) {
+        iq_send_stanza(iq);
+    } else {
+        iq_send_stanza_bulk(iq);
+    }
     xmpp_stanza_release(iq);
 }
 
@@ -1004,92 +1036,114 @@ _caps_response_legacy_id_handler(xmpp_stanza_t *const stanza, void *const userda
 static int
 _room_list_id_handler(xmpp_stanza_t *const stanza, void *const userdata)
 {
-    gchar *filter = (gchar*)userdata;
+    RoomListRequest *request = (RoomListRequest*)userdata;
     const char *id = xmpp_stanza_get_id(stanza);
-    const char *from = xmpp_stanza_get_from(stanza);
-
-    if (prefs_get_boolean(PREF_ROOM_LIST_CACHE) && !g_hash_table_contains(rooms_cache, from)) {
-        g_hash_table_insert(rooms_cache, strdup(from), xmpp_stanza_copy(stanza));
-    }
 
     log_debug("Response to query: %s", id);
 
+    int before = room_directory_size(request->directory);
+    char *last = NULL;
+
     xmpp_stanza_t *query = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_QUERY);
-    if (query == NULL) {
+    if (query) {
+        xmpp_stanza_t *child = xmpp_stanza_get_children(query);
+        while (child) {
+            const char *stanza_name = xmpp_stanza_get_name(child);
+            if (stanza_name && (g_strcmp0(stanza_name, STANZA_NAME_ITEM) == 0)) {
+                const char *item_jid = xmpp_stanza_get_attribute(child, STANZA_ATTR_JID);
+                const char *item_name = xmpp_stanza_get_attribute(child, STANZA_ATTR_NAME);
+                room_directory_add(request->directory, item_jid, item_name);
+            }
+            child = xmpp_stanza_get_next(child);
+        }
+
+        xmpp_stanza_t *set = xmpp_stanza_get_child_by_ns(query, STANZA_NS_RSM);
+        xmpp_stanza_t *last_st = set ? xmpp_stanza_get_child_by_name(set, STANZA_NAME_LAST) : NULL;
+        if (last_st) {
+            last = xmpp_stanza_get_text(last_st);
+        }
+    } else if (before == 0) {
         return 0;
     }
 
-    cons_show("");
-    if (filter) {
-        cons_show("Rooms list response received: %s, filter: %s", from, filter);
-    } else {
-        cons_show("Rooms list response received: %s", from);
-    }
-    xmpp_stanza_t *child = xmpp_stanza_get_children(query);
-    if (child == NULL) {
-        cons_show("  No rooms found.");
+    // keep paging while the service reports more results and the last page added rooms
+    if (last && room_directory_size(request->directory) > before) {
+        RoomListRequest *next = malloc(sizeof(RoomListRequest));
+        *next = *request;
+        request->service = NULL;
+        request->filter = NULL;
+        request->directory = NULL;
+
+        _room_list_request_page(next, last);
+        xmpp_free(connection_get_ctx(), last);
         return 0;
     }
 
-    GPatternSpec *glob = NULL;
-    if (filter != NULL) {
-        gchar *filter_lower = g_utf8_strdown(filter, -1);
-        GString *glob_str = g_string_new("*");
-        g_string_append(glob_str, filter_lower);
-        g_string_append(glob_str, "*");
-        glob = g_pattern_spec_new(glob_str->str);
-        g_string_free(glob_str, TRUE);
+    if (last) {
+        xmpp_free(connection_get_ctx(), last);
     }
 
-    gboolean matched = FALSE;
-    while (child) {
-        const char *stanza_name = xmpp_stanza_get_name(child);
-        if (stanza_name && (g_strcmp0(stanza_name, STANZA_NAME_ITEM) == 0)) {
-            const char *item_jid = xmpp_stanza_get_attribute(child, STANZA_ATTR_JID);
-            gchar *item_jid_lower = NULL;
-            if (item_jid) {
-                Jid *jidp = jid_create(item_jid);
-                if (jidp && jidp->localpart) {
-                    item_jid_lower = g_utf8_strdown(jidp->localpart, -1);
-                }
-                jid_destroy(jidp);
-            }
-            const char *item_name = xmpp_stanza_get_attribute(child, STANZA_ATTR_NAME);
-            gchar *item_name_lower = NULL;
-            if (item_name) {
-                item_name_lower = g_utf8_strdown(item_name, -1);
-            }
-            if ((item_jid_lower) && ((glob == NULL) ||
-                ((g_pattern_match(glob, strlen(item_jid_lower), item_jid_lower, NULL)) ||
-                (item_name_lower && g_pattern_match(glob, strlen(item_name_lower), item_name_lower, NULL))))) {
+    room_directory_set_fetched(request->directory, g_get_real_time());
+    if (request->display) {
+        _room_list_show(request->directory, request->filter);
+    }
 
-                if (glob) {
-                    matched = TRUE;
-                }
-                GString *item = g_string_new(item_jid);
-                if (item_name) {
-                    g_string_append(item, " (");
-                    g_string_append(item, item_name);
-                    g_string_append(item, ")");
-                }
-                cons_show("  %s", item->str);
-                g_string_free(item, TRUE);
-            }
-            g_free(item_jid_lower);
-            g_free(item_name_lower);
-        }
-        child = xmpp_stanza_get_next(child);
+    if (prefs_get_boolean(PREF_ROOM_LIST_CACHE)) {
+        room_directory_store(request->directory);
+        request->directory = NULL;
     }
 
-    if (glob && matched == FALSE) {
-        cons_show("  No rooms found matching filter: %s", filter);
+    return 0;
+}
+
+static void
+_room_list_request_page(RoomListRequest *request, const char *const after)
+{
+    xmpp_ctx_t * const ctx = connection_get_ctx();
+    char *id = connection_create_stanza_id();
+    xmpp_stanza_t *iq = stanza_create_disco_items_page_iq(ctx, id, request->service, ROOM_LIST_PAGE_SIZE, after);
+
+    iq_id_handler_add(id, _room_list_id_handler, (ProfIqFreeCallback)_iq_free_room_list_request, request);
+
+    iq_send_stanza(iq);
+    xmpp_stanza_release(iq);
+    free(id);
+}
+
+static void
+_room_list_show(RoomDirectory *directory, const char *const filter)
+{
+    const char *service = room_directory_service(directory);
+
+    cons_show("");
+    if (filter) {
+        cons_show("Rooms list response received: %s, filter: %s", service, filter);
+    } else {
+        cons_show("Rooms list response received: %s", service);
     }
 
-    if (glob) {
-        g_pattern_spec_free(glob);
+    if (room_directory_size(directory) == 0) {
+        cons_show("  No rooms found.");
+        return;
     }
 
-    return 0;
+    GSList *rooms = room_directory_search(directory, filter);
+    if (rooms == NULL) {
+        cons_show("  No rooms found matching filter: %s", filter);
+        return;
+    }
+
+    GSList *curr = rooms;
+    while (curr) {
+        RoomDirectoryEntry *entry = curr->data;
+        if (entry->name) {
+            cons_show("  %s (%s)", entry->jid, entry->name);
+        } else {
+            cons_show("  %s", entry->jid);
+        }
+        curr = g_slist_next(curr);
+    }
+    g_slist_free(rooms);
 }
 
 static int
@@ -2387,8 +2441,7 @@ _http_upload_response_id_handler(xmpp_stanza_t *const stanza, void *const userda
             if (put_url) xmpp_free(ctx, put_url);
             if (get_url) xmpp_free(ctx, get_url);
 
-            pthread_create(&(upload->worker), NULL, &http_file_put, upload);
-            upload_processes = g_slist_append(upload_processes, upload);
+            http_file_put(upload);
         } else {
             log_error("Invalid XML in HTTP Upload slot");
             return 1;
@@ -2454,22 +2507,47 @@ _disco_items_result_handler(xmpp_stanza_t *const stanza)
 
 void
 iq_send_stanza(xmpp_stanza_t *const stanza)
+{
+    _iq_send(stanza, OUTBOUND_NORMAL);
+}
+
+/*
+ * Send a request nobody is waiting on interactively, e.g. caps or device list fetches
+ */
+void
+iq_send_stanza_bulk(xmpp_stanza_t *const stanza)
+{
+    _iq_send(stanza, OUTBOUND_BULK);
+}
+
+static void
+_iq_send(xmpp_stanza_t *const stanza, outbound_class_t class)
 {
     char *text;
     size_t text_size;
     xmpp_stanza_to_text(stanza, &text, &text_size);
 
-    xmpp_conn_t *conn = connection_get_conn();
     char *plugin_text = plugins_on_iq_stanza_send(text);
     if (plugin_text) {
-        xmpp_send_raw_string(conn, "%s", plugin_text);
+        outbound_send(class, plugin_text);
         free(plugin_text);
     } else {
-        xmpp_send_raw_string(conn, "%s", text);
+        outbound_send(class, text);
     }
     xmpp_free(connection_get_ctx(), text);
 }
 
+static void
+_iq_free_room_list_request(RoomListRequest *request)
+{
+    if (request) {
+        free(request->service);
+        free(request->filter);
+        room_directory_free(request->directory);
+        free(request);
+    }
+}
+
 static void
 _iq_free_room_data(ProfRoomInfoData *roominfo)
 {
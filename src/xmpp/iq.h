@@ -40,7 +40,9 @@ typedef int(*ProfIqCallback)(xmpp_stanza_t *const stanza, void *const userdata);
 typedef void(*ProfIqFreeCallback)(void *userdata);
 
 void iq_handlers_init(void);
+void iq_handle_stanza(xmpp_stanza_t *const stanza);
 void iq_send_stanza(xmpp_stanza_t *const stanza);
+void iq_send_stanza_bulk(xmpp_stanza_t *const stanza);
 void iq_id_handler_add(const char *const id, ProfIqCallback func, ProfIqFreeCallback free_func, void *userdata);
 void iq_disco_info_request_onconnect(gchar *jid);
 void iq_disco_items_request_onconnect(gchar *jid);
@@ -41,33 +41,43 @@
 #include "common.h"
 #include "xmpp/jid.h"
 
+// maximum number of parsed JIDs kept in the intern table
+#define JID_CACHE_MAX 512
+
+// parsed JIDs keyed by the string they were created from
+static GHashTable *jids = NULL;
+
+static void _jid_intern(Jid *jid);
+
 Jid*
 jid_create(const gchar *const str)
 {
     Jid *result = NULL;
 
-    /* if str is NULL g_strdup returns NULL */
-    gchar *trimmed = g_strdup(str);
-    if (trimmed == NULL) {
+    if (str == NULL || str[0] == '\0') {
         return NULL;
     }
 
-    if (strlen(trimmed) == 0) {
-        g_free(trimmed);
+    if (str[0] == '/' || str[0] == '@') {
         return NULL;
     }
 
-    if (g_str_has_prefix(trimmed, "/") || g_str_has_prefix(trimmed, "@")) {
-        g_free(trimmed);
-        return NULL;
+    if (jids) {
+        result = g_hash_table_lookup(jids, str);
+        if (result) {
+            return jid_ref(result);
+        }
     }
 
+    gchar *trimmed = g_strdup(str);
+
     if (!g_utf8_validate(trimmed, -1, NULL)) {
         g_free(trimmed);
         return NULL;
     }
 
     result = malloc(sizeof(struct jid_t));
+    result->refcount = 1;
     result->str = NULL;
     result->localpart = NULL;
     result->domainpart = NULL;
@@ -96,12 +106,15 @@ jid_create(const gchar *const str)
         result->barejid = g_utf8_strdown(trimmed, -1);
     }
 
+    // owned by the jid from here, freed with it on the error path too
+    result->str = trimmed;
+
     if (result->domainpart == NULL) {
         jid_destroy(result);
         return NULL;
     }
 
-    result->str = trimmed;
+    _jid_intern(result);
 
     return result;
 }
@@ -117,6 +130,20 @@ jid_create_from_bare_and_resource(const char *const barejid, const char *const r
     return result;
 }
 
+Jid*
+jid_ref(Jid *jid)
+{
+    if (jid) {
+        jid->refcount++;
+    }
+
+    return jid;
+}
+
+/*
+ * Release a reference to the jid, the jid is freed once the last reference,
+ * including the one held by the intern table, is released
+ */
 void
 jid_destroy(Jid *jid)
 {
@@ -124,6 +151,11 @@ jid_destroy(Jid *jid)
         return;
     }
 
+    jid->refcount--;
+    if (jid->refcount > 0) {
+        return;
+    }
+
     g_free(jid->str);
     g_free(jid->localpart);
     g_free(jid->domainpart);
@@ -133,6 +165,37 @@ jid_destroy(Jid *jid)
     free(jid);
 }
 
+void
+jid_cache_clear(void)
+{
+    if (jids) {
+        g_hash_table_destroy(jids);
+        jids = NULL;
+    }
+}
+
+static gboolean
+_jid_unused(gpointer key, gpointer value, gpointer user_data)
+{
+    Jid *jid = value;
+    return jid->refcount == 1;
+}
+
+static void
+_jid_intern(Jid *jid)
+{
+    if (jids == NULL) {
+        jids = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)jid_destroy);
+    }
+
+    // drop entries only referenced by the table before growing past the limit
+    if (g_hash_table_size(jids) >= JID_CACHE_MAX) {
+        g_hash_table_foreach_remove(jids, _jid_unused, NULL);
+    }
+
+    g_hash_table_insert(jids, jid->str, jid_ref(jid));
+}
+
 gboolean
 jid_is_valid_room_form(Jid *jid)
 {
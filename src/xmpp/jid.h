@@ -45,13 +45,16 @@ struct jid_t {
     char *resourcepart;
     char *barejid;
     char *fulljid;
+    int refcount;
 };
 
 typedef struct jid_t Jid;
 
 Jid* jid_create(const gchar *const str);
 Jid* jid_create_from_bare_and_resource(const char *const barejid, const char *const resource);
+Jid* jid_ref(Jid *jid);
 void jid_destroy(Jid *jid);
+void jid_cache_clear(void);
 
 gboolean jid_is_valid_room_form(Jid *jid);
 char* create_fulljid(const char *const barejid, const char *const resource);
@@ -62,6 +62,9 @@
 #include "xmpp/roster_list.h"
 #include "xmpp/stanza.h"
 #include "xmpp/connection.h"
+#include "xmpp/jid.h"
+#include "xmpp/outbound.h"
+#include "xmpp/chat_state_queue.h"
 #include "xmpp/xmpp.h"
 
 #ifdef HAVE_OMEMO
@@ -86,7 +89,7 @@ static void _handle_captcha(xmpp_stanza_t *const stanza);
 static void _handle_receipt_received(xmpp_stanza_t *const stanza);
 static void _handle_chat(xmpp_stanza_t *const stanza);
 
-static void _send_message_stanza(xmpp_stanza_t *const stanza);
+static void _send_message_stanza(xmpp_stanza_t *const stanza, outbound_class_t class);
 
 static GHashTable *pubsub_event_handlers;
 
@@ -180,6 +183,16 @@ message_handlers_init(void)
     pubsub_event_handlers = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
 }
 
+/*
+ * Run a message stanza through the message handler as if it was received
+ * from the server, used to replay recorded traffic
+ */
+void
+message_handle_stanza(xmpp_stanza_t *const stanza)
+{
+    _message_handler(connection_get_conn(), stanza, NULL);
+}
+
 ProfMessage *
 message_init(void)
 {
@@ -240,6 +253,7 @@ message_handlers_clear(void)
     if (pubsub_event_handlers) {
         g_hash_table_remove_all(pubsub_event_handlers);
     }
+    chat_state_queue_clear();
 }
 
 void
@@ -270,6 +284,7 @@ message_send_chat(const char *const barejid, const char *const msg, const char *
     if (state) {
         stanza_attach_state(ctx, message, state);
     }
+    chat_state_queue_superseded(barejid, state);
 
     if (oob_url) {
         stanza_attach_x_oob_url(ctx, message, oob_url);
@@ -279,7 +294,7 @@ message_send_chat(const char *const barejid, const char *const msg, const char *
         stanza_attach_receipt_request(ctx, message);
     }
 
-    _send_message_stanza(message);
+    _send_message_stanza(message, OUTBOUND_MESSAGE);
     xmpp_stanza_release(message);
 
     return id;
@@ -333,12 +348,13 @@ message_send_chat_pgp(const char *const barejid, const char *const msg, gboolean
     if (state) {
         stanza_attach_state(ctx, message, state);
     }
+    chat_state_queue_superseded(barejid, state);
 
     if (request_receipt) {
         stanza_attach_receipt_request(ctx, message);
     }
 
-    _send_message_stanza(message);
+    _send_message_stanza(message, OUTBOUND_MESSAGE);
     xmpp_stanza_release(message);
 
     return id;
@@ -361,6 +377,7 @@ message_send_chat_otr(const char *const barejid, const char *const msg, gboolean
     if (state) {
         stanza_attach_state(ctx, message, state);
     }
+    chat_state_queue_superseded(barejid, state);
 
     stanza_attach_carbons_private(ctx, message);
     stanza_attach_hints_no_copy(ctx, message);
@@ -370,7 +387,7 @@ message_send_chat_otr(const char *const barejid, const char *const msg, gboolean
         stanza_attach_receipt_request(ctx, message);
     }
 
-    _send_message_stanza(message);
+    _send_message_stanza(message, OUTBOUND_MESSAGE);
     xmpp_stanza_release(message);
 
     return id;
@@ -474,6 +491,9 @@ message_send_chat_omemo(const char *const jid, uint32_t sid, GList *keys,
     if (state) {
         stanza_attach_state(ctx, message, state);
     }
+    if (!muc) {
+        chat_state_queue_superseded(jid, state);
+    }
 
     stanza_attach_hints_store(ctx, message);
 
@@ -481,7 +501,7 @@ message_send_chat_omemo(const char *const jid, uint32_t sid, GList *keys,
         stanza_attach_receipt_request(ctx, message);
     }
 
-    _send_message_stanza(message);
+    _send_message_stanza(message, muc ? OUTBOUND_NORMAL : OUTBOUND_MESSAGE);
     xmpp_stanza_release(message);
 
     return id;
@@ -503,7 +523,7 @@ message_send_private(const char *const fulljid, const char *const msg, const cha
         stanza_attach_x_oob_url(ctx, message, oob_url);
     }
 
-    _send_message_stanza(message);
+    _send_message_stanza(message, OUTBOUND_NORMAL);
     xmpp_stanza_release(message);
 }
 
@@ -521,7 +541,7 @@ message_send_groupchat(const char *const roomjid, const char *const msg, const c
         stanza_attach_x_oob_url(ctx, message, oob_url);
     }
 
-    _send_message_stanza(message);
+    _send_message_stanza(message, OUTBOUND_NORMAL);
     xmpp_stanza_release(message);
 
     return id;
@@ -533,7 +553,7 @@ message_send_groupchat_subject(const char *const roomjid, const char *const subj
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *message = stanza_create_room_subject_message(ctx, roomjid, subject);
 
-    _send_message_stanza(message);
+    _send_message_stanza(message, OUTBOUND_NORMAL);
     xmpp_stanza_release(message);
 }
 
@@ -554,46 +574,49 @@ message_send_invite(const char *const roomjid, const char *const contact,
         stanza = stanza_create_mediated_invite(ctx, roomjid, contact, reason);
     }
 
-    _send_message_stanza(stanza);
+    _send_message_stanza(stanza, OUTBOUND_NORMAL);
     xmpp_stanza_release(stanza);
 }
 
 void
 message_send_composing(const char *const jid)
 {
-    xmpp_ctx_t * const ctx = connection_get_ctx();
-
-    xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, STANZA_NAME_COMPOSING);
-    _send_message_stanza(stanza);
-    xmpp_stanza_release(stanza);
-
+    chat_state_queue_push(jid, STANZA_NAME_COMPOSING, g_get_monotonic_time());
 }
 
 void
 message_send_paused(const char *const jid)
 {
-    xmpp_ctx_t * const ctx = connection_get_ctx();
-    xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, STANZA_NAME_PAUSED);
-    _send_message_stanza(stanza);
-    xmpp_stanza_release(stanza);
+    chat_state_queue_push(jid, STANZA_NAME_PAUSED, g_get_monotonic_time());
 }
 
 void
 message_send_inactive(const char *const jid)
 {
-    xmpp_ctx_t * const ctx = connection_get_ctx();
-    xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, STANZA_NAME_INACTIVE);
-
-    _send_message_stanza(stanza);
-    xmpp_stanza_release(stanza);
+    chat_state_queue_push(jid, STANZA_NAME_INACTIVE, g_get_monotonic_time());
 }
 
 void
 message_send_gone(const char *const jid)
+{
+    chat_state_queue_push(jid, STANZA_NAME_GONE, g_get_monotonic_time());
+}
+
+void
+message_chat_states_flush(void)
+{
+    chat_state_queue_flush(g_get_monotonic_time());
+}
+
+/*
+ * Send a chat state notification now, pacing is left to the chat state queue
+ */
+void
+message_send_chat_state(const char *const jid, const char *const state)
 {
     xmpp_ctx_t * const ctx = connection_get_ctx();
-    xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, STANZA_NAME_GONE);
-    _send_message_stanza(stanza);
+    xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, state);
+    _send_message_stanza(stanza, OUTBOUND_NORMAL);
     xmpp_stanza_release(stanza);
 }
 
@@ -865,7 +888,7 @@ _message_send_receipt(const char *const fulljid, const char *const message_id)
     xmpp_stanza_add_child(message, receipt);
     xmpp_stanza_release(receipt);
 
-    _send_message_stanza(message);
+    _send_message_stanza(message, OUTBOUND_NORMAL);
     xmpp_stanza_release(message);
 }
 
@@ -1161,19 +1184,18 @@ _handle_chat(xmpp_stanza_t *const stanza)
 }
 
 static void
-_send_message_stanza(xmpp_stanza_t *const stanza)
+_send_message_stanza(xmpp_stanza_t *const stanza, outbound_class_t class)
 {
     char *text;
     size_t text_size;
     xmpp_stanza_to_text(stanza, &text, &text_size);
 
-    xmpp_conn_t *conn = connection_get_conn();
     char *plugin_text = plugins_on_message_stanza_send(text);
     if (plugin_text) {
-        xmpp_send_raw_string(conn, "%s", plugin_text);
+        outbound_send(class, plugin_text);
         free(plugin_text);
     } else {
-        xmpp_send_raw_string(conn, "%s", text);
+        outbound_send(class, text);
     }
     xmpp_free(connection_get_ctx(), text);
 }
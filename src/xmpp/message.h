@@ -45,6 +45,9 @@ ProfMessage *message_init(void);
 void message_free(ProfMessage *message);
 void message_handlers_init(void);
 void message_handlers_clear(void);
+void message_chat_states_flush(void);
+void message_send_chat_state(const char *const jid, const char *const state);
+void message_handle_stanza(xmpp_stanza_t *const stanza);
 void message_pubsub_event_handler_add(const char *const node, ProfMessageCallback func, ProfMessageFreeCallback free_func, void *userdata);
 
 #endif
@@ -41,6 +41,7 @@
 
 #include "common.h"
 #include "tools/autocomplete.h"
+#include "tools/memory.h"
 #include "ui/ui.h"
 #include "ui/window_list.h"
 #include "xmpp/jid.h"
@@ -87,6 +88,8 @@ static char* _affiliation_to_string(muc_affiliation_t affiliation);
 static Occupant* _muc_occupant_new(const char *const nick, const char *const jid, muc_role_t role,
     muc_affiliation_t affiliation, resource_presence_t presence, const char *const status);
 static void _occupant_free(Occupant *occupant);
+static gint64 _room_size(ChatRoom *room);
+static gint64 _occupant_size(Occupant *occupant);
 
 void
 muc_init(void)
@@ -234,6 +237,7 @@ muc_join(const char *const room, const char *const nick, const char *const passw
     new_room->autojoin = autojoin;
     new_room->member_type = MUC_MEMBER_TYPE_UNKNOWN;
     new_room->anonymity_type = MUC_ANONYMITY_TYPE_UNKNOWN;
+    memory_add(MEMORY_MUC, _room_size(new_room), 1);
 
     g_hash_table_insert(rooms, strdup(room), new_room);
 }
@@ -917,6 +921,7 @@ static void
 _free_room(ChatRoom *room)
 {
     if (room) {
+        memory_add(MEMORY_MUC, -_room_size(room), -1);
         free(room->room);
         free(room->nick);
         free(room->subject);
@@ -1074,6 +1079,7 @@ _muc_occupant_new(const char *const nick, const char *const jid, muc_role_t role
 
     occupant->role = role;
     occupant->affiliation = affiliation;
+    memory_add(MEMORY_MUC, _occupant_size(occupant), 1);
 
     return occupant;
 }
@@ -1082,6 +1088,7 @@ static void
 _occupant_free(Occupant *occupant)
 {
     if (occupant) {
+        memory_add(MEMORY_MUC, -_occupant_size(occupant), -1);
         free(occupant->nick);
         free(occupant->nick_collate_key);
         free(occupant->jid);
@@ -1089,3 +1096,34 @@ _occupant_free(Occupant *occupant)
         free(occupant);
     }
 }
+
+/*
+ * Approximate heap used by a room without its occupants, the room jid is kept
+ * in the room and as its key
+ */
+static gint64
+_room_size(ChatRoom *room)
+{
+    return sizeof(ChatRoom) + 2 * (strlen(room->room) + 1);
+}
+
+/*
+ * Approximate heap used by an occupant, the nick is kept in the occupant and
+ * as its key in the room roster
+ */
+static gint64
+_occupant_size(Occupant *occupant)
+{
+    gint64 size = sizeof(Occupant);
+    if (occupant->nick) {
+        size += 2 * (strlen(occupant->nick) + 1) + strlen(occupant->nick_collate_key) + 1;
+    }
+    if (occupant->jid) {
+        size += strlen(occupant->jid) + 1;
+    }
+    if (occupant->status) {
+        size += strlen(occupant->status) + 1;
+    }
+
+    return size;
+}
@@ -80,7 +80,7 @@ omemo_devicelist_request(const char * const jid)
     xmpp_stanza_t *iq = stanza_create_omemo_devicelist_request(ctx, id, jid);
     iq_id_handler_add(id, _omemo_receive_devicelist, NULL, NULL);
 
-    iq_send_stanza(iq);
+    iq_send_stanza_bulk(iq);
 
     free(id);
     xmpp_stanza_release(iq);
@@ -137,7 +137,7 @@ omemo_bundle_request(const char * const jid, uint32_t device_id, ProfIqCallback
     xmpp_stanza_t *iq = stanza_create_omemo_bundle_request(ctx, id, jid, device_id);
     iq_id_handler_add(id, func, free_func, userdata);
 
-    iq_send_stanza(iq);
+    iq_send_stanza_bulk(iq);
 
     free(id);
     xmpp_stanza_release(iq);
@@ -0,0 +1,210 @@
+/*
+ * outbound.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "log.h"
+#include "xmpp/connection.h"
+#include "xmpp/outbound.h"
+
+// bulk stanzas handed to the connection per second, and how many may go at once
+#define OUTBOUND_BULK_RATE 20
+#define OUTBOUND_BULK_BURST 10
+// user messages kept while offline
+#define OUTBOUND_OFFLINE_MAX 200
+
+typedef struct outbound_stanza_t {
+    char *to;
+    char *text;
+} OutboundStanza;
+
+// bulk stanzas waiting for their turn
+static GQueue bulk = G_QUEUE_INIT;
+// user messages written while offline
+static GQueue offline = G_QUEUE_INIT;
+
+static double bulk_tokens = OUTBOUND_BULK_BURST;
+static gint64 bulk_refilled = 0;
+
+static void _outbound_write(const char *const text);
+static void _outbound_release(const char *const to);
+static void _outbound_stanza_free(OutboundStanza *stanza);
+
+/*
+ * Hand a serialised stanza to the connection according to its class.
+ * Messages and normal stanzas go out at once, bulk stanzas are paced so they
+ * never queue up in front of what the user is waiting for.
+ */
+void
+outbound_send(outbound_class_t class, const char *const text)
+{
+    outbound_send_to(class, NULL, text);
+}
+
+/*
+ * As outbound_send, for a stanza addressed to the bare jid to. Stanzas to the
+ * same jid keep their order, bulk ones still queued for it are sent first.
+ */
+void
+outbound_send_to(outbound_class_t class, const char *const to, const char *const text)
+{
+    if (connection_get_status() != JABBER_CONNECTED) {
+        if (class == OUTBOUND_MESSAGE) {
+            if (g_queue_get_length(&offline) >= OUTBOUND_OFFLINE_MAX) {
+                log_warning("Outbound: offline buffer full, dropping oldest message");
+                free(g_queue_pop_head(&offline));
+            }
+            g_queue_push_tail(&offline, strdup(text));
+        } else {
+            log_debug("Outbound: not connected, dropping stanza");
+        }
+        return;
+    }
+
+    if (class == OUTBOUND_BULK) {
+        OutboundStanza *stanza = malloc(sizeof(OutboundStanza));
+        stanza->to = to ? strdup(to) : NULL;
+        stanza->text = strdup(text);
+        g_queue_push_tail(&bulk, stanza);
+        outbound_flush();
+    } else {
+        if (to) {
+            _outbound_release(to);
+        }
+        _outbound_write(text);
+    }
+}
+
+/*
+ * Release as many bulk stanzas as the rate allows, called from the event loop
+ */
+void
+outbound_flush(void)
+{
+    if (g_queue_is_empty(&bulk) || connection_get_status() != JABBER_CONNECTED) {
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    if (bulk_refilled != 0) {
+        bulk_tokens += (double)(now - bulk_refilled) * OUTBOUND_BULK_RATE / G_TIME_SPAN_SECOND;
+        if (bulk_tokens > OUTBOUND_BULK_BURST) {
+            bulk_tokens = OUTBOUND_BULK_BURST;
+        }
+    }
+    bulk_refilled = now;
+
+    while (bulk_tokens >= 1 && !g_queue_is_empty(&bulk)) {
+        OutboundStanza *stanza = g_queue_pop_head(&bulk);
+        _outbound_write(stanza->text);
+        _outbound_stanza_free(stanza);
+        bulk_tokens--;
+    }
+}
+
+/*
+ * Send the messages written while offline, called once the session is established
+ */
+void
+outbound_connected(void)
+{
+    if (!g_queue_is_empty(&offline)) {
+        log_info("Outbound: sending %d message(s) written while offline", g_queue_get_length(&offline));
+    }
+
+    char *text;
+    while ((text = g_queue_pop_head(&offline)) != NULL) {
+        _outbound_write(text);
+        free(text);
+    }
+}
+
+/*
+ * Queued bulk stanzas belong to the lost session, messages are kept for the next one
+ */
+void
+outbound_lost_connection(void)
+{
+    g_queue_foreach(&bulk, (GFunc)_outbound_stanza_free, NULL);
+    g_queue_clear(&bulk);
+    bulk_tokens = OUTBOUND_BULK_BURST;
+    bulk_refilled = 0;
+}
+
+void
+outbound_clear(void)
+{
+    outbound_lost_connection();
+    g_queue_foreach(&offline, (GFunc)free, NULL);
+    g_queue_clear(&offline);
+}
+
+static void
+_outbound_write(const char *const text)
+{
+    connection_send_stanza(text);
+}
+
+/*
+ * Send the bulk stanzas queued for to now, in the order they were queued
+ */
+static void
+_outbound_release(const char *const to)
+{
+    GList *curr = bulk.head;
+    while (curr) {
+        GList *next = g_list_next(curr);
+        OutboundStanza *stanza = curr->data;
+        if (g_strcmp0(stanza->to, to) == 0) {
+            _outbound_write(stanza->text);
+            _outbound_stanza_free(stanza);
+            g_queue_delete_link(&bulk, curr);
+        }
+        curr = next;
+    }
+}
+
+static void
+_outbound_stanza_free(OutboundStanza *stanza)
+{
+    free(stanza->to);
+    free(stanza->text);
+    free(stanza);
+}
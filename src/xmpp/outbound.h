@@ -0,0 +1,57 @@
+/*
+ * outbound.h
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef XMPP_OUTBOUND_H
+#define XMPP_OUTBOUND_H
+
+#include <glib.h>
+
+typedef enum {
+    // user messages, kept while offline and sent after reconnecting
+    OUTBOUND_MESSAGE,
+    // anything else the user is waiting for
+    OUTBOUND_NORMAL,
+    // background traffic, paced behind everything else
+    OUTBOUND_BULK
+} outbound_class_t;
+
+void outbound_send(outbound_class_t class, const char *const text);
+void outbound_send_to(outbound_class_t class, const char *const to, const char *const text);
+void outbound_flush(void);
+void outbound_connected(void);
+void outbound_lost_connection(void);
+void outbound_clear(void);
+
+#endif
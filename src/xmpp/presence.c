@@ -57,11 +57,13 @@
 #include "event/server_events.h"
 #include "plugins/plugins.h"
 #include "ui/ui.h"
+#include "xmpp/autojoin.h"
 #include "xmpp/connection.h"
 #include "xmpp/capabilities.h"
 #include "xmpp/session.h"
 #include "xmpp/stanza.h"
 #include "xmpp/iq.h"
+#include "xmpp/outbound.h"
 #include "xmpp/xmpp.h"
 #include "xmpp/muc.h"
 
@@ -79,7 +81,8 @@ static void _available_handler(xmpp_stanza_t *const stanza);
 
 void _send_caps_request(char *node, char *caps_key, char *id, char *from);
 static void _send_room_presence(xmpp_stanza_t *presence);
-static void _send_presence_stanza(xmpp_stanza_t *const stanza);
+static void _send_presence_stanza(xmpp_stanza_t *const stanza, outbound_class_t class);
+static void _join_room(const char *const room, const char *const nick, const char *const passwd, outbound_class_t class);
 
 void
 presence_sub_requests_init(void)
@@ -95,6 +98,16 @@ presence_handlers_init(void)
     xmpp_handler_add(conn, _presence_handler, NULL, STANZA_NAME_PRESENCE, NULL, ctx);
 }
 
+/*
+ * Run a presence stanza through the presence handler as if it was received
+ * from the server, used to replay recorded traffic
+ */
+void
+presence_handle_stanza(xmpp_stanza_t *const stanza)
+{
+    _presence_handler(connection_get_conn(), stanza, NULL);
+}
+
 void
 presence_subscription(const char *const jid, const jabber_subscr_t action)
 {
@@ -137,7 +150,7 @@ presence_subscription(const char *const jid, const jabber_subscr_t action)
     xmpp_stanza_set_to(presence, jidp->barejid);
     jid_destroy(jidp);
 
-    _send_presence_stanza(presence);
+    _send_presence_stanza(presence, OUTBOUND_NORMAL);
 
     xmpp_stanza_release(presence);
 }
@@ -244,7 +257,7 @@ presence_send(const resource_presence_t presence_type, const int idle, char *sig
 
     stanza_attach_caps(ctx, presence);
 
-    _send_presence_stanza(presence);
+    _send_presence_stanza(presence, OUTBOUND_NORMAL);
     _send_room_presence(presence);
 
     xmpp_stanza_release(presence);
@@ -275,7 +288,7 @@ _send_room_presence(xmpp_stanza_t *presence)
             log_debug("Sending presence to room: %s", full_room_jid);
             free(full_room_jid);
 
-            _send_presence_stanza(presence);
+            _send_presence_stanza(presence, OUTBOUND_BULK);
         }
 
         curr = g_list_next(curr);
@@ -285,6 +298,21 @@ _send_room_presence(xmpp_stanza_t *presence)
 
 void
 presence_join_room(const char *const room, const char *const nick, const char *const passwd)
+{
+    _join_room(room, nick, passwd, OUTBOUND_NORMAL);
+}
+
+/*
+ * Join a room the user did not ask for just now, queued behind interactive traffic
+ */
+void
+presence_autojoin_room(const char *const room, const char *const nick, const char *const passwd)
+{
+    _join_room(room, nick, passwd, OUTBOUND_BULK);
+}
+
+static void
+_join_room(const char *const room, const char *const nick, const char *const passwd, outbound_class_t class)
 {
     Jid *jid = jid_create_from_bare_and_resource(room, nick);
     log_debug("Sending room join presence to: %s", jid->fulljid);
@@ -301,7 +329,7 @@ presence_join_room(const char *const room, const char *const nick, const char *c
     stanza_attach_priority(ctx, presence, pri);
     stanza_attach_caps(ctx, presence);
 
-    _send_presence_stanza(presence);
+    _send_presence_stanza(presence, class);
 
     xmpp_stanza_release(presence);
     jid_destroy(jid);
@@ -327,7 +355,7 @@ presence_change_room_nick(const char *const room, const char *const nick)
     stanza_attach_priority(ctx, presence, pri);
     stanza_attach_caps(ctx, presence);
 
-    _send_presence_stanza(presence);
+    _send_presence_stanza(presence, OUTBOUND_NORMAL);
 
     xmpp_stanza_release(presence);
     free(full_room_jid);
@@ -349,7 +377,7 @@ presence_leave_chat_room(const char *const room_jid)
     xmpp_ctx_t *ctx = connection_get_ctx();
     xmpp_stanza_t *presence = stanza_create_room_leave_presence(ctx, room_jid, nick);
 
-    _send_presence_stanza(presence);
+    _send_presence_stanza(presence, OUTBOUND_NORMAL);
 
     xmpp_stanza_release(presence);
 }
@@ -430,6 +458,7 @@ _presence_error_handler(xmpp_stanza_t *const stanza)
             muc_leave(fulljid->barejid);
         }
         cons_show_error("Error joining room %s, reason: %s", fulljid->barejid, error_cond);
+        autojoin_room_done(fulljid->barejid);
         jid_destroy(fulljid);
 
         return;
@@ -776,6 +805,7 @@ _muc_user_self_handler(xmpp_stanza_t *stanza)
             }
         }
         sv_ev_muc_self_online(room, nick, config_required, role, affiliation, actor, reason, jid, show_str, status_str);
+        autojoin_room_done(room);
         free(show_str);
         free(status_str);
         free(reason);
@@ -897,19 +927,24 @@ _muc_user_handler(xmpp_stanza_t *const stanza)
 }
 
 static void
-_send_presence_stanza(xmpp_stanza_t *const stanza)
+_send_presence_stanza(xmpp_stanza_t *const stanza, outbound_class_t class)
 {
     char *text;
     size_t text_size;
     xmpp_stanza_to_text(stanza, &text, &text_size);
 
-    xmpp_conn_t *conn = connection_get_conn();
+    // presence to a room stays in order, a leave can't overtake a queued autojoin
+    const char *const to_attr = xmpp_stanza_get_to(stanza);
+    Jid *to = to_attr ? jid_create(to_attr) : NULL;
+    const char *const barejid = to ? to->barejid : NULL;
+
     char *plugin_text = plugins_on_presence_stanza_send(text);
     if (plugin_text) {
-        xmpp_send_raw_string(conn, "%s", plugin_text);
+        outbound_send_to(class, barejid, plugin_text);
         free(plugin_text);
     } else {
-        xmpp_send_raw_string(conn, "%s", text);
+        outbound_send_to(class, barejid, text);
     }
+    jid_destroy(to);
     xmpp_free(connection_get_ctx(), text);
 }
@@ -36,7 +36,10 @@
 #ifndef XMPP_PRESENCE_H
 #define XMPP_PRESENCE_H
 
+#include "xmpp/xmpp.h"
+
 void presence_handlers_init(void);
+void presence_handle_stanza(xmpp_stanza_t *const stanza);
 void presence_sub_requests_init(void);
 void presence_clear_sub_requests(void);
 
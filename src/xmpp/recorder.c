@@ -0,0 +1,283 @@
+/*
+ * recorder.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#ifdef HAVE_LIBMESODE
+#include <mesode.h>
+#endif
+
+#ifdef HAVE_LIBSTROPHE
+#include <strophe.h>
+#endif
+
+#include "log.h"
+#include "xmpp/connection.h"
+#include "xmpp/iq.h"
+#include "xmpp/message.h"
+#include "xmpp/presence.h"
+#include "xmpp/recorder.h"
+#include "xmpp/stanza.h"
+
+/*
+ * A recording holds one stanza per line:
+ *
+ *   <microseconds since start> SENT|RECV <stanza, escaped with g_strescape>
+ *
+ * The timestamps come from the monotonic clock so they are not affected by
+ * changes to the wall clock while recording.
+ */
+
+// seconds between flushes of the recording file
+#define RECORDER_FLUSH_INTERVAL 1
+// maximum stanzas replayed per main loop iteration when replaying unthrottled
+#define RECORDER_REPLAY_BATCH 100
+
+typedef struct recorded_stanza_t {
+    gint64 offset;
+    char *stanza;
+} RecordedStanza;
+
+static FILE *record_file = NULL;
+static gint64 record_start = 0;
+static gint64 record_last_flush = 0;
+
+static FILE *replay_file = NULL;
+static double replay_speed = 1.0;
+static gint64 replay_start = 0;
+static gint64 replay_first_offset = -1;
+static RecordedStanza *replay_next = NULL;
+static int replay_count = 0;
+
+static RecordedStanza* _recorder_read_next(void);
+static void _recorder_stanza_free(RecordedStanza *recorded);
+static void _recorder_dispatch(const char *const text);
+
+gboolean
+recorder_record_start(const char *const path)
+{
+    record_file = fopen(path, "w");
+    if (record_file == NULL) {
+        return FALSE;
+    }
+
+    record_start = g_get_monotonic_time();
+    record_last_flush = record_start;
+
+    return TRUE;
+}
+
+/*
+ * Record a libstrophe "SENT: " or "RECV: " log line, anything else is ignored
+ */
+void
+recorder_record(const char *const msg)
+{
+    if (record_file == NULL) {
+        return;
+    }
+
+    const char *direction = NULL;
+    if (g_str_has_prefix(msg, "SENT: ")) {
+        direction = "SENT";
+    } else if (g_str_has_prefix(msg, "RECV: ")) {
+        direction = "RECV";
+    } else {
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    gchar *escaped = g_strescape(&msg[6], NULL);
+    fprintf(record_file, "%" G_GINT64_FORMAT " %s %s\n", now - record_start, direction, escaped);
+    g_free(escaped);
+
+    if (now - record_last_flush >= RECORDER_FLUSH_INTERVAL * G_USEC_PER_SEC) {
+        fflush(record_file);
+        record_last_flush = now;
+    }
+}
+
+/*
+ * Replay the received stanzas of a recording once connected, speed is a
+ * multiplier of the recorded pace, 0 replays as fast as possible
+ */
+gboolean
+recorder_replay_start(const char *const path, double speed)
+{
+    replay_file = fopen(path, "r");
+    if (replay_file == NULL) {
+        return FALSE;
+    }
+
+    replay_speed = speed;
+    replay_start = 0;
+    replay_first_offset = -1;
+    replay_count = 0;
+
+    return TRUE;
+}
+
+void
+recorder_replay_process(void)
+{
+    if (replay_file == NULL) {
+        return;
+    }
+
+    if (connection_get_status() != JABBER_CONNECTED) {
+        return;
+    }
+
+    if (replay_next == NULL) {
+        replay_next = _recorder_read_next();
+        if (replay_next == NULL) {
+            log_info("Replay finished, %d stanzas replayed", replay_count);
+            fclose(replay_file);
+            replay_file = NULL;
+            return;
+        }
+    }
+
+    gint64 now = g_get_monotonic_time();
+    if (replay_first_offset == -1) {
+        log_info("Starting replay at %.2fx speed", replay_speed);
+        replay_start = now;
+        replay_first_offset = replay_next->offset;
+    }
+
+    int batch = 0;
+    while (replay_next) {
+        if (replay_speed > 0) {
+            gint64 due = replay_start + (gint64)((replay_next->offset - replay_first_offset) / replay_speed);
+            if (due > now) {
+                return;
+            }
+        } else if (batch == RECORDER_REPLAY_BATCH) {
+            return;
+        }
+
+        _recorder_dispatch(replay_next->stanza);
+        _recorder_stanza_free(replay_next);
+        replay_count++;
+        batch++;
+
+        replay_next = _recorder_read_next();
+    }
+}
+
+void
+recorder_close(void)
+{
+    if (record_file) {
+        fclose(record_file);
+        record_file = NULL;
+    }
+
+    if (replay_file) {
+        fclose(replay_file);
+        replay_file = NULL;
+    }
+
+    _recorder_stanza_free(replay_next);
+    replay_next = NULL;
+}
+
+/*
+ * Read the next received stanza from the replay file, skipping sent stanzas
+ * and malformed lines
+ */
+static RecordedStanza*
+_recorder_read_next(void)
+{
+    char *line = NULL;
+    size_t len = 0;
+
+    while (getline(&line, &len, replay_file) != -1) {
+        g_strchomp(line);
+
+        gchar **tokens = g_strsplit(line, " ", 3);
+        if (g_strv_length(tokens) == 3 && g_strcmp0(tokens[1], "RECV") == 0) {
+            RecordedStanza *recorded = malloc(sizeof(RecordedStanza));
+            recorded->offset = g_ascii_strtoll(tokens[0], NULL, 10);
+            recorded->stanza = g_strcompress(tokens[2]);
+            g_strfreev(tokens);
+            free(line);
+            return recorded;
+        }
+        g_strfreev(tokens);
+    }
+
+    free(line);
+    return NULL;
+}
+
+static void
+_recorder_stanza_free(RecordedStanza *recorded)
+{
+    if (recorded == NULL) {
+        return;
+    }
+
+    g_free(recorded->stanza);
+    free(recorded);
+}
+
+static void
+_recorder_dispatch(const char *const text)
+{
+    xmpp_stanza_t *stanza = xmpp_stanza_new_from_string(connection_get_ctx(), text);
+    if (stanza == NULL) {
+        log_warning("Replay: could not parse stanza: %s", text);
+        return;
+    }
+
+    const char *name = xmpp_stanza_get_name(stanza);
+    if (g_strcmp0(name, STANZA_NAME_MESSAGE) == 0) {
+        message_handle_stanza(stanza);
+    } else if (g_strcmp0(name, STANZA_NAME_PRESENCE) == 0) {
+        presence_handle_stanza(stanza);
+    } else if (g_strcmp0(name, STANZA_NAME_IQ) == 0) {
+        iq_handle_stanza(stanza);
+    }
+
+    xmpp_stanza_release(stanza);
+}
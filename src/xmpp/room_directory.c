@@ -0,0 +1,553 @@
+/*
+ * room_directory.c
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include "log.h"
+#include "common.h"
+#include "config/files.h"
+#include "xmpp/room_directory.h"
+
+// cached room lists older than this are refreshed on the next request
+#define ROOM_DIRECTORY_TTL (24 * G_TIME_SPAN_HOUR)
+
+// length of the n-grams in the search index, shorter queries scan all entries
+#define ROOM_DIRECTORY_NGRAM 3
+
+struct room_directory_t {
+    char *service;
+    gint64 fetched;
+    GPtrArray *entries;
+    GHashTable *jids;
+    // trigram -> GArray of entry positions, built on the first search
+    GHashTable *index;
+};
+
+static GHashTable *directories = NULL;
+static gboolean directories_scanned = FALSE;
+
+static GPtrArray *find_matches = NULL;
+static int find_pos = -1;
+
+static void _room_directory_entry_free(RoomDirectoryEntry *entry);
+static void _room_directory_postings_free(GArray *postings);
+static void _room_directory_index(RoomDirectory *directory);
+static guint32 _room_directory_trigram(const char *const str);
+static GArray* _room_directory_candidates(RoomDirectory *directory, const char *const needle);
+static GHashTable* _room_directory_registry(void);
+static char* _room_directory_path(const char *const service);
+static RoomDirectory* _room_directory_load(const char *const service);
+static void _room_directory_save(RoomDirectory *directory);
+static void _room_directory_load_all(void);
+static gint _room_directory_cmp(gconstpointer a, gconstpointer b);
+
+RoomDirectory*
+room_directory_new(const char *const service)
+{
+    RoomDirectory *directory = malloc(sizeof(struct room_directory_t));
+    directory->service = strdup(service);
+    directory->fetched = 0;
+    directory->entries = g_ptr_array_new_with_free_func((GDestroyNotify)_room_directory_entry_free);
+    directory->jids = g_hash_table_new(g_str_hash, g_str_equal);
+    directory->index = NULL;
+
+    return directory;
+}
+
+void
+room_directory_free(RoomDirectory *directory)
+{
+    if (directory == NULL) {
+        return;
+    }
+
+    if (directory->index) {
+        g_hash_table_destroy(directory->index);
+    }
+    g_hash_table_destroy(directory->jids);
+    g_ptr_array_free(directory->entries, TRUE);
+    free(directory->service);
+    free(directory);
+}
+
+const char*
+room_directory_service(RoomDirectory *directory)
+{
+    return directory->service;
+}
+
+void
+room_directory_add(RoomDirectory *directory, const char *const jid, const char *const name)
+{
+    // rooms always have a localpart, pages may overlap when the list changes between requests
+    const char *at = jid ? strchr(jid, '@') : NULL;
+    if (at == NULL || at == jid || g_hash_table_contains(directory->jids, jid)) {
+        return;
+    }
+
+    RoomDirectoryEntry *entry = malloc(sizeof(RoomDirectoryEntry));
+    entry->jid = strdup(jid);
+    entry->name = (name && name[0] != '\0') ? strdup(name) : NULL;
+
+    gchar *localpart = g_strndup(jid, at - jid);
+    gchar *search = g_utf8_strdown(localpart, -1);
+    g_free(localpart);
+    if (entry->name) {
+        gchar *name_lower = g_utf8_strdown(entry->name, -1);
+        gchar *combined = g_strconcat(search, "\n", name_lower, NULL);
+        g_free(name_lower);
+        g_free(search);
+        search = combined;
+    }
+    entry->search = search;
+
+    g_ptr_array_add(directory->entries, entry);
+    g_hash_table_insert(directory->jids, entry->jid, entry);
+
+    if (directory->index) {
+        g_hash_table_destroy(directory->index);
+        directory->index = NULL;
+    }
+}
+
+int
+room_directory_size(RoomDirectory *directory)
+{
+    return directory->entries->len;
+}
+
+void
+room_directory_set_fetched(RoomDirectory *directory, gint64 fetched)
+{
+    directory->fetched = fetched;
+}
+
+gboolean
+room_directory_is_stale(RoomDirectory *directory)
+{
+    return g_get_real_time() - directory->fetched > ROOM_DIRECTORY_TTL;
+}
+
+GSList*
+room_directory_search(RoomDirectory *directory, const char *const filter)
+{
+    GSList *result = NULL;
+    gchar *needle = filter ? g_utf8_strdown(filter, -1) : NULL;
+    guint i;
+
+    if (needle == NULL || strlen(needle) < ROOM_DIRECTORY_NGRAM) {
+        for (i = 0; i < directory->entries->len; i++) {
+            RoomDirectoryEntry *entry = g_ptr_array_index(directory->entries, i);
+            if (needle == NULL || strstr(entry->search, needle)) {
+                result = g_slist_prepend(result, entry);
+            }
+        }
+    } else {
+        GArray *candidates = _room_directory_candidates(directory, needle);
+        for (i = 0; candidates && i < candidates->len; i++) {
+            RoomDirectoryEntry *entry = g_ptr_array_index(directory->entries, g_array_index(candidates, guint, i));
+            if (strstr(entry->search, needle)) {
+                result = g_slist_prepend(result, entry);
+            }
+        }
+    }
+
+    g_free(needle);
+
+    return g_slist_reverse(result);
+}
+
+RoomDirectory*
+room_directory_get(const char *const service)
+{
+    GHashTable *registry = _room_directory_registry();
+    RoomDirectory *directory = g_hash_table_lookup(registry, service);
+    if (directory == NULL) {
+        directory = _room_directory_load(service);
+        if (directory) {
+            g_hash_table_insert(registry, strdup(service), directory);
+        }
+    }
+
+    return directory;
+}
+
+void
+room_directory_store(RoomDirectory *directory)
+{
+    _room_directory_save(directory);
+
+    GHashTable *registry = _room_directory_registry();
+    if (g_hash_table_lookup(registry, directory->service) != directory) {
+        g_hash_table_replace(registry, strdup(directory->service), directory);
+    }
+    room_directory_reset_find();
+}
+
+void
+room_directory_clear(void)
+{
+    char *rooms_dir = files_get_data_path(DIR_ROOMS);
+    GDir *dir = g_dir_open(rooms_dir, 0, NULL);
+    if (dir) {
+        const gchar *name;
+        while ((name = g_dir_read_name(dir)) != NULL) {
+            gchar *path = g_build_filename(rooms_dir, name, NULL);
+            unlink(path);
+            g_free(path);
+        }
+        g_dir_close(dir);
+    }
+    free(rooms_dir);
+
+    if (directories) {
+        g_hash_table_remove_all(directories);
+    }
+    directories_scanned = FALSE;
+    room_directory_reset_find();
+}
+
+void
+room_directory_close(void)
+{
+    room_directory_reset_find();
+    if (directories) {
+        g_hash_table_destroy(directories);
+        directories = NULL;
+    }
+    directories_scanned = FALSE;
+}
+
+char*
+room_directory_find(const char *const search_str, gboolean previous)
+{
+    if (find_matches == NULL) {
+        if (search_str == NULL || search_str[0] == '\0') {
+            return NULL;
+        }
+
+        _room_directory_load_all();
+        find_matches = g_ptr_array_new_with_free_func(free);
+        find_pos = -1;
+
+        gchar *search_lower = g_utf8_strdown(search_str, -1);
+        gchar **parts = g_strsplit(search_lower, "@", 2);
+
+        GList *values = g_hash_table_get_values(directories);
+        GList *curr = values;
+        while (curr) {
+            GSList *entries = room_directory_search(curr->data, parts[0]);
+            GSList *curr_entry = entries;
+            while (curr_entry) {
+                RoomDirectoryEntry *entry = curr_entry->data;
+                gchar *jid_lower = g_utf8_strdown(entry->jid, -1);
+                if (g_str_has_prefix(jid_lower, search_lower)) {
+                    g_ptr_array_add(find_matches, strdup(entry->jid));
+                }
+                g_free(jid_lower);
+                curr_entry = g_slist_next(curr_entry);
+            }
+            g_slist_free(entries);
+            curr = g_list_next(curr);
+        }
+        g_list_free(values);
+
+        g_strfreev(parts);
+        g_free(search_lower);
+
+        g_ptr_array_sort(find_matches, _room_directory_cmp);
+    }
+
+    if (find_matches->len == 0) {
+        return NULL;
+    }
+
+    if (previous) {
+        find_pos = find_pos <= 0 ? find_matches->len - 1 : find_pos - 1;
+    } else {
+        find_pos = (find_pos + 1) % find_matches->len;
+    }
+
+    return strdup(g_ptr_array_index(find_matches, find_pos));
+}
+
+void
+room_directory_reset_find(void)
+{
+    if (find_matches) {
+        g_ptr_array_free(find_matches, TRUE);
+        find_matches = NULL;
+    }
+    find_pos = -1;
+}
+
+static void
+_room_directory_entry_free(RoomDirectoryEntry *entry)
+{
+    if (entry) {
+        free(entry->jid);
+        free(entry->name);
+        g_free(entry->search);
+        free(entry);
+    }
+}
+
+static void
+_room_directory_postings_free(GArray *postings)
+{
+    g_array_free(postings, TRUE);
+}
+
+static void
+_room_directory_index(RoomDirectory *directory)
+{
+    if (directory->index) {
+        return;
+    }
+
+    directory->index = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+        (GDestroyNotify)_room_directory_postings_free);
+
+    guint i;
+    for (i = 0; i < directory->entries->len; i++) {
+        RoomDirectoryEntry *entry = g_ptr_array_index(directory->entries, i);
+        size_t len = strlen(entry->search);
+        size_t pos;
+        for (pos = 0; pos + ROOM_DIRECTORY_NGRAM <= len; pos++) {
+            gpointer key = GUINT_TO_POINTER(_room_directory_trigram(&entry->search[pos]));
+            GArray *postings = g_hash_table_lookup(directory->index, key);
+            if (postings == NULL) {
+                postings = g_array_new(FALSE, FALSE, sizeof(guint));
+                g_hash_table_insert(directory->index, key, postings);
+            }
+
+            // entries are indexed in order, so a repeated trigram can only match the last posting
+            if (postings->len == 0 || g_array_index(postings, guint, postings->len - 1) != i) {
+                g_array_append_val(postings, i);
+            }
+        }
+    }
+}
+
+static guint32
+_room_directory_trigram(const char *const str)
+{
+    return ((guint32)(guchar)str[0] << 16) | ((guint32)(guchar)str[1] << 8) | (guint32)(guchar)str[2];
+}
+
+static GArray*
+_room_directory_candidates(RoomDirectory *directory, const char *const needle)
+{
+    _room_directory_index(directory);
+
+    // every trigram of the needle must occur, the rarest one bounds the candidates
+    GArray *smallest = NULL;
+    size_t len = strlen(needle);
+    size_t pos;
+    for (pos = 0; pos + ROOM_DIRECTORY_NGRAM <= len; pos++) {
+        gpointer key = GUINT_TO_POINTER(_room_directory_trigram(&needle[pos]));
+        GArray *postings = g_hash_table_lookup(directory->index, key);
+        if (postings == NULL) {
+            return NULL;
+        }
+        if (smallest == NULL || postings->len < smallest->len) {
+            smallest = postings;
+        }
+    }
+
+    return smallest;
+}
+
+static GHashTable*
+_room_directory_registry(void)
+{
+    if (directories == NULL) {
+        directories = g_hash_table_new_full(g_str_hash, g_str_equal, free, (GDestroyNotify)room_directory_free);
+    }
+
+    return directories;
+}
+
+static char*
+_room_directory_path(const char *const service)
+{
+    // the service comes from the user or the server, escape it so it names a single file in the rooms dir
+    char *filename = g_uri_escape_string(service, NULL, FALSE);
+    if (filename[0] == '\0' || g_strcmp0(filename, ".") == 0 || g_strcmp0(filename, "..") == 0) {
+        g_free(filename);
+        return NULL;
+    }
+
+    char *rooms_dir = files_get_data_path(DIR_ROOMS);
+    GString *path = g_string_new(rooms_dir);
+    g_string_append_printf(path, "/%s", filename);
+    free(rooms_dir);
+    g_free(filename);
+
+    char *result = strdup(path->str);
+    g_string_free(path, TRUE);
+
+    return result;
+}
+
+static RoomDirectory*
+_room_directory_load(const char *const service)
+{
+    char *path = _room_directory_path(service);
+    if (path == NULL) {
+        return NULL;
+    }
+    FILE *fp = fopen(path, "r");
+    free(path);
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    // first line holds the fetch time, then one "jid<TAB>name" line per room
+    char *line = file_getline(fp);
+    if (line == NULL) {
+        fclose(fp);
+        return NULL;
+    }
+
+    RoomDirectory *directory = room_directory_new(service);
+    directory->fetched = g_ascii_strtoll(line, NULL, 10);
+    free(line);
+
+    while ((line = file_getline(fp)) != NULL) {
+        gchar **fields = g_strsplit(line, "\t", 2);
+        if (fields[0]) {
+            gchar *jid = g_strcompress(fields[0]);
+            gchar *name = fields[1] ? g_strcompress(fields[1]) : NULL;
+            room_directory_add(directory, jid, name);
+            g_free(jid);
+            g_free(name);
+        }
+        g_strfreev(fields);
+        free(line);
+    }
+    fclose(fp);
+
+    log_debug("Loaded %d rooms for %s from cache", room_directory_size(directory), service);
+
+    return directory;
+}
+
+static void
+_room_directory_save(RoomDirectory *directory)
+{
+    char *rooms_dir = files_get_data_path(DIR_ROOMS);
+    gboolean created = mkdir_recursive(rooms_dir);
+    free(rooms_dir);
+    if (!created) {
+        log_error("Could not create room directory cache");
+        return;
+    }
+
+    char *path = _room_directory_path(directory->service);
+    if (path == NULL) {
+        log_error("Invalid service name for room directory cache: %s", directory->service);
+        return;
+    }
+    gchar *partial = g_strconcat(path, ".part", NULL);
+    FILE *fp = fopen(partial, "w");
+    if (fp == NULL) {
+        log_error("Could not write room directory cache %s", partial);
+        g_free(partial);
+        free(path);
+        return;
+    }
+
+    fprintf(fp, "%" G_GINT64_FORMAT "\n", directory->fetched);
+    guint i;
+    for (i = 0; i < directory->entries->len; i++) {
+        RoomDirectoryEntry *entry = g_ptr_array_index(directory->entries, i);
+        gchar *jid = g_strescape(entry->jid, NULL);
+        gchar *name = entry->name ? g_strescape(entry->name, NULL) : NULL;
+        fprintf(fp, "%s\t%s\n", jid, name ? name : "");
+        g_free(jid);
+        g_free(name);
+    }
+
+    if (fclose(fp) != 0 || rename(partial, path) != 0) {
+        log_error("Could not write room directory cache %s", path);
+        unlink(partial);
+    }
+
+    g_free(partial);
+    free(path);
+}
+
+static void
+_room_directory_load_all(void)
+{
+    if (directories_scanned) {
+        return;
+    }
+    directories_scanned = TRUE;
+
+    char *rooms_dir = files_get_data_path(DIR_ROOMS);
+    GDir *dir = g_dir_open(rooms_dir, 0, NULL);
+    free(rooms_dir);
+    _room_directory_registry();
+    if (dir == NULL) {
+        return;
+    }
+
+    const gchar *name;
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        if (!g_str_has_suffix(name, ".part")) {
+            char *service = g_uri_unescape_string(name, NULL);
+            if (service) {
+                room_directory_get(service);
+                g_free(service);
+            }
+        }
+    }
+    g_dir_close(dir);
+}
+
+static gint
+_room_directory_cmp(gconstpointer a, gconstpointer b)
+{
+    return g_strcmp0(*(char**)a, *(char**)b);
+}
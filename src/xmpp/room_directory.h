@@ -0,0 +1,67 @@
+/*
+ * room_directory.h
+ * vim: expandtab:ts=4:sts=4:sw=4
+ *
+ * Copyright (C) 2020 Paul Fariello <paul@fariello.eu>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef XMPP_ROOM_DIRECTORY_H
+#define XMPP_ROOM_DIRECTORY_H
+
+#include <glib.h>
+
+typedef struct room_directory_entry_t {
+    char *jid;
+    char *name;
+    // lower case localpart and name, used for matching
+    char *search;
+} RoomDirectoryEntry;
+
+typedef struct room_directory_t RoomDirectory;
+
+RoomDirectory* room_directory_new(const char *const service);
+void room_directory_free(RoomDirectory *directory);
+const char* room_directory_service(RoomDirectory *directory);
+void room_directory_add(RoomDirectory *directory, const char *const jid, const char *const name);
+int room_directory_size(RoomDirectory *directory);
+void room_directory_set_fetched(RoomDirectory *directory, gint64 fetched);
+gboolean room_directory_is_stale(RoomDirectory *directory);
+GSList* room_directory_search(RoomDirectory *directory, const char *const filter);
+
+RoomDirectory* room_directory_get(const char *const service);
+void room_directory_store(RoomDirectory *directory);
+void room_directory_clear(void);
+void room_directory_close(void);
+
+char* room_directory_find(const char *const search_str, gboolean previous);
+void room_directory_reset_find(void);
+
+#endif
@@ -42,11 +42,15 @@
 
 #include "config/preferences.h"
 #include "tools/autocomplete.h"
+#include "tools/memory.h"
 #include "xmpp/roster_list.h"
 #include "xmpp/resource.h"
 #include "xmpp/contact.h"
 #include "xmpp/jid.h"
 
+// approximate size of a contact with its resource table and autocompleter
+#define CONTACT_BASE_SIZE 256
+
 typedef struct prof_roster_t {
     // contacts, indexed on barejid
     GHashTable *contacts;
@@ -82,6 +86,8 @@ static gboolean _key_equals(void *key1, void *key2);
 static gboolean _datetimes_equal(GDateTime *dt1, GDateTime *dt2);
 static void _replace_name(const char *const current_name, const char *const new_name, const char *const barejid);
 static void _add_name_and_barejid(const char *const name, const char *const barejid);
+static gint64 _contact_size(const char *const barejid);
+static void _contact_free(PContact contact);
 
 void
 roster_create(void)
@@ -89,7 +95,7 @@ roster_create(void)
     assert(roster == NULL);
 
     roster = malloc(sizeof(ProfRoster));
-    roster->contacts = g_hash_table_new_full(g_str_hash, (GEqualFunc)_key_equals, g_free, (GDestroyNotify)p_contact_free);
+    roster->contacts = g_hash_table_new_full(g_str_hash, (GEqualFunc)_key_equals, g_free, (GDestroyNotify)_contact_free);
     roster->name_ac = autocomplete_new();
     roster->barejid_ac = autocomplete_new();
     roster->fulljid_ac = autocomplete_new();
@@ -380,6 +386,7 @@ roster_add(const char *const barejid, const char *const name, GSList *groups, co
     }
 
     g_hash_table_insert(roster->contacts, strdup(barejid), contact);
+    memory_add(MEMORY_ROSTER, _contact_size(barejid), 1);
     autocomplete_add(roster->barejid_ac, barejid);
     _add_name_and_barejid(name, barejid);
 
@@ -682,6 +689,23 @@ roster_compare_presence(PContact a, PContact b)
     }
 }
 
+/*
+ * Approximate heap used by a contact, its barejid is kept in the contact,
+ * the contacts table, the name map and the autocompleters
+ */
+static gint64
+_contact_size(const char *const barejid)
+{
+    return CONTACT_BASE_SIZE + 5 * (strlen(barejid) + 1);
+}
+
+static void
+_contact_free(PContact contact)
+{
+    memory_add(MEMORY_ROSTER, -_contact_size(p_contact_barejid(contact)), -1);
+    p_contact_free(contact);
+}
+
 static void
 _pendingPresence_free(ProfPendingPresence *presence)
 {
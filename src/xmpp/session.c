@@ -46,13 +46,16 @@
 #include "plugins/plugins.h"
 #include "event/server_events.h"
 #include "event/client_events.h"
+#include "xmpp/autojoin.h"
 #include "xmpp/bookmark.h"
 #include "xmpp/blocking.h"
 #include "xmpp/connection.h"
+#include "xmpp/connector.h"
 #include "xmpp/capabilities.h"
 #include "xmpp/session.h"
 #include "xmpp/iq.h"
 #include "xmpp/message.h"
+#include "xmpp/outbound.h"
 #include "xmpp/presence.h"
 #include "xmpp/roster.h"
 #include "xmpp/stanza.h"
@@ -60,6 +63,7 @@
 #include "xmpp/muc.h"
 #include "xmpp/chat_session.h"
 #include "xmpp/jid.h"
+#include "xmpp/room_directory.h"
 
 #ifdef HAVE_OMEMO
 #include "omemo/omemo.h"
@@ -81,6 +85,14 @@ static struct {
     char *tls_policy;
 } saved_details;
 
+// where to connect once eval_password has finished
+static struct {
+    char *jid;
+    char *server;
+    int port;
+    char *tls_policy;
+} evaluating;
+
 typedef enum {
     ACTIVITY_ST_ACTIVE,
     ACTIVITY_ST_IDLE,
@@ -94,9 +106,15 @@ static resource_presence_t saved_presence;
 static char *saved_status;
 
 static void _session_reconnect(void);
+static jabber_conn_status_t _session_connect_account(const ProfAccount *const account);
+static char* _session_account_jid(const ProfAccount *const account);
+static void _session_password_evaluated(char *password);
+static void _session_login_failed(gboolean report);
 
 static void _session_free_saved_account(void);
 static void _session_free_saved_details(void);
+static void _session_free_evaluating(void);
+static void _session_drop_previous(void);
 
 void
 session_init(void)
@@ -111,34 +129,33 @@ jabber_conn_status_t
 session_connect_with_account(const ProfAccount *const account)
 {
     assert(account != NULL);
+    assert(account->password != NULL || account->eval_password != NULL);
 
     log_info("Connecting using account: %s", account->name);
 
+    _session_drop_previous();
     _session_free_saved_account();
     _session_free_saved_details();
+    _session_free_evaluating();
 
     // save account name and password for reconnect
     saved_account.name = strdup(account->name);
-    saved_account.passwd = strdup(account->password);
 
-    char *jid = NULL;
-    if (account->resource) {
-        Jid *jidp = jid_create_from_bare_and_resource(account->jid, account->resource);
-        jid = strdup(jidp->fulljid);
-        jid_destroy(jidp);
-    } else {
-        jid = strdup(account->jid);
+    // evaluate the password in the background and connect once it arrives
+    if (account->password == NULL && account->eval_password) {
+        log_info("Evaluating password for account: %s", account->name);
+        evaluating.jid = _session_account_jid(account);
+        evaluating.server = g_strdup(account->server);
+        evaluating.port = account->port;
+        evaluating.tls_policy = g_strdup(account->tls_policy);
+        connection_set_connecting();
+        connector_eval_password(account->eval_password, _session_password_evaluated);
+        return JABBER_CONNECTING;
     }
 
-    jabber_conn_status_t result = connection_connect(
-        jid,
-        account->password,
-        account->server,
-        account->port,
-        account->tls_policy);
-    free(jid);
+    saved_account.passwd = g_strdup(account->password);
 
-    return result;
+    return _session_connect_account(account);
 }
 
 jabber_conn_status_t
@@ -148,8 +165,10 @@ session_connect_with_details(const char *const jid, const char *const passwd, co
     assert(jid != NULL);
     assert(passwd != NULL);
 
+    _session_drop_previous();
     _session_free_saved_account();
     _session_free_saved_details();
+    _session_free_evaluating();
 
     // save details for reconnect, remember name for account creating on success
     saved_details.name = strdup(jid);
@@ -213,7 +232,6 @@ session_disconnect(void)
 
         accounts_set_last_activity(session_get_account_name());
 
-        iq_rooms_cache_clear();
         iq_handlers_clear();
 
         connection_disconnect();
@@ -224,6 +242,8 @@ session_disconnect(void)
         presence_clear_sub_requests();
     }
 
+    outbound_clear();
+    autojoin_clear();
     connection_set_disconnected();
 }
 
@@ -235,8 +255,11 @@ session_shutdown(void)
 
     chat_sessions_clear();
     presence_clear_sub_requests();
+    outbound_clear();
+    autojoin_clear();
 
     connection_shutdown();
+    room_directory_close();
     if (saved_status) {
         free(saved_status);
     }
@@ -247,6 +270,8 @@ session_process_events(void)
 {
     int reconnect_sec;
 
+    connector_process();
+
     jabber_conn_status_t conn_status = connection_get_status();
     switch (conn_status)
     {
@@ -254,6 +279,11 @@ session_process_events(void)
     case JABBER_CONNECTING:
     case JABBER_DISCONNECTING:
         connection_check_events();
+        if (conn_status == JABBER_CONNECTED) {
+            message_chat_states_flush();
+            autojoin_process();
+            outbound_flush();
+        }
         break;
     case JABBER_DISCONNECTED:
         reconnect_sec = prefs_get_reconnect();
@@ -275,6 +305,48 @@ session_get_account_name(void)
     return saved_account.name;
 }
 
+/*
+ * The connection was lost and will be retried, messages written meanwhile are kept
+ */
+gboolean
+session_reconnecting(void)
+{
+    return reconnect_timer != NULL && connection_get_status() == JABBER_DISCONNECTED;
+}
+
+/*
+ * Give up on a connection attempt that has not logged in yet, including
+ * waiting for eval_password or for the next reconnect
+ */
+gboolean
+session_cancel_connect(void)
+{
+    if (connection_get_status() != JABBER_CONNECTING && !session_reconnecting()) {
+        return FALSE;
+    }
+
+    log_info("Connection attempt cancelled");
+    connector_cancel();
+    connection_disconnect();
+    connection_set_disconnected();
+
+    if (reconnect_timer) {
+        g_timer_destroy(reconnect_timer);
+        reconnect_timer = NULL;
+    }
+    _session_free_saved_account();
+    _session_free_saved_details();
+    _session_free_evaluating();
+    outbound_clear();
+    autojoin_clear();
+
+    connection_clear_data();
+    chat_sessions_clear();
+    presence_clear_sub_requests();
+
+    return TRUE;
+}
+
 void
 session_login_success(gboolean secured)
 {
@@ -296,7 +368,7 @@ session_login_success(gboolean secured)
         accounts_set_jid(saved_details.name, saved_details.jid);
 
         saved_account.name = strdup(saved_details.name);
-        saved_account.passwd = strdup(saved_details.passwd);
+        saved_account.passwd = g_strdup(saved_details.passwd);
 
         _session_free_saved_details();
         sv_ev_login_account_success(saved_account.name, secured);
@@ -315,6 +387,8 @@ session_login_success(gboolean secured)
         iq_enable_carbons();
     }
 
+    outbound_connected();
+
     if ((prefs_get_reconnect() != 0) && reconnect_timer) {
         g_timer_destroy(reconnect_timer);
         reconnect_timer = NULL;
@@ -323,12 +397,21 @@ session_login_success(gboolean secured)
 
 void
 session_login_failed(void)
+{
+    _session_login_failed(TRUE);
+}
+
+static void
+_session_login_failed(gboolean report)
 {
     if (reconnect_timer == NULL) {
         log_debug("Connection handler: No reconnect timer");
-        sv_ev_failed_login();
+        if (report) {
+            sv_ev_failed_login();
+        }
         _session_free_saved_account();
         _session_free_saved_details();
+        outbound_clear();
     } else {
         log_debug("Connection handler: Restarting reconnect timer");
         if (prefs_get_reconnect() != 0) {
@@ -346,12 +429,15 @@ session_lost_connection(void)
 {
     /* this callback also clears all cached data */
     sv_ev_lost_connection();
+    autojoin_clear();
     if (prefs_get_reconnect() != 0) {
         assert(reconnect_timer == NULL);
         reconnect_timer = g_timer_new();
+        outbound_lost_connection();
     } else {
         _session_free_saved_account();
         _session_free_saved_details();
+        outbound_clear();
     }
 }
 
@@ -517,11 +603,69 @@ _session_reconnect(void)
     g_timer_start(reconnect_timer);
 }
 
+static jabber_conn_status_t
+_session_connect_account(const ProfAccount *const account)
+{
+    char *jid = _session_account_jid(account);
+    jabber_conn_status_t result = connection_connect(
+        jid,
+        saved_account.passwd,
+        account->server,
+        account->port,
+        account->tls_policy);
+    free(jid);
+
+    return result;
+}
+
+static char*
+_session_account_jid(const ProfAccount *const account)
+{
+    if (account->resource) {
+        Jid *jidp = jid_create_from_bare_and_resource(account->jid, account->resource);
+        char *jid = strdup(jidp->fulljid);
+        jid_destroy(jidp);
+        return jid;
+    }
+
+    return strdup(account->jid);
+}
+
+/*
+ * eval_password finished, carry on with the connection it was started for,
+ * using the account as it was given to /connect
+ */
+static void
+_session_password_evaluated(char *password)
+{
+    if (password == NULL) {
+        sv_ev_password_eval_failed();
+        _session_free_evaluating();
+        _session_login_failed(FALSE);
+        connection_set_disconnected();
+        return;
+    }
+
+    saved_account.passwd = password;
+    jabber_conn_status_t result = connection_connect(
+        evaluating.jid,
+        saved_account.passwd,
+        evaluating.server,
+        evaluating.port,
+        evaluating.tls_policy);
+    _session_free_evaluating();
+
+    if (result == JABBER_DISCONNECTED) {
+        session_login_failed();
+        connection_set_disconnected();
+    }
+}
+
 static void
 _session_free_saved_account(void)
 {
     FREE_SET_NULL(saved_account.name);
-    FREE_SET_NULL(saved_account.passwd);
+    GFREE_SET_NULL(saved_account.passwd);
 }
 
 static void
@@ -534,3 +678,25 @@ _session_free_saved_details(void)
     FREE_SET_NULL(saved_details.tls_policy);
 }
 
+static void
+_session_free_evaluating(void)
+{
+    FREE_SET_NULL(evaluating.jid);
+    GFREE_SET_NULL(evaluating.server);
+    GFREE_SET_NULL(evaluating.tls_policy);
+    evaluating.port = 0;
+}
+
+/*
+ * A new connection replaces any reconnect still pending, and what was queued
+ * for the previous session must not be sent on the new one
+ */
+static void
+_session_drop_previous(void)
+{
+    if (reconnect_timer) {
+        g_timer_destroy(reconnect_timer);
+        reconnect_timer = NULL;
+    }
+    outbound_clear();
+}
@@ -957,6 +957,45 @@ stanza_create_disco_items_iq(xmpp_ctx_t *ctx, const char *const id,
     return iq;
 }
 
+xmpp_stanza_t*
+stanza_create_disco_items_page_iq(xmpp_ctx_t *ctx, const char *const id,
+    const char *const jid, int max, const char *const after)
+{
+    xmpp_stanza_t *iq = stanza_create_disco_items_iq(ctx, id, jid, NULL);
+    xmpp_stanza_t *query = xmpp_stanza_get_child_by_name(iq, STANZA_NAME_QUERY);
+
+    xmpp_stanza_t *set = xmpp_stanza_new(ctx);
+    xmpp_stanza_set_name(set, STANZA_NAME_SET);
+    xmpp_stanza_set_ns(set, STANZA_NS_RSM);
+
+    xmpp_stanza_t *max_st = xmpp_stanza_new(ctx);
+    xmpp_stanza_set_name(max_st, STANZA_NAME_MAX);
+    xmpp_stanza_t *max_txt = xmpp_stanza_new(ctx);
+    char *max_str = g_strdup_printf("%d", max);
+    xmpp_stanza_set_text(max_txt, max_str);
+    g_free(max_str);
+    xmpp_stanza_add_child(max_st, max_txt);
+    xmpp_stanza_release(max_txt);
+    xmpp_stanza_add_child(set, max_st);
+    xmpp_stanza_release(max_st);
+
+    if (after) {
+        xmpp_stanza_t *after_st = xmpp_stanza_new(ctx);
+        xmpp_stanza_set_name(after_st, STANZA_NAME_AFTER);
+        xmpp_stanza_t *after_txt = xmpp_stanza_new(ctx);
+        xmpp_stanza_set_text(after_txt, after);
+        xmpp_stanza_add_child(after_st, after_txt);
+        xmpp_stanza_release(after_txt);
+        xmpp_stanza_add_child(set, after_st);
+        xmpp_stanza_release(after_st);
+    }
+
+    xmpp_stanza_add_child(query, set);
+    xmpp_stanza_release(set);
+
+    return iq;
+}
+
 xmpp_stanza_t*
 stanza_create_last_activity_iq(xmpp_ctx_t *ctx, const char *const id, const char *const to)
 {
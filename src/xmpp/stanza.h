@@ -104,6 +104,10 @@
 #define STANZA_NAME_COMMAND "command"
 #define STANZA_NAME_CONFIGURE "configure"
 #define STANZA_NAME_ORIGIN_ID "origin-id"
+#define STANZA_NAME_SET "set"
+#define STANZA_NAME_MAX "max"
+#define STANZA_NAME_AFTER "after"
+#define STANZA_NAME_LAST "last"
 
 // error conditions
 #define STANZA_NAME_BAD_REQUEST "bad-request"
@@ -198,6 +202,7 @@
 #define STANZA_NS_OMEMO "eu.siacs.conversations.axolotl"
 #define STANZA_NS_OMEMO_DEVICELIST "eu.siacs.conversations.axolotl.devicelist"
 #define STANZA_NS_OMEMO_BUNDLES "eu.siacs.conversations.axolotl.bundles"
+#define STANZA_NS_RSM "http://jabber.org/protocol/rsm"
 #define STANZA_NS_STABLE_ID "urn:xmpp:sid:0"
 #define STANZA_NS_USER_AVATAR_DATA "urn:xmpp:avatar:data"
 #define STANZA_NS_USER_AVATAR_METADATA "urn:xmpp:avatar:metadata"
@@ -325,6 +330,7 @@ EntityCapabilities* stanza_create_caps_from_query_element(xmpp_stanza_t *query);
 const char* stanza_get_presence_string_from_type(resource_presence_t presence_type);
 xmpp_stanza_t* stanza_create_software_version_iq(xmpp_ctx_t *ctx, const char *const fulljid);
 xmpp_stanza_t* stanza_create_disco_items_iq(xmpp_ctx_t *ctx, const char *const id, const char *const jid, const char *const node);
+xmpp_stanza_t* stanza_create_disco_items_page_iq(xmpp_ctx_t *ctx, const char *const id, const char *const jid, int max, const char *const after);
 
 char* stanza_get_status(xmpp_stanza_t *stanza, char *def);
 char* stanza_get_show(xmpp_stanza_t *stanza, char *def);
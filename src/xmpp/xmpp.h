@@ -150,6 +150,8 @@ void session_disconnect(void);
 void session_shutdown(void);
 void session_process_events(void);
 char* session_get_account_name(void);
+gboolean session_reconnecting(void);
+gboolean session_cancel_connect(void);
 
 jabber_conn_status_t connection_get_status(void);
 char *connection_get_presence_msg(void);
@@ -190,6 +192,7 @@ gint presence_sub_request_count(void);
 void presence_reset_sub_request_search(void);
 char* presence_sub_request_find(const char *const search_str, gboolean previous);
 void presence_join_room(const char *const room, const char *const nick, const char *const passwd);
+void presence_autojoin_room(const char *const room, const char *const nick, const char *const passwd);
 void presence_change_room_nick(const char *const room, const char *const nick);
 void presence_leave_chat_room(const char *const room_jid);
 void presence_send(resource_presence_t status, int idle, char *signed_status);
@@ -54,16 +54,18 @@ void log_stderr_close(void) {}
 void log_stderr_handler(void) {}
 
 void chat_log_init(void) {}
+void chat_log_compress(void) {}
 
-void chat_log_msg_out(const char * const barejid, const char * const msg, const char *const resource) {}
-void chat_log_otr_msg_out(const char * const barejid, const char * const msg, const char *const resource) {}
-void chat_log_pgp_msg_out(const char * const barejid, const char * const msg, const char *const resource) {}
-void chat_log_omemo_msg_out(const char *const barejid, const char *const msg, const char *const resource) {}
+void chat_log_msg_out(const char * const barejid, const char * const msg, const char *const resource, const char *const id) {}
+void chat_log_otr_msg_out(const char * const barejid, const char * const msg, const char *const resource, const char *const id) {}
+void chat_log_pgp_msg_out(const char * const barejid, const char * const msg, const char *const resource, const char *const id) {}
+void chat_log_omemo_msg_out(const char *const barejid, const char *const msg, const char *const resource, const char *const id) {}
 
 void chat_log_msg_in(ProfMessage *message) {}
 void chat_log_otr_msg_in(ProfMessage *message) {}
 void chat_log_pgp_msg_in(ProfMessage *message) {}
 void chat_log_omemo_msg_in(ProfMessage *message) {}
+void chat_log_msg_receipt(const char *const barejid, const char *const id) {}
 
 void chat_log_close(void) {}
 GSList * chat_log_get_previous(const gchar * const login,
@@ -73,7 +75,9 @@ GSList * chat_log_get_previous(const gchar * const login,
 }
 
 void groupchat_log_init(void) {}
-void groupchat_log_msg_in(const gchar *const room, const gchar *const nick, const gchar *const msg) {}
-void groupchat_log_msg_out(const gchar *const room, const gchar *const msg) {}
-void groupchat_log_omemo_msg_in(const gchar *const room, const gchar *const nick, const gchar *const msg) {}
-void groupchat_log_omemo_msg_out(const gchar *const room, const gchar *const msg) {}
+void groupchat_log_msg_in(const gchar *const room, const gchar *const nick, const gchar *const msg,
+    GDateTime *timestamp, const char *const id) {}
+void groupchat_log_msg_out(const gchar *const room, const gchar *const msg, const char *const id) {}
+void groupchat_log_omemo_msg_in(const gchar *const room, const gchar *const nick, const gchar *const msg,
+    GDateTime *timestamp, const char *const id) {}
+void groupchat_log_omemo_msg_out(const gchar *const room, const gchar *const msg, const char *const id) {}
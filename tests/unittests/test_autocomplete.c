@@ -7,6 +7,7 @@
 
 #include "xmpp/contact.h"
 #include "tools/autocomplete.h"
+#include "plugins/autocompleters.h"
 
 void clear_empty(void **state)
 {
@@ -216,3 +217,37 @@ void complete_previous(void **state)
     free(result3);
     free(result4);
 }
+
+void plugin_autocompleter_completes_subcommand_key(void **state)
+{
+    autocompleters_init();
+    char *items1[] = { "first", NULL };
+    char *items2[] = { "second", NULL };
+    autocompleters_add("plugin1.py", "/cmd", items1);
+    autocompleters_add("plugin2.py", "/cmd sub", items2);
+
+    char *result1 = autocompleters_complete("/cmd f", FALSE);
+    char *result2 = autocompleters_complete("/cmd sub s", FALSE);
+
+    assert_string_equal("/cmd first", result1);
+    assert_string_equal("/cmd sub second", result2);
+
+    free(result1);
+    free(result2);
+    autocompleters_destroy();
+}
+
+void plugin_autocompleter_ignores_other_commands(void **state)
+{
+    autocompleters_init();
+    char *items[] = { "first", NULL };
+    autocompleters_add("plugin1.py", "/cmd", items);
+
+    char *result1 = autocompleters_complete("/cmdx f", FALSE);
+    char *result2 = autocompleters_complete("/other f", FALSE);
+
+    assert_null(result1);
+    assert_null(result2);
+
+    autocompleters_destroy();
+}
@@ -14,3 +14,5 @@ void complete_both_with_accented(void **state);
 void complete_both_with_base(void **state);
 void complete_ignores_case(void **state);
 void complete_previous(void **state);
+void plugin_autocompleter_completes_subcommand_key(void **state);
+void plugin_autocompleter_ignores_other_commands(void **state);
@@ -0,0 +1,211 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <glib.h>
+
+#include "helpers.h"
+#include "tools/memory.h"
+#include "ui/buffer.h"
+
+// matches the number of entries a buffer keeps in memory
+#define BUFF_SIZE 1200
+#define SCROLLBACK_DIR "./tests/files/xdg_data_home/profanity/scrollback"
+
+void remove_scrollback_dir(void **state)
+{
+    rmdir(SCROLLBACK_DIR);
+    remove_data_dir(state);
+    rmdir("./tests/files");
+}
+
+static void
+_append_messages(ProfBuff buffer, int from, int count)
+{
+    GDateTime *now = g_date_time_new_now_local();
+    int i;
+    for (i = from; i < from + count; i++) {
+        char *message = g_strdup_printf("message %d", i);
+        char *id = g_strdup_printf("id%d", i);
+        DeliveryReceipt *receipt = NULL;
+        if (i % 2 == 0) {
+            receipt = malloc(sizeof(DeliveryReceipt));
+            receipt->received = i % 4 == 0;
+        }
+        buffer_append(buffer, '-', 0, now, 0, THEME_TEXT, "bob", message, receipt, id);
+        g_free(message);
+        g_free(id);
+    }
+    g_date_time_unref(now);
+}
+
+void buffer_drops_oldest_entry_when_spill_disabled(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    _append_messages(buffer, 0, BUFF_SIZE + 1);
+
+    assert_int_equal(BUFF_SIZE, buffer_size(buffer));
+    assert_int_equal(0, buffer_spilled_size(buffer));
+    assert_string_equal("message 1", buffer_get_entry(buffer, 0)->message);
+    assert_null(buffer_get_spilled_entry(buffer, 0));
+
+    buffer_free(buffer);
+}
+
+void buffer_spills_oldest_entry_when_full(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    buffer_set_spill(buffer, TRUE);
+    _append_messages(buffer, 0, BUFF_SIZE + 1);
+
+    assert_int_equal(BUFF_SIZE, buffer_size(buffer));
+    assert_int_equal(1, buffer_spilled_size(buffer));
+    assert_string_equal("message 1", buffer_get_entry(buffer, 0)->message);
+    assert_string_equal("message 0", buffer_get_spilled_entry(buffer, 0)->message);
+
+    buffer_free(buffer);
+}
+
+void buffer_reads_back_spilled_entries(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    buffer_set_spill(buffer, TRUE);
+    _append_messages(buffer, 0, BUFF_SIZE + 700);
+
+    assert_int_equal(700, buffer_spilled_size(buffer));
+
+    int checks[] = { 0, 1, 63, 64, 65, 300, 255, 256, 699 };
+    int i;
+    for (i = 0; i < (int)(sizeof(checks) / sizeof(checks[0])); i++) {
+        int n = checks[i];
+        ProfBuffEntry *entry = buffer_get_spilled_entry(buffer, n);
+        assert_non_null(entry);
+
+        char *message = g_strdup_printf("message %d", n);
+        char *id = g_strdup_printf("id%d", n);
+        assert_string_equal(message, entry->message);
+        assert_string_equal(id, entry->id);
+        assert_string_equal("bob", entry->from);
+        if (n % 2 == 0) {
+            assert_non_null(entry->receipt);
+            assert_int_equal(n % 4 == 0, entry->receipt->received);
+        } else {
+            assert_null(entry->receipt);
+        }
+        g_free(message);
+        g_free(id);
+    }
+    assert_null(buffer_get_spilled_entry(buffer, 700));
+
+    buffer_free(buffer);
+}
+
+void buffer_spills_only_entries_appended_while_enabled(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    buffer_set_spill(buffer, TRUE);
+    _append_messages(buffer, 0, 10);
+    buffer_set_spill(buffer, FALSE);
+    _append_messages(buffer, 10, 10);
+    buffer_set_spill(buffer, TRUE);
+    _append_messages(buffer, 20, BUFF_SIZE);
+
+    assert_int_equal(BUFF_SIZE, buffer_size(buffer));
+    assert_int_equal(10, buffer_spilled_size(buffer));
+    assert_string_equal("message 9", buffer_get_spilled_entry(buffer, 9)->message);
+    assert_string_equal("message 20", buffer_get_entry(buffer, 0)->message);
+
+    buffer_free(buffer);
+}
+
+void buffer_leaves_no_spill_file_behind(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    buffer_set_spill(buffer, TRUE);
+    _append_messages(buffer, 0, BUFF_SIZE + 10);
+    assert_string_equal("message 5", buffer_get_spilled_entry(buffer, 5)->message);
+
+    DIR *dir = opendir(SCROLLBACK_DIR);
+    assert_non_null(dir);
+    int files = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            files++;
+        }
+    }
+    closedir(dir);
+    assert_int_equal(0, files);
+
+    buffer_free(buffer);
+}
+
+void buffer_trim_spills_all_but_newest_entries(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    buffer_set_spill(buffer, TRUE);
+    _append_messages(buffer, 0, 100);
+
+    assert_int_equal(90, buffer_trim(buffer, 10));
+    assert_int_equal(10, buffer_size(buffer));
+    assert_int_equal(90, buffer_spilled_size(buffer));
+    assert_string_equal("message 90", buffer_get_entry(buffer, 0)->message);
+    assert_string_equal("message 89", buffer_get_spilled_entry(buffer, 89)->message);
+
+    buffer_free(buffer);
+}
+
+void buffer_trim_keeps_entries_not_to_be_spilled(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    _append_messages(buffer, 0, 100);
+
+    assert_int_equal(0, buffer_trim(buffer, 10));
+    assert_int_equal(100, buffer_size(buffer));
+    assert_int_equal(0, buffer_spilled_size(buffer));
+
+    buffer_free(buffer);
+}
+
+void buffer_trim_stops_at_entry_not_to_be_spilled(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    buffer_set_spill(buffer, TRUE);
+    _append_messages(buffer, 0, 50);
+    buffer_set_spill(buffer, FALSE);
+    _append_messages(buffer, 50, 50);
+
+    assert_int_equal(50, buffer_trim(buffer, 10));
+    assert_int_equal(50, buffer_size(buffer));
+    assert_string_equal("message 50", buffer_get_entry(buffer, 0)->message);
+
+    buffer_free(buffer);
+}
+
+void buffer_memory_follows_entries_in_memory(void **state)
+{
+    gint64 bytes = memory_bytes(MEMORY_BUFFERS);
+    gint64 objects = memory_objects(MEMORY_BUFFERS);
+
+    ProfBuff buffer = buffer_create();
+    buffer_set_spill(buffer, TRUE);
+    _append_messages(buffer, 0, 100);
+
+    assert_int_equal(objects + 100, memory_objects(MEMORY_BUFFERS));
+    gint64 appended = memory_bytes(MEMORY_BUFFERS);
+    assert_true(appended > bytes);
+
+    buffer_trim(buffer, 10);
+
+    assert_int_equal(objects + 10, memory_objects(MEMORY_BUFFERS));
+    assert_true(memory_bytes(MEMORY_BUFFERS) < appended);
+
+    buffer_free(buffer);
+
+    assert_int_equal(objects, memory_objects(MEMORY_BUFFERS));
+    assert_int_equal(bytes, memory_bytes(MEMORY_BUFFERS));
+}
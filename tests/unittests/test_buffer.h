@@ -0,0 +1,10 @@
+void remove_scrollback_dir(void **state);
+void buffer_drops_oldest_entry_when_spill_disabled(void **state);
+void buffer_spills_oldest_entry_when_full(void **state);
+void buffer_reads_back_spilled_entries(void **state);
+void buffer_spills_only_entries_appended_while_enabled(void **state);
+void buffer_leaves_no_spill_file_behind(void **state);
+void buffer_trim_spills_all_but_newest_entries(void **state);
+void buffer_trim_keeps_entries_not_to_be_spilled(void **state);
+void buffer_trim_stops_at_entry_not_to_be_spilled(void **state);
+void buffer_memory_follows_entries_in_memory(void **state);
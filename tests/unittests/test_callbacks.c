@@ -62,3 +62,61 @@ void returns_commands(void **state)
     //TODO: why does this make the test fail?
     //callbacks_close();
 }
+
+static int batches_delivered = 0;
+static int events_delivered = 0;
+
+static void
+_count_events(PluginEventsFunction *events_function, GPtrArray *events)
+{
+    batches_delivered++;
+    events_delivered += events->len;
+}
+
+void delivers_queued_events_in_one_batch(void **state)
+{
+    callbacks_init();
+    batches_delivered = 0;
+    events_delivered = 0;
+
+    PluginEventsFunction *events_function = malloc(sizeof(PluginEventsFunction));
+    events_function->callback = NULL;
+    events_function->callback_exec = _count_events;
+    events_function->callback_destroy = NULL;
+    events_function->interval_ms = 0;
+    callbacks_add_events("plugin1", events_function);
+
+    callbacks_queue_event("chat", "bob@server.org", "laptop", "hello", NULL, 0);
+    callbacks_queue_event("room", "room@conf.server.org", "mike", "hi all", NULL, 0);
+    callbacks_queue_event("presence", "bob@server.org", "laptop", "busy", "dnd", 10);
+    plugins_run_events();
+
+    assert_int_equal(1, batches_delivered);
+    assert_int_equal(3, events_delivered);
+
+    plugins_run_events();
+    assert_int_equal(1, batches_delivered);
+
+    callbacks_close();
+}
+
+void holds_events_until_interval_elapsed(void **state)
+{
+    callbacks_init();
+    batches_delivered = 0;
+    events_delivered = 0;
+
+    PluginEventsFunction *events_function = malloc(sizeof(PluginEventsFunction));
+    events_function->callback = NULL;
+    events_function->callback_exec = _count_events;
+    events_function->callback_destroy = NULL;
+    events_function->interval_ms = 60000;
+    callbacks_add_events("plugin1", events_function);
+
+    callbacks_queue_event("chat", "bob@server.org", "laptop", "hello", NULL, 0);
+    plugins_run_events();
+
+    assert_int_equal(0, batches_delivered);
+
+    callbacks_close();
+}
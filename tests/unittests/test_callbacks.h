@@ -1,2 +1,4 @@
 void returns_no_commands(void **state);
 void returns_commands(void **state);
+void delivers_queued_events_in_one_batch(void **state);
+void holds_events_until_interval_elapsed(void **state);
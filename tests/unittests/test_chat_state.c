@@ -0,0 +1,96 @@
+#include <stdarg.h>
+#include <string.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "config/preferences.h"
+#include "xmpp/xmpp.h"
+#include "xmpp/chat_state.h"
+
+static ChatState*
+_create_inactive_state(const char *const barejid)
+{
+    ChatState *state = chat_state_new(barejid);
+    chat_state_active(state);
+    state->since -= 30 * G_TIME_SPAN_SECOND;
+    chat_state_handle_idle(barejid, state);
+
+    return state;
+}
+
+void schedules_paused_after_typing(void **state)
+{
+    ChatState *chat_state = chat_state_new("bob@server.org");
+
+    chat_state_handle_typing("bob@server.org", chat_state);
+
+    assert_int_equal(CHAT_STATE_COMPOSING, chat_state->type);
+    assert_non_null(chat_state->scheduled);
+    assert_true(chat_state->deadline == chat_state->since + 10 * G_TIME_SPAN_SECOND);
+
+    chat_state_free(chat_state);
+}
+
+void does_not_schedule_inactive_when_gone_disabled(void **state)
+{
+    prefs_set_gone(0);
+    ChatState *chat_state = _create_inactive_state("bob@server.org");
+
+    assert_int_equal(CHAT_STATE_INACTIVE, chat_state->type);
+    assert_null(chat_state->scheduled);
+
+    chat_state_free(chat_state);
+}
+
+void reschedules_inactive_when_gone_enabled(void **state)
+{
+    prefs_set_gone(0);
+    ChatState *chat_state = _create_inactive_state("bob@server.org");
+
+    prefs_set_gone(5);
+    chat_state_reschedule_all();
+
+    assert_non_null(chat_state->scheduled);
+    assert_true(chat_state->deadline == chat_state->since + 5 * G_TIME_SPAN_MINUTE);
+
+    chat_state_free(chat_state);
+}
+
+void inactive_goes_gone_after_gone_enabled(void **state)
+{
+    prefs_set_gone(0);
+    ChatState *chat_state = _create_inactive_state("bob@server.org");
+    chat_state->since -= 5 * G_TIME_SPAN_MINUTE;
+
+    prefs_set_gone(5);
+    chat_state_reschedule_all();
+    will_return(connection_get_status, JABBER_CONNECTED);
+    chat_state_idle();
+
+    assert_int_equal(CHAT_STATE_GONE, chat_state->type);
+    assert_null(chat_state->scheduled);
+
+    chat_state_free(chat_state);
+}
+
+void idle_skips_chats_not_yet_due(void **state)
+{
+    ChatState *due = chat_state_new("bob@server.org");
+    ChatState *waiting = chat_state_new("alice@server.org");
+    chat_state_handle_typing("bob@server.org", due);
+    chat_state_handle_typing("alice@server.org", waiting);
+    due->since -= 10 * G_TIME_SPAN_SECOND;
+    chat_state_reschedule_all();
+
+    will_return(connection_get_status, JABBER_CONNECTED);
+    chat_state_idle();
+
+    assert_int_equal(CHAT_STATE_PAUSED, due->type);
+    assert_int_equal(CHAT_STATE_COMPOSING, waiting->type);
+
+    chat_state_free(due);
+    chat_state_free(waiting);
+}
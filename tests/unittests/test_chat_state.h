@@ -0,0 +1,5 @@
+void schedules_paused_after_typing(void **state);
+void does_not_schedule_inactive_when_gone_disabled(void **state);
+void reschedules_inactive_when_gone_enabled(void **state);
+void inactive_goes_gone_after_gone_enabled(void **state);
+void idle_skips_chats_not_yet_due(void **state);
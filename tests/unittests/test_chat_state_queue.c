@@ -0,0 +1,97 @@
+#include <stdarg.h>
+#include <string.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "xmpp/stanza.h"
+#include "xmpp/chat_state_queue.h"
+
+#define JID "bob@server.org/laptop"
+#define START (60 * G_TIME_SPAN_MINUTE)
+
+static void
+_expect_sent(const char *const state)
+{
+    expect_string(message_send_chat_state, jid, JID);
+    expect_string(message_send_chat_state, state, state);
+}
+
+void clear_chat_state_queue(void **state)
+{
+    chat_state_queue_clear();
+}
+
+void chat_state_queue_sends_composing_at_once(void **state)
+{
+    _expect_sent(STANZA_NAME_COMPOSING);
+
+    chat_state_queue_push(JID, STANZA_NAME_COMPOSING, START);
+}
+
+void chat_state_queue_holds_back_paused(void **state)
+{
+    _expect_sent(STANZA_NAME_COMPOSING);
+    chat_state_queue_push(JID, STANZA_NAME_COMPOSING, START);
+
+    chat_state_queue_push(JID, STANZA_NAME_PAUSED, START + G_TIME_SPAN_SECOND);
+    chat_state_queue_flush(START + 2 * G_TIME_SPAN_SECOND);
+
+    _expect_sent(STANZA_NAME_PAUSED);
+    chat_state_queue_flush(START + 3 * G_TIME_SPAN_SECOND);
+}
+
+void chat_state_queue_drops_superseded_paused(void **state)
+{
+    _expect_sent(STANZA_NAME_COMPOSING);
+    chat_state_queue_push(JID, STANZA_NAME_COMPOSING, START);
+
+    // typing resumes before paused is due, the contact still sees composing
+    chat_state_queue_push(JID, STANZA_NAME_PAUSED, START + G_TIME_SPAN_SECOND);
+    chat_state_queue_push(JID, STANZA_NAME_COMPOSING, START + 2 * G_TIME_SPAN_SECOND);
+    chat_state_queue_flush(START + 10 * G_TIME_SPAN_SECOND);
+}
+
+void chat_state_queue_drops_state_superseded_by_message(void **state)
+{
+    _expect_sent(STANZA_NAME_COMPOSING);
+    chat_state_queue_push(JID, STANZA_NAME_COMPOSING, START);
+
+    chat_state_queue_push(JID, STANZA_NAME_PAUSED, START + G_TIME_SPAN_SECOND);
+    chat_state_queue_superseded("bob@server.org", STANZA_NAME_ACTIVE);
+    chat_state_queue_flush(START + 10 * G_TIME_SPAN_SECOND);
+
+    // typing after the message is not held back by the interval
+    _expect_sent(STANZA_NAME_COMPOSING);
+    chat_state_queue_push(JID, STANZA_NAME_COMPOSING, START + 10 * G_TIME_SPAN_SECOND);
+}
+
+void chat_state_queue_sends_gone_at_once(void **state)
+{
+    _expect_sent(STANZA_NAME_COMPOSING);
+    chat_state_queue_push(JID, STANZA_NAME_COMPOSING, START);
+
+    _expect_sent(STANZA_NAME_GONE);
+    chat_state_queue_push(JID, STANZA_NAME_GONE, START + 1);
+}
+
+void chat_state_queue_caps_states_per_minute(void **state)
+{
+    gint64 now = START;
+    int i;
+    for (i = 0; i < 10; i++) {
+        const char *chat_state = i % 2 == 0 ? STANZA_NAME_COMPOSING : STANZA_NAME_ACTIVE;
+        _expect_sent(chat_state);
+        chat_state_queue_push(JID, chat_state, now);
+        now += 2 * G_TIME_SPAN_SECOND;
+    }
+
+    // the eleventh state within a minute waits for the next one
+    chat_state_queue_push(JID, STANZA_NAME_COMPOSING, now);
+    chat_state_queue_flush(START + 59 * G_TIME_SPAN_SECOND);
+
+    _expect_sent(STANZA_NAME_COMPOSING);
+    chat_state_queue_flush(START + 60 * G_TIME_SPAN_SECOND);
+}
@@ -0,0 +1,7 @@
+void clear_chat_state_queue(void **state);
+void chat_state_queue_sends_composing_at_once(void **state);
+void chat_state_queue_holds_back_paused(void **state);
+void chat_state_queue_drops_superseded_paused(void **state);
+void chat_state_queue_drops_state_superseded_by_message(void **state);
+void chat_state_queue_sends_gone_at_once(void **state);
+void chat_state_queue_caps_states_per_minute(void **state);
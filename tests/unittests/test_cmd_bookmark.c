@@ -13,6 +13,7 @@
 
 #include "xmpp/muc.h"
 #include "common.h"
+#include "config/preferences.h"
 
 #include "command/cmd_funcs.h"
 
@@ -411,3 +412,40 @@ void cmd_bookmark_remove_uses_supplied_jid_in_room(void **state)
 
     muc_close();
 }
+
+void cmd_bookmark_order_sets_autojoin_order(void **state)
+{
+    gchar *args[] = { "order", "server", NULL };
+    ProfWin window;
+    window.type = WIN_CONSOLE;
+
+    will_return(connection_get_status, JABBER_CONNECTED);
+
+    expect_cons_show("Autojoin rooms in the order stored on the server.");
+
+    gboolean result = cmd_bookmark(&window, CMD_BOOKMARK, args);
+    assert_true(result);
+
+    char *order = prefs_get_string(PREF_BOOKMARK_AUTOJOIN_ORDER);
+    assert_string_equal("server", order);
+    prefs_free_string(order);
+}
+
+void cmd_bookmark_order_shows_usage_when_invalid(void **state)
+{
+    gchar *args[] = { "order", "alphabetical", NULL };
+    ProfWin window;
+    window.type = WIN_CONSOLE;
+
+    will_return(connection_get_status, JABBER_CONNECTED);
+
+    expect_string(cons_bad_cmd_usage, cmd, CMD_BOOKMARK);
+    expect_cons_show("");
+
+    gboolean result = cmd_bookmark(&window, CMD_BOOKMARK, args);
+    assert_true(result);
+
+    char *order = prefs_get_string(PREF_BOOKMARK_AUTOJOIN_ORDER);
+    assert_string_equal("activity", order);
+    prefs_free_string(order);
+}
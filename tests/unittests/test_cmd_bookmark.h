@@ -16,3 +16,5 @@ void cmd_bookmark_add_adds_bookmark_with_jid_autojoin(void **state);
 void cmd_bookmark_add_adds_bookmark_with_jid_nick_autojoin(void **state);
 void cmd_bookmark_remove_removes_bookmark(void **state);
 void cmd_bookmark_remove_shows_message_when_no_bookmark(void **state);
+void cmd_bookmark_order_sets_autojoin_order(void **state);
+void cmd_bookmark_order_shows_usage_when_invalid(void **state);
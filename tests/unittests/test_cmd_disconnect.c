@@ -34,3 +34,23 @@ void clears_chat_sessions(void **state)
     assert_null(session1);
     assert_null(session2);
 }
+
+void cmd_disconnect_cancels_connection_attempt(void **state)
+{
+    will_return(connection_get_status, JABBER_CONNECTING);
+    will_return(session_cancel_connect, TRUE);
+    expect_cons_show("Connection attempt cancelled.");
+
+    gboolean result = cmd_disconnect(NULL, CMD_DISCONNECT, NULL);
+    assert_true(result);
+}
+
+void cmd_disconnect_shows_message_when_not_connected(void **state)
+{
+    will_return(connection_get_status, JABBER_DISCONNECTED);
+    will_return(session_cancel_connect, FALSE);
+    expect_cons_show("You are not currently connected.");
+
+    gboolean result = cmd_disconnect(NULL, CMD_DISCONNECT, NULL);
+    assert_true(result);
+}
@@ -1 +1,3 @@
 void clears_chat_sessions(void **state);
+void cmd_disconnect_cancels_connection_attempt(void **state);
+void cmd_disconnect_shows_message_when_not_connected(void **state);
@@ -0,0 +1,223 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <glib.h>
+
+#include "config.h"
+#include "common.h"
+#include "helpers.h"
+#include "log_compress.h"
+#include "database.h"
+
+#define DATA_DIR "./tests/files/xdg_data_home/profanity"
+#define BOB_LOGS DATA_DIR "/chatlogs/me_at_server.org/bob_at_server.org"
+#define ROOM_LOGS DATA_DIR "/chatlogs/me_at_server.org/rooms/room_at_conference.server.org"
+
+static void
+_remove_tree(const char *const path)
+{
+    GDir *dir = g_dir_open(path, 0, NULL);
+    if (dir) {
+        const gchar *name;
+        while ((name = g_dir_read_name(dir)) != NULL) {
+            char *child = g_strdup_printf("%s/%s", path, name);
+            _remove_tree(child);
+            g_free(child);
+        }
+        g_dir_close(dir);
+        rmdir(path);
+    } else {
+        remove(path);
+    }
+}
+
+void remove_database_dir(void **state)
+{
+    log_database_close();
+    _remove_tree(DATA_DIR "/database");
+    _remove_tree(DATA_DIR "/chatlogs");
+    remove_data_dir(state);
+    rmdir("./tests/files");
+}
+
+static void
+_write_log(const char *const dir, const char *const name, const char *const content)
+{
+    assert_true(mkdir_recursive(dir));
+    char *filename = g_strdup_printf("%s/%s", dir, name);
+    FILE *logp = fopen(filename, "w");
+    assert_non_null(logp);
+    fputs(content, logp);
+    fclose(logp);
+    g_free(filename);
+}
+
+static void
+_write_text_logs(void)
+{
+    _write_log(BOB_LOGS, "2020_01_02.log",
+        "10:00:00 - bob@server.org: hello\n"
+        "10:00:05 - me: hi: bob\n"
+        "10:01:00 - bob@server.org: two\n"
+        "lines\n"
+        "10:02:00 - *me waves\n");
+    _write_log(ROOM_LOGS, "2020_01_02.log",
+        "11:00:00 - alice: hi all\n");
+}
+
+static GDateTime*
+_day(int day)
+{
+    return g_date_time_new_local(2020, 1, day, 0, 0, 0);
+}
+
+static void
+_add_message(const char *const peer, chat_log_direction_t direction, GDateTime *timestamp,
+    const char *const message)
+{
+    log_database_add("me@server.org", peer, NULL, PROF_DB_CHAT, direction, timestamp, NULL,
+        PROF_MSG_ENC_PLAIN, message);
+}
+
+// closing waits for the writer, reopening then reads everything written
+static void
+_reopen(void)
+{
+    log_database_close();
+    assert_true(log_database_init());
+    assert_true(log_database_history_ready());
+}
+
+void database_imports_text_logs_on_first_open(void **state)
+{
+    _write_text_logs();
+    assert_true(log_database_init());
+    _reopen();
+
+    GDateTime *since = _day(1);
+    GSList *history = log_database_get_previous_chat("me@server.org", "bob@server.org", since);
+    g_date_time_unref(since);
+
+    assert_int_equal(4, g_slist_length(history));
+
+    ProfDbMessage *first = g_slist_nth_data(history, 0);
+    assert_int_equal(PROF_IN_LOG, first->direction);
+    assert_string_equal("hello", first->message);
+    assert_int_equal(10, g_date_time_get_hour(first->timestamp));
+
+    ProfDbMessage *second = g_slist_nth_data(history, 1);
+    assert_int_equal(PROF_OUT_LOG, second->direction);
+    assert_string_equal("hi: bob", second->message);
+
+    ProfDbMessage *third = g_slist_nth_data(history, 2);
+    assert_string_equal("two\nlines", third->message);
+
+    ProfDbMessage *fourth = g_slist_nth_data(history, 3);
+    assert_int_equal(PROF_OUT_LOG, fourth->direction);
+    assert_string_equal("/me waves", fourth->message);
+
+    g_slist_free_full(history, (GDestroyNotify)log_database_free_message);
+
+    GSList *room = log_database_search("me@server.org", "room@conference.server.org", "all", 10);
+    assert_int_equal(1, g_slist_length(room));
+    ProfDbMessage *entry = room->data;
+    assert_string_equal("alice", entry->resource);
+    assert_string_equal("hi all", entry->message);
+    g_slist_free_full(room, (GDestroyNotify)log_database_free_message);
+}
+
+void database_imports_text_logs_only_once(void **state)
+{
+    _write_text_logs();
+    assert_true(log_database_init());
+    _reopen();
+    _write_log(BOB_LOGS, "2020_01_03.log", "09:00:00 - bob@server.org: later\n");
+    _reopen();
+
+    GDateTime *since = _day(1);
+    GSList *history = log_database_get_previous_chat("me@server.org", "bob@server.org", since);
+    g_date_time_unref(since);
+
+    assert_int_equal(4, g_slist_length(history));
+    g_slist_free_full(history, (GDestroyNotify)log_database_free_message);
+}
+
+void database_returns_history_since_time(void **state)
+{
+    assert_true(log_database_init());
+
+    GDateTime *day1 = g_date_time_new_local(2020, 1, 1, 12, 0, 0);
+    GDateTime *day2_morning = g_date_time_new_local(2020, 1, 2, 8, 0, 0);
+    GDateTime *day2_evening = g_date_time_new_local(2020, 1, 2, 20, 0, 0);
+    _add_message("bob@server.org", PROF_IN_LOG, day1, "yesterday");
+    _add_message("bob@server.org", PROF_IN_LOG, day2_evening, "evening");
+    _add_message("bob@server.org", PROF_OUT_LOG, day2_morning, "morning");
+    _add_message("carol@server.org", PROF_IN_LOG, day2_morning, "someone else");
+    _reopen();
+
+    GDateTime *since = _day(2);
+    GSList *history = log_database_get_previous_chat("me@server.org", "bob@server.org", since);
+    g_date_time_unref(since);
+
+    assert_int_equal(2, g_slist_length(history));
+    assert_string_equal("morning", ((ProfDbMessage*)g_slist_nth_data(history, 0))->message);
+    assert_string_equal("evening", ((ProfDbMessage*)g_slist_nth_data(history, 1))->message);
+    g_slist_free_full(history, (GDestroyNotify)log_database_free_message);
+
+    g_date_time_unref(day1);
+    g_date_time_unref(day2_morning);
+    g_date_time_unref(day2_evening);
+}
+
+void database_search_matches_text_literally(void **state)
+{
+    assert_true(log_database_init());
+
+    GDateTime *now = g_date_time_new_now_local();
+    _add_message("bob@server.org", PROF_IN_LOG, now, "100% sure");
+    _add_message("bob@server.org", PROF_IN_LOG, now, "100 percent");
+    _add_message("bob@server.org", PROF_IN_LOG, now, "snake_case");
+    _add_message("bob@server.org", PROF_IN_LOG, now, "snakeXcase");
+    _reopen();
+    g_date_time_unref(now);
+
+    GSList *found = log_database_search("me@server.org", "bob@server.org", "100%", 10);
+    assert_int_equal(1, g_slist_length(found));
+    assert_string_equal("100% sure", ((ProfDbMessage*)found->data)->message);
+    g_slist_free_full(found, (GDestroyNotify)log_database_free_message);
+
+    found = log_database_search("me@server.org", "bob@server.org", "e_c", 10);
+    assert_int_equal(1, g_slist_length(found));
+    assert_string_equal("snake_case", ((ProfDbMessage*)found->data)->message);
+    g_slist_free_full(found, (GDestroyNotify)log_database_free_message);
+
+    found = log_database_search("me@server.org", "bob@server.org", "nothing like it", 10);
+    assert_null(found);
+}
+
+#ifdef HAVE_ZSTD
+void database_imports_compressed_text_logs(void **state)
+{
+    _write_log(BOB_LOGS, "2000_01_01.log", "10:00:00 - bob@server.org: from a compressed log\n");
+    log_compress_start(DATA_DIR "/chatlogs", 7);
+    int i;
+    for (i = 0; i < 500 && g_file_test(BOB_LOGS "/2000_01_01.log", G_FILE_TEST_EXISTS); i++) {
+        g_usleep(10 * G_TIME_SPAN_MILLISECOND);
+    }
+    log_compress_stop();
+    assert_true(g_file_test(BOB_LOGS "/2000_01_01.log" LOG_COMPRESS_SUFFIX, G_FILE_TEST_EXISTS));
+
+    assert_true(log_database_init());
+    _reopen();
+
+    GSList *found = log_database_search("me@server.org", "bob@server.org", "compressed", 10);
+    assert_int_equal(1, g_slist_length(found));
+    assert_string_equal("from a compressed log", ((ProfDbMessage*)found->data)->message);
+    g_slist_free_full(found, (GDestroyNotify)log_database_free_message);
+}
+#endif
@@ -0,0 +1,8 @@
+void remove_database_dir(void **state);
+void database_imports_text_logs_on_first_open(void **state);
+void database_imports_text_logs_only_once(void **state);
+void database_returns_history_since_time(void **state);
+void database_search_matches_text_literally(void **state);
+#ifdef HAVE_ZSTD
+void database_imports_compressed_text_logs(void **state);
+#endif
@@ -7,11 +7,6 @@
 
 #include "xmpp/form.h"
 
-xmpp_ctx_t* connection_get_ctx(void)
-{
-    return NULL;
-}
-
 static DataForm*
 _new_form(void)
 {
@@ -212,3 +212,27 @@ void returns_barejid_when_fulljid_not_exists(void **state)
 
     jid_destroy(jid);
 }
+
+void create_same_jid_twice_returns_shared_jid(void **state)
+{
+    Jid *first = jid_create("myuser@mydomain/laptop");
+    Jid *second = jid_create("myuser@mydomain/laptop");
+
+    assert_ptr_equal(first, second);
+
+    jid_destroy(first);
+    jid_destroy(second);
+}
+
+void destroy_shared_jid_keeps_other_reference(void **state)
+{
+    Jid *first = jid_create("myuser@mydomain/desktop");
+    Jid *second = jid_create("myuser@mydomain/desktop");
+
+    jid_destroy(first);
+
+    assert_string_equal("myuser@mydomain", second->barejid);
+    assert_string_equal("desktop", second->resourcepart);
+
+    jid_destroy(second);
+}
@@ -0,0 +1,162 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <glib.h>
+
+#include "config.h"
+#include "common.h"
+#include "log_compress.h"
+
+#define LOGS_DIR "./tests/files/chatlogs"
+#define OLD_LOG LOGS_DIR "/2000_01_01.log"
+
+static void
+_write_file(const char *const filename, const char *const content, size_t len)
+{
+    FILE *logp = fopen(filename, "w");
+    assert_non_null(logp);
+    assert_int_equal(len, fwrite(content, 1, len, logp));
+    fclose(logp);
+}
+
+static char*
+_read_all(FILE *logp, size_t *len)
+{
+    GString *content = g_string_new(NULL);
+    char buf[4096];
+    size_t read;
+    while ((read = fread(buf, 1, sizeof(buf), logp)) > 0) {
+        g_string_append_len(content, buf, read);
+    }
+    *len = content->len;
+
+    return g_string_free(content, FALSE);
+}
+
+// several compression blocks worth of log lines
+static GString*
+_old_log_content(void)
+{
+    GString *content = g_string_new(NULL);
+    int i;
+    for (i = 0; content->len < 400 * 1024; i++) {
+        g_string_append_printf(content, "%02d:%02d:%02d - bob@server.org: message number %d\n",
+            (i / 3600) % 24, (i / 60) % 60, i % 60, i);
+    }
+
+    return content;
+}
+
+void create_log_compress_dir(void **state)
+{
+    assert_true(mkdir_recursive(LOGS_DIR));
+}
+
+void remove_log_compress_dir(void **state)
+{
+    GDir *dir = g_dir_open(LOGS_DIR, 0, NULL);
+    if (dir) {
+        const gchar *name;
+        while ((name = g_dir_read_name(dir)) != NULL) {
+            char *path = g_strdup_printf("%s/%s", LOGS_DIR, name);
+            remove(path);
+            g_free(path);
+        }
+        g_dir_close(dir);
+    }
+    rmdir(LOGS_DIR);
+    rmdir("./tests/files");
+}
+
+void log_compress_open_reads_plain_log(void **state)
+{
+    const char *content = "10:00:00 - bob@server.org: hello\n";
+    _write_file(OLD_LOG, content, strlen(content));
+
+    FILE *logp = log_compress_open(OLD_LOG);
+    assert_non_null(logp);
+    size_t len = 0;
+    char *read = _read_all(logp, &len);
+    fclose(logp);
+
+    assert_string_equal(content, read);
+    g_free(read);
+}
+
+void log_compress_open_returns_null_for_missing_log(void **state)
+{
+    assert_null(log_compress_open(LOGS_DIR "/1999_12_31.log"));
+}
+
+#ifdef HAVE_ZSTD
+// wait for the compactor to replace the plain log with the compressed one
+static void
+_wait_compressed(const char *const filename)
+{
+    gchar *compressed = g_strconcat(filename, LOG_COMPRESS_SUFFIX, NULL);
+    int i;
+    for (i = 0; i < 500; i++) {
+        if (!g_file_test(filename, G_FILE_TEST_EXISTS) && g_file_test(compressed, G_FILE_TEST_EXISTS)) {
+            break;
+        }
+        g_usleep(10 * G_TIME_SPAN_MILLISECOND);
+    }
+    log_compress_stop();
+
+    assert_false(g_file_test(filename, G_FILE_TEST_EXISTS));
+    assert_true(g_file_test(compressed, G_FILE_TEST_EXISTS));
+    g_free(compressed);
+}
+
+void log_compress_reads_back_compressed_log(void **state)
+{
+    GString *content = _old_log_content();
+    _write_file(OLD_LOG, content->str, content->len);
+
+    log_compress_start(LOGS_DIR, 7);
+    _wait_compressed(OLD_LOG);
+
+    FILE *logp = log_compress_open(OLD_LOG);
+    assert_non_null(logp);
+    size_t len = 0;
+    char *read = _read_all(logp, &len);
+    fclose(logp);
+
+    assert_int_equal(content->len, len);
+    assert_memory_equal(content->str, read, len);
+
+    // the decompressed copy does not stay on disk
+    GDir *dir = g_dir_open(LOGS_DIR, 0, NULL);
+    int files = 0;
+    while (g_dir_read_name(dir) != NULL) {
+        files++;
+    }
+    g_dir_close(dir);
+    assert_int_equal(1, files);
+
+    g_free(read);
+    g_string_free(content, TRUE);
+}
+
+void log_compress_keeps_recent_logs(void **state)
+{
+    GDateTime *now = g_date_time_new_now_local();
+    gchar *recent = g_date_time_format(now, LOGS_DIR "/%Y_%m_%d.log");
+    g_date_time_unref(now);
+
+    const char *content = "10:00:00 - bob@server.org: hello\n";
+    _write_file(OLD_LOG, content, strlen(content));
+    _write_file(recent, content, strlen(content));
+
+    log_compress_start(LOGS_DIR, 7);
+    _wait_compressed(OLD_LOG);
+
+    assert_true(g_file_test(recent, G_FILE_TEST_EXISTS));
+    g_free(recent);
+}
+#endif
@@ -0,0 +1,8 @@
+void create_log_compress_dir(void **state);
+void remove_log_compress_dir(void **state);
+void log_compress_open_reads_plain_log(void **state);
+void log_compress_open_returns_null_for_missing_log(void **state);
+#ifdef HAVE_ZSTD
+void log_compress_reads_back_compressed_log(void **state);
+void log_compress_keeps_recent_logs(void **state);
+#endif
@@ -0,0 +1,66 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "tools/memory.h"
+
+void memory_add_counts_bytes_and_objects(void **state)
+{
+    gint64 bytes = memory_bytes(MEMORY_CAPS);
+    gint64 objects = memory_objects(MEMORY_CAPS);
+
+    memory_add(MEMORY_CAPS, 100, 2);
+
+    assert_int_equal(bytes + 100, memory_bytes(MEMORY_CAPS));
+    assert_int_equal(objects + 2, memory_objects(MEMORY_CAPS));
+
+    memory_add(MEMORY_CAPS, -100, -2);
+
+    assert_int_equal(bytes, memory_bytes(MEMORY_CAPS));
+    assert_int_equal(objects, memory_objects(MEMORY_CAPS));
+}
+
+void memory_total_sums_all_subsystems(void **state)
+{
+    gint64 total = memory_total();
+
+    memory_add(MEMORY_ROSTER, 100, 1);
+    memory_add(MEMORY_PADS, 50, 1);
+
+    assert_int_equal(total + 150, memory_total());
+
+    memory_add(MEMORY_ROSTER, -100, -1);
+    memory_add(MEMORY_PADS, -50, -1);
+
+    assert_int_equal(total, memory_total());
+}
+
+void memory_format_bytes_picks_unit(void **state)
+{
+    char *b = memory_format_bytes(512);
+    char *kb = memory_format_bytes(1536);
+    char *mb = memory_format_bytes(2 * 1024 * 1024);
+
+    assert_string_equal("512 B", b);
+    assert_string_equal("1.5 KB", kb);
+    assert_string_equal("2.0 MB", mb);
+
+    g_free(b);
+    g_free(kb);
+    g_free(mb);
+}
+
+void memory_summary_lists_subsystems_and_total(void **state)
+{
+    char *summary = memory_summary();
+
+    assert_non_null(strstr(summary, "buffers "));
+    assert_non_null(strstr(summary, "omemo "));
+    assert_non_null(strstr(summary, "total "));
+
+    g_free(summary);
+}
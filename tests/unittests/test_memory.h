@@ -0,0 +1,4 @@
+void memory_add_counts_bytes_and_objects(void **state);
+void memory_total_sums_all_subsystems(void **state);
+void memory_format_bytes_picks_unit(void **state);
+void memory_summary_lists_subsystems_and_total(void **state);
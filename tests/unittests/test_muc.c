@@ -4,6 +4,7 @@
 #include <cmocka.h>
 #include <stdlib.h>
 
+#include "tools/memory.h"
 #include "xmpp/muc.h"
 
 void muc_before_test(void **state)
@@ -76,3 +77,32 @@ void test_muc_active(void **state)
 
     assert_true(room_is_active);
 }
+
+void test_muc_memory_counts_room_and_occupants(void **state)
+{
+    char *room = "room@server.org";
+    gint64 objects = memory_objects(MEMORY_MUC);
+    gint64 bytes = memory_bytes(MEMORY_MUC);
+
+    muc_join(room, "bob", NULL, FALSE);
+    muc_roster_add(room, "alice", "alice@server.org", "participant", "member", NULL, NULL);
+    muc_roster_add(room, "carol", NULL, "participant", "none", "away", "busy");
+
+    assert_int_equal(objects + 3, memory_objects(MEMORY_MUC));
+    assert_true(memory_bytes(MEMORY_MUC) > bytes);
+}
+
+void test_muc_memory_released_on_leave(void **state)
+{
+    char *room = "room@server.org";
+    gint64 objects = memory_objects(MEMORY_MUC);
+    gint64 bytes = memory_bytes(MEMORY_MUC);
+
+    muc_join(room, "bob", NULL, FALSE);
+    muc_roster_add(room, "alice", "alice@server.org", "participant", "member", NULL, NULL);
+    muc_roster_add(room, "alice", "alice@server.org", "moderator", "member", "away", "busy");
+    muc_leave(room);
+
+    assert_int_equal(objects, memory_objects(MEMORY_MUC));
+    assert_int_equal(bytes, memory_bytes(MEMORY_MUC));
+}
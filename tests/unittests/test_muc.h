@@ -7,3 +7,5 @@ void test_muc_invites_count_0(void **state);
 void test_muc_invites_count_5(void **state);
 void test_muc_room_is_not_active(void **state);
 void test_muc_active(void **state);
+void test_muc_memory_counts_room_and_occupants(void **state);
+void test_muc_memory_released_on_leave(void **state);
@@ -0,0 +1,145 @@
+#include <stdarg.h>
+#include <string.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "xmpp/xmpp.h"
+#include "xmpp/outbound.h"
+
+void clear_outbound(void **state)
+{
+    outbound_clear();
+}
+
+void outbound_sends_normal_stanza_at_once(void **state)
+{
+    will_return(connection_get_status, JABBER_CONNECTED);
+    expect_string(connection_send_stanza, stanza, "<presence/>");
+
+    outbound_send(OUTBOUND_NORMAL, "<presence/>");
+}
+
+void outbound_drops_normal_stanza_when_offline(void **state)
+{
+    will_return(connection_get_status, JABBER_DISCONNECTED);
+    outbound_send(OUTBOUND_NORMAL, "<presence/>");
+
+    outbound_connected();
+}
+
+void outbound_sends_offline_messages_on_connect(void **state)
+{
+    will_return(connection_get_status, JABBER_DISCONNECTED);
+    outbound_send(OUTBOUND_MESSAGE, "<message id='1'/>");
+    will_return(connection_get_status, JABBER_DISCONNECTED);
+    outbound_send(OUTBOUND_MESSAGE, "<message id='2'/>");
+
+    expect_string(connection_send_stanza, stanza, "<message id='1'/>");
+    expect_string(connection_send_stanza, stanza, "<message id='2'/>");
+    outbound_connected();
+}
+
+void outbound_drops_oldest_offline_message_when_full(void **state)
+{
+    int i;
+    for (i = 0; i <= 200; i++) {
+        char *text = g_strdup_printf("<message id='%d'/>", i);
+        will_return(connection_get_status, JABBER_DISCONNECTED);
+        outbound_send(OUTBOUND_MESSAGE, text);
+        g_free(text);
+    }
+
+    for (i = 1; i <= 200; i++) {
+        char *text = g_strdup_printf("<message id='%d'/>", i);
+        expect_string(connection_send_stanza, stanza, text);
+        g_free(text);
+    }
+    outbound_connected();
+}
+
+void outbound_paces_bulk_stanzas_after_burst(void **state)
+{
+    int i;
+    for (i = 0; i < 12; i++) {
+        char *text = g_strdup_printf("<presence id='%d'/>", i);
+        will_return(connection_get_status, JABBER_CONNECTED);
+        will_return(connection_get_status, JABBER_CONNECTED);
+        if (i < 10) {
+            expect_string(connection_send_stanza, stanza, text);
+        }
+        outbound_send(OUTBOUND_BULK, text);
+        g_free(text);
+    }
+}
+
+void outbound_sends_normal_stanza_before_queued_bulk(void **state)
+{
+    int i;
+    for (i = 0; i < 11; i++) {
+        will_return(connection_get_status, JABBER_CONNECTED);
+        will_return(connection_get_status, JABBER_CONNECTED);
+        if (i < 10) {
+            expect_string(connection_send_stanza, stanza, "<presence type='bulk'/>");
+        }
+        outbound_send(OUTBOUND_BULK, "<presence type='bulk'/>");
+    }
+
+    will_return(connection_get_status, JABBER_CONNECTED);
+    expect_string(connection_send_stanza, stanza, "<presence/>");
+    outbound_send(OUTBOUND_NORMAL, "<presence/>");
+}
+
+void outbound_sends_queued_bulk_for_same_jid_first(void **state)
+{
+    int i;
+    for (i = 0; i < 10; i++) {
+        will_return(connection_get_status, JABBER_CONNECTED);
+        will_return(connection_get_status, JABBER_CONNECTED);
+        expect_string(connection_send_stanza, stanza, "<presence/>");
+        outbound_send(OUTBOUND_BULK, "<presence/>");
+    }
+    will_return(connection_get_status, JABBER_CONNECTED);
+    will_return(connection_get_status, JABBER_CONNECTED);
+    outbound_send_to(OUTBOUND_BULK, "room@conference.org", "<presence id='join'/>");
+    will_return(connection_get_status, JABBER_CONNECTED);
+    will_return(connection_get_status, JABBER_CONNECTED);
+    outbound_send_to(OUTBOUND_BULK, "other@conference.org", "<presence id='other'/>");
+
+    will_return(connection_get_status, JABBER_CONNECTED);
+    expect_string(connection_send_stanza, stanza, "<presence id='join'/>");
+    expect_string(connection_send_stanza, stanza, "<presence id='leave'/>");
+    outbound_send_to(OUTBOUND_NORMAL, "room@conference.org", "<presence id='leave'/>");
+}
+
+void outbound_lost_connection_drops_bulk_keeps_messages(void **state)
+{
+    int i;
+    for (i = 0; i < 11; i++) {
+        will_return(connection_get_status, JABBER_CONNECTED);
+        will_return(connection_get_status, JABBER_CONNECTED);
+        if (i < 10) {
+            expect_string(connection_send_stanza, stanza, "<presence/>");
+        }
+        outbound_send(OUTBOUND_BULK, "<presence/>");
+    }
+    will_return(connection_get_status, JABBER_DISCONNECTED);
+    outbound_send(OUTBOUND_MESSAGE, "<message/>");
+
+    outbound_lost_connection();
+    outbound_flush();
+
+    expect_string(connection_send_stanza, stanza, "<message/>");
+    outbound_connected();
+}
+
+void outbound_clear_drops_offline_messages(void **state)
+{
+    will_return(connection_get_status, JABBER_DISCONNECTED);
+    outbound_send(OUTBOUND_MESSAGE, "<message/>");
+
+    outbound_clear();
+    outbound_connected();
+}
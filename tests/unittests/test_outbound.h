@@ -0,0 +1,10 @@
+void clear_outbound(void **state);
+void outbound_sends_normal_stanza_at_once(void **state);
+void outbound_drops_normal_stanza_when_offline(void **state);
+void outbound_sends_offline_messages_on_connect(void **state);
+void outbound_drops_oldest_offline_message_when_full(void **state);
+void outbound_paces_bulk_stanzas_after_burst(void **state);
+void outbound_sends_normal_stanza_before_queued_bulk(void **state);
+void outbound_sends_queued_bulk_for_same_jid_first(void **state);
+void outbound_lost_connection_drops_bulk_keeps_messages(void **state);
+void outbound_clear_drops_offline_messages(void **state);
@@ -672,3 +672,43 @@ parse_options_with_duplicated_option_sets_error(void **state)
 
     options_destroy(options);
 }
+
+void
+parse_tokens_returns_ranges_of_input(void **state)
+{
+    char *inp = "  /cmd \"quoted arg\" last ";
+    ParserToken tokens[3];
+    int num = parse_tokens(inp, 0, tokens, 3);
+
+    assert_int_equal(3, num);
+    assert_int_equal(2, tokens[0].start);
+    assert_int_equal(4, tokens[0].len);
+    assert_int_equal(8, tokens[1].start);
+    assert_int_equal(10, tokens[1].len);
+    assert_int_equal(20, tokens[2].start);
+    assert_int_equal(4, tokens[2].len);
+}
+
+void
+parse_tokens_counts_tokens_past_max(void **state)
+{
+    char *inp = "/cmd one two three";
+    ParserToken tokens[2];
+    int num = parse_tokens(inp, 0, tokens, 2);
+
+    assert_int_equal(4, num);
+    assert_int_equal(5, tokens[1].start);
+    assert_int_equal(3, tokens[1].len);
+}
+
+void
+parse_tokens_with_freetext_keeps_rest_of_line(void **state)
+{
+    char *inp = "/msg bob hello there";
+    ParserToken tokens[3];
+    int num = parse_tokens(inp, 3, tokens, 3);
+
+    assert_int_equal(3, num);
+    assert_int_equal(9, tokens[2].start);
+    assert_int_equal(11, tokens[2].len);
+}
@@ -48,3 +48,6 @@ void parse_options_when_opt3_no_val_sets_error(void **state);
 void parse_options_when_three_returns_map(void **state);
 void parse_options_when_unknown_opt_sets_error(void **state);
 void parse_options_with_duplicated_option_sets_error(void **state);
+void parse_tokens_returns_ranges_of_input(void **state);
+void parse_tokens_counts_tokens_past_max(void **state);
+void parse_tokens_with_freetext_keeps_rest_of_line(void **state);
@@ -0,0 +1,74 @@
+#include <stdarg.h>
+#include <string.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "xmpp/xmpp.h"
+#include "xmpp/recorder.h"
+
+#define RECORDING_DIR "./tests/files"
+#define RECORDING RECORDING_DIR "/recording"
+
+static void
+_record_session(void)
+{
+    assert_true(mkdir_recursive(RECORDING_DIR));
+    assert_true(recorder_record_start(RECORDING));
+    recorder_record("SENT: <message id=\"out1\" to=\"bob@server.org\"><body>hello</body></message>");
+    recorder_record("RECV: <message id=\"in1\" from=\"bob@server.org\"><body>first line\nsecond \"line\"</body></message>");
+    recorder_record("conn: TLS connection established");
+    recorder_record("RECV: <presence id=\"pres1\" from=\"bob@server.org/laptop\"/>");
+    recorder_record("SENT: <iq id=\"iq0\" type=\"get\" to=\"server.org\"/>");
+    recorder_record("RECV: <iq id=\"iq1\" type=\"result\" from=\"server.org\"/>");
+    recorder_close();
+}
+
+static void
+_remove_recording(void)
+{
+    remove(RECORDING);
+    rmdir(RECORDING_DIR);
+}
+
+void recorder_replays_received_stanzas(void **state)
+{
+    _record_session();
+    assert_true(recorder_replay_start(RECORDING, 0));
+
+    will_return(connection_get_status, JABBER_CONNECTED);
+    expect_string(message_handle_stanza, id, "in1");
+    expect_string(message_handle_stanza, body, "first line\nsecond \"line\"");
+    expect_string(presence_handle_stanza, id, "pres1");
+    expect_string(iq_handle_stanza, id, "iq1");
+    recorder_replay_process();
+
+    // the next call reaches the end of the recording and finishes the replay
+    will_return(connection_get_status, JABBER_CONNECTED);
+    recorder_replay_process();
+    recorder_replay_process();
+
+    recorder_close();
+    _remove_recording();
+}
+
+void recorder_does_not_replay_before_connected(void **state)
+{
+    _record_session();
+    assert_true(recorder_replay_start(RECORDING, 0));
+
+    will_return(connection_get_status, JABBER_CONNECTING);
+    recorder_replay_process();
+
+    recorder_close();
+    _remove_recording();
+}
+
+void recorder_fails_to_replay_missing_file(void **state)
+{
+    assert_false(recorder_replay_start(RECORDING_DIR "/no_such_recording", 0));
+}
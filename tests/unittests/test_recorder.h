@@ -0,0 +1,3 @@
+void recorder_replays_received_stanzas(void **state);
+void recorder_does_not_replay_before_connected(void **state);
+void recorder_fails_to_replay_missing_file(void **state);
@@ -0,0 +1,150 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+
+#include "helpers.h"
+#include "xmpp/room_directory.h"
+
+#define DATA_DIR "./tests/files/xdg_data_home"
+
+static RoomDirectory*
+_create_directory(void)
+{
+    RoomDirectory *directory = room_directory_new("conference.server");
+    room_directory_add(directory, "chatroom@conference.server", "A chat room");
+    room_directory_add(directory, "hangout@conference.server", "Another Chat Room");
+    room_directory_add(directory, "dev@conference.server", NULL);
+
+    return directory;
+}
+
+void room_directory_ignores_duplicates(void **state)
+{
+    RoomDirectory *directory = _create_directory();
+    room_directory_add(directory, "dev@conference.server", "Development");
+
+    assert_int_equal(3, room_directory_size(directory));
+
+    room_directory_free(directory);
+}
+
+void room_directory_ignores_jids_without_localpart(void **state)
+{
+    RoomDirectory *directory = _create_directory();
+    room_directory_add(directory, "conference.server", NULL);
+    room_directory_add(directory, NULL, "No jid");
+
+    assert_int_equal(3, room_directory_size(directory));
+
+    room_directory_free(directory);
+}
+
+void room_directory_search_without_filter_returns_all(void **state)
+{
+    RoomDirectory *directory = _create_directory();
+
+    GSList *result = room_directory_search(directory, NULL);
+
+    assert_int_equal(3, g_slist_length(result));
+    assert_string_equal("chatroom@conference.server", ((RoomDirectoryEntry*)result->data)->jid);
+
+    g_slist_free(result);
+    room_directory_free(directory);
+}
+
+void room_directory_search_matches_name_case_insensitive(void **state)
+{
+    RoomDirectory *directory = _create_directory();
+
+    GSList *result = room_directory_search(directory, "CHAT ROOM");
+
+    assert_int_equal(2, g_slist_length(result));
+    assert_string_equal("chatroom@conference.server", ((RoomDirectoryEntry*)result->data)->jid);
+    assert_string_equal("hangout@conference.server", ((RoomDirectoryEntry*)result->next->data)->jid);
+
+    g_slist_free(result);
+    room_directory_free(directory);
+}
+
+void room_directory_search_matches_short_filter(void **state)
+{
+    RoomDirectory *directory = _create_directory();
+
+    GSList *result = room_directory_search(directory, "de");
+
+    assert_int_equal(1, g_slist_length(result));
+    assert_string_equal("dev@conference.server", ((RoomDirectoryEntry*)result->data)->jid);
+
+    g_slist_free(result);
+    room_directory_free(directory);
+}
+
+void room_directory_search_does_not_match_domain(void **state)
+{
+    RoomDirectory *directory = _create_directory();
+
+    GSList *result = room_directory_search(directory, "conference");
+
+    assert_null(result);
+
+    room_directory_free(directory);
+}
+
+void room_directory_search_after_add_finds_new_room(void **state)
+{
+    RoomDirectory *directory = _create_directory();
+
+    GSList *result = room_directory_search(directory, "music");
+    assert_null(result);
+
+    room_directory_add(directory, "music@conference.server", NULL);
+    result = room_directory_search(directory, "music");
+
+    assert_int_equal(1, g_slist_length(result));
+
+    g_slist_free(result);
+    room_directory_free(directory);
+}
+
+void remove_room_directory_dir(void **state)
+{
+    room_directory_clear();
+    room_directory_close();
+    rmdir(DATA_DIR "/profanity/rooms");
+    remove_data_dir(state);
+    rmdir("./tests/files");
+}
+
+void room_directory_store_escapes_service(void **state)
+{
+    RoomDirectory *directory = room_directory_new("../../escape");
+    room_directory_add(directory, "chatroom@conference.server", "A chat room");
+    room_directory_store(directory);
+
+    assert_int_equal(-1, access(DATA_DIR "/escape", F_OK));
+
+    room_directory_close();
+    RoomDirectory *loaded = room_directory_get("../../escape");
+
+    assert_non_null(loaded);
+    assert_string_equal("../../escape", room_directory_service(loaded));
+    assert_int_equal(1, room_directory_size(loaded));
+}
+
+void room_directory_find_loads_escaped_services(void **state)
+{
+    RoomDirectory *directory = room_directory_new("conference/server");
+    room_directory_add(directory, "chatroom@conference.server", NULL);
+    room_directory_store(directory);
+    room_directory_close();
+
+    char *found = room_directory_find("chat", FALSE);
+
+    assert_string_equal("chatroom@conference.server", found);
+    free(found);
+}
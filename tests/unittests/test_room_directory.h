@@ -0,0 +1,10 @@
+void room_directory_ignores_duplicates(void **state);
+void room_directory_ignores_jids_without_localpart(void **state);
+void room_directory_search_without_filter_returns_all(void **state);
+void room_directory_search_matches_name_case_insensitive(void **state);
+void room_directory_search_matches_short_filter(void **state);
+void room_directory_search_does_not_match_domain(void **state);
+void room_directory_search_after_add_finds_new_room(void **state);
+void remove_room_directory_dir(void **state);
+void room_directory_store_escapes_service(void **state);
+void room_directory_find_loads_escaped_services(void **state);
@@ -0,0 +1,88 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "ui/win_types.h"
+#include "ui/window_list.h"
+#include "xmpp/roster_list.h"
+
+static ProfWin*
+_create_window(win_type_t type, gint64 last_shown)
+{
+    ProfChatWin *chatwin = calloc(1, sizeof(ProfChatWin));
+    chatwin->window.type = type;
+    chatwin->window.layout = calloc(1, sizeof(ProfLayout));
+    chatwin->window.layout->last_shown = last_shown;
+
+    return &chatwin->window;
+}
+
+static ProfWin*
+_new_chat(const char *const barejid, gint64 last_shown)
+{
+    ProfWin *window = _create_window(WIN_CHAT, last_shown);
+    will_return(win_create_chat, window);
+    wins_new_chat(barejid);
+
+    return window;
+}
+
+static void
+_free_window(ProfWin *window)
+{
+    free(window->layout);
+    free(window);
+}
+
+void init_window_list(void **state)
+{
+    roster_create();
+}
+
+void close_window_list(void **state)
+{
+    wins_destroy();
+    roster_destroy();
+}
+
+void wins_trim_trims_least_recently_shown_first(void **state)
+{
+    // the console is current, so it is skipped although shown least recently
+    ProfWin *console = _create_window(WIN_CONSOLE, 0);
+    will_return(win_create_console, console);
+    wins_init();
+    ProfWin *recent = _new_chat("recent@server.org", 300);
+    ProfWin *oldest = _new_chat("oldest@server.org", 100);
+    ProfWin *older = _new_chat("older@server.org", 200);
+
+    expect_value(win_trim, window, oldest);
+    will_return(win_trim, TRUE);
+    expect_value(win_trim, window, older);
+    will_return(win_trim, TRUE);
+    expect_value(win_trim, window, recent);
+    will_return(win_trim, FALSE);
+
+    assert_int_equal(2, wins_trim(-1));
+
+    _free_window(console);
+    _free_window(recent);
+    _free_window(oldest);
+    _free_window(older);
+}
+
+void wins_trim_does_nothing_within_budget(void **state)
+{
+    ProfWin *console = _create_window(WIN_CONSOLE, 0);
+    will_return(win_create_console, console);
+    wins_init();
+    ProfWin *chat = _new_chat("bob@server.org", 100);
+
+    assert_int_equal(0, wins_trim(G_MAXINT));
+
+    _free_window(console);
+    _free_window(chat);
+}
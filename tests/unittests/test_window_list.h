@@ -0,0 +1,4 @@
+void init_window_list(void **state);
+void close_window_list(void **state);
+void wins_trim_trims_least_recently_shown_first(void **state);
+void wins_trim_does_nothing_within_budget(void **state);
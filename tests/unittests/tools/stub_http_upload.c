@@ -1,8 +1,8 @@
 #ifndef TOOLS_HTTP_UPLOAD_H
 #define TOOLS_HTTP_UPLOAD_H
 
+#include <stdio.h>
 #include <curl/curl.h>
-#include <pthread.h>
 
 // forward -> ui/win_types.h
 typedef struct prof_win_t ProfWin;
@@ -15,13 +15,13 @@ typedef struct http_upload_t {
     char *get_url;
     char *put_url;
     ProfWin *window;
-    pthread_t worker;
+    FILE *fd;
     int cancel;
 } HTTPUpload;
 
 //GSList *upload_processes;
 
-void* http_file_put(void *userdata) { return NULL; }
+void http_file_put(HTTPUpload *upload) {}
 
 char* file_mime_type(const char* const file_name) { return NULL; }
 off_t file_size(const char* const file_name) { return 0; }
@@ -142,6 +142,18 @@ char *ui_get_line(void)
 }
 
 void xmlwin_show(ProfXMLWin *xmlwin, const char * const msg) {}
+void xmlwin_update(ProfXMLWin *xmlwin) {}
+gboolean xmlwin_set_filter(ProfXMLWin *xmlwin, const char *const filter, const char *const value)
+{
+    return TRUE;
+}
+void xmlwin_clear_filters(ProfXMLWin *xmlwin) {}
+void xmlwin_show_filters(ProfXMLWin *xmlwin) {}
+gboolean xmlwin_save(ProfXMLWin *xmlwin, const char *const path, int *count)
+{
+    return TRUE;
+}
+void xmlwin_clear_capture(ProfXMLWin *xmlwin) {}
 
 // ui events
 void ui_contact_online(char *barejid, Resource *resource, GDateTime *last_activity)
@@ -296,6 +308,8 @@ char* inp_readline(void)
 }
 
 void inp_nonblocking(gboolean reset) {}
+void inp_suspend(void) {}
+void inp_resume(void) {}
 
 void ui_inp_history_append(char *inp) {}
 
@@ -334,6 +348,7 @@ void cons_show_ui_prefs(void) {}
 void cons_show_desktop_prefs(void) {}
 void cons_show_chat_prefs(void) {}
 void cons_show_log_prefs(void) {}
+void cons_show_memory(void) {}
 void cons_show_presence_prefs(void) {}
 void cons_show_connection_prefs(void) {}
 void cons_show_otr_prefs(void) {}
@@ -442,6 +457,7 @@ void cons_carbons_setting(void) {}
 void cons_receipts_setting(void) {}
 void cons_log_setting(void) {}
 void cons_logging_setting(void) {}
+void cons_memory_setting(void) {}
 void cons_autoaway_setting(void) {}
 void cons_reconnect_setting(void) {}
 void cons_autoping_setting(void) {}
@@ -516,6 +532,12 @@ char* win_get_tab_identifier(ProfWin *window)
 }
 
 void win_update_virtual(ProfWin *window) {}
+void win_pad_acquire(ProfWin *window) {}
+gboolean win_trim(ProfWin *window)
+{
+    check_expected(window);
+    return mock_type(gboolean);
+}
 void win_free(ProfWin *window) {}
 gboolean win_notify_remind(ProfWin *window)
 {
@@ -541,6 +563,8 @@ void win_println(ProfWin *window, theme_item_t theme, const char ch, const char
     va_end(args);
 }
 
+void win_println_lines(ProfWin *window, theme_item_t theme, const char ch, char **lines) {}
+
 void win_print(ProfWin *window, theme_item_t theme_item, const char ch, const char *const message, ...) {}
 void win_appendln(ProfWin *window, theme_item_t theme_item, const char *const message, ...) {}
 
@@ -15,6 +15,11 @@
 #include "helpers.h"
 #include "test_autocomplete.h"
 #include "test_chat_session.h"
+#include "test_chat_state.h"
+#include "test_chat_state_queue.h"
+#include "test_memory.h"
+#include "test_window_list.h"
+#include "test_outbound.h"
 #include "test_common.h"
 #include "test_contact.h"
 #include "test_cmd_connect.h"
@@ -33,9 +38,14 @@
 #include "test_cmd_bookmark.h"
 #include "test_cmd_join.h"
 #include "test_muc.h"
+#include "test_room_directory.h"
 #include "test_cmd_roster.h"
 #include "test_cmd_disconnect.h"
 #include "test_form.h"
+#include "test_recorder.h"
+#include "test_buffer.h"
+#include "test_database.h"
+#include "test_log_compress.h"
 #include "test_callbacks.h"
 #include "test_plugins_disco.h"
 
@@ -105,6 +115,8 @@ int main(int argc, char* argv[]) {
         unit_test(complete_both_with_base),
         unit_test(complete_ignores_case),
         unit_test(complete_previous),
+        unit_test(plugin_autocompleter_completes_subcommand_key),
+        unit_test(plugin_autocompleter_ignores_other_commands),
 
         unit_test(create_jid_from_null_returns_null),
         unit_test(create_jid_from_empty_string_returns_null),
@@ -131,6 +143,8 @@ int main(int argc, char* argv[]) {
         unit_test(create_full_with_trailing_slash),
         unit_test(returns_fulljid_when_exists),
         unit_test(returns_barejid_when_fulljid_not_exists),
+        unit_test(create_same_jid_twice_returns_shared_jid),
+        unit_test(destroy_shared_jid_keeps_other_reference),
 
         unit_test(parse_null_returns_null),
         unit_test(parse_empty_returns_null),
@@ -182,6 +196,9 @@ int main(int argc, char* argv[]) {
         unit_test(parse_options_when_three_returns_map),
         unit_test(parse_options_when_unknown_opt_sets_error),
         unit_test(parse_options_with_duplicated_option_sets_error),
+        unit_test(parse_tokens_returns_ranges_of_input),
+        unit_test(parse_tokens_counts_tokens_past_max),
+        unit_test(parse_tokens_with_freetext_keeps_rest_of_line),
 
         unit_test(empty_list_when_none_added),
         unit_test(contains_one_element),
@@ -228,6 +245,68 @@ int main(int argc, char* argv[]) {
         unit_test_setup_teardown(removes_chat_session,
             init_chat_sessions,
             close_chat_sessions),
+        unit_test_setup_teardown(schedules_paused_after_typing,
+            init_chat_sessions,
+            close_chat_sessions),
+        unit_test_setup_teardown(does_not_schedule_inactive_when_gone_disabled,
+            init_chat_sessions,
+            close_chat_sessions),
+        unit_test_setup_teardown(reschedules_inactive_when_gone_enabled,
+            init_chat_sessions,
+            close_chat_sessions),
+        unit_test_setup_teardown(inactive_goes_gone_after_gone_enabled,
+            init_chat_sessions,
+            close_chat_sessions),
+        unit_test_setup_teardown(idle_skips_chats_not_yet_due,
+            init_chat_sessions,
+            close_chat_sessions),
+
+        unit_test_setup_teardown(chat_state_queue_sends_composing_at_once,
+            clear_chat_state_queue,
+            clear_chat_state_queue),
+        unit_test_setup_teardown(chat_state_queue_holds_back_paused,
+            clear_chat_state_queue,
+            clear_chat_state_queue),
+        unit_test_setup_teardown(chat_state_queue_drops_superseded_paused,
+            clear_chat_state_queue,
+            clear_chat_state_queue),
+        unit_test_setup_teardown(chat_state_queue_drops_state_superseded_by_message,
+            clear_chat_state_queue,
+            clear_chat_state_queue),
+        unit_test_setup_teardown(chat_state_queue_sends_gone_at_once,
+            clear_chat_state_queue,
+            clear_chat_state_queue),
+        unit_test_setup_teardown(chat_state_queue_caps_states_per_minute,
+            clear_chat_state_queue,
+            clear_chat_state_queue),
+
+        unit_test_setup_teardown(outbound_sends_normal_stanza_at_once,
+            clear_outbound,
+            clear_outbound),
+        unit_test_setup_teardown(outbound_drops_normal_stanza_when_offline,
+            clear_outbound,
+            clear_outbound),
+        unit_test_setup_teardown(outbound_sends_offline_messages_on_connect,
+            clear_outbound,
+            clear_outbound),
+        unit_test_setup_teardown(outbound_drops_oldest_offline_message_when_full,
+            clear_outbound,
+            clear_outbound),
+        unit_test_setup_teardown(outbound_paces_bulk_stanzas_after_burst,
+            clear_outbound,
+            clear_outbound),
+        unit_test_setup_teardown(outbound_sends_normal_stanza_before_queued_bulk,
+            clear_outbound,
+            clear_outbound),
+        unit_test_setup_teardown(outbound_sends_queued_bulk_for_same_jid_first,
+            clear_outbound,
+            clear_outbound),
+        unit_test_setup_teardown(outbound_lost_connection_drops_bulk_keeps_messages,
+            clear_outbound,
+            clear_outbound),
+        unit_test_setup_teardown(outbound_clear_drops_offline_messages,
+            clear_outbound,
+            clear_outbound),
 
         unit_test_setup_teardown(cmd_connect_shows_message_when_disconnecting,
             load_preferences,
@@ -481,6 +560,22 @@ int main(int argc, char* argv[]) {
         unit_test_setup_teardown(test_muc_invites_count_5, muc_before_test, muc_after_test),
         unit_test_setup_teardown(test_muc_room_is_not_active, muc_before_test, muc_after_test),
         unit_test_setup_teardown(test_muc_active, muc_before_test, muc_after_test),
+        unit_test_setup_teardown(test_muc_memory_counts_room_and_occupants, muc_before_test, muc_after_test),
+        unit_test_setup_teardown(test_muc_memory_released_on_leave, muc_before_test, muc_after_test),
+
+        unit_test(room_directory_ignores_duplicates),
+        unit_test(room_directory_ignores_jids_without_localpart),
+        unit_test(room_directory_search_without_filter_returns_all),
+        unit_test(room_directory_search_matches_name_case_insensitive),
+        unit_test(room_directory_search_matches_short_filter),
+        unit_test(room_directory_search_does_not_match_domain),
+        unit_test(room_directory_search_after_add_finds_new_room),
+        unit_test_setup_teardown(room_directory_store_escapes_service,
+            create_data_dir,
+            remove_room_directory_dir),
+        unit_test_setup_teardown(room_directory_find_loads_escaped_services,
+            create_data_dir,
+            remove_room_directory_dir),
 
         unit_test(cmd_bookmark_shows_message_when_disconnected),
         unit_test(cmd_bookmark_shows_message_when_disconnecting),
@@ -499,6 +594,12 @@ int main(int argc, char* argv[]) {
         unit_test(cmd_bookmark_add_adds_bookmark_with_jid_nick_autojoin),
         unit_test(cmd_bookmark_remove_removes_bookmark),
         unit_test(cmd_bookmark_remove_shows_message_when_no_bookmark),
+        unit_test_setup_teardown(cmd_bookmark_order_sets_autojoin_order,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(cmd_bookmark_order_shows_usage_when_invalid,
+            load_preferences,
+            close_preferences),
 
 #ifdef HAVE_LIBOTR
         unit_test(cmd_otr_log_shows_usage_when_no_args),
@@ -610,12 +711,16 @@ int main(int argc, char* argv[]) {
         unit_test_setup_teardown(clears_chat_sessions,
             load_preferences,
             close_preferences),
+        unit_test(cmd_disconnect_cancels_connection_attempt),
+        unit_test(cmd_disconnect_shows_message_when_not_connected),
 
         unit_test(prof_partial_occurrences_tests),
         unit_test(prof_whole_occurrences_tests),
 
         unit_test(returns_no_commands),
         unit_test(returns_commands),
+        unit_test(delivers_queued_events_in_one_batch),
+        unit_test(holds_events_until_interval_elapsed),
 
         unit_test(returns_empty_list_when_none),
         unit_test(returns_added_feature),
@@ -624,6 +729,81 @@ int main(int argc, char* argv[]) {
         unit_test(does_not_add_duplicate_feature),
         unit_test(removes_plugin_features),
         unit_test(does_not_remove_feature_when_more_than_one_reference),
+
+        unit_test(recorder_replays_received_stanzas),
+        unit_test(recorder_does_not_replay_before_connected),
+        unit_test(recorder_fails_to_replay_missing_file),
+
+        unit_test_setup_teardown(buffer_drops_oldest_entry_when_spill_disabled,
+            create_data_dir,
+            remove_scrollback_dir),
+        unit_test_setup_teardown(buffer_spills_oldest_entry_when_full,
+            create_data_dir,
+            remove_scrollback_dir),
+        unit_test_setup_teardown(buffer_reads_back_spilled_entries,
+            create_data_dir,
+            remove_scrollback_dir),
+        unit_test_setup_teardown(buffer_spills_only_entries_appended_while_enabled,
+            create_data_dir,
+            remove_scrollback_dir),
+        unit_test_setup_teardown(buffer_leaves_no_spill_file_behind,
+            create_data_dir,
+            remove_scrollback_dir),
+        unit_test_setup_teardown(buffer_trim_spills_all_but_newest_entries,
+            create_data_dir,
+            remove_scrollback_dir),
+        unit_test_setup_teardown(buffer_trim_keeps_entries_not_to_be_spilled,
+            create_data_dir,
+            remove_scrollback_dir),
+        unit_test_setup_teardown(buffer_trim_stops_at_entry_not_to_be_spilled,
+            create_data_dir,
+            remove_scrollback_dir),
+        unit_test_setup_teardown(buffer_memory_follows_entries_in_memory,
+            create_data_dir,
+            remove_scrollback_dir),
+
+        unit_test(memory_add_counts_bytes_and_objects),
+        unit_test(memory_total_sums_all_subsystems),
+        unit_test(memory_format_bytes_picks_unit),
+        unit_test(memory_summary_lists_subsystems_and_total),
+
+        unit_test_setup_teardown(wins_trim_trims_least_recently_shown_first,
+            init_window_list,
+            close_window_list),
+        unit_test_setup_teardown(wins_trim_does_nothing_within_budget,
+            init_window_list,
+            close_window_list),
+
+        unit_test_setup_teardown(database_imports_text_logs_on_first_open,
+            create_data_dir,
+            remove_database_dir),
+        unit_test_setup_teardown(database_imports_text_logs_only_once,
+            create_data_dir,
+            remove_database_dir),
+        unit_test_setup_teardown(database_returns_history_since_time,
+            create_data_dir,
+            remove_database_dir),
+        unit_test_setup_teardown(database_search_matches_text_literally,
+            create_data_dir,
+            remove_database_dir),
+
+        unit_test_setup_teardown(log_compress_open_reads_plain_log,
+            create_log_compress_dir,
+            remove_log_compress_dir),
+        unit_test_setup_teardown(log_compress_open_returns_null_for_missing_log,
+            create_log_compress_dir,
+            remove_log_compress_dir),
+#ifdef HAVE_ZSTD
+        unit_test_setup_teardown(log_compress_reads_back_compressed_log,
+            create_log_compress_dir,
+            remove_log_compress_dir),
+        unit_test_setup_teardown(log_compress_keeps_recent_logs,
+            create_log_compress_dir,
+            remove_log_compress_dir),
+        unit_test_setup_teardown(database_imports_compressed_text_logs,
+            create_data_dir,
+            remove_database_dir),
+#endif
     };
 
     return run_tests(all_tests);
@@ -0,0 +1,6 @@
+#include <glib.h>
+
+void autojoin_add(const char *const room, const char *const nick, const char *const password, gboolean rejoin) {}
+void autojoin_room_done(const char *const room) {}
+void autojoin_process(void) {}
+void autojoin_clear(void) {}
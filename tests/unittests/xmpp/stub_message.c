@@ -1,7 +1,33 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
 #include "xmpp/message.h"
+#include "xmpp/connection.h"
 
 ProfMessage *message_init(void) {
     return NULL;
 }
 
 void message_free(ProfMessage *message) {}
+
+void message_handle_stanza(xmpp_stanza_t *const stanza)
+{
+    const char *id = xmpp_stanza_get_id(stanza);
+    check_expected(id);
+
+    char *body = NULL;
+    xmpp_stanza_t *body_stanza = xmpp_stanza_get_child_by_name(stanza, "body");
+    if (body_stanza) {
+        body = xmpp_stanza_get_text(body_stanza);
+    }
+    check_expected(body);
+    xmpp_free(connection_get_ctx(), body);
+}
+
+void message_send_chat_state(const char *const jid, const char *const state)
+{
+    check_expected(jid);
+    check_expected(state);
+}
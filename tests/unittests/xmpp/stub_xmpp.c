@@ -4,6 +4,9 @@
 #include <cmocka.h>
 
 #include "xmpp/xmpp.h"
+#include "xmpp/connection.h"
+#include "xmpp/iq.h"
+#include "xmpp/presence.h"
 
 // connection functions
 void session_init(void) {}
@@ -34,7 +37,7 @@ const char * connection_get_fulljid(void)
     return mock_ptr_type(char *);
 }
 
-const char * connection_get_domain(void)
+char* connection_get_domain(void)
 {
     return NULL;
 }
@@ -63,6 +66,27 @@ jabber_conn_status_t connection_get_status(void)
     return mock_type(jabber_conn_status_t);
 }
 
+xmpp_ctx_t* connection_get_ctx(void)
+{
+    static xmpp_ctx_t *ctx = NULL;
+    if (ctx == NULL) {
+        ctx = xmpp_ctx_new(NULL, NULL);
+    }
+    return ctx;
+}
+
+void iq_handle_stanza(xmpp_stanza_t *const stanza)
+{
+    const char *id = xmpp_stanza_get_id(stanza);
+    check_expected(id);
+}
+
+void presence_handle_stanza(xmpp_stanza_t *const stanza)
+{
+    const char *id = xmpp_stanza_get_id(stanza);
+    check_expected(id);
+}
+
 char* connection_get_presence_msg(void)
 {
     return mock_ptr_type(char*);
@@ -73,6 +97,16 @@ char* session_get_account_name(void)
     return mock_ptr_type(char*);
 }
 
+gboolean session_reconnecting(void)
+{
+    return FALSE;
+}
+
+gboolean session_cancel_connect(void)
+{
+    return (gboolean)mock();
+}
+
 GList * session_get_available_resources(void)
 {
     return NULL;
@@ -83,6 +117,7 @@ void connection_set_presence_msg(const char *const message) {}
 gboolean
 connection_send_stanza(const char *const stanza)
 {
+    check_expected(stanza);
     return TRUE;
 }
 
@@ -163,6 +198,7 @@ void presence_join_room(const char *const room, const char *const nick, const ch
     check_expected(passwd);
 }
 
+void presence_autojoin_room(const char *const room, const char *const nick, const char *const passwd) {}
 void presence_change_room_nick(const char * const room, const char * const nick) {}
 void presence_leave_chat_room(const char * const room_jid) {}
 